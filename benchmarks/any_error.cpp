@@ -0,0 +1,116 @@
+#include "../result.h"
+#include "common.hpp"
+#include <any>
+#include <benchmark/benchmark.h>
+#include <exception>
+
+// Errors of two layers with their own error types unified into one error type at the service layer, which a caller
+// then inspects. Compares res::any_error with the allocating alternatives, std::any and std::exception_ptr.
+namespace {
+
+void failure_rates(benchmark::internal::Benchmark *benchmark) {
+  for (const int percent : {0, 10, 50, 100}) { benchmark->Arg(percent); }
+}
+
+// 16 bytes: inline in res::any_error, on the heap in std::any, whose buffer holds a pointer.
+struct io_error {
+  int code;
+  const char *path;
+};
+
+enum class parse_errc { negative };
+
+BENCH_NOINLINE auto read(int input) -> res::result<int, io_error> {
+  if (input < 0 && input % 2 == 0) { return res::err(io_error{input, "/var/data"}); }
+  return res::ok(input);
+}
+
+BENCH_NOINLINE auto parse(int input) -> res::result<int, parse_errc> {
+  if (input < 0) { return res::err(parse_errc::negative); }
+  return res::ok(input + 1);
+}
+
+BENCH_NOINLINE auto service_any_error(int input) -> res::result<int, res::any_error> {
+  RES_TRY_ASSIGN(const int raw, read(input));
+  RES_TRY_ASSIGN(const int parsed, parse(raw));
+  return res::ok(parsed);
+}
+
+BENCH_NOINLINE auto service_std_any(int input) -> res::result<int, std::any> {
+  auto raw = read(input);
+  if (!raw) { return res::err(std::any(raw.error())); }
+  auto parsed = parse(raw.value());
+  if (!parsed) { return res::err(std::any(parsed.error())); }
+  return res::ok(parsed.value());
+}
+
+BENCH_NOINLINE auto service_exception_ptr(int input) -> res::result<int, std::exception_ptr> {
+  auto raw = read(input);
+  if (!raw) { return res::err(std::make_exception_ptr(raw.error())); }
+  auto parsed = parse(raw.value());
+  if (!parsed) { return res::err(std::make_exception_ptr(parsed.error())); }
+  return res::ok(parsed.value());
+}
+
+// The caller adds up the values and the codes of the I/O errors, so every error is inspected.
+void BM_AnyError(benchmark::State &state) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    long total = 0;
+    for (const int input : inputs) {
+      const auto outcome = service_any_error(input);
+      if (outcome) {
+        total += outcome.value();
+      } else if (const auto *error = outcome.error().as<io_error>()) {
+        total += error->code;
+      }
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+BENCHMARK(BM_AnyError)->Apply(failure_rates);
+
+void BM_StdAny(benchmark::State &state) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    long total = 0;
+    for (const int input : inputs) {
+      const auto outcome = service_std_any(input);
+      if (outcome) {
+        total += outcome.value();
+      } else if (const auto *error = std::any_cast<io_error>(&outcome.error())) {
+        total += error->code;
+      }
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+BENCHMARK(BM_StdAny)->Apply(failure_rates);
+
+// An exception_ptr can only be inspected by rethrowing it.
+void BM_ExceptionPtr(benchmark::State &state) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    long total = 0;
+    for (const int input : inputs) {
+      const auto outcome = service_exception_ptr(input);
+      if (outcome) {
+        total += outcome.value();
+        continue;
+      }
+      try {
+        std::rethrow_exception(outcome.error());
+      } catch (const io_error &error) {
+        total += error.code;
+      } catch (...) {
+      }
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+BENCHMARK(BM_ExceptionPtr)->Apply(failure_rates);
+
+} // namespace
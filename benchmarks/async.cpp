@@ -0,0 +1,63 @@
+#include "../result_concurrency.h"
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <future>
+#include <thread>
+#include <vector>
+
+// Fan-out/fan-in: a producer thread fulfills a batch of one-shot results while the consumer maps every one of them
+// and then waits for the whole batch. std::future can only map after a blocking get; async_result chains the map as
+// a continuation that runs on whichever thread finishes second.
+namespace {
+
+constexpr int batch_size = 4096;
+
+void BM_FanOutStdFuture(benchmark::State &state) {
+  for (auto _ : state) {
+    std::vector<std::promise<res::result<int, int>>> promises(batch_size);
+    std::vector<std::future<res::result<int, int>>> futures;
+    futures.reserve(batch_size);
+    for (auto &promise : promises) { futures.push_back(promise.get_future()); }
+    std::thread producer([&promises] {
+      int value = 0;
+      for (auto &promise : promises) { promise.set_value(res::ok(value++)); }
+    });
+    long sum = 0;
+    for (auto &future : futures) {
+      sum += future.get().map([](int val) { return val * 2; }).value();
+    }
+    producer.join();
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+BENCHMARK(BM_FanOutStdFuture)->UseRealTime();
+
+void BM_FanOutAsyncResult(benchmark::State &state) {
+  for (auto _ : state) {
+    std::vector<res::promise<int, int>> promises(batch_size);
+    std::vector<res::async_result<int, int>> mapped;
+    mapped.reserve(batch_size);
+    std::atomic<long> sum{0};
+    std::vector<res::async_result<int, int>> futures;
+    futures.reserve(batch_size);
+    for (auto &promise : promises) { futures.push_back(promise.get_async_result()); }
+    std::thread producer([&promises] {
+      int value = 0;
+      for (auto &promise : promises) { promise.set_result(res::ok(value++)); }
+    });
+    for (auto &future : futures) {
+      mapped.push_back(std::move(future).map([&sum](int val) {
+        sum.fetch_add(val * 2, std::memory_order_relaxed);
+        return val;
+      }));
+    }
+    for (auto &result : mapped) { benchmark::DoNotOptimize(std::move(result).get()); }
+    producer.join();
+    benchmark::DoNotOptimize(sum.load());
+  }
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+BENCHMARK(BM_FanOutAsyncResult)->UseRealTime();
+
+} // namespace
@@ -0,0 +1,83 @@
+#include "../result.h"
+#include "common.hpp"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+namespace {
+
+// A lambda rather than a function so traverse can inline it instead of calling through a function pointer.
+constexpr auto checked = [](int input) -> res::result<int, int> {
+  if (input < 0) { return res::err(-input); }
+  return res::ok(input);
+};
+
+// Inputs that fail only at the very end, so every strategy walks the whole range on the ok path.
+auto make_batch(int failure_percent) -> std::vector<int> {
+  auto inputs = bench::make_inputs(0);
+  if (failure_percent > 0) { inputs.back() = -1; }
+  return inputs;
+}
+
+// The loop as it is usually written by hand: no reserve, the error is only checked after the whole range.
+auto traverse_naive(const std::vector<int> &inputs) -> res::result<std::vector<int>, int> {
+  std::vector<int> values;
+  int error = 0;
+  bool failed = false;
+  for (const int input : inputs) {
+    auto parsed = checked(input);
+    if (parsed.is_ok()) {
+      values.push_back(parsed.value());
+    } else if (!failed) {
+      failed = true;
+      error = parsed.error();
+    }
+  }
+  if (failed) { return res::err(error); }
+  return res::ok(values);
+}
+
+void BM_TraverseNaive(benchmark::State &state) {
+  const auto inputs = make_batch(static_cast<int>(state.range(0)));
+  for (auto _ : state) { benchmark::DoNotOptimize(traverse_naive(inputs)); }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+BENCHMARK(BM_TraverseNaive)->Arg(0)->Arg(100);
+
+void BM_Traverse(benchmark::State &state) {
+  const auto inputs = make_batch(static_cast<int>(state.range(0)));
+  for (auto _ : state) { benchmark::DoNotOptimize(res::traverse(inputs, checked)); }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+BENCHMARK(BM_Traverse)->Arg(0)->Arg(100);
+
+// Collecting materialized results, both by hand and with res::collect.
+void BM_CollectManual(benchmark::State &state) {
+  std::vector<res::result<int, int>> results;
+  for (const int input : make_batch(static_cast<int>(state.range(0)))) { results.push_back(checked(input)); }
+  for (auto _ : state) {
+    std::vector<int> values;
+    values.reserve(results.size());
+    bool failed = false;
+    for (const auto &result : results) {
+      if (!result.is_ok()) {
+        failed = true;
+        break;
+      }
+      values.push_back(result.value());
+    }
+    benchmark::DoNotOptimize(values.data());
+    benchmark::DoNotOptimize(failed);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(results.size()));
+}
+BENCHMARK(BM_CollectManual)->Arg(0)->Arg(100);
+
+void BM_Collect(benchmark::State &state) {
+  std::vector<res::result<int, int>> results;
+  for (const int input : make_batch(static_cast<int>(state.range(0)))) { results.push_back(checked(input)); }
+  for (auto _ : state) { benchmark::DoNotOptimize(res::collect(results)); }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(results.size()));
+}
+BENCHMARK(BM_Collect)->Arg(0)->Arg(100);
+
+} // namespace
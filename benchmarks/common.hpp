@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#if defined(_MSC_VER)
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#define BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+namespace bench {
+
+inline constexpr std::size_t input_size = 1024;
+
+// Deterministic inputs where roughly failure_percent of the entries are negative, i.e. make the workload fail.
+inline auto make_inputs(int failure_percent) -> std::vector<int> {
+  std::mt19937 gen(42); // NOLINT(cert-msc51-cpp)
+  std::uniform_int_distribution<int> percent(0, 99);
+  std::uniform_int_distribution<int> value(1, 1000);
+  std::vector<int> inputs(input_size);
+  for (auto &input : inputs) { input = percent(gen) < failure_percent ? -value(gen) : value(gen); }
+  return inputs;
+}
+
+} // namespace bench
@@ -0,0 +1,35 @@
+// Instantiation cost of many distinct result types, see the compile_time_benchmarks target.
+#include "../../result.h"
+#include <array>
+#include <cstddef>
+#include <string>
+#include <utility>
+
+namespace {
+
+template <std::size_t I> struct tag {
+  int value = static_cast<int>(I);
+};
+
+// Each result<tag<I>, std::string> is a separate instantiation of result, its storage and the ok/err conversions.
+template <std::size_t I> auto make(int input) -> res::result<tag<I>, std::string> {
+  if (input < 0) { return res::err(std::string("negative")); }
+  return res::ok(tag<I>{input});
+}
+
+template <std::size_t I> auto use(int input) -> int {
+  return make<I>(input).map([](tag<I> value) { return value.value; }).value_or(0);
+}
+
+// A table of separate functions rather than one fold expression, so the optimizer sees many small functions like it
+// would across a code base instead of one huge one.
+template <std::size_t... Is> constexpr auto uses(std::index_sequence<Is...> /*indices*/) {
+  return std::array<int (*)(int), sizeof...(Is)>{&use<Is>...};
+}
+
+} // namespace
+
+auto compile_time_many_types(std::size_t index, int input) -> int {
+  static constexpr auto table = uses(std::make_index_sequence<1000>{});
+  return table[index % table.size()](input);
+}
@@ -0,0 +1,25 @@
+// Instantiation cost of deep map and and_then chains, see the compile_time_benchmarks target.
+#include "../../result.h"
+#include <cstddef>
+#include <string>
+
+namespace {
+
+// Every step has its own lambda type, so each map and and_then in the chain is a separate instantiation.
+template <std::size_t Depth> auto chain(res::result<int, std::string> value) -> res::result<int, std::string> {
+  if constexpr (Depth == 0) {
+    return value;
+  } else {
+    auto next = std::move(value)
+                    .map([](int current) { return current + static_cast<int>(Depth); })
+                    .and_then([](int current) -> res::result<int, std::string> {
+                      if (current < 0) { return res::err(std::string("overflow")); }
+                      return res::ok(current);
+                    });
+    return chain<Depth - 1>(std::move(next));
+  }
+}
+
+} // namespace
+
+auto compile_time_map_chain(int input) -> res::result<int, std::string> { return chain<256>(res::ok(input)); }
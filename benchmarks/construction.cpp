@@ -0,0 +1,51 @@
+#include "../result.h"
+#include "common.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+BENCH_NOINLINE auto make_int(int input) -> res::result<int, int> {
+  if (input < 0) { return res::err(input); }
+  return res::ok(input);
+}
+
+BENCH_NOINLINE auto make_string(int input) -> res::result<std::string, std::string> {
+  if (input < 0) { return res::err(std::string("negative input is not allowed here")); }
+  return res::ok(std::string("positive input is accepted as is"));
+}
+
+void BM_ConstructInt(benchmark::State &state) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    for (const int input : inputs) { benchmark::DoNotOptimize(make_int(input)); }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+BENCHMARK(BM_ConstructInt)->Arg(0)->Arg(50)->Arg(100);
+
+void BM_ConstructString(benchmark::State &state) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    for (const int input : inputs) { benchmark::DoNotOptimize(make_string(input)); }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+BENCHMARK(BM_ConstructString)->Arg(0)->Arg(50)->Arg(100);
+
+void BM_IsOk(benchmark::State &state) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  std::vector<res::result<int, int>> results;
+  results.reserve(inputs.size());
+  for (const int input : inputs) { results.push_back(make_int(input)); }
+  for (auto _ : state) {
+    int count = 0;
+    for (const auto &result : results) { count += static_cast<int>(result.is_ok()); }
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(results.size()));
+}
+BENCHMARK(BM_IsOk)->Arg(0)->Arg(50)->Arg(100);
+
+} // namespace
@@ -0,0 +1,52 @@
+#include "../result.h"
+#include "common.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+
+namespace {
+
+// Five layers of propagation, each attaching what it was doing; the errors are counted but never printed.
+BENCH_NOINLINE auto read_string(int input) -> res::result<int, std::string> {
+  if (input < 0) { return res::err(std::string("not found")); }
+  return res::ok(input);
+}
+
+BENCH_NOINLINE auto load_string(int input) -> res::result<int, std::string> {
+  return read_string(input)
+      .map_err([](std::string error) { return "reading block: " + error; })
+      .map_err([](std::string error) { return "decoding page: " + error; })
+      .map_err([input](std::string error) { return "loading row " + std::to_string(-input) + ": " + error; })
+      .map_err([](std::string error) { return "scanning table: " + error; })
+      .map_err([](std::string error) { return "running query: " + error; });
+}
+
+BENCH_NOINLINE auto load_context(int input) -> res::result<int, res::context_error<std::string>> {
+  return read_string(input)
+      .context("reading block")
+      .context("decoding page")
+      .with_context([input] { return "loading row " + std::to_string(-input); })
+      .context("scanning table")
+      .context("running query");
+}
+
+template <typename Load> void run_load(benchmark::State &state, Load load) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    int failed = 0;
+    for (const int input : inputs) {
+      auto loaded = load(input);
+      benchmark::DoNotOptimize(loaded);
+      failed += loaded.is_ok() ? 0 : 1;
+    }
+    benchmark::DoNotOptimize(failed);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+
+void BM_ContextMapErrString(benchmark::State &state) { run_load(state, load_string); }
+BENCHMARK(BM_ContextMapErrString)->Arg(0)->Arg(10)->Arg(50)->Arg(100);
+
+void BM_ContextArena(benchmark::State &state) { run_load(state, load_context); }
+BENCHMARK(BM_ContextArena)->Arg(0)->Arg(10)->Arg(50)->Arg(100);
+
+} // namespace
@@ -0,0 +1,167 @@
+// Coroutine support needs C++20; the suite builds as C++23 when the compiler supports it.
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include "../result_coro.h"
+#include "common.hpp"
+#include <benchmark/benchmark.h>
+#include <coroutine>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+// Three-level propagation written by hand, as a result coroutine, as res::task and as an exception-based task.
+namespace {
+
+BENCH_NOINLINE auto parse(int input) -> res::result<int, int> {
+  if (input < 0) { return res::err(-input); }
+  return res::ok(input);
+}
+
+BENCH_NOINLINE auto manual_middle(int input) -> res::result<int, int> {
+  auto parsed = parse(input);
+  if (!parsed) { return res::err(parsed.error()); }
+  return res::ok(parsed.value() * 2);
+}
+
+BENCH_NOINLINE auto manual_top(int input) -> res::result<int, int> {
+  auto middle = manual_middle(input);
+  if (!middle) { return res::err(middle.error()); }
+  return res::ok(middle.value() + 1);
+}
+
+BENCH_NOINLINE auto coro_middle(int input) -> res::result<int, int> {
+  const int parsed = co_await parse(input);
+  co_return res::ok(parsed * 2);
+}
+
+BENCH_NOINLINE auto coro_top(int input) -> res::result<int, int> {
+  const int middle = co_await coro_middle(input);
+  co_return res::ok(middle + 1);
+}
+
+auto task_middle(int input) -> res::task<int, int> {
+  const int parsed = co_await parse(input);
+  co_return res::ok(parsed * 2);
+}
+
+auto task_top(int input) -> res::task<int, int> {
+  const int middle = co_await task_middle(input);
+  co_return res::ok(middle + 1);
+}
+
+// Minimal lazy task that reports failures by throwing, for comparison with res::task.
+template <typename T> class throwing_task {
+public:
+  struct promise_type {
+    T value_{};
+    std::exception_ptr exception_;
+    std::coroutine_handle<> continuation_ = std::noop_coroutine();
+
+    auto get_return_object() noexcept -> throwing_task {
+      return throwing_task(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    static auto initial_suspend() noexcept -> std::suspend_always { return {}; }
+    static auto final_suspend() noexcept {
+      struct awaiter {
+        static auto await_ready() noexcept -> bool { return false; }
+        static auto await_suspend(std::coroutine_handle<promise_type> handle) noexcept -> std::coroutine_handle<> {
+          return handle.promise().continuation_;
+        }
+        static void await_resume() noexcept {}
+      };
+      return awaiter{};
+    }
+    void return_value(T value) { value_ = std::move(value); }
+    void unhandled_exception() noexcept { exception_ = std::current_exception(); }
+  };
+
+  throwing_task(throwing_task &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+  throwing_task(const throwing_task &) = delete;
+  auto operator=(const throwing_task &) -> throwing_task & = delete;
+  auto operator=(throwing_task &&) -> throwing_task & = delete;
+  ~throwing_task() {
+    if (handle_) { handle_.destroy(); }
+  }
+
+  auto operator co_await() && noexcept {
+    struct awaiter {
+      std::coroutine_handle<promise_type> handle_;
+      static auto await_ready() noexcept -> bool { return false; }
+      auto await_suspend(std::coroutine_handle<> continuation) noexcept -> std::coroutine_handle<> {
+        handle_.promise().continuation_ = continuation;
+        return handle_;
+      }
+      auto await_resume() -> T {
+        if (handle_.promise().exception_) { std::rethrow_exception(handle_.promise().exception_); }
+        return std::move(handle_.promise().value_);
+      }
+    };
+    return awaiter{handle_};
+  }
+
+  // Runs a task that never suspends on anything external.
+  auto get() -> T {
+    handle_.resume();
+    if (handle_.promise().exception_) { std::rethrow_exception(handle_.promise().exception_); }
+    return std::move(handle_.promise().value_);
+  }
+
+private:
+  std::coroutine_handle<promise_type> handle_;
+  explicit throwing_task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+};
+
+BENCH_NOINLINE auto parse_or_throw(int input) -> int {
+  if (input < 0) { throw std::invalid_argument("negative"); }
+  return input;
+}
+
+auto throwing_middle(int input) -> throwing_task<int> { co_return parse_or_throw(input) * 2; }
+
+auto throwing_top(int input) -> throwing_task<int> { co_return co_await throwing_middle(input) + 1; }
+
+void BM_CoroManual(benchmark::State &state) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    for (const int input : inputs) { benchmark::DoNotOptimize(manual_top(input)); }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+BENCHMARK(BM_CoroManual)->Arg(0)->Arg(10)->Arg(100);
+
+void BM_CoroResult(benchmark::State &state) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    for (const int input : inputs) { benchmark::DoNotOptimize(coro_top(input)); }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+BENCHMARK(BM_CoroResult)->Arg(0)->Arg(10)->Arg(100);
+
+void BM_CoroTask(benchmark::State &state) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    for (const int input : inputs) { benchmark::DoNotOptimize(res::sync_wait(task_top(input))); }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+BENCHMARK(BM_CoroTask)->Arg(0)->Arg(10)->Arg(100);
+
+void BM_CoroThrowingTask(benchmark::State &state) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    for (const int input : inputs) {
+      try {
+        benchmark::DoNotOptimize(throwing_top(input).get());
+      } catch (const std::invalid_argument &error) {
+        benchmark::DoNotOptimize(&error);
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+BENCHMARK(BM_CoroThrowingTask)->Arg(0)->Arg(10)->Arg(100);
+
+} // namespace
+
+#endif
@@ -0,0 +1,52 @@
+#include "../result.h"
+#include "common.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+
+namespace {
+
+constexpr res::error_descriptor out_of_range{"validation", "value {} is outside [{}, {}]"};
+
+// Validation that rejects roughly failure_percent of the inputs; rejections are only counted, never printed.
+BENCH_NOINLINE auto validate_string(int input) -> res::result<int, std::string> {
+  if (input < 0) {
+    return res::err("value " + std::to_string(input) + " is outside [" + std::to_string(0) + ", " +
+                    std::to_string(1000) + "]");
+  }
+  return res::ok(input);
+}
+
+BENCH_NOINLINE auto validate_code(int input) -> res::result<int, res::formatted_error> {
+  if (input < 0) { return res::err(out_of_range(input, 0, 1000)); }
+  return res::ok(input);
+}
+
+BENCH_NOINLINE auto validate_plain_code(int input) -> res::result<int, res::error_code> {
+  if (input < 0) { return res::err(res::error_code(out_of_range)); }
+  return res::ok(input);
+}
+
+template <typename Validate> void run_validation(benchmark::State &state, Validate validate) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    int rejected = 0;
+    for (const int input : inputs) {
+      auto validated = validate(input);
+      benchmark::DoNotOptimize(validated);
+      rejected += validated.is_ok() ? 0 : 1;
+    }
+    benchmark::DoNotOptimize(rejected);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+
+void BM_ValidateString(benchmark::State &state) { run_validation(state, validate_string); }
+BENCHMARK(BM_ValidateString)->Arg(0)->Arg(10)->Arg(50);
+
+void BM_ValidateFormattedError(benchmark::State &state) { run_validation(state, validate_code); }
+BENCHMARK(BM_ValidateFormattedError)->Arg(0)->Arg(10)->Arg(50);
+
+void BM_ValidateErrorCode(benchmark::State &state) { run_validation(state, validate_plain_code); }
+BENCHMARK(BM_ValidateErrorCode)->Arg(0)->Arg(10)->Arg(50);
+
+} // namespace
@@ -0,0 +1,84 @@
+#include "../result.h"
+#include "common.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace {
+
+enum class lookup_errc : std::uint8_t { missing };
+
+struct cache_entry {
+  std::string key;
+  std::string payload;
+};
+
+// A cache of multi-KB entries where roughly failure_percent of the lookups miss.
+class entry_cache {
+  std::unordered_map<int, cache_entry> entries_;
+
+public:
+  explicit entry_cache(std::size_t payload_size) {
+    for (int key = 1; key <= 1000; ++key) {
+      entries_.emplace(key, cache_entry{std::to_string(key), std::string(payload_size, 'x')});
+    }
+  }
+
+  BENCH_NOINLINE auto find_copy(int key) const -> res::result<cache_entry, lookup_errc> {
+    const auto found = entries_.find(key);
+    if (found == entries_.end()) { return res::err(lookup_errc::missing); }
+    return res::ok(found->second);
+  }
+
+  BENCH_NOINLINE auto find_ref(int key) const -> res::result<const cache_entry &, lookup_errc> {
+    const auto found = entries_.find(key);
+    if (found == entries_.end()) { return res::err(lookup_errc::missing); }
+    return res::ok(std::cref(found->second));
+  }
+
+  BENCH_NOINLINE auto find_view(int key) const -> res::result<std::string_view, lookup_errc> {
+    const auto found = entries_.find(key);
+    if (found == entries_.end()) { return res::err(lookup_errc::missing); }
+    return res::ok(std::string_view(found->second.payload));
+  }
+};
+
+template <typename Lookup> void run_lookups(benchmark::State &state, Lookup lookup) {
+  const entry_cache cache(static_cast<std::size_t>(state.range(1)));
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    std::size_t bytes = 0;
+    for (const int input : inputs) { bytes += lookup(cache, input); }
+    benchmark::DoNotOptimize(bytes);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+
+void BM_LookupOwning(benchmark::State &state) {
+  run_lookups(state, [](const entry_cache &cache, int key) -> std::size_t {
+    auto found = cache.find_copy(key);
+    return found ? found.value().payload.size() : 0;
+  });
+}
+BENCHMARK(BM_LookupOwning)->ArgsProduct({{0, 50}, {64, 4096}});
+
+void BM_LookupReference(benchmark::State &state) {
+  run_lookups(state, [](const entry_cache &cache, int key) -> std::size_t {
+    auto found = cache.find_ref(key);
+    return found ? found.value().payload.size() : 0;
+  });
+}
+BENCHMARK(BM_LookupReference)->ArgsProduct({{0, 50}, {64, 4096}});
+
+void BM_LookupView(benchmark::State &state) {
+  run_lookups(state, [](const entry_cache &cache, int key) -> std::size_t {
+    auto found = cache.find_view(key);
+    return found ? found.value().size() : 0;
+  });
+}
+BENCHMARK(BM_LookupView)->ArgsProduct({{0, 50}, {64, 4096}});
+
+} // namespace
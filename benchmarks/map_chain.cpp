@@ -0,0 +1,50 @@
+#include "../result.h"
+#include "common.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+
+namespace {
+
+auto make_payload(int input) -> res::result<std::string, std::string> {
+  if (input < 0) { return res::err(std::string(64, 'e')); }
+  return res::ok(std::string(64, 'v'));
+}
+
+auto append(char chr) {
+  return [chr](std::string value) -> std::string {
+    value.back() = chr;
+    return value;
+  };
+}
+
+// Chain on named results: every stage copies the payload out of the previous one.
+void BM_MapChainLvalue(benchmark::State &state) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    for (const int input : inputs) {
+      const auto first = make_payload(input);
+      const auto second = first.map(append('a'));
+      const auto third = second.map(append('b'));
+      const auto fourth = third.map_err(append('c'));
+      const auto fifth = fourth.map(append('d'));
+      benchmark::DoNotOptimize(fifth.map(append('e')));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+BENCHMARK(BM_MapChainLvalue)->Arg(0)->Arg(50)->Arg(100);
+
+// Chain on temporaries: rvalue overloads move the payload through every stage.
+void BM_MapChainRvalue(benchmark::State &state) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    for (const int input : inputs) {
+      benchmark::DoNotOptimize(
+          make_payload(input).map(append('a')).map(append('b')).map_err(append('c')).map(append('d')).map(append('e')));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+BENCHMARK(BM_MapChainRvalue)->Arg(0)->Arg(50)->Arg(100);
+
+} // namespace
@@ -0,0 +1,78 @@
+#include "../result_concurrency.h"
+#include "common.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+enum class lookup_errc { missing };
+
+// An expensive lookup of which a quarter of the keys do not exist.
+BENCH_NOINLINE auto slow_lookup(int key) -> res::result<std::string, lookup_errc> {
+  std::uint64_t state = static_cast<std::uint64_t>(key);
+  for (int round = 0; round < 2000; ++round) { state = state * 6364136223846793005ULL + 1442695040888963407ULL; }
+  benchmark::DoNotOptimize(state);
+  if (key % 4 == 0) { return res::err(lookup_errc::missing); }
+  return res::ok(std::to_string(key));
+}
+
+// Keys skewed towards small values, like the popular entries of a real cache.
+auto make_keys(int seed) -> std::vector<int> {
+  std::mt19937 gen(static_cast<std::mt19937::result_type>(seed));
+  std::geometric_distribution<int> key(0.01);
+  std::vector<int> keys(bench::input_size);
+  for (auto &value : keys) { value = key(gen); }
+  return keys;
+}
+
+auto policy(std::size_t err_capacity) -> res::memoize_policy {
+  res::memoize_policy result;
+  result.ok_capacity = 512;
+  result.err_capacity = err_capacity;
+  result.err_ttl = std::chrono::seconds(60);
+  return result;
+}
+
+template <typename Memoized> void run(benchmark::State &state, Memoized &lookup) {
+  const auto keys = make_keys(state.thread_index());
+  for (auto _ : state) {
+    std::size_t found = 0;
+    for (const int key : keys) { found += lookup(key).is_ok() ? 1 : 0; }
+    benchmark::DoNotOptimize(found);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(keys.size()));
+  if (state.thread_index() == 0) {
+    const auto stats = lookup.stats();
+    const auto calls = static_cast<double>(stats.ok_hits + stats.err_hits + stats.misses + stats.coalesced);
+    state.counters["hit_rate"] = static_cast<double>(stats.ok_hits + stats.err_hits) / calls;
+  }
+}
+
+void BM_Uncached(benchmark::State &state) {
+  const auto keys = make_keys(state.thread_index());
+  for (auto _ : state) {
+    std::size_t found = 0;
+    for (const int key : keys) { found += slow_lookup(key).is_ok() ? 1 : 0; }
+    benchmark::DoNotOptimize(found);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(keys.size()));
+}
+BENCHMARK(BM_Uncached)->ThreadRange(1, 8)->UseRealTime();
+
+// Only values are cached, so every lookup of a missing key pays the full cost.
+void BM_MemoizeValuesOnly(benchmark::State &state) {
+  static auto lookup = res::memoize(slow_lookup, policy(0));
+  run(state, lookup);
+}
+BENCHMARK(BM_MemoizeValuesOnly)->ThreadRange(1, 8)->UseRealTime();
+
+void BM_MemoizeNegative(benchmark::State &state) {
+  static auto lookup = res::memoize(slow_lookup, policy(256));
+  run(state, lookup);
+}
+BENCHMARK(BM_MemoizeNegative)->ThreadRange(1, 8)->UseRealTime();
+
+} // namespace
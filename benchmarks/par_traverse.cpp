@@ -0,0 +1,55 @@
+#include "../result_concurrency.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t batch_size = 1 << 18;
+
+// A record worth a few hundred nanoseconds of work; the record at fail_at fails.
+auto make_work(int fail_at) {
+  return [fail_at](int record) -> res::result<double, int> {
+    if (record == fail_at) { return res::err(record); }
+    double acc = record;
+    for (int i = 0; i < 64; ++i) { acc = std::sqrt(acc + i); }
+    return res::ok(acc);
+  };
+}
+
+auto make_batch() -> std::vector<int> {
+  std::vector<int> batch(batch_size);
+  std::iota(batch.begin(), batch.end(), 0);
+  return batch;
+}
+
+// Arg is the index of the failing record, -1 for none.
+void BM_TraverseSequential(benchmark::State &state) {
+  const auto batch = make_batch();
+  const auto work = make_work(static_cast<int>(state.range(0)));
+  for (auto _ : state) { benchmark::DoNotOptimize(res::traverse(batch, work)); }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch.size()));
+}
+BENCHMARK(BM_TraverseSequential)->Arg(-1)->Arg(batch_size / 2)->Unit(benchmark::kMillisecond);
+
+void BM_ParTraverse(benchmark::State &state) {
+  const auto batch = make_batch();
+  const auto work = make_work(static_cast<int>(state.range(0)));
+  for (auto _ : state) { benchmark::DoNotOptimize(res::par_traverse(batch, work)); }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch.size()));
+}
+BENCHMARK(BM_ParTraverse)->Arg(-1)->Arg(batch_size / 2)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+void BM_ParTraverseFirstInTime(benchmark::State &state) {
+  const auto batch = make_batch();
+  const auto work = make_work(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(res::par_traverse(batch, work, res::error_order::first_in_time));
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch.size()));
+}
+BENCHMARK(BM_ParTraverseFirstInTime)->Arg(batch_size / 2)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+} // namespace
@@ -0,0 +1,49 @@
+#include "../result.h"
+#include "common.hpp"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+BENCH_NOINLINE auto parse(int input) -> res::result<int, int> {
+  if (input < 0) { return res::err(-input); }
+  return res::ok(input);
+}
+
+// A lambda rather than a function so the fused stage stores no function pointer to call through.
+constexpr auto checked = [](int value) -> res::result<int, int> {
+  if (value > 5000) { return res::err(value); }
+  return res::ok(value);
+};
+
+// Six eager stages: every stage materializes an intermediate result and tests its discriminant.
+void BM_PipelineEager(benchmark::State &state) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    for (const int input : inputs) {
+      benchmark::DoNotOptimize(parse(input)
+                                   .map([](int val) { return val * 2; })
+                                   .and_then(checked)
+                                   .map([](int val) { return val + 7; })
+                                   .map_err([](int err) { return err + 1; })
+                                   .and_then(checked)
+                                   .map([](int val) { return val / 3; }));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+BENCHMARK(BM_PipelineEager)->Arg(0)->Arg(50)->Arg(100);
+
+// The same six stages fused: values and errors travel as plain ints and only the final result is built.
+void BM_PipelineFused(benchmark::State &state) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  const auto stages = res::map([](int val) { return val * 2; }) | res::and_then(checked) |
+                      res::map([](int val) { return val + 7; }) | res::map_err([](int err) { return err + 1; }) |
+                      res::and_then(checked) | res::map([](int val) { return val / 3; });
+  for (auto _ : state) {
+    for (const int input : inputs) { benchmark::DoNotOptimize((parse(input) | stages).run()); }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+BENCHMARK(BM_PipelineFused)->Arg(0)->Arg(50)->Arg(100);
+
+} // namespace
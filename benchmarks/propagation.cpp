@@ -0,0 +1,160 @@
+#include "../result.h"
+#include "common.hpp"
+#include <benchmark/benchmark.h>
+#include <optional>
+
+#if __has_include(<expected>)
+#include <expected>
+#endif
+
+// The same workload, a value checked at the bottom of N calls and incremented on the way up, written with every
+// error-handling strategy we compare result against.
+namespace {
+
+void failure_rates(benchmark::internal::Benchmark *benchmark) {
+  for (const int percent : {0, 1, 10, 50, 100}) { benchmark->Arg(percent); }
+}
+
+template <int Depth> BENCH_NOINLINE auto result_level(int input) -> res::result<int, int> {
+  if constexpr (Depth == 0) {
+    if (input < 0) { return res::err(input); }
+    return res::ok(input);
+  } else {
+    auto inner = result_level<Depth - 1>(input);
+    if (!inner) { return res::err(inner.error()); }
+    return res::ok(inner.value() + 1);
+  }
+}
+
+struct failure {
+  int code;
+};
+
+template <int Depth> BENCH_NOINLINE auto exception_level(int input) -> int {
+  if constexpr (Depth == 0) {
+    if (input < 0) { throw failure{input}; }
+    return input;
+  } else {
+    return exception_level<Depth - 1>(input) + 1;
+  }
+}
+
+template <int Depth> BENCH_NOINLINE auto error_code_level(int input, int &output) -> int {
+  if constexpr (Depth == 0) {
+    if (input < 0) { return input; }
+    output = input;
+    return 0;
+  } else {
+    int inner = 0;
+    if (const int code = error_code_level<Depth - 1>(input, inner); code != 0) { return code; }
+    output = inner + 1;
+    return 0;
+  }
+}
+
+template <int Depth> BENCH_NOINLINE auto optional_level(int input) -> std::optional<int> {
+  if constexpr (Depth == 0) {
+    if (input < 0) { return std::nullopt; }
+    return input;
+  } else {
+    auto inner = optional_level<Depth - 1>(input);
+    if (!inner) { return std::nullopt; }
+    return *inner + 1;
+  }
+}
+
+template <int Depth> void BM_Result(benchmark::State &state) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    int sum = 0;
+    for (const int input : inputs) {
+      const auto result = result_level<Depth>(input);
+      sum += result ? result.value() : result.error();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+
+template <int Depth> void BM_Exception(benchmark::State &state) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    int sum = 0;
+    for (const int input : inputs) {
+      try {
+        sum += exception_level<Depth>(input);
+      } catch (const failure &error) { sum += error.code; }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+
+template <int Depth> void BM_ErrorCode(benchmark::State &state) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    int sum = 0;
+    for (const int input : inputs) {
+      int output = 0;
+      const int code = error_code_level<Depth>(input, output);
+      sum += code == 0 ? output : code;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+
+template <int Depth> void BM_Optional(benchmark::State &state) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    int sum = 0;
+    for (const int input : inputs) {
+      const auto result = optional_level<Depth>(input);
+      sum += result ? *result : -1;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+
+BENCHMARK_TEMPLATE(BM_Result, 1)->Apply(failure_rates);
+BENCHMARK_TEMPLATE(BM_Result, 8)->Apply(failure_rates);
+BENCHMARK_TEMPLATE(BM_Exception, 1)->Apply(failure_rates);
+BENCHMARK_TEMPLATE(BM_Exception, 8)->Apply(failure_rates);
+BENCHMARK_TEMPLATE(BM_ErrorCode, 1)->Apply(failure_rates);
+BENCHMARK_TEMPLATE(BM_ErrorCode, 8)->Apply(failure_rates);
+BENCHMARK_TEMPLATE(BM_Optional, 1)->Apply(failure_rates);
+BENCHMARK_TEMPLATE(BM_Optional, 8)->Apply(failure_rates);
+
+#if defined(__cpp_lib_expected)
+
+template <int Depth> BENCH_NOINLINE auto expected_level(int input) -> std::expected<int, int> {
+  if constexpr (Depth == 0) {
+    if (input < 0) { return std::unexpected(input); }
+    return input;
+  } else {
+    auto inner = expected_level<Depth - 1>(input);
+    if (!inner) { return std::unexpected(inner.error()); }
+    return *inner + 1;
+  }
+}
+
+template <int Depth> void BM_Expected(benchmark::State &state) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    int sum = 0;
+    for (const int input : inputs) {
+      const auto result = expected_level<Depth>(input);
+      sum += result ? *result : result.error();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+
+BENCHMARK_TEMPLATE(BM_Expected, 1)->Apply(failure_rates);
+BENCHMARK_TEMPLATE(BM_Expected, 8)->Apply(failure_rates);
+
+#endif
+
+} // namespace
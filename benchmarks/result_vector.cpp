@@ -0,0 +1,66 @@
+#include "../result.h"
+#include "common.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <vector>
+
+namespace {
+
+auto to_result(int input) -> res::result<int, int> {
+  if (input < 0) { return res::err(-input); }
+  return res::ok(input);
+}
+
+auto make_rows(int failure_percent) -> std::vector<res::result<int, int>> {
+  std::vector<res::result<int, int>> rows;
+  for (const int input : bench::make_inputs(failure_percent)) { rows.push_back(to_result(input)); }
+  return rows;
+}
+
+auto make_columns(int failure_percent) -> res::result_vector<int, int> {
+  res::result_vector<int, int> columns;
+  for (const int input : bench::make_inputs(failure_percent)) { columns.push_back(to_result(input)); }
+  return columns;
+}
+
+void BM_CountOkRows(benchmark::State &state) {
+  const auto rows = make_rows(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::count_if(rows.begin(), rows.end(), [](const auto &row) { return row.is_ok(); }));
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(rows.size()));
+}
+BENCHMARK(BM_CountOkRows)->Arg(0)->Arg(5)->Arg(50);
+
+void BM_CountOkColumns(benchmark::State &state) {
+  const auto columns = make_columns(static_cast<int>(state.range(0)));
+  for (auto _ : state) { benchmark::DoNotOptimize(columns.count_ok()); }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(columns.size()));
+}
+BENCHMARK(BM_CountOkColumns)->Arg(0)->Arg(5)->Arg(50);
+
+void BM_MapRows(benchmark::State &state) {
+  const auto rows = make_rows(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    std::vector<res::result<int, int>> mapped;
+    mapped.reserve(rows.size());
+    for (const auto &row : rows) {
+      mapped.push_back(row.map([](int val) { return val * 3 + 1; }));
+    }
+    benchmark::DoNotOptimize(mapped.data());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(rows.size()));
+}
+BENCHMARK(BM_MapRows)->Arg(0)->Arg(5)->Arg(50);
+
+void BM_MapColumns(benchmark::State &state) {
+  const auto columns = make_columns(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    auto mapped = columns.map([](int val) { return val * 3 + 1; });
+    benchmark::DoNotOptimize(mapped.first_err());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(columns.size()));
+}
+BENCHMARK(BM_MapColumns)->Arg(0)->Arg(5)->Arg(50);
+
+} // namespace
@@ -0,0 +1,111 @@
+#include "../result.h"
+#include "common.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+enum class job_errc : std::uint8_t { cancelled, timed_out };
+
+using outcome = res::result<std::string, job_errc>;
+
+// A batch of job outcomes with roughly failure_percent errors; values are log lines of a few dozen bytes.
+auto make_batch(int failure_percent) -> std::vector<outcome> {
+  std::vector<outcome> batch;
+  for (const int input : bench::make_inputs(failure_percent)) {
+    if (input < 0) {
+      batch.emplace_back(res::err(job_errc::timed_out));
+    } else {
+      batch.emplace_back(res::ok("job " + std::to_string(input) + " finished, wrote " + std::to_string(input * 7) +
+                                 " records"));
+    }
+  }
+  return batch;
+}
+
+// The hand-rolled baseline: every outcome is encoded into its own std::string and appended to the batch.
+auto encode_to_string(const outcome &value) -> std::string {
+  std::string record(1, value.is_ok() ? 'v' : 'e');
+  if (value.is_ok()) {
+    const auto size = static_cast<std::uint32_t>(value.value().size());
+    record.append(reinterpret_cast<const char *>(&size), sizeof(size)); // NOLINT
+    record.append(value.value());
+  } else {
+    record.push_back(static_cast<char>(value.error()));
+  }
+  return record;
+}
+
+// Decoding the baseline materializes every outcome again, copying each value into a new std::string.
+template <typename Consume> void decode_from_string(const std::string &batch, Consume consume) {
+  std::size_t offset = 0;
+  while (offset < batch.size()) {
+    if (batch[offset] == 'v') {
+      std::uint32_t size = 0;
+      std::memcpy(&size, batch.data() + offset + 1, sizeof(size));
+      consume(outcome(res::ok(batch.substr(offset + 5, size))));
+      offset += 5 + size;
+    } else {
+      consume(outcome(res::err(static_cast<job_errc>(batch[offset + 1]))));
+      offset += 2;
+    }
+  }
+}
+
+void BM_SerializeStringBuffer(benchmark::State &state) {
+  const auto batch = make_batch(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    std::string buffer;
+    for (const auto &value : batch) { buffer += encode_to_string(value); }
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch.size()));
+}
+BENCHMARK(BM_SerializeStringBuffer)->Arg(0)->Arg(10);
+
+void BM_SerializeEncoder(benchmark::State &state) {
+  const auto batch = make_batch(static_cast<int>(state.range(0)));
+  res::result_encoder encoder;
+  for (auto _ : state) {
+    encoder.clear();
+    for (const auto &value : batch) { encoder.write(value); }
+    benchmark::DoNotOptimize(encoder.data());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch.size()));
+}
+BENCHMARK(BM_SerializeEncoder)->Arg(0)->Arg(10);
+
+void BM_DeserializeStringBuffer(benchmark::State &state) {
+  const auto batch = make_batch(static_cast<int>(state.range(0)));
+  std::string buffer;
+  for (const auto &value : batch) { buffer += encode_to_string(value); }
+  for (auto _ : state) {
+    std::size_t bytes = 0;
+    decode_from_string(buffer, [&](const outcome &value) { bytes += value.is_ok() ? value.value().size() : 0; });
+    benchmark::DoNotOptimize(bytes);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch.size()));
+}
+BENCHMARK(BM_DeserializeStringBuffer)->Arg(0)->Arg(10);
+
+void BM_DeserializeResultView(benchmark::State &state) {
+  const auto batch = make_batch(static_cast<int>(state.range(0)));
+  res::result_encoder encoder;
+  for (const auto &value : batch) { encoder.write(value); }
+  for (auto _ : state) {
+    std::size_t bytes = 0;
+    res::result_reader<std::string, job_errc> reader(encoder.buffer());
+    while (!reader.done()) {
+      const auto view = reader.next().value_unchecked();
+      bytes += view.is_ok() ? view.value().size() : 0;
+    }
+    benchmark::DoNotOptimize(bytes);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch.size()));
+}
+BENCHMARK(BM_DeserializeResultView)->Arg(0)->Arg(10);
+
+} // namespace
@@ -0,0 +1,18 @@
+// Object size of one parse-and-propagate workload per error-handling strategy, see the binary_sizes target.
+auto size_error_code_parse(const char *text, int &value) -> int {
+  value = 0;
+  for (; *text != '\0'; ++text) {
+    if (*text < '0' || *text > '9') { return static_cast<int>(*text); }
+    value = value * 10 + (*text - '0');
+  }
+  return 0;
+}
+
+auto size_error_code_sum(const char *lhs, const char *rhs, int &value) -> int {
+  int left = 0;
+  if (const int code = size_error_code_parse(lhs, left); code != 0) { return code; }
+  int right = 0;
+  if (const int code = size_error_code_parse(rhs, right); code != 0) { return code; }
+  value = left + right;
+  return 0;
+}
@@ -0,0 +1,15 @@
+// Object size of one parse-and-propagate workload per error-handling strategy, see the binary_sizes target.
+#include <stdexcept>
+
+auto size_exceptions_parse(const char *text) -> int {
+  int value = 0;
+  for (; *text != '\0'; ++text) {
+    if (*text < '0' || *text > '9') { throw std::invalid_argument("unexpected character"); }
+    value = value * 10 + (*text - '0');
+  }
+  return value;
+}
+
+auto size_exceptions_sum(const char *lhs, const char *rhs) -> int {
+  return size_exceptions_parse(lhs) + size_exceptions_parse(rhs);
+}
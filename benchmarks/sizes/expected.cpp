@@ -0,0 +1,25 @@
+// Object size of one parse-and-propagate workload per error-handling strategy, see the binary_sizes target.
+#if __has_include(<expected>)
+#include <expected>
+#endif
+
+#if defined(__cpp_lib_expected)
+
+auto size_expected_parse(const char *text) -> std::expected<int, int> {
+  int value = 0;
+  for (; *text != '\0'; ++text) {
+    if (*text < '0' || *text > '9') { return std::unexpected(static_cast<int>(*text)); }
+    value = value * 10 + (*text - '0');
+  }
+  return value;
+}
+
+auto size_expected_sum(const char *lhs, const char *rhs) -> std::expected<int, int> {
+  auto left = size_expected_parse(lhs);
+  if (!left) { return std::unexpected(left.error()); }
+  auto right = size_expected_parse(rhs);
+  if (!right) { return std::unexpected(right.error()); }
+  return *left + *right;
+}
+
+#endif
@@ -0,0 +1,19 @@
+// Object size of one parse-and-propagate workload per error-handling strategy, see the binary_sizes target.
+#include <optional>
+
+auto size_optional_parse(const char *text) -> std::optional<int> {
+  int value = 0;
+  for (; *text != '\0'; ++text) {
+    if (*text < '0' || *text > '9') { return std::nullopt; }
+    value = value * 10 + (*text - '0');
+  }
+  return value;
+}
+
+auto size_optional_sum(const char *lhs, const char *rhs) -> std::optional<int> {
+  auto left = size_optional_parse(lhs);
+  if (!left) { return std::nullopt; }
+  auto right = size_optional_parse(rhs);
+  if (!right) { return std::nullopt; }
+  return *left + *right;
+}
@@ -0,0 +1,17 @@
+// Object size of one parse-and-propagate workload per error-handling strategy, see the binary_sizes target.
+#include "../../result.h"
+
+auto size_result_int_parse(const char *text) -> res::result<int, int> {
+  int value = 0;
+  for (; *text != '\0'; ++text) {
+    if (*text < '0' || *text > '9') { return res::err(static_cast<int>(*text)); }
+    value = value * 10 + (*text - '0');
+  }
+  return res::ok(value);
+}
+
+auto size_result_int_sum(const char *lhs, const char *rhs) -> res::result<int, int> {
+  auto left = size_result_int_parse(lhs);
+  if (!left) { return res::err(left.error()); }
+  return size_result_int_parse(rhs).map([&](int right) { return left.value() + right; });
+}
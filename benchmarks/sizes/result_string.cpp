@@ -0,0 +1,18 @@
+// Object size of one parse-and-propagate workload per error-handling strategy, see the binary_sizes target.
+#include "../../result.h"
+#include <string>
+
+auto size_result_string_parse(const char *text) -> res::result<int, std::string> {
+  int value = 0;
+  for (; *text != '\0'; ++text) {
+    if (*text < '0' || *text > '9') { return res::err(std::string("unexpected character")); }
+    value = value * 10 + (*text - '0');
+  }
+  return res::ok(value);
+}
+
+auto size_result_string_sum(const char *lhs, const char *rhs) -> res::result<int, std::string> {
+  auto left = size_result_string_parse(lhs);
+  if (!left) { return res::err(std::move(left).error()); }
+  return size_result_string_parse(rhs).map([&](int right) { return left.value() + right; });
+}
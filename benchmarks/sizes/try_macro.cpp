@@ -0,0 +1,11 @@
+// Object size of one parse-and-propagate workload per error-handling strategy, see the binary_sizes target.
+#include "../../result.h"
+#include <string>
+
+auto size_try_macro_parse(const char *text) -> res::result<int, std::string>;
+
+auto size_try_macro_sum(const char *lhs, const char *rhs) -> res::result<int, std::string> {
+  RES_TRY_ASSIGN(const int left, size_try_macro_parse(lhs));
+  RES_TRY_ASSIGN(const int right, size_try_macro_parse(rhs));
+  return res::ok(left + right);
+}
@@ -0,0 +1,13 @@
+// Object size of one parse-and-propagate workload per error-handling strategy, see the binary_sizes target.
+#include "../../result.h"
+#include <string>
+
+auto size_try_manual_parse(const char *text) -> res::result<int, std::string>;
+
+auto size_try_manual_sum(const char *lhs, const char *rhs) -> res::result<int, std::string> {
+  auto left = size_try_manual_parse(lhs);
+  if (!left) { return res::err(std::move(left).error()); }
+  auto right = size_try_manual_parse(rhs);
+  if (!right) { return res::err(std::move(right).error()); }
+  return res::ok(left.value() + right.value());
+}
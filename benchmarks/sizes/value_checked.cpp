@@ -0,0 +1,9 @@
+// Object size of summing result values through the checked value(), see the binary_sizes target.
+#include "../../result.h"
+#include <cstddef>
+
+auto size_value_checked_sum(const res::result<int, int> *results, std::size_t count) -> int {
+  int sum = 0;
+  for (std::size_t index = 0; index < count; ++index) { sum += results[index].value(); }
+  return sum;
+}
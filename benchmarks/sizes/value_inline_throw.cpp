@@ -0,0 +1,14 @@
+// Object size of summing result values with the check and throw written inline at every call site, as value() used to
+// be, see the binary_sizes target.
+#include "../../result.h"
+#include <cstddef>
+#include <stdexcept>
+
+auto size_value_inline_throw_sum(const res::result<int, int> *results, std::size_t count) -> int {
+  int sum = 0;
+  for (std::size_t index = 0; index < count; ++index) {
+    if (!results[index].is_ok()) { throw std::logic_error("value() called on result with error"); }
+    sum += results[index].value_unchecked();
+  }
+  return sum;
+}
@@ -0,0 +1,9 @@
+// Object size of summing result values through value_unchecked(), see the binary_sizes target.
+#include "../../result.h"
+#include <cstddef>
+
+auto size_value_unchecked_sum(const res::result<int, int> *results, std::size_t count) -> int {
+  int sum = 0;
+  for (std::size_t index = 0; index < count; ++index) { sum += results[index].value_unchecked(); }
+  return sum;
+}
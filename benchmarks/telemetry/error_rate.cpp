@@ -0,0 +1,28 @@
+// Built twice, as benchmarks_telemetry_off and benchmarks_telemetry_on, to compare the cost of recording every error.
+#include "../../result.h"
+#include "../common.hpp"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+BENCH_NOINLINE auto checked(int input) -> res::result<int, int> {
+  if (input < 0) { return res::err(-input); }
+  return res::ok(input);
+}
+
+void BM_TelemetryErrorRate(benchmark::State &state) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    int sum = 0;
+    for (const int input : inputs) {
+      const auto result = checked(input);
+      sum += result.is_ok() ? result.value() : -result.error();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+  state.SetLabel(RESULT_ENABLE_TELEMETRY ? "telemetry on" : "telemetry off");
+}
+BENCHMARK(BM_TelemetryErrorRate)->Arg(0)->Arg(10)->Arg(50)->Arg(100);
+
+} // namespace
@@ -0,0 +1,50 @@
+#include "../result.h"
+#include "common.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+
+// RES_TRY against the hand-written early return it replaces. The hand-written version returns through err<E>, whose
+// conversion operator copies the error, while RES_TRY moves it straight into the caller's result.
+namespace {
+
+template <int Depth> BENCH_NOINLINE auto manual_level(int input) -> res::result<int, std::string> {
+  if constexpr (Depth == 0) {
+    if (input < 0) { return res::err(std::string("negative input is not allowed here")); }
+    return res::ok(input);
+  } else {
+    auto inner = manual_level<Depth - 1>(input);
+    if (!inner) { return res::err(std::move(inner).error()); }
+    return res::ok(std::move(inner).value() + 1);
+  }
+}
+
+template <int Depth> BENCH_NOINLINE auto try_level(int input) -> res::result<int, std::string> {
+  if constexpr (Depth == 0) {
+    if (input < 0) { return res::err(std::string("negative input is not allowed here")); }
+    return res::ok(input);
+  } else {
+    RES_TRY_ASSIGN(const int inner, try_level<Depth - 1>(input));
+    return res::ok(inner + 1);
+  }
+}
+
+template <int Depth> void BM_ManualEarlyReturn(benchmark::State &state) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    for (const int input : inputs) { benchmark::DoNotOptimize(manual_level<Depth>(input)); }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+
+template <int Depth> void BM_Try(benchmark::State &state) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    for (const int input : inputs) { benchmark::DoNotOptimize(try_level<Depth>(input)); }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+
+BENCHMARK_TEMPLATE(BM_ManualEarlyReturn, 8)->Arg(0)->Arg(10)->Arg(100);
+BENCHMARK_TEMPLATE(BM_Try, 8)->Arg(0)->Arg(10)->Arg(100);
+
+} // namespace
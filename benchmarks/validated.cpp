@@ -0,0 +1,84 @@
+#include "../result.h"
+#include "common.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+enum class field_error { missing_name, bad_age, unknown_country };
+
+struct request {
+  std::string name;
+  int age = 0;
+  std::string country;
+};
+
+// Requests with exactly `errors` problems each, the common case being none to a few.
+auto make_requests(int errors) -> std::vector<request> {
+  std::vector<request> requests(bench::input_size, request{"someone", 30, "NL"});
+  for (auto &input : requests) {
+    if (errors > 0) { input.name.clear(); }
+    if (errors > 1) { input.age = -1; }
+    if (errors > 2) { input.country = "XX"; }
+  }
+  return requests;
+}
+
+auto has_name(const request &input) -> res::result<void, field_error> {
+  if (input.name.empty()) { return res::err(field_error::missing_name); }
+  return res::ok();
+}
+auto has_valid_age(const request &input) -> res::result<void, field_error> {
+  if (input.age < 0 || input.age > 150) { return res::err(field_error::bad_age); }
+  return res::ok();
+}
+auto has_known_country(const request &input) -> res::result<void, field_error> {
+  if (input.country != "NL" && input.country != "DE") { return res::err(field_error::unknown_country); }
+  return res::ok();
+}
+
+// The hand-rolled alternative: every request gets a std::vector of errors, which allocates once there is one.
+BENCH_NOINLINE auto validate_vector(const request &input) -> std::vector<field_error> {
+  std::vector<field_error> errors;
+  for (const auto check : {has_name, has_valid_age, has_known_country}) {
+    auto outcome = check(input);
+    if (!outcome) { errors.push_back(outcome.error()); }
+  }
+  return errors;
+}
+
+// Validates a pointer so the request is not copied into the result, like validate_vector.
+BENCH_NOINLINE auto validate_inline(const request &input) -> res::validated<const request *, field_error> {
+  return res::validate_all(
+      &input, [](const request *subject) { return has_name(*subject); },
+      [](const request *subject) { return has_valid_age(*subject); },
+      [](const request *subject) { return has_known_country(*subject); });
+}
+
+void BM_ValidateVector(benchmark::State &state) {
+  const auto requests = make_requests(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    std::size_t errors = 0;
+    for (const auto &input : requests) { errors += validate_vector(input).size(); }
+    benchmark::DoNotOptimize(errors);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(requests.size()));
+}
+BENCHMARK(BM_ValidateVector)->DenseRange(0, 3);
+
+void BM_ValidateInline(benchmark::State &state) {
+  const auto requests = make_requests(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    std::size_t errors = 0;
+    for (const auto &input : requests) {
+      const auto checked = validate_inline(input);
+      errors += checked ? 0 : checked.errors().size();
+    }
+    benchmark::DoNotOptimize(errors);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(requests.size()));
+}
+BENCHMARK(BM_ValidateInline)->DenseRange(0, 3);
+
+} // namespace
@@ -0,0 +1,54 @@
+#include "../result.h"
+#include "common.hpp"
+#include <benchmark/benchmark.h>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+auto make_results() -> std::vector<res::result<int, int>> {
+  std::vector<res::result<int, int>> results;
+  for (const int input : bench::make_inputs(0)) { results.push_back(res::ok(input)); }
+  return results;
+}
+
+// value() as it used to be: the check, the string and the throw written inline at the call site.
+auto inline_throw_value(const res::result<int, int> &result) -> int {
+  if (!result.is_ok()) { throw std::logic_error("value() called on result with error"); }
+  return result.value_unchecked();
+}
+
+void BM_ValueInlineThrow(benchmark::State &state) {
+  const auto results = make_results();
+  for (auto _ : state) {
+    int sum = 0;
+    for (const auto &result : results) { sum += inline_throw_value(result); }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(results.size()));
+}
+BENCHMARK(BM_ValueInlineThrow);
+
+void BM_ValueChecked(benchmark::State &state) {
+  const auto results = make_results();
+  for (auto _ : state) {
+    int sum = 0;
+    for (const auto &result : results) { sum += result.value(); }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(results.size()));
+}
+BENCHMARK(BM_ValueChecked);
+
+void BM_ValueUnchecked(benchmark::State &state) {
+  const auto results = make_results();
+  for (auto _ : state) {
+    int sum = 0;
+    for (const auto &result : results) { sum += result.value_unchecked(); }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(results.size()));
+}
+BENCHMARK(BM_ValueUnchecked);
+
+} // namespace
@@ -0,0 +1,53 @@
+#include "../result.h"
+#include "common.hpp"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+namespace {
+
+BENCH_NOINLINE auto parse_part(int input, int shift) -> res::result<int, int> {
+  if (input < 0) { return res::err(input); }
+  return res::ok(input >> shift);
+}
+
+// Each result is checked on its own and its error propagated, one branch per result.
+BENCH_NOINLINE auto combine_by_hand(int input) -> res::result<int, int> {
+  const auto first = parse_part(input, 0);
+  if (!first) { return res::err(first.error()); }
+  const auto second = parse_part(input, 1);
+  if (!second) { return res::err(second.error()); }
+  const auto third = parse_part(input, 2);
+  if (!third) { return res::err(third.error()); }
+  const auto fourth = parse_part(input, 3);
+  if (!fourth) { return res::err(fourth.error()); }
+  return res::ok(first.value() + second.value() + third.value() + fourth.value());
+}
+
+// All results are evaluated, then tested with a single branch. With failures, the hand-written version wins by
+// skipping the calls after the first error.
+BENCH_NOINLINE auto combine_with_apply(int input) -> res::result<int, int> {
+  return res::apply([](int first, int second, int third, int fourth) { return first + second + third + fourth; },
+                    parse_part(input, 0), parse_part(input, 1), parse_part(input, 2), parse_part(input, 3));
+}
+
+BENCH_NOINLINE auto combine_with_zip(int input) -> res::result<int, int> {
+  return res::zip(parse_part(input, 0), parse_part(input, 1), parse_part(input, 2), parse_part(input, 3))
+      .map([](const auto &parts) {
+        return std::get<0>(parts) + std::get<1>(parts) + std::get<2>(parts) + std::get<3>(parts);
+      });
+}
+
+template <auto Combine> void BM_Combine(benchmark::State &state) {
+  const auto inputs = bench::make_inputs(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    int sum = 0;
+    for (const int input : inputs) { sum += Combine(input).value_or(0); }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(inputs.size()));
+}
+BENCHMARK_TEMPLATE(BM_Combine, combine_by_hand)->Arg(0)->Arg(10)->Arg(50);
+BENCHMARK_TEMPLATE(BM_Combine, combine_with_apply)->Arg(0)->Arg(10)->Arg(50);
+BENCHMARK_TEMPLATE(BM_Combine, combine_with_zip)->Arg(0)->Arg(10)->Arg(50);
+
+} // namespace
@@ -0,0 +1,4301 @@
+/// @file
+/// @brief C++20 coroutine support for result: coroutines returning result<T, E> that propagate errors with co_await,
+/// and the lazy task<T, E>.
+///
+/// This header is opt-in and requires C++20. It contains the whole library, so it can be used instead of result.h.
+/// @author GregoryKogan
+/// @par License
+/// This software is released under the GNU GENERAL PUBLIC LICENSE Version 3.
+/// @par Contact
+/// My github page: https://github.com/GregoryKogan
+
+#ifndef RESULT_CORO_LIB
+#define RESULT_CORO_LIB
+
+/// @file
+/// @brief result is a C++ library that provides a Result<T, E> type, which can be used to return and propagate
+/// errors. It's inspired by Rust's std::Result type.
+///
+/// This file contains the declaration of the Result class template.
+/// @author GregoryKogan
+/// @version 0.0.1
+/// @date 2023, December 21
+/// @par License
+/// This software is released under the GNU GENERAL PUBLIC LICENSE Version 3.
+/// @par Contact
+/// My github page: https://github.com/GregoryKogan
+
+#ifndef RESULT_LIB
+#define RESULT_LIB
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+/// @brief Whether the library may throw, detected from the compiler flags. With -fno-exceptions the default checking
+/// policy becomes RESULT_CHECKING_ABORT, and the few operations that would throw on misuse, such as an out of range
+/// result_vector::at, report it through the misuse handler instead (see res::set_misuse_handler).
+#ifndef RESULT_HAS_EXCEPTIONS
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define RESULT_HAS_EXCEPTIONS 1
+#else
+#define RESULT_HAS_EXCEPTIONS 0
+#endif
+#endif
+
+/// @brief Checking policies for value() and error() called on the wrong alternative of a result.
+/// @details Select one by defining RESULT_CHECKING before including result.h, the same in every translation unit:
+/// - RESULT_CHECKING_THROW, the default, throws std::logic_error.
+/// - RESULT_CHECKING_ABORT reports the misuse to the misuse handler and aborts. It is the default without exceptions.
+/// - RESULT_CHECKING_ASSERT aborts like RESULT_CHECKING_ABORT unless NDEBUG is defined, and does not check then.
+/// - RESULT_CHECKING_UNCHECKED never checks; calling the wrong accessor is undefined behavior.
+///
+/// value_unchecked() and error_unchecked() skip the check regardless of the policy.
+#define RESULT_CHECKING_THROW 0
+#define RESULT_CHECKING_ABORT 1
+#define RESULT_CHECKING_ASSERT 2
+#define RESULT_CHECKING_UNCHECKED 3
+
+#ifndef RESULT_CHECKING
+#if RESULT_HAS_EXCEPTIONS
+#define RESULT_CHECKING RESULT_CHECKING_THROW
+#else
+#define RESULT_CHECKING RESULT_CHECKING_ABORT
+#endif
+#endif
+
+#if RESULT_CHECKING == RESULT_CHECKING_THROW && !RESULT_HAS_EXCEPTIONS
+#error "RESULT_CHECKING_THROW needs exceptions, pick another RESULT_CHECKING policy"
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define RESULT_LIKELY(...) __builtin_expect(static_cast<bool>(__VA_ARGS__), 1)
+#define RESULT_UNLIKELY(...) __builtin_expect(static_cast<bool>(__VA_ARGS__), 0)
+#define RESULT_NOINLINE [[gnu::noinline]]
+#define RESULT_COLD [[gnu::cold, gnu::noinline]]
+#elif defined(_MSC_VER)
+#define RESULT_LIKELY(...) static_cast<bool>(__VA_ARGS__)
+#define RESULT_UNLIKELY(...) static_cast<bool>(__VA_ARGS__)
+#define RESULT_NOINLINE __declspec(noinline)
+#define RESULT_COLD __declspec(noinline)
+#else
+#define RESULT_LIKELY(...) static_cast<bool>(__VA_ARGS__)
+#define RESULT_UNLIKELY(...) static_cast<bool>(__VA_ARGS__)
+#define RESULT_NOINLINE
+#define RESULT_COLD
+#endif
+
+namespace res {
+
+/// @brief Receives the description of a misuse, e.g. value() called on an error, before the library aborts.
+/// @details A handler may end the program its own way, such as logging and flushing first; if it returns, the library
+/// calls std::abort. It is never called for misuse that throws.
+using misuse_handler = void (*)(const char *message);
+
+namespace detail {
+
+inline auto misuse_handler_slot() noexcept -> std::atomic<misuse_handler> & {
+  static std::atomic<misuse_handler> handler{nullptr};
+  return handler;
+}
+
+} // namespace detail
+
+/// @brief Installs handler for misuse that aborts and returns the previous one. nullptr restores the default handler,
+/// which prints the message to stderr.
+inline auto set_misuse_handler(misuse_handler handler) noexcept -> misuse_handler {
+  return detail::misuse_handler_slot().exchange(handler, std::memory_order_acq_rel);
+}
+
+namespace detail {
+
+inline constexpr bool checked_access =
+    RESULT_CHECKING == RESULT_CHECKING_THROW || RESULT_CHECKING == RESULT_CHECKING_ABORT ||
+#if defined(NDEBUG)
+    false;
+#else
+    RESULT_CHECKING == RESULT_CHECKING_ASSERT;
+#endif
+
+// Accessors are noexcept unless a wrong access throws.
+inline constexpr bool throwing_access = RESULT_CHECKING == RESULT_CHECKING_THROW;
+
+[[noreturn]] RESULT_COLD inline void report_misuse(const char *message) noexcept {
+  if (const misuse_handler handler = misuse_handler_slot().load(std::memory_order_acquire)) {
+    handler(message);
+  } else {
+    std::fputs(message, stderr);
+    std::fputc('\n', stderr);
+  }
+  std::abort();
+}
+
+/// @brief Throws Exception, or reports the misuse and aborts when exceptions are disabled.
+template <typename Exception> [[noreturn]] RESULT_COLD void throw_or_abort(const char *message) {
+#if RESULT_HAS_EXCEPTIONS
+  throw Exception(message);
+#else
+  report_misuse(message);
+#endif
+}
+
+/// @brief Reports value() or error() called on the wrong alternative according to RESULT_CHECKING.
+/// @details Kept out of line and cold so that checked accessors inline to a compare and a branch to this call.
+[[noreturn]] RESULT_COLD inline void bad_result_access(const char *message) {
+#if RESULT_CHECKING == RESULT_CHECKING_THROW
+  throw std::logic_error(message);
+#else
+  report_misuse(message);
+#endif
+}
+
+} // namespace detail
+
+} // namespace res
+
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+/// @brief Error telemetry, off unless RESULT_ENABLE_TELEMETRY is defined to 1 in every translation unit.
+/// @details When enabled, every res::err records the call site that created it: a per-thread counter per call site and
+/// an entry in a per-thread ring of recent errors. telemetry::take_snapshot() aggregates both across threads. When
+/// disabled, none of it is declared and res::err is unchanged.
+#ifndef RESULT_ENABLE_TELEMETRY
+#define RESULT_ENABLE_TELEMETRY 0
+#endif
+
+#if RESULT_ENABLE_TELEMETRY
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+/// @brief Number of distinct call sites each thread counts; errors from further call sites are only counted in total.
+#ifndef RESULT_TELEMETRY_SITES
+#define RESULT_TELEMETRY_SITES 256
+#endif
+/// @brief Number of recent errors each thread keeps.
+#ifndef RESULT_TELEMETRY_RECENT
+#define RESULT_TELEMETRY_RECENT 64
+#endif
+/// @brief Whether recent errors are timestamped. Reading the clock is most of the cost of recording an error; without
+/// it recent errors are only ordered within each thread.
+#ifndef RESULT_TELEMETRY_TIMESTAMPS
+#define RESULT_TELEMETRY_TIMESTAMPS 1
+#endif
+
+// Recording is skipped while err is constant evaluated, so res::err stays usable in constant expressions.
+#if defined(__cpp_lib_is_constant_evaluated)
+#define RESULT_IS_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#elif (defined(__GNUC__) && __GNUC__ >= 9) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#define RESULT_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+#define RESULT_IS_CONSTANT_EVALUATED() false
+#endif
+
+namespace res::telemetry {
+
+/// @brief Where an error was created.
+struct call_site {
+  const char *file = "";
+  const char *function = "";
+  unsigned line = 0;
+
+  /// @brief The call site of the expression this is a default argument of.
+  static constexpr auto current(const char *file = __builtin_FILE(), const char *function = __builtin_FUNCTION(),
+                                unsigned line = __builtin_LINE()) noexcept -> call_site {
+    return {file, function, line};
+  }
+};
+
+struct site_count {
+  call_site site;
+  std::uint64_t count = 0;
+};
+
+struct recorded_error {
+  call_site site;
+  /// Index of the recorder of the thread that created the error. Recorders of finished threads are reused.
+  std::size_t thread = 0;
+  /// Position of the error among all errors recorded by the same recorder.
+  std::uint64_t sequence = 0;
+  /// The epoch of the clock when RESULT_TELEMETRY_TIMESTAMPS is 0.
+  std::chrono::steady_clock::time_point time;
+};
+
+struct snapshot {
+  /// Errors per call site summed over all threads, most frequent first.
+  std::vector<site_count> sites;
+  /// The most recent errors of every thread, oldest first.
+  std::vector<recorded_error> recent;
+  /// Errors from call sites that did not fit into the counters of their thread.
+  std::uint64_t untracked = 0;
+};
+
+namespace detail {
+
+/// @brief Telemetry of one thread.
+/// @details Only the owning thread writes, so counters are bumped with a plain load and store rather than a
+/// read-modify-write, and snapshots read them concurrently. Ring entries are guarded by a sequence number that is odd
+/// while the entry is being written, so readers skip entries that change under them.
+class thread_recorder {
+  struct site_slot {
+    std::atomic<const char *> file{nullptr};
+    std::atomic<const char *> function{nullptr};
+    std::atomic<unsigned> line{0};
+    std::atomic<std::uint64_t> count{0};
+  };
+  struct recent_slot {
+    std::atomic<std::uint64_t> sequence{0};
+    std::atomic<const char *> file{nullptr};
+    std::atomic<const char *> function{nullptr};
+    std::atomic<unsigned> line{0};
+    std::atomic<std::chrono::steady_clock::rep> ticks{0};
+  };
+
+  static_assert((RESULT_TELEMETRY_SITES & (RESULT_TELEMETRY_SITES - 1)) == 0, "site count must be a power of two");
+
+  std::array<site_slot, RESULT_TELEMETRY_SITES> sites_;
+  std::array<recent_slot, RESULT_TELEMETRY_RECENT> recent_;
+  std::atomic<std::uint64_t> untracked_{0};
+  std::uint64_t recorded_ = 0;
+  std::size_t index_;
+
+  template <typename V> static void bump(std::atomic<V> &counter) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+public:
+  explicit thread_recorder(std::size_t index) noexcept : index_(index) {}
+
+  void record(const call_site &site) noexcept {
+    count(site);
+    auto &slot = recent_[recorded_ % recent_.size()];
+    const std::uint64_t sequence = 2 * recorded_++;
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.file.store(site.file, std::memory_order_relaxed);
+    slot.function.store(site.function, std::memory_order_relaxed);
+    slot.line.store(site.line, std::memory_order_relaxed);
+#if RESULT_TELEMETRY_TIMESTAMPS
+    slot.ticks.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+#endif
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+  }
+
+  void collect(snapshot &into) const {
+    for (const auto &slot : sites_) {
+      const std::uint64_t hits = slot.count.load(std::memory_order_acquire);
+      if (hits == 0) { continue; }
+      const call_site site{slot.file.load(std::memory_order_relaxed), slot.function.load(std::memory_order_relaxed),
+                           slot.line.load(std::memory_order_relaxed)};
+      into.sites.push_back({site, hits});
+    }
+    for (const auto &slot : recent_) {
+      const std::uint64_t before = slot.sequence.load(std::memory_order_acquire);
+      if (before == 0 || before % 2 == 1) { continue; }
+      const call_site site{slot.file.load(std::memory_order_relaxed), slot.function.load(std::memory_order_relaxed),
+                           slot.line.load(std::memory_order_relaxed)};
+      const auto ticks = slot.ticks.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.sequence.load(std::memory_order_relaxed) != before) { continue; }
+      using clock = std::chrono::steady_clock;
+      into.recent.push_back({site, index_, before / 2 - 1, clock::time_point(clock::duration(ticks))});
+    }
+    into.untracked += untracked_.load(std::memory_order_relaxed);
+  }
+
+private:
+  // Open addressing on the file pointer and line. The same site reached through different copies of a file name
+  // literal takes several slots, which take_snapshot merges again.
+  void count(const call_site &site) noexcept {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto address = reinterpret_cast<std::uintptr_t>(site.file);
+    const std::uintptr_t hash = address ^ (std::uintptr_t{site.line} * 0x9E3779B1U);
+    for (std::size_t probe = 0; probe < sites_.size(); ++probe) {
+      auto &slot = sites_[(hash + probe) & (sites_.size() - 1)];
+      const char *file = slot.file.load(std::memory_order_relaxed);
+      if (file == site.file && slot.line.load(std::memory_order_relaxed) == site.line) {
+        bump(slot.count);
+        return;
+      }
+      if (file == nullptr) {
+        slot.file.store(site.file, std::memory_order_relaxed);
+        slot.function.store(site.function, std::memory_order_relaxed);
+        slot.line.store(site.line, std::memory_order_relaxed);
+        slot.count.store(1, std::memory_order_release);
+        return;
+      }
+    }
+    bump(untracked_);
+  }
+};
+
+/// @brief Owns the recorders of all threads. Recorders outlive their threads so their counts stay in snapshots, and
+/// are handed to threads started later.
+class recorder_registry {
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<thread_recorder>> recorders_;
+  std::vector<thread_recorder *> idle_;
+
+public:
+  // Never destroyed, so threads that outlive static destruction can still hand their recorder back.
+  static auto instance() -> recorder_registry & {
+    static auto *registry = new recorder_registry();
+    return *registry;
+  }
+
+  auto acquire() -> thread_recorder * {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if (!idle_.empty()) {
+      auto *recorder = idle_.back();
+      idle_.pop_back();
+      return recorder;
+    }
+    recorders_.push_back(std::make_unique<thread_recorder>(recorders_.size()));
+    return recorders_.back().get();
+  }
+
+  void release(thread_recorder *recorder) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    idle_.push_back(recorder);
+  }
+
+  auto take_snapshot() -> snapshot {
+    snapshot result;
+    {
+      const std::lock_guard<std::mutex> lock(mutex_);
+      for (const auto &recorder : recorders_) { recorder->collect(result); }
+    }
+    auto &sites = result.sites;
+    const auto same_site = [](const call_site &lhs, const call_site &rhs) {
+      return lhs.line == rhs.line && std::strcmp(lhs.file, rhs.file) == 0;
+    };
+    std::sort(sites.begin(), sites.end(), [](const site_count &lhs, const site_count &rhs) {
+      const int file = std::strcmp(lhs.site.file, rhs.site.file);
+      return file != 0 ? file < 0 : lhs.site.line < rhs.site.line;
+    });
+    std::size_t merged = 0;
+    for (std::size_t index = 0; index < sites.size(); ++index) {
+      if (merged > 0 && same_site(sites[merged - 1].site, sites[index].site)) {
+        sites[merged - 1].count += sites[index].count;
+      } else {
+        sites[merged++] = sites[index];
+      }
+    }
+    sites.resize(merged);
+    std::stable_sort(sites.begin(), sites.end(),
+                     [](const site_count &lhs, const site_count &rhs) { return lhs.count > rhs.count; });
+    std::sort(result.recent.begin(), result.recent.end(), [](const recorded_error &lhs, const recorded_error &rhs) {
+      if (lhs.time != rhs.time) { return lhs.time < rhs.time; }
+      return lhs.thread != rhs.thread ? lhs.thread < rhs.thread : lhs.sequence < rhs.sequence;
+    });
+    return result;
+  }
+};
+
+struct recorder_handle {
+  thread_recorder *recorder = recorder_registry::instance().acquire();
+
+  recorder_handle() = default;
+  recorder_handle(const recorder_handle &) = delete;
+  auto operator=(const recorder_handle &) -> recorder_handle & = delete;
+  recorder_handle(recorder_handle &&) = delete;
+  auto operator=(recorder_handle &&) -> recorder_handle & = delete;
+  ~recorder_handle() { recorder_registry::instance().release(recorder); }
+};
+
+/// @brief Called by res::err. Kept out of line so err construction only grows by a call.
+RESULT_NOINLINE inline void record_error(const call_site &site) {
+  thread_local recorder_handle handle;
+  handle.recorder->record(site);
+}
+
+} // namespace detail
+
+/// @brief Aggregates the telemetry of every thread that has created an error so far.
+/// @details Safe to call while other threads keep recording; errors recorded meanwhile may or may not be included.
+inline auto take_snapshot() -> snapshot { return detail::recorder_registry::instance().take_snapshot(); }
+
+} // namespace res::telemetry
+
+#endif // RESULT_ENABLE_TELEMETRY
+
+
+namespace res {
+
+template <typename T, typename E> class result;
+template <typename E> class result<void, E>;
+
+/// @brief Err object represents an unsuccessful outcome and can be implicitly converted to a result.
+/// @details Err object holds an error of type E. Err object can't be empty, E must not be std::monostate. A temporary
+/// Err object moves its error into the result.
+/// @tparam E Type of the error.
+template <typename E> class err {
+  E error_;
+
+public:
+  err() = delete;
+#if RESULT_ENABLE_TELEMETRY
+  // The defaulted call site is evaluated where res::err is called.
+  constexpr explicit err(E error, const telemetry::call_site &site = telemetry::call_site::current())
+      : error_(std::move(error)) {
+    if (!RESULT_IS_CONSTANT_EVALUATED()) { telemetry::detail::record_error(site); }
+  }
+#else
+  constexpr explicit err(E error) noexcept(std::is_nothrow_move_constructible_v<E>) : error_(std::move(error)) {}
+#endif
+
+  // NOLINTBEGIN(google-explicit-constructor)
+  template <typename T> constexpr operator result<T, E>() const & noexcept(std::is_nothrow_copy_constructible_v<E>);
+  template <typename T> constexpr operator result<T, E>() && noexcept(std::is_nothrow_move_constructible_v<E>);
+  constexpr operator result<void, E>() const & noexcept(std::is_nothrow_copy_constructible_v<E>);
+  constexpr operator result<void, E>() && noexcept(std::is_nothrow_move_constructible_v<E>);
+  // NOLINTEND(google-explicit-constructor)
+};
+
+template <typename E>
+template <typename T>
+constexpr err<E>::operator result<T, E>() const & noexcept(std::is_nothrow_copy_constructible_v<E>) {
+  return result<T, E>(result<T, E>::Unsuccessful::UNSUCCESSFUL, error_);
+}
+
+template <typename E>
+template <typename T>
+constexpr err<E>::operator result<T, E>() && noexcept(std::is_nothrow_move_constructible_v<E>) {
+  return result<T, E>(result<T, E>::Unsuccessful::UNSUCCESSFUL, std::move(error_));
+}
+
+template <typename E>
+constexpr err<E>::operator result<void, E>() const & noexcept(std::is_nothrow_copy_constructible_v<E>) {
+  return result<void, E>(result<void, E>::Unsuccessful::UNSUCCESSFUL, error_);
+}
+
+template <typename E>
+constexpr err<E>::operator result<void, E>() && noexcept(std::is_nothrow_move_constructible_v<E>) {
+  return result<void, E>(result<void, E>::Unsuccessful::UNSUCCESSFUL, std::move(error_));
+}
+
+/// @brief Constructs the error of an unsuccessful result in place from the arguments it references.
+/// @details Returned by err_in_place. It only holds references, so it must be converted within the full expression
+/// that created it.
+template <typename E, typename... Args> class err_in_place_t {
+  std::tuple<Args &&...> args_;
+
+  template <typename R, std::size_t... I> constexpr auto build(std::index_sequence<I...> /*indices*/) -> R {
+    return R(R::Unsuccessful::UNSUCCESSFUL, std::forward<Args>(std::get<I>(args_))...);
+  }
+
+public:
+#if RESULT_ENABLE_TELEMETRY
+  // A call site cannot follow the arguments of err_in_place, so these errors are counted under err_in_place itself.
+  constexpr explicit err_in_place_t(Args &&...args, const telemetry::call_site &site)
+      : args_(std::forward<Args>(args)...) {
+    if (!RESULT_IS_CONSTANT_EVALUATED()) { telemetry::detail::record_error(site); }
+  }
+#else
+  constexpr explicit err_in_place_t(Args &&...args) noexcept : args_(std::forward<Args>(args)...) {}
+#endif
+
+  // The result is returned as a prvalue, so E is constructed directly in its final place and need not be movable.
+  template <typename T> constexpr operator result<T, E>() && { // NOLINT(google-explicit-constructor)
+    return build<result<T, E>>(std::index_sequence_for<Args...>{});
+  }
+  constexpr operator result<void, E>() && { // NOLINT(google-explicit-constructor)
+    return build<result<void, E>>(std::index_sequence_for<Args...>{});
+  }
+};
+
+/// @brief An unsuccessful result whose error is constructed in place from args, without a temporary E.
+template <typename E, typename... Args>
+constexpr auto err_in_place(Args &&...args) noexcept(!RESULT_ENABLE_TELEMETRY) -> err_in_place_t<E, Args...> {
+#if RESULT_ENABLE_TELEMETRY
+  return err_in_place_t<E, Args...>(std::forward<Args>(args)..., telemetry::call_site::current());
+#else
+  return err_in_place_t<E, Args...>(std::forward<Args>(args)...);
+#endif
+}
+
+} // namespace res
+
+
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace res {
+
+template <typename T, typename E> class result;
+template <typename E> class result<void, E>;
+
+/// @brief Ok object represents a successful outcome and can be implicitly converted to a result.
+/// @details Ok object holds a value of type T. Empty Ok object can be created if T is std::monostate. A temporary Ok
+/// object moves its value into the result, so move-only values can be returned with `return res::ok(std::move(x));`.
+/// @tparam T Type of the value. Defaults to std::monostate. An lvalue reference makes a result<T &, E>, which
+/// `res::ok(std::ref(x))` deduces.
+template <typename T = std::monostate> class ok {
+  T value_;
+
+public:
+  ok() = default;
+  constexpr explicit ok(T value) noexcept(std::is_nothrow_move_constructible_v<T>) : value_(std::forward<T>(value)) {}
+
+  // NOLINTBEGIN(google-explicit-constructor)
+  template <typename E> constexpr operator result<T, E>() const & noexcept(std::is_nothrow_copy_constructible_v<T>);
+  template <typename E> constexpr operator result<T, E>() && noexcept(std::is_nothrow_move_constructible_v<T>);
+  template <typename E> constexpr operator result<void, E>() const noexcept;
+  // NOLINTEND(google-explicit-constructor)
+};
+
+template <typename T> ok(std::reference_wrapper<T>) -> ok<T &>;
+
+template <typename T>
+template <typename E>
+constexpr ok<T>::operator result<T, E>() const & noexcept(std::is_nothrow_copy_constructible_v<T>) {
+  return result<T, E>(result<T, E>::Successful::SUCCESSFUL, value_);
+}
+
+template <typename T>
+template <typename E>
+constexpr ok<T>::operator result<T, E>() && noexcept(std::is_nothrow_move_constructible_v<T>) {
+  return result<T, E>(result<T, E>::Successful::SUCCESSFUL, std::forward<T>(value_));
+}
+
+template <typename T> template <typename E> constexpr ok<T>::operator result<void, E>() const noexcept {
+  return result<void, E>(result<void, E>::Successful::SUCCESSFUL);
+}
+
+/// @brief Constructs the value of a successful result in place from the arguments it references.
+/// @details Returned by ok_in_place. It only holds references, so it must be converted within the full expression
+/// that created it, which `return res::ok_in_place<T>(...);` does.
+template <typename T, typename... Args> class ok_in_place_t {
+  std::tuple<Args &&...> args_;
+
+  template <typename E, std::size_t... I> constexpr auto build(std::index_sequence<I...> /*indices*/) -> result<T, E> {
+    return result<T, E>(result<T, E>::Successful::SUCCESSFUL, std::forward<Args>(std::get<I>(args_))...);
+  }
+
+public:
+  constexpr explicit ok_in_place_t(Args &&...args) noexcept : args_(std::forward<Args>(args)...) {}
+
+  // The result is returned as a prvalue, so T is constructed directly in its final place and need not be movable.
+  template <typename E> constexpr operator result<T, E>() && { // NOLINT(google-explicit-constructor)
+    return build<E>(std::index_sequence_for<Args...>{});
+  }
+};
+
+/// @brief A successful result whose value is constructed in place from args, without a temporary T.
+/// @details `return res::ok_in_place<std::vector<int>>(size, 0);`. Works for types that can be neither copied nor
+/// moved.
+template <typename T, typename... Args>
+constexpr auto ok_in_place(Args &&...args) noexcept -> ok_in_place_t<T, Args...> {
+  return ok_in_place_t<T, Args...>(std::forward<Args>(args)...);
+}
+
+} // namespace res
+
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace res::detail {
+
+// Tags selecting which member of the storage union is constructed.
+struct in_place_ok_t {
+  explicit in_place_ok_t() = default;
+};
+struct in_place_err_t {
+  explicit in_place_err_t() = default;
+};
+struct uninitialized_t {
+  explicit uninitialized_t() = default;
+};
+inline constexpr in_place_ok_t in_place_ok{};
+inline constexpr in_place_err_t in_place_err{};
+inline constexpr uninitialized_t uninitialized{};
+
+/// @brief Discriminated union of T and E.
+/// @details Unlike std::variant this storage keeps every special member trivial whenever T and E have trivial ones, so
+/// small results such as result<int, int> are trivially copyable and returned in registers.
+template <typename T, typename E, bool = std::is_trivially_destructible_v<T> && std::is_trivially_destructible_v<E>>
+struct storage_base {
+  union {
+    char dummy_;
+    T value_;
+    E error_;
+  };
+  bool has_value_;
+
+  constexpr explicit storage_base(uninitialized_t /*tag*/) noexcept : dummy_(), has_value_(false) {}
+  template <typename... Args>
+  constexpr explicit storage_base(in_place_ok_t /*tag*/, Args &&...args)
+      : value_(std::forward<Args>(args)...), has_value_(true) {}
+  template <typename... Args>
+  constexpr explicit storage_base(in_place_err_t /*tag*/, Args &&...args)
+      : error_(std::forward<Args>(args)...), has_value_(false) {}
+
+  void destroy() noexcept {}
+};
+
+template <typename T, typename E> struct storage_base<T, E, false> {
+  union {
+    char dummy_;
+    T value_;
+    E error_;
+  };
+  bool has_value_;
+
+  constexpr explicit storage_base(uninitialized_t /*tag*/) noexcept : dummy_(), has_value_(false) {}
+  template <typename... Args>
+  constexpr explicit storage_base(in_place_ok_t /*tag*/, Args &&...args)
+      : value_(std::forward<Args>(args)...), has_value_(true) {}
+  template <typename... Args>
+  constexpr explicit storage_base(in_place_err_t /*tag*/, Args &&...args)
+      : error_(std::forward<Args>(args)...), has_value_(false) {}
+
+  storage_base(const storage_base &) = default;
+  storage_base(storage_base &&) = default;
+  auto operator=(const storage_base &) -> storage_base & = default;
+  auto operator=(storage_base &&) -> storage_base & = default;
+  ~storage_base() { destroy(); }
+
+  void destroy() noexcept {
+    if (has_value_) {
+      value_.~T();
+    } else {
+      error_.~E();
+    }
+  }
+};
+
+// Shared helpers used by the non-trivial special member layers below.
+template <typename T, typename E> struct storage_ops : storage_base<T, E> {
+  using storage_base<T, E>::storage_base;
+
+  template <typename Other> void construct_from(Other &&other) {
+    if (other.has_value_) {
+      ::new (static_cast<void *>(std::addressof(this->value_))) T(std::forward<Other>(other).value_);
+    } else {
+      ::new (static_cast<void *>(std::addressof(this->error_))) E(std::forward<Other>(other).error_);
+    }
+    this->has_value_ = other.has_value_;
+  }
+
+  template <typename... Args> auto emplace_value(Args &&...args) -> T & {
+    emplace_member<T>(this->value_, std::forward<Args>(args)...);
+    this->has_value_ = true;
+    return this->value_;
+  }
+  template <typename... Args> void emplace_error(Args &&...args) {
+    emplace_member<E>(this->error_, std::forward<Args>(args)...);
+    this->has_value_ = false;
+  }
+
+  template <typename Other> void assign_from(Other &&other) {
+    if (this->has_value_ && other.has_value_) {
+      this->value_ = std::forward<Other>(other).value_;
+    } else if (!this->has_value_ && !other.has_value_) {
+      this->error_ = std::forward<Other>(other).error_;
+    } else if (other.has_value_) {
+      // Build the new member before destroying the old one so a throwing copy leaves *this untouched.
+      T tmp(std::forward<Other>(other).value_);
+      this->destroy();
+      ::new (static_cast<void *>(std::addressof(this->value_))) T(std::move(tmp));
+      this->has_value_ = true;
+    } else {
+      E tmp(std::forward<Other>(other).error_);
+      this->destroy();
+      ::new (static_cast<void *>(std::addressof(this->error_))) E(std::move(tmp));
+      this->has_value_ = false;
+    }
+  }
+
+private:
+  // Destroys the current member and constructs member in its place. Unless the constructor cannot throw, the new
+  // member is built aside first so a throwing constructor leaves *this untouched; result::emplace requires moving it
+  // in to be nothrow then.
+  template <typename M, typename... Args> void emplace_member(M &member, Args &&...args) {
+    if constexpr (std::is_nothrow_constructible_v<M, Args...>) {
+      this->destroy();
+      ::new (static_cast<void *>(std::addressof(member))) M(std::forward<Args>(args)...);
+    } else {
+      M tmp(std::forward<Args>(args)...);
+      this->destroy();
+      ::new (static_cast<void *>(std::addressof(member))) M(std::move(tmp));
+    }
+  }
+};
+
+template <typename T, typename E>
+inline constexpr bool trivially_copy_constructible_v =
+    std::is_trivially_copy_constructible_v<T> && std::is_trivially_copy_constructible_v<E>;
+template <typename T, typename E>
+inline constexpr bool trivially_move_constructible_v =
+    std::is_trivially_move_constructible_v<T> && std::is_trivially_move_constructible_v<E>;
+template <typename T, typename E>
+inline constexpr bool trivially_copy_assignable_v =
+    trivially_copy_constructible_v<T, E> && std::is_trivially_copy_assignable_v<T> &&
+    std::is_trivially_copy_assignable_v<E> && std::is_trivially_destructible_v<T> &&
+    std::is_trivially_destructible_v<E>;
+template <typename T, typename E>
+inline constexpr bool trivially_move_assignable_v =
+    trivially_move_constructible_v<T, E> && std::is_trivially_move_assignable_v<T> &&
+    std::is_trivially_move_assignable_v<E> && std::is_trivially_destructible_v<T> &&
+    std::is_trivially_destructible_v<E>;
+
+// Each layer either defaults one special member (keeping it trivial) or implements it through storage_ops.
+template <typename T, typename E, bool = trivially_copy_constructible_v<T, E>>
+struct copy_construct_layer : storage_ops<T, E> {
+  using storage_ops<T, E>::storage_ops;
+};
+
+template <typename T, typename E> struct copy_construct_layer<T, E, false> : storage_ops<T, E> {
+  using storage_ops<T, E>::storage_ops;
+
+  copy_construct_layer(const copy_construct_layer &other) : storage_ops<T, E>(uninitialized) {
+    this->construct_from(other);
+  }
+  copy_construct_layer(copy_construct_layer &&) = default;
+  auto operator=(const copy_construct_layer &) -> copy_construct_layer & = default;
+  auto operator=(copy_construct_layer &&) -> copy_construct_layer & = default;
+  ~copy_construct_layer() = default;
+};
+
+template <typename T, typename E, bool = trivially_move_constructible_v<T, E>>
+struct move_construct_layer : copy_construct_layer<T, E> {
+  using copy_construct_layer<T, E>::copy_construct_layer;
+};
+
+template <typename T, typename E> struct move_construct_layer<T, E, false> : copy_construct_layer<T, E> {
+  using copy_construct_layer<T, E>::copy_construct_layer;
+
+  move_construct_layer(const move_construct_layer &) = default;
+  move_construct_layer(move_construct_layer &&other) noexcept(
+      std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_constructible_v<E>)
+      : copy_construct_layer<T, E>(uninitialized) {
+    this->construct_from(std::move(other));
+  }
+  auto operator=(const move_construct_layer &) -> move_construct_layer & = default;
+  auto operator=(move_construct_layer &&) -> move_construct_layer & = default;
+  ~move_construct_layer() = default;
+};
+
+template <typename T, typename E, bool = trivially_copy_assignable_v<T, E>>
+struct copy_assign_layer : move_construct_layer<T, E> {
+  using move_construct_layer<T, E>::move_construct_layer;
+};
+
+template <typename T, typename E> struct copy_assign_layer<T, E, false> : move_construct_layer<T, E> {
+  using move_construct_layer<T, E>::move_construct_layer;
+
+  copy_assign_layer(const copy_assign_layer &) = default;
+  copy_assign_layer(copy_assign_layer &&) = default;
+  auto operator=(const copy_assign_layer &other) -> copy_assign_layer & {
+    this->assign_from(other);
+    return *this;
+  }
+  auto operator=(copy_assign_layer &&) -> copy_assign_layer & = default;
+  ~copy_assign_layer() = default;
+};
+
+template <typename T, typename E, bool = trivially_move_assignable_v<T, E>>
+struct move_assign_layer : copy_assign_layer<T, E> {
+  using copy_assign_layer<T, E>::copy_assign_layer;
+};
+
+template <typename T, typename E> struct move_assign_layer<T, E, false> : copy_assign_layer<T, E> {
+  using copy_assign_layer<T, E>::copy_assign_layer;
+
+  move_assign_layer(const move_assign_layer &) = default;
+  move_assign_layer(move_assign_layer &&) = default;
+  auto operator=(const move_assign_layer &) -> move_assign_layer & = default;
+  auto operator=(move_assign_layer &&other) noexcept(
+      std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T> &&
+      std::is_nothrow_move_constructible_v<E> && std::is_nothrow_move_assignable_v<E>) -> move_assign_layer & {
+    this->assign_from(std::move(other));
+    return *this;
+  }
+  ~move_assign_layer() = default;
+};
+
+// Empty bases that delete the special members T or E do not support, so type traits on result stay truthful.
+template <bool Enable> struct enable_copy_construct {};
+template <> struct enable_copy_construct<false> {
+  enable_copy_construct() = default;
+  enable_copy_construct(const enable_copy_construct &) = delete;
+  enable_copy_construct(enable_copy_construct &&) = default;
+  auto operator=(const enable_copy_construct &) -> enable_copy_construct & = default;
+  auto operator=(enable_copy_construct &&) -> enable_copy_construct & = default;
+  ~enable_copy_construct() = default;
+};
+
+template <bool Enable> struct enable_move_construct {};
+template <> struct enable_move_construct<false> {
+  enable_move_construct() = default;
+  enable_move_construct(const enable_move_construct &) = default;
+  enable_move_construct(enable_move_construct &&) = delete;
+  auto operator=(const enable_move_construct &) -> enable_move_construct & = default;
+  auto operator=(enable_move_construct &&) -> enable_move_construct & = default;
+  ~enable_move_construct() = default;
+};
+
+template <bool Enable> struct enable_copy_assign {};
+template <> struct enable_copy_assign<false> {
+  enable_copy_assign() = default;
+  enable_copy_assign(const enable_copy_assign &) = default;
+  enable_copy_assign(enable_copy_assign &&) = default;
+  auto operator=(const enable_copy_assign &) -> enable_copy_assign & = delete;
+  auto operator=(enable_copy_assign &&) -> enable_copy_assign & = default;
+  ~enable_copy_assign() = default;
+};
+
+template <bool Enable> struct enable_move_assign {};
+template <> struct enable_move_assign<false> {
+  enable_move_assign() = default;
+  enable_move_assign(const enable_move_assign &) = default;
+  enable_move_assign(enable_move_assign &&) = default;
+  auto operator=(const enable_move_assign &) -> enable_move_assign & = default;
+  auto operator=(enable_move_assign &&) -> enable_move_assign & = delete;
+  ~enable_move_assign() = default;
+};
+
+template <typename T, typename E>
+inline constexpr bool trivial_storage_v = trivially_copy_assignable_v<T, E> && trivially_move_assignable_v<T, E>;
+
+/// @brief Storage used by result: a tagged union whose triviality follows T and E.
+/// @details The fully trivial case is a flat struct on purpose: GCC stops scalarizing return values through base
+/// classes, which would force small results through the stack instead of RAX/RDX.
+template <typename T, typename E, bool = trivial_storage_v<T, E>> struct storage {
+  union {
+    char dummy_;
+    T value_;
+    E error_;
+  };
+  bool has_value_;
+
+  using error_const_reference = const E &;
+  using error_rvalue_reference = E &&;
+
+  template <typename... Args>
+  constexpr explicit storage(in_place_ok_t /*tag*/, Args &&...args)
+      : value_(std::forward<Args>(args)...), has_value_(true) {}
+  template <typename... Args>
+  constexpr explicit storage(in_place_err_t /*tag*/, Args &&...args)
+      : error_(std::forward<Args>(args)...), has_value_(false) {}
+
+  [[nodiscard]] constexpr auto has_value() const noexcept -> bool { return has_value_; }
+  [[nodiscard]] constexpr auto value() const & noexcept -> const T & { return value_; }
+  [[nodiscard]] constexpr auto value() && noexcept -> T && { return std::move(value_); }
+  [[nodiscard]] constexpr auto error() const & noexcept -> const E & { return error_; }
+  [[nodiscard]] constexpr auto error() && noexcept -> E && { return std::move(error_); }
+
+  // Members are trivially copyable, so building the new one aside costs nothing and keeps a throwing constructor from
+  // clobbering the old one.
+  template <typename... Args> auto emplace_value(Args &&...args) -> T & {
+    const T tmp(std::forward<Args>(args)...);
+    ::new (static_cast<void *>(std::addressof(value_))) T(tmp);
+    has_value_ = true;
+    return value_;
+  }
+  template <typename... Args> void emplace_error(Args &&...args) {
+    const E tmp(std::forward<Args>(args)...);
+    ::new (static_cast<void *>(std::addressof(error_))) E(tmp);
+    has_value_ = false;
+  }
+};
+
+template <typename T, typename E>
+struct storage<T, E, false>
+    : move_assign_layer<T, E>,
+      enable_copy_construct<std::is_copy_constructible_v<T> && std::is_copy_constructible_v<E>>,
+      enable_move_construct<std::is_move_constructible_v<T> && std::is_move_constructible_v<E>>,
+      enable_copy_assign<std::is_copy_constructible_v<T> && std::is_copy_assignable_v<T> &&
+                         std::is_copy_constructible_v<E> && std::is_copy_assignable_v<E>>,
+      enable_move_assign<std::is_move_constructible_v<T> && std::is_move_assignable_v<T> &&
+                         std::is_move_constructible_v<E> && std::is_move_assignable_v<E>> {
+  using move_assign_layer<T, E>::move_assign_layer;
+
+  using error_const_reference = const E &;
+  using error_rvalue_reference = E &&;
+
+  [[nodiscard]] constexpr auto has_value() const noexcept -> bool { return this->has_value_; }
+  [[nodiscard]] constexpr auto value() const & noexcept -> const T & { return this->value_; }
+  [[nodiscard]] constexpr auto value() && noexcept -> T && { return std::move(this->value_); }
+  [[nodiscard]] constexpr auto error() const & noexcept -> const E & { return this->error_; }
+  [[nodiscard]] constexpr auto error() && noexcept -> E && { return std::move(this->error_); }
+};
+
+} // namespace res::detail
+
+namespace res {
+
+/// @brief Customization point describing spare representations of T that result can use as its discriminant.
+/// @details The primary template describes no niche. A specialization may describe one of two kinds of niche:
+///
+/// - Spare bits: `static constexpr unsigned spare_bits` (at least 1), `static auto to_bits(const T &) noexcept ->
+///   std::uintptr_t` and `static void store_bits(T &, std::uintptr_t) noexcept`. Every valid T has its lowest bit
+///   clear, store_bits overwrites the representation without releasing what T owns, and moving a T must carry its
+///   representation unchanged. result<T, E> then packs an integral or enum E smaller than T into T itself and is
+///   sizeof(T); wider errors keep the tagged union. Packed results are not usable in constant expressions.
+/// - Sentinel: `static constexpr auto sentinel() noexcept -> T` returning a value that is never a meaningful T.
+///   result<void, E> then stores a single E and is sizeof(E). Storing the sentinel as an error is reported as misuse
+///   when accesses are checked (see RESULT_CHECKING).
+///
+/// Built-in specializations cover object pointers with alignment above 1 and std::unique_ptr with the default deleter.
+/// Sentinels are never inferred, since any enumerator may be a real error; an enum opts in with its own specialization.
+template <typename T, typename = void> struct niche_traits {};
+
+template <typename T> struct niche_traits<T *, std::enable_if_t<std::is_object_v<T> && (alignof(T) > 1)>> {
+  static constexpr unsigned spare_bits = 1;
+  static auto to_bits(T *const &value) noexcept -> std::uintptr_t { return reinterpret_cast<std::uintptr_t>(value); }
+  static void store_bits(T *&value, std::uintptr_t bits) noexcept { value = reinterpret_cast<T *>(bits); }
+};
+
+template <typename T>
+struct niche_traits<std::unique_ptr<T>, std::enable_if_t<std::is_object_v<T> && (alignof(T) > 1)>> {
+  static constexpr unsigned spare_bits = 1;
+  static auto to_bits(const std::unique_ptr<T> &value) noexcept -> std::uintptr_t {
+    return reinterpret_cast<std::uintptr_t>(value.get());
+  }
+  static void store_bits(std::unique_ptr<T> &value, std::uintptr_t bits) noexcept {
+    (void)value.release();
+    value.reset(reinterpret_cast<T *>(bits));
+  }
+};
+
+namespace detail {
+
+template <typename T, typename = void> struct has_spare_bits : std::false_type {};
+template <typename T>
+struct has_spare_bits<T, std::enable_if_t<(niche_traits<T>::spare_bits > 0)>> : std::true_type {};
+
+template <typename T, typename = void> struct has_sentinel : std::false_type {};
+template <typename T>
+struct has_sentinel<T, std::void_t<decltype(niche_traits<T>::sentinel())>> : std::true_type {};
+
+// Errors that can be shifted above the spare bit of T and recovered losslessly: their representation must leave that
+// bit free both in T itself and in the std::uintptr_t the bits travel through.
+template <typename T, typename E>
+inline constexpr bool packable_error_v = (std::is_enum_v<E> || (std::is_integral_v<E> && !std::is_same_v<E, bool>)) &&
+                                         sizeof(E) < sizeof(T) && sizeof(E) < sizeof(std::uintptr_t);
+
+/// @brief Whether result<T, E> packs its error into the spare bits of T.
+/// @details That layout converts between T and its bits with reinterpret_cast, so such results, e.g.
+/// result<const int *, int>, cannot be used in constant expressions. Every other layout can.
+template <typename T, typename E>
+inline constexpr bool packs_error_v = has_spare_bits<T>::value && packable_error_v<T, E>;
+
+template <typename E, bool = std::is_enum_v<E>> struct packed_repr {
+  using type = std::make_unsigned_t<std::underlying_type_t<E>>;
+};
+template <typename E> struct packed_repr<E, false> {
+  using type = std::make_unsigned_t<E>;
+};
+
+/// @brief Storage for result<T, E> that packs E into the spare low bit of a pointer-like T.
+/// @details The lowest bit set means the storage holds an error whose bits are shifted above it.
+template <typename T, typename E, bool = std::is_trivially_copyable_v<T>> struct tagged_storage {
+  using traits = niche_traits<T>;
+  using error_const_reference = E;
+  using error_rvalue_reference = E;
+
+  T value_;
+
+  template <typename... Args>
+  explicit tagged_storage(in_place_ok_t /*tag*/, Args &&...args) : value_(std::forward<Args>(args)...) {}
+  template <typename... Args> explicit tagged_storage(in_place_err_t /*tag*/, Args &&...args) : value_() {
+    traits::store_bits(value_, encode(E(std::forward<Args>(args)...)));
+  }
+
+  [[nodiscard]] auto has_value() const noexcept -> bool { return (traits::to_bits(value_) & 1U) == 0; }
+  [[nodiscard]] auto value() const & noexcept -> const T & { return value_; }
+  [[nodiscard]] auto value() && noexcept -> T && { return std::move(value_); }
+  [[nodiscard]] auto error() const noexcept -> E { return decode(traits::to_bits(value_)); }
+
+  template <typename... Args> auto emplace_value(Args &&...args) -> T & {
+    *this = tagged_storage(in_place_ok, std::forward<Args>(args)...);
+    return value_;
+  }
+  template <typename... Args> void emplace_error(Args &&...args) {
+    *this = tagged_storage(in_place_err, std::forward<Args>(args)...);
+  }
+
+  static auto encode(E error) noexcept -> std::uintptr_t {
+    using repr = typename packed_repr<E>::type;
+    return (static_cast<std::uintptr_t>(static_cast<repr>(error)) << 1U) | 1U;
+  }
+  static auto decode(std::uintptr_t bits) noexcept -> E {
+    using repr = typename packed_repr<E>::type;
+    return static_cast<E>(static_cast<repr>(bits >> 1U));
+  }
+};
+
+// Owning pointer-like types must never see their tagged representation in a destructor or assignment.
+template <typename T, typename E> struct tagged_storage<T, E, false> : tagged_storage<T, E, true> {
+  using base = tagged_storage<T, E, true>;
+  using traits = typename base::traits;
+  using base::base;
+
+  tagged_storage(tagged_storage &&other) noexcept : base(in_place_ok, std::move(other.value_)) {
+    restore(other);
+  }
+  auto operator=(tagged_storage &&other) noexcept -> tagged_storage & {
+    if (this != &other) {
+      disarm();
+      this->value_ = std::move(other.value_);
+      restore(other);
+    }
+    return *this;
+  }
+  ~tagged_storage() { disarm(); }
+
+  // Emplacing goes through the move assignment above, which releases what the old value owns.
+  template <typename... Args> auto emplace_value(Args &&...args) -> T & {
+    *this = tagged_storage(in_place_ok, std::forward<Args>(args)...);
+    return this->value_;
+  }
+  template <typename... Args> void emplace_error(Args &&...args) {
+    *this = tagged_storage(in_place_err, std::forward<Args>(args)...);
+  }
+
+private:
+  void disarm() noexcept {
+    if (!this->has_value()) { traits::store_bits(this->value_, 0); }
+  }
+  // Moving transferred the tag, so put it back to keep the moved-from storage holding its error.
+  void restore(tagged_storage &other) noexcept {
+    if (!this->has_value()) { traits::store_bits(other.value_, traits::to_bits(this->value_)); }
+  }
+};
+
+/// @brief Storage for result<void, E> that uses the niche sentinel of E as the success state.
+template <typename E> struct sentinel_storage {
+  using traits = niche_traits<E>;
+  using error_const_reference = const E &;
+  using error_rvalue_reference = E &&;
+
+  E error_;
+
+  constexpr explicit sentinel_storage(in_place_ok_t /*tag*/) noexcept : error_(traits::sentinel()) {}
+  template <typename... Args>
+  constexpr explicit sentinel_storage(in_place_err_t /*tag*/, Args &&...args) noexcept
+      : error_(std::forward<Args>(args)...) {
+    check_error();
+  }
+
+  [[nodiscard]] constexpr auto has_value() const noexcept -> bool { return error_ == traits::sentinel(); }
+  [[nodiscard]] constexpr auto error() const & noexcept -> const E & { return error_; }
+  [[nodiscard]] constexpr auto error() && noexcept -> E && { return std::move(error_); }
+
+  constexpr void emplace_value() noexcept { error_ = traits::sentinel(); }
+  template <typename... Args> constexpr void emplace_error(Args &&...args) noexcept {
+    error_ = E(std::forward<Args>(args)...);
+    check_error();
+  }
+
+private:
+  // The sentinel would read back as success, silently dropping the error.
+  constexpr void check_error() const noexcept {
+    if constexpr (checked_access) {
+      if (RESULT_UNLIKELY(error_ == traits::sentinel())) {
+        report_misuse("result<void, E> cannot hold the niche sentinel of E as an error");
+      }
+    }
+  }
+};
+
+template <typename T, typename E, typename = void> struct storage_for {
+  using type = storage<T, E>;
+};
+template <typename T, typename E>
+struct storage_for<T, E, std::enable_if_t<packs_error_v<T, E>>> {
+  using type = tagged_storage<T, E>;
+};
+template <typename E>
+struct storage_for<std::monostate, E, std::enable_if_t<has_sentinel<E>::value && std::is_trivially_copyable_v<E>>> {
+  using type = sentinel_storage<E>;
+};
+
+/// @brief Storage layout result<T, E> uses: a niche layout when T or E has one, the tagged union otherwise.
+template <typename T, typename E> using storage_for_t = typename storage_for<T, E>::type;
+
+} // namespace detail
+
+} // namespace res
+
+
+namespace res {
+
+template <typename E> class context_error;
+
+namespace detail {
+
+template <typename R> struct is_result : std::false_type {};
+template <typename T, typename E> struct is_result<result<T, E>> : std::true_type {};
+template <typename R>
+inline constexpr bool is_result_v = is_result<std::remove_cv_t<std::remove_reference_t<R>>>::value;
+
+template <typename Result> class error_forwarder;
+
+// Adding context to an error that already carries some extends its chain instead of nesting context_errors.
+template <typename E> struct context_error_for {
+  using type = context_error<E>;
+};
+template <typename E> struct context_error_for<context_error<E>> {
+  using type = context_error<E>;
+};
+template <typename E> using context_error_t = typename context_error_for<E>::type;
+
+// Failure paths of result::context and result::with_context, defined with context_error.
+template <typename R, typename E> auto add_text_context(E &&error, std::string_view text) -> R;
+template <typename R, typename E, typename F> auto add_lazy_context(E &&error, F &&functor) -> R;
+
+// result<T &, E> stores a pointer to the referenced object, which also lets it use the niche of pointers.
+template <typename T> struct stored_value {
+  using type = T;
+};
+template <typename T> struct stored_value<T &> {
+  using type = T *;
+};
+template <typename T> using stored_value_t = typename stored_value<T>::type;
+
+// Turns a constructor argument of result<T, E> into what its storage holds: the address for references, the argument
+// itself otherwise.
+template <typename T, typename Arg> constexpr auto store_value(Arg &&arg) noexcept -> decltype(auto) {
+  if constexpr (std::is_reference_v<T>) {
+    static_assert(std::is_lvalue_reference_v<Arg &&>, "result<T &, E> cannot refer to a temporary");
+    return std::addressof(arg);
+  } else {
+    return std::forward<Arg>(arg);
+  }
+}
+
+/// @brief Grants library components outside of result (pipelines, algorithms) access to its named constructors.
+struct result_access {
+  template <typename R, typename... Args> static constexpr auto make_ok(Args &&...args) -> R {
+    return R(R::SUCCESSFUL, std::forward<Args>(args)...);
+  }
+  template <typename R, typename... Args> static constexpr auto make_err(Args &&...args) -> R {
+    return R(R::UNSUCCESSFUL, std::forward<Args>(args)...);
+  }
+};
+
+} // namespace detail
+
+/// @brief `result` is a type that represents either success or failure.
+///
+/// result<T, E> is the type used for returning and propagating errors. It holds either a successful value of type T or
+/// an error of type E.
+///
+/// Results are usable in constant expressions, except those that pack an integral or enum error into the spare bits of
+/// a pointer-like T (see niche_traits and detail::packs_error_v), which are runtime-only.
+/// @tparam T
+/// @tparam E
+template <typename T, typename E> class result {
+  static_assert(!std::is_same_v<T, void>, "T (value type) must not be void");
+  static_assert(!std::is_same_v<E, void>, "E (error type) must not be void");
+  static_assert(!std::is_rvalue_reference_v<T>, "T (value type) must not be an rvalue reference");
+
+  using storage_type = detail::storage_for_t<detail::stored_value_t<T>, E>;
+  storage_type storage_;
+
+  // Simulate named constructors
+  enum Successful { SUCCESSFUL };
+  enum Unsuccessful { UNSUCCESSFUL };
+  // Arguments are forwarded to the constructor of T or E, so the member is built once, in place.
+  template <typename... Args>
+  constexpr result(Successful /*tag*/, Args &&...args)
+      : storage_(detail::in_place_ok, detail::store_value<T>(std::forward<Args>(args))...) {}
+  template <typename... Args>
+  constexpr result(Unsuccessful /*tag*/, Args &&...args)
+      : storage_(detail::in_place_err, std::forward<Args>(args)...) {}
+
+  template <typename U> friend class ok;
+  template <typename U> friend class err;
+  template <typename U, typename... Args> friend class ok_in_place_t;
+  template <typename U, typename... Args> friend class err_in_place_t;
+  template <typename U, typename V> friend class result;
+  template <typename R> friend class detail::error_forwarder;
+  friend struct detail::result_access;
+
+public:
+  using value_type = T;
+  using error_type = E;
+
+  // Observers
+  [[nodiscard]] constexpr auto is_ok() const noexcept -> bool { return storage_.has_value(); }
+  constexpr explicit operator bool() const noexcept { return is_ok(); }
+  constexpr auto operator!() const noexcept -> bool { return !is_ok(); }
+
+  // Checked accessors are noexcept unless RESULT_CHECKING throws on a wrong access.
+  [[nodiscard]] constexpr auto value() const & noexcept(!detail::throwing_access) -> const T &;
+  [[nodiscard]] constexpr auto value() && noexcept(!detail::throwing_access) -> T &&;
+  [[nodiscard]] constexpr auto value_or(T &&default_value) const & noexcept(
+      std::is_nothrow_copy_constructible_v<T> && std::is_nothrow_move_constructible_v<T>) -> T;
+  [[nodiscard]] constexpr auto value_or(T &&default_value) && noexcept(std::is_nothrow_move_constructible_v<T>) -> T;
+  [[nodiscard]] constexpr auto error() const & noexcept(!detail::throwing_access) ->
+      typename storage_type::error_const_reference;
+  [[nodiscard]] constexpr auto error() && noexcept(!detail::throwing_access) ->
+      typename storage_type::error_rvalue_reference;
+
+  // Unchecked accessors skip the check whatever RESULT_CHECKING is; calling the wrong one is undefined behavior.
+  [[nodiscard]] constexpr auto value_unchecked() const & noexcept -> const T & {
+    if constexpr (std::is_reference_v<T>) {
+      return *storage_.value();
+    } else {
+      return storage_.value();
+    }
+  }
+  [[nodiscard]] constexpr auto value_unchecked() && noexcept -> T && {
+    if constexpr (std::is_reference_v<T>) {
+      return *storage_.value();
+    } else {
+      return std::move(storage_).value();
+    }
+  }
+  [[nodiscard]] constexpr auto error_unchecked() const & noexcept -> typename storage_type::error_const_reference {
+    return storage_.error();
+  }
+  [[nodiscard]] constexpr auto error_unchecked() && noexcept -> typename storage_type::error_rvalue_reference {
+    return std::move(storage_).error();
+  }
+
+  // Modifiers
+  // emplace destroys the value or error held and constructs a value from args in its place; emplace_error does the
+  // same for the error. If the constructor throws, the result keeps what it held, which requires the new member to be
+  // nothrow constructible from args or nothrow movable. For result<T &, E>, emplace rebinds the reference.
+  template <typename... Args>
+  auto emplace(Args &&...args) noexcept(std::is_nothrow_constructible_v<T, Args...>) -> T & {
+    static_assert(std::is_nothrow_constructible_v<T, Args...> || std::is_nothrow_move_constructible_v<T>,
+                  "emplace needs T to be nothrow constructible from the arguments or nothrow movable");
+    auto &stored = storage_.emplace_value(detail::store_value<T>(std::forward<Args>(args))...);
+    if constexpr (std::is_reference_v<T>) {
+      return *stored;
+    } else {
+      return stored;
+    }
+  }
+  template <typename... Args>
+  void emplace_error(Args &&...args) noexcept(std::is_nothrow_constructible_v<E, Args...>) {
+    static_assert(std::is_nothrow_constructible_v<E, Args...> || std::is_nothrow_move_constructible_v<E>,
+                  "emplace_error needs E to be nothrow constructible from the arguments or nothrow movable");
+    storage_.emplace_error(std::forward<Args>(args)...);
+  }
+
+  // Monadic operations
+  // map method gets functor F(T x) -> R as an argument and returns result of applying this functor to the value of the
+  // result object. If the result object is an error, the functor is not called and the error is propagated. But the
+  // result value type is changed to R.
+  template <typename F, typename R = std::invoke_result_t<F, T>>
+  constexpr auto map(F &&functor) const & -> result<R, E> {
+    if (is_ok()) { return result<R, E>(result<R, E>::SUCCESSFUL, std::forward<F>(functor)(value())); }
+    return result<R, E>(result<R, E>::UNSUCCESSFUL, error());
+  }
+  // Rvalue overload of map moves the value into the functor and the error into the returned result, so chains of
+  // map calls on temporaries never copy the payload.
+  template <typename F, typename R = std::invoke_result_t<F, T>>
+  constexpr auto map(F &&functor) && -> result<R, E> {
+    if (is_ok()) { return result<R, E>(result<R, E>::SUCCESSFUL, std::forward<F>(functor)(std::move(*this).value())); }
+    return result<R, E>(result<R, E>::UNSUCCESSFUL, std::move(*this).error());
+  }
+  // map_err method gets functor F(E x) -> U as an argument and returns result of applying this functor to the error of
+  // the result object. If the result object is a success, the functor is not called and the value is propagated. But
+  // the result error type is changed to U.
+  template <typename F, typename U = std::invoke_result_t<F, E>>
+  constexpr auto map_err(F &&functor) const & -> result<T, U> {
+    if (!is_ok()) { return result<T, U>(result<T, U>::UNSUCCESSFUL, std::forward<F>(functor)(error())); }
+    return result<T, U>(result<T, U>::SUCCESSFUL, value());
+  }
+  // Rvalue overload of map_err moves the error into the functor and the value into the returned result.
+  template <typename F, typename U = std::invoke_result_t<F, E>>
+  constexpr auto map_err(F &&functor) && -> result<T, U> {
+    if (!is_ok()) {
+      return result<T, U>(result<T, U>::UNSUCCESSFUL, std::forward<F>(functor)(std::move(*this).error()));
+    }
+    return result<T, U>(result<T, U>::SUCCESSFUL, std::move(*this).value());
+  }
+  // and_then method gets functor F(T x) -> result<U, E> as an argument and returns the result of applying this functor
+  // to the value of the result object. If the result object is an error, the functor is not called and the error is
+  // propagated. Unlike map, it lets the next step fail without nesting results.
+  template <typename F, typename R = std::invoke_result_t<F, T>>
+  constexpr auto and_then(F &&functor) const & -> R {
+    static_assert(detail::is_result_v<R>, "and_then functor must return a result");
+    static_assert(std::is_same_v<typename R::error_type, E>, "and_then functor must keep the error type");
+    if (is_ok()) { return std::forward<F>(functor)(value()); }
+    return R(R::UNSUCCESSFUL, error());
+  }
+  template <typename F, typename R = std::invoke_result_t<F, T>>
+  constexpr auto and_then(F &&functor) && -> R {
+    static_assert(detail::is_result_v<R>, "and_then functor must return a result");
+    static_assert(std::is_same_v<typename R::error_type, E>, "and_then functor must keep the error type");
+    if (is_ok()) { return std::forward<F>(functor)(std::move(*this).value()); }
+    return R(R::UNSUCCESSFUL, std::move(*this).error());
+  }
+  // or_else method gets functor F(E x) -> result<T, U> as an argument and returns the result of applying this functor
+  // to the error of the result object. If the result object is a success, the functor is not called and the value is
+  // propagated. It lets an error be recovered from or replaced by a different one.
+  template <typename F, typename R = std::invoke_result_t<F, E>>
+  constexpr auto or_else(F &&functor) const & -> R {
+    static_assert(detail::is_result_v<R>, "or_else functor must return a result");
+    static_assert(std::is_same_v<typename R::value_type, T>, "or_else functor must keep the value type");
+    if (!is_ok()) { return std::forward<F>(functor)(error()); }
+    return R(R::SUCCESSFUL, value());
+  }
+  template <typename F, typename R = std::invoke_result_t<F, E>>
+  constexpr auto or_else(F &&functor) && -> R {
+    static_assert(detail::is_result_v<R>, "or_else functor must return a result");
+    static_assert(std::is_same_v<typename R::value_type, T>, "or_else functor must keep the value type");
+    if (!is_ok()) { return std::forward<F>(functor)(std::move(*this).error()); }
+    return R(R::SUCCESSFUL, std::move(*this).value());
+  }
+  // context method attaches a description of what was being done to the error, turning E into context_error<E>. The
+  // text is copied into a thread-local arena and only joined with the error when the context_error is formatted.
+  auto context(std::string_view text) const & -> result<T, detail::context_error_t<E>> {
+    using output = result<T, detail::context_error_t<E>>;
+    if (is_ok()) { return output(output::SUCCESSFUL, value()); }
+    return detail::add_text_context<output>(error(), text);
+  }
+  auto context(std::string_view text) && -> result<T, detail::context_error_t<E>> {
+    using output = result<T, detail::context_error_t<E>>;
+    if (is_ok()) { return output(output::SUCCESSFUL, std::move(*this).value()); }
+    return detail::add_text_context<output>(std::move(*this).error(), text);
+  }
+  // with_context method is the lazy form of context: functor() -> text is stored in the arena and only called when
+  // the error is formatted, so it must capture by value. It is not called at all if the result is a success.
+  template <typename F> auto with_context(F &&functor) const & -> result<T, detail::context_error_t<E>> {
+    using output = result<T, detail::context_error_t<E>>;
+    if (is_ok()) { return output(output::SUCCESSFUL, value()); }
+    return detail::add_lazy_context<output>(error(), std::forward<F>(functor));
+  }
+  template <typename F> auto with_context(F &&functor) && -> result<T, detail::context_error_t<E>> {
+    using output = result<T, detail::context_error_t<E>>;
+    if (is_ok()) { return output(output::SUCCESSFUL, std::move(*this).value()); }
+    return detail::add_lazy_context<output>(std::move(*this).error(), std::forward<F>(functor));
+  }
+};
+
+/// @brief `result` class specialization for void value type.
+template <typename E> class result<void, E> {
+  static_assert(!std::is_same_v<E, void>, "E (error type) must not be void");
+
+  // std::monostate stands in for the missing value, so the void specialization shares the tagged union storage.
+  using storage_type = detail::storage_for_t<std::monostate, E>;
+  storage_type storage_;
+
+  // Simulate named constructors
+  enum Successful { SUCCESSFUL };
+  enum Unsuccessful { UNSUCCESSFUL };
+  constexpr explicit result(Successful /*tag*/) : storage_(detail::in_place_ok) {}
+  template <typename... Args>
+  constexpr result(Unsuccessful /*tag*/, Args &&...args)
+      : storage_(detail::in_place_err, std::forward<Args>(args)...) {}
+
+  template <typename U> friend class ok;
+  template <typename U> friend class err;
+  template <typename U, typename... Args> friend class err_in_place_t;
+  template <typename U, typename V> friend class result;
+  template <typename R> friend class detail::error_forwarder;
+  friend struct detail::result_access;
+
+public:
+  using value_type = void;
+  using error_type = E;
+
+  // Observers
+  [[nodiscard]] constexpr auto is_ok() const noexcept -> bool { return storage_.has_value(); }
+  constexpr explicit operator bool() const noexcept { return is_ok(); }
+  constexpr auto operator!() const noexcept -> bool { return !is_ok(); }
+
+  [[nodiscard]] constexpr auto error() const & noexcept(!detail::throwing_access) ->
+      typename storage_type::error_const_reference;
+  [[nodiscard]] constexpr auto error() && noexcept(!detail::throwing_access) ->
+      typename storage_type::error_rvalue_reference;
+
+  [[nodiscard]] constexpr auto error_unchecked() const & noexcept -> typename storage_type::error_const_reference {
+    return storage_.error();
+  }
+  [[nodiscard]] constexpr auto error_unchecked() && noexcept -> typename storage_type::error_rvalue_reference {
+    return std::move(storage_).error();
+  }
+
+  // Modifiers
+  // emplace makes the result successful; emplace_error constructs a new error in place, see result<T, E>::emplace.
+  void emplace() noexcept { storage_.emplace_value(); }
+  template <typename... Args>
+  void emplace_error(Args &&...args) noexcept(std::is_nothrow_constructible_v<E, Args...>) {
+    static_assert(std::is_nothrow_constructible_v<E, Args...> || std::is_nothrow_move_constructible_v<E>,
+                  "emplace_error needs E to be nothrow constructible from the arguments or nothrow movable");
+    storage_.emplace_error(std::forward<Args>(args)...);
+  }
+
+  // Monadic operations
+  // map method gets functor F() -> R as an argument and returns result of applying this functor to the value of the
+  // result object. If the result object is an error, the functor is not called and the error is propagated. But the
+  // result value type is changed to R.
+  template <typename F, typename R = std::invoke_result_t<F>>
+  constexpr auto map(F &&functor) const & -> result<R, E> {
+    if (is_ok()) { return result<R, E>(result<R, E>::SUCCESSFUL, std::forward<F>(functor)()); }
+    return result<R, E>(result<R, E>::UNSUCCESSFUL, error());
+  }
+  // Rvalue overload of map moves the error into the returned result.
+  template <typename F, typename R = std::invoke_result_t<F>>
+  constexpr auto map(F &&functor) && -> result<R, E> {
+    if (is_ok()) { return result<R, E>(result<R, E>::SUCCESSFUL, std::forward<F>(functor)()); }
+    return result<R, E>(result<R, E>::UNSUCCESSFUL, std::move(*this).error());
+  }
+  // map_err method for void value type is same as for non-void value type because it does not depend on the value type.
+  template <typename F, typename U = std::invoke_result_t<F, E>>
+  constexpr auto map_err(F &&functor) const & -> result<void, U> {
+    if (!is_ok()) { return result<void, U>(result<void, U>::UNSUCCESSFUL, std::forward<F>(functor)(error())); }
+    return result<void, U>(result<void, U>::SUCCESSFUL);
+  }
+  // Rvalue overload of map_err moves the error into the functor.
+  template <typename F, typename U = std::invoke_result_t<F, E>>
+  constexpr auto map_err(F &&functor) && -> result<void, U> {
+    if (!is_ok()) {
+      return result<void, U>(result<void, U>::UNSUCCESSFUL, std::forward<F>(functor)(std::move(*this).error()));
+    }
+    return result<void, U>(result<void, U>::SUCCESSFUL);
+  }
+  // and_then method for void value type gets functor F() -> result<U, E>.
+  template <typename F, typename R = std::invoke_result_t<F>>
+  constexpr auto and_then(F &&functor) const & -> R {
+    static_assert(detail::is_result_v<R>, "and_then functor must return a result");
+    static_assert(std::is_same_v<typename R::error_type, E>, "and_then functor must keep the error type");
+    if (is_ok()) { return std::forward<F>(functor)(); }
+    return R(R::UNSUCCESSFUL, error());
+  }
+  template <typename F, typename R = std::invoke_result_t<F>>
+  constexpr auto and_then(F &&functor) && -> R {
+    static_assert(detail::is_result_v<R>, "and_then functor must return a result");
+    static_assert(std::is_same_v<typename R::error_type, E>, "and_then functor must keep the error type");
+    if (is_ok()) { return std::forward<F>(functor)(); }
+    return R(R::UNSUCCESSFUL, std::move(*this).error());
+  }
+  // or_else method for void value type gets functor F(E x) -> result<void, U>.
+  template <typename F, typename R = std::invoke_result_t<F, E>>
+  constexpr auto or_else(F &&functor) const & -> R {
+    static_assert(detail::is_result_v<R>, "or_else functor must return a result");
+    static_assert(std::is_same_v<typename R::value_type, void>, "or_else functor must keep the value type");
+    if (!is_ok()) { return std::forward<F>(functor)(error()); }
+    return R(R::SUCCESSFUL);
+  }
+  template <typename F, typename R = std::invoke_result_t<F, E>>
+  constexpr auto or_else(F &&functor) && -> R {
+    static_assert(detail::is_result_v<R>, "or_else functor must return a result");
+    static_assert(std::is_same_v<typename R::value_type, void>, "or_else functor must keep the value type");
+    if (!is_ok()) { return std::forward<F>(functor)(std::move(*this).error()); }
+    return R(R::SUCCESSFUL);
+  }
+  // context and with_context methods for void value type are same as for non-void value type.
+  auto context(std::string_view text) const & -> result<void, detail::context_error_t<E>> {
+    using output = result<void, detail::context_error_t<E>>;
+    if (is_ok()) { return output(output::SUCCESSFUL); }
+    return detail::add_text_context<output>(error(), text);
+  }
+  auto context(std::string_view text) && -> result<void, detail::context_error_t<E>> {
+    using output = result<void, detail::context_error_t<E>>;
+    if (is_ok()) { return output(output::SUCCESSFUL); }
+    return detail::add_text_context<output>(std::move(*this).error(), text);
+  }
+  template <typename F> auto with_context(F &&functor) const & -> result<void, detail::context_error_t<E>> {
+    using output = result<void, detail::context_error_t<E>>;
+    if (is_ok()) { return output(output::SUCCESSFUL); }
+    return detail::add_lazy_context<output>(error(), std::forward<F>(functor));
+  }
+  template <typename F> auto with_context(F &&functor) && -> result<void, detail::context_error_t<E>> {
+    using output = result<void, detail::context_error_t<E>>;
+    if (is_ok()) { return output(output::SUCCESSFUL); }
+    return detail::add_lazy_context<output>(std::move(*this).error(), std::forward<F>(functor));
+  }
+};
+
+template <typename T, typename E>
+constexpr auto result<T, E>::value() const & noexcept(!detail::throwing_access) -> const T & {
+  if constexpr (detail::checked_access) {
+    if (RESULT_UNLIKELY(!is_ok())) { detail::bad_result_access("value() called on result with error"); }
+  }
+  return value_unchecked();
+}
+
+template <typename T, typename E> constexpr auto result<T, E>::value() && noexcept(!detail::throwing_access) -> T && {
+  if constexpr (detail::checked_access) {
+    if (RESULT_UNLIKELY(!is_ok())) { detail::bad_result_access("value() called on result with error"); }
+  }
+  return std::move(*this).value_unchecked();
+}
+
+template <typename T, typename E>
+constexpr auto result<T, E>::value_or(T &&default_value) const & noexcept(
+    std::is_nothrow_copy_constructible_v<T> && std::is_nothrow_move_constructible_v<T>) -> T {
+  if (is_ok()) { return value_unchecked(); }
+  return std::forward<T>(default_value);
+}
+
+template <typename T, typename E>
+constexpr auto result<T, E>::value_or(T &&default_value) && noexcept(std::is_nothrow_move_constructible_v<T>) -> T {
+  if (is_ok()) { return std::move(*this).value_unchecked(); }
+  return std::forward<T>(default_value);
+}
+
+template <typename T, typename E>
+constexpr auto result<T, E>::error() const & noexcept(!detail::throwing_access) ->
+    typename storage_type::error_const_reference {
+  if constexpr (detail::checked_access) {
+    if (RESULT_UNLIKELY(is_ok())) { detail::bad_result_access("error() called on result with value"); }
+  }
+  return storage_.error();
+}
+
+template <typename T, typename E>
+constexpr auto result<T, E>::error() && noexcept(!detail::throwing_access) ->
+    typename storage_type::error_rvalue_reference {
+  if constexpr (detail::checked_access) {
+    if (RESULT_UNLIKELY(is_ok())) { detail::bad_result_access("error() called on result with value"); }
+  }
+  return std::move(storage_).error();
+}
+
+template <typename E>
+constexpr auto result<void, E>::error() const & noexcept(!detail::throwing_access) ->
+    typename storage_type::error_const_reference {
+  if constexpr (detail::checked_access) {
+    if (RESULT_UNLIKELY(is_ok())) { detail::bad_result_access("error() called on result with value"); }
+  }
+  return storage_.error();
+}
+
+template <typename E>
+constexpr auto result<void, E>::error() && noexcept(!detail::throwing_access) ->
+    typename storage_type::error_rvalue_reference {
+  if constexpr (detail::checked_access) {
+    if (RESULT_UNLIKELY(is_ok())) { detail::bad_result_access("error() called on result with value"); }
+  }
+  return std::move(storage_).error();
+}
+
+/// @brief Results are equal when both hold equal values or both hold equal errors. Results of references compare the
+/// objects they refer to.
+template <typename T, typename E, typename U, typename F>
+constexpr auto operator==(const result<T, E> &lhs, const result<U, F> &rhs) -> bool {
+  static_assert(std::is_void_v<T> == std::is_void_v<U>, "a result<void, E> only compares with another one");
+  if (lhs.is_ok() != rhs.is_ok()) { return false; }
+  if (!lhs.is_ok()) { return lhs.error_unchecked() == rhs.error_unchecked(); }
+  if constexpr (std::is_void_v<T>) {
+    return true;
+  } else {
+    return lhs.value_unchecked() == rhs.value_unchecked();
+  }
+}
+
+template <typename T, typename E, typename U, typename F>
+constexpr auto operator!=(const result<T, E> &lhs, const result<U, F> &rhs) -> bool {
+  return !(lhs == rhs);
+}
+
+namespace detail {
+
+inline constexpr auto hash_combine(std::size_t seed, std::size_t value) noexcept -> std::size_t {
+  return seed ^ (value + static_cast<std::size_t>(0x9E3779B97F4A7C15ULL) + (seed << 6U) + (seed >> 2U));
+}
+
+template <typename T> inline constexpr bool is_hashable_v = std::is_default_constructible_v<std::hash<T>>;
+
+template <typename T, typename E,
+          bool = (std::is_void_v<T> || is_hashable_v<std::remove_cv_t<std::remove_reference_t<T>>>) &&
+                 is_hashable_v<E>>
+struct result_hash {
+  auto operator()(const result<T, E> &value) const -> std::size_t {
+    if (!value.is_ok()) { return hash_combine(2, std::hash<E>()(value.error_unchecked())); }
+    if constexpr (std::is_void_v<T>) {
+      return 1;
+    } else {
+      using plain = std::remove_cv_t<std::remove_reference_t<T>>;
+      return hash_combine(1, std::hash<plain>()(value.value_unchecked()));
+    }
+  }
+};
+
+// Disabled like std::hash of a type without a hash, so containers and traits can detect it.
+template <typename T, typename E> struct result_hash<T, E, false> {
+  result_hash() = delete;
+  result_hash(const result_hash &) = delete;
+  auto operator=(const result_hash &) -> result_hash & = delete;
+};
+
+} // namespace detail
+
+} // namespace res
+
+/// @brief Hashes whether the result holds a value and the value or error, so results can be keys of unordered
+/// containers. Enabled when T and E are hashable.
+template <typename T, typename E> struct std::hash<res::result<T, E>> : res::detail::result_hash<T, E> {};
+
+#include <type_traits>
+#include <utility>
+
+
+namespace res::detail {
+
+template <typename From, typename To, typename = void> struct is_non_narrowing : std::false_type {};
+template <typename From, typename To>
+struct is_non_narrowing<From, To, std::void_t<decltype(To{std::declval<From>()})>> : std::true_type {};
+
+/// @brief Whether an error of type From propagates into an error of type To: the conversion must be implicit and,
+/// between arithmetic types, must not narrow.
+template <typename From, typename To>
+inline constexpr bool forwards_error_v =
+    std::is_convertible_v<From, To> &&
+    (!(std::is_arithmetic_v<std::remove_cv_t<std::remove_reference_t<From>>> && std::is_arithmetic_v<To>) ||
+     is_non_narrowing<From, To>::value);
+
+/// @brief Converts to any result whose error type the source's error implicitly converts to, by forwarding the error
+/// out of the source result.
+/// @details Returned by RES_TRY on the error path, so the error goes straight into the caller's return slot instead of
+/// being copied through err<E>. Result is an lvalue reference when RES_TRY was given an lvalue, whose error is then
+/// copied rather than moved. The error type usually stays the same; a wider one such as res::any_error lets a layer
+/// propagate the errors of the layers below it without map_err. Explicit constructors are never called, so an int
+/// error does not become, say, a std::vector<int> of that many elements, and arithmetic errors only widen, so an int
+/// error code is not silently turned into a bool or truncated to an unsigned char.
+template <typename Result> class error_forwarder {
+  using source_error_t = decltype(std::declval<Result &&>().error());
+  template <typename F>
+  using enable_if_convertible_t = std::enable_if_t<forwards_error_v<source_error_t, F>>;
+
+  std::remove_reference_t<Result> &source_;
+
+public:
+  constexpr explicit error_forwarder(std::remove_reference_t<Result> &source) : source_(source) {}
+
+  // NOLINTBEGIN(google-explicit-constructor)
+  template <typename T, typename F, typename = enable_if_convertible_t<F>> constexpr operator result<T, F>() && {
+    return result<T, F>(result<T, F>::UNSUCCESSFUL, std::forward<Result>(source_).error());
+  }
+  template <typename F, typename = enable_if_convertible_t<F>> constexpr operator result<void, F>() && {
+    return result<void, F>(result<void, F>::UNSUCCESSFUL, std::forward<Result>(source_).error());
+  }
+  // NOLINTEND(google-explicit-constructor)
+};
+
+template <typename Result> constexpr auto forward_error(Result &&source) -> error_forwarder<Result> {
+  return error_forwarder<Result>(source);
+}
+
+// A named result is left intact: its value is copied out rather than moved.
+template <typename T, typename E> constexpr auto unwrap(const result<T, E> &source) -> const T & {
+  return source.value();
+}
+template <typename T, typename E> constexpr auto unwrap(result<T, E> &&source) -> T && {
+  return std::move(source).value();
+}
+template <typename E> constexpr void unwrap(const result<void, E> & /*source*/) {}
+template <typename E> constexpr void unwrap(result<void, E> && /*source*/) {}
+
+} // namespace res::detail
+
+#define RES_CONCAT_IMPL(lhs, rhs) lhs##rhs
+#define RES_CONCAT(lhs, rhs) RES_CONCAT_IMPL(lhs, rhs)
+// Moves out of the checked result only when the expression given to RES_TRY was an rvalue.
+#define RES_TRY_FORWARD(name) std::forward<decltype(name)>(name)
+
+/// @brief Evaluates an expression returning a result and returns its error from the enclosing function on failure.
+/// @details With GCC and Clang statement expressions RES_TRY(expr) is an expression yielding the value, e.g.
+/// `int port = RES_TRY(parse_port(text));`. Other compilers only get the statement form, which discards the value and
+/// is meant for result<void, E>; use RES_TRY_ASSIGN there to keep it.
+#if defined(__GNUC__) || defined(__clang__)
+#define RESULT_HAS_STATEMENT_EXPRESSIONS 1
+#define RES_TRY(...)                                                                                                   \
+  __extension__({                                                                                                      \
+    auto &&res_try_result_ = (__VA_ARGS__);                                                                            \
+    if (!res_try_result_) { return ::res::detail::forward_error(RES_TRY_FORWARD(res_try_result_)); }                   \
+    ::res::detail::unwrap(RES_TRY_FORWARD(res_try_result_));                                                           \
+  })
+#else
+#define RESULT_HAS_STATEMENT_EXPRESSIONS 0
+#define RES_TRY(...)                                                                                                   \
+  do {                                                                                                                 \
+    auto &&res_try_result_ = (__VA_ARGS__);                                                                            \
+    if (!res_try_result_) { return ::res::detail::forward_error(RES_TRY_FORWARD(res_try_result_)); }                   \
+  } while (false)
+#endif
+
+/// @brief Portable statement form of RES_TRY that binds the value to a declaration, e.g.
+/// `RES_TRY_ASSIGN(int port, parse_port(text));`.
+#define RES_TRY_ASSIGN(declaration, ...)                                                                               \
+  auto &&RES_CONCAT(res_try_result_, __LINE__) = (__VA_ARGS__);                                                        \
+  if (!RES_CONCAT(res_try_result_, __LINE__)) {                                                                        \
+    return ::res::detail::forward_error(RES_TRY_FORWARD(RES_CONCAT(res_try_result_, __LINE__)));                       \
+  }                                                                                                                    \
+  declaration = ::res::detail::unwrap(RES_TRY_FORWARD(RES_CONCAT(res_try_result_, __LINE__)))
+
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+namespace res {
+
+namespace detail {
+
+// Placeholder carried through the ok lane of a pipeline when the value type is void.
+struct void_value {};
+
+template <typename F, typename T, bool = std::is_void_v<T>> struct value_invoke_result {
+  using type = std::invoke_result_t<F, T>;
+};
+template <typename F, typename T> struct value_invoke_result<F, T, true> {
+  using type = std::invoke_result_t<F>;
+};
+template <typename F, typename T> using value_invoke_result_t = typename value_invoke_result<F, T>::type;
+
+template <typename F, typename V> constexpr decltype(auto) invoke_value(F &f, V &&value) {
+  if constexpr (std::is_same_v<std::decay_t<V>, void_value>) {
+    return f();
+  } else {
+    return f(std::forward<V>(value));
+  }
+}
+
+template <typename F> struct map_stage {
+  F functor;
+};
+template <typename F> struct and_then_stage {
+  F functor;
+};
+template <typename F> struct map_err_stage {
+  F functor;
+};
+template <typename F> struct or_else_stage {
+  F functor;
+};
+
+// Computes the result type a list of stages produces from result<T, E>.
+template <typename T, typename E, typename... Stages> struct pipeline_result {
+  using type = result<T, E>;
+};
+template <typename T, typename E, typename F, typename... Rest>
+struct pipeline_result<T, E, map_stage<F>, Rest...>
+    : pipeline_result<value_invoke_result_t<F &, T>, E, Rest...> {};
+template <typename T, typename E, typename F, typename... Rest>
+struct pipeline_result<T, E, and_then_stage<F>, Rest...>
+    : pipeline_result<typename value_invoke_result_t<F &, T>::value_type, E, Rest...> {
+  static_assert(std::is_same_v<typename value_invoke_result_t<F &, T>::error_type, E>,
+                "and_then stage must keep the error type");
+};
+template <typename T, typename E, typename F, typename... Rest>
+struct pipeline_result<T, E, map_err_stage<F>, Rest...> : pipeline_result<T, std::invoke_result_t<F &, E>, Rest...> {};
+template <typename T, typename E, typename F, typename... Rest>
+struct pipeline_result<T, E, or_else_stage<F>, Rest...>
+    : pipeline_result<T, typename std::invoke_result_t<F &, E>::error_type, Rest...> {
+  static_assert(std::is_same_v<typename std::invoke_result_t<F &, E>::value_type, T>,
+                "or_else stage must keep the value type");
+};
+
+/// @brief Runs a list of stages as one function.
+/// @details Values travel through the ok lane and errors through the err lane as plain T and E; only and_then and
+/// or_else stages test a discriminant and only the final result is ever constructed.
+template <typename Final, typename... Stages> struct pipeline_runner {
+  using stages_type = std::tuple<Stages...>;
+
+  template <std::size_t I, typename V> static constexpr auto run_ok(stages_type &stages, V &&value) -> Final {
+    if constexpr (I == sizeof...(Stages)) {
+      if constexpr (std::is_same_v<std::decay_t<V>, void_value>) {
+        return result_access::make_ok<Final>();
+      } else {
+        return result_access::make_ok<Final>(std::forward<V>(value));
+      }
+    } else {
+      using stage = std::tuple_element_t<I, stages_type>;
+      auto &functor = std::get<I>(stages).functor;
+      if constexpr (is_specialization_v<stage, map_stage>) {
+        if constexpr (std::is_void_v<decltype(invoke_value(functor, std::forward<V>(value)))>) {
+          invoke_value(functor, std::forward<V>(value));
+          return run_ok<I + 1>(stages, void_value{});
+        } else {
+          return run_ok<I + 1>(stages, invoke_value(functor, std::forward<V>(value)));
+        }
+      } else if constexpr (is_specialization_v<stage, and_then_stage>) {
+        auto next = invoke_value(functor, std::forward<V>(value));
+        if (next.is_ok()) { return run_ok_from<I + 1>(stages, std::move(next)); }
+        return run_err<I + 1>(stages, std::move(next).error());
+      } else {
+        return run_ok<I + 1>(stages, std::forward<V>(value));
+      }
+    }
+  }
+
+  template <std::size_t I, typename V> static constexpr auto run_err(stages_type &stages, V &&error) -> Final {
+    if constexpr (I == sizeof...(Stages)) {
+      return result_access::make_err<Final>(std::forward<V>(error));
+    } else {
+      using stage = std::tuple_element_t<I, stages_type>;
+      auto &functor = std::get<I>(stages).functor;
+      if constexpr (is_specialization_v<stage, map_err_stage>) {
+        return run_err<I + 1>(stages, functor(std::forward<V>(error)));
+      } else if constexpr (is_specialization_v<stage, or_else_stage>) {
+        auto next = functor(std::forward<V>(error));
+        if (next.is_ok()) { return run_ok_from<I + 1>(stages, std::move(next)); }
+        return run_err<I + 1>(stages, std::move(next).error());
+      } else {
+        return run_err<I + 1>(stages, std::forward<V>(error));
+      }
+    }
+  }
+
+  template <std::size_t I, typename R> static constexpr auto run_ok_from(stages_type &stages, R &&source) -> Final {
+    if constexpr (std::is_void_v<typename std::decay_t<R>::value_type>) {
+      return run_ok<I>(stages, void_value{});
+    } else {
+      return run_ok<I>(stages, std::forward<R>(source).value());
+    }
+  }
+
+  template <typename R> static constexpr auto run(stages_type &stages, R &&source) -> Final {
+    if (source.is_ok()) { return run_ok_from<0>(stages, std::forward<R>(source)); }
+    return run_err<0>(stages, std::forward<R>(source).error());
+  }
+
+private:
+  template <typename S, template <typename> class Stage> struct is_specialization : std::false_type {};
+  template <typename F, template <typename> class Stage>
+  struct is_specialization<Stage<F>, Stage> : std::true_type {};
+  template <typename S, template <typename> class Stage>
+  static constexpr bool is_specialization_v = is_specialization<S, Stage>::value;
+};
+
+} // namespace detail
+
+template <typename Source, typename P> class deferred_result;
+
+/// @brief A composition of map, and_then, map_err and or_else stages that runs as a single function.
+/// @details Pipelines are built with res::map, res::and_then, res::map_err and res::or_else and joined with `|`.
+/// Applying one to a result with `|` yields a deferred_result that is evaluated when converted to a result or when
+/// run() is called.
+template <typename... Stages> class pipeline {
+  std::tuple<Stages...> stages_;
+
+public:
+  constexpr explicit pipeline(std::tuple<Stages...> stages) : stages_(std::move(stages)) {}
+
+  /// @brief Releases the stages, used when pipelines are joined.
+  constexpr auto stages() && -> std::tuple<Stages...> { return std::move(stages_); }
+
+  template <typename... Other>
+  friend constexpr auto operator|(pipeline lhs, pipeline<Other...> rhs) -> pipeline<Stages..., Other...> {
+    return pipeline<Stages..., Other...>(std::tuple_cat(std::move(lhs.stages_), std::move(rhs).stages()));
+  }
+
+  /// @brief Applies the pipeline to a result. Rvalue results are moved into the deferred result, lvalues are
+  /// referenced.
+  template <typename R, typename = std::enable_if_t<detail::is_result_v<R>>>
+  friend constexpr auto operator|(R &&source, pipeline stages)
+      -> deferred_result<std::conditional_t<std::is_lvalue_reference_v<R>, const std::decay_t<R> &, std::decay_t<R>>,
+                         pipeline> {
+    using source_type = std::conditional_t<std::is_lvalue_reference_v<R>, const std::decay_t<R> &, std::decay_t<R>>;
+    return deferred_result<source_type, pipeline>(std::forward<R>(source), std::move(stages.stages_));
+  }
+};
+
+/// @brief A result with a pipeline applied to it that has not been evaluated yet.
+template <typename Source, typename... Stages> class deferred_result<Source, pipeline<Stages...>> {
+  using source_type = std::decay_t<Source>;
+  using stages_type = std::tuple<Stages...>;
+
+  Source source_;
+  stages_type stages_;
+
+public:
+  using result_type =
+      typename detail::pipeline_result<typename source_type::value_type, typename source_type::error_type,
+                                       Stages...>::type;
+
+  constexpr deferred_result(Source source, stages_type stages)
+      : source_(std::forward<Source>(source)), stages_(std::move(stages)) {}
+
+  /// @brief Evaluates every stage in a single pass and returns the final result.
+  constexpr auto run() && -> result_type {
+    return detail::pipeline_runner<result_type, Stages...>::run(stages_, std::forward<Source>(source_));
+  }
+  constexpr operator result_type() && { return std::move(*this).run(); } // NOLINT(google-explicit-constructor)
+
+  template <typename... Other>
+  friend constexpr auto operator|(deferred_result &&lhs, pipeline<Other...> rhs)
+      -> deferred_result<Source, pipeline<Stages..., Other...>> {
+    return deferred_result<Source, pipeline<Stages..., Other...>>(
+        std::forward<Source>(lhs.source_), std::tuple_cat(std::move(lhs.stages_), std::move(rhs).stages()));
+  }
+};
+
+/// @brief Pipeline stage equivalent to result::map.
+template <typename F> constexpr auto map(F &&functor) -> pipeline<detail::map_stage<std::decay_t<F>>> {
+  using stage = detail::map_stage<std::decay_t<F>>;
+  return pipeline<stage>(std::make_tuple(stage{std::forward<F>(functor)}));
+}
+
+/// @brief Pipeline stage equivalent to result::and_then.
+template <typename F> constexpr auto and_then(F &&functor) -> pipeline<detail::and_then_stage<std::decay_t<F>>> {
+  using stage = detail::and_then_stage<std::decay_t<F>>;
+  return pipeline<stage>(std::make_tuple(stage{std::forward<F>(functor)}));
+}
+
+/// @brief Pipeline stage equivalent to result::map_err.
+template <typename F> constexpr auto map_err(F &&functor) -> pipeline<detail::map_err_stage<std::decay_t<F>>> {
+  using stage = detail::map_err_stage<std::decay_t<F>>;
+  return pipeline<stage>(std::make_tuple(stage{std::forward<F>(functor)}));
+}
+
+/// @brief Pipeline stage equivalent to result::or_else.
+template <typename F> constexpr auto or_else(F &&functor) -> pipeline<detail::or_else_stage<std::decay_t<F>>> {
+  using stage = detail::or_else_stage<std::decay_t<F>>;
+  return pipeline<stage>(std::make_tuple(stage{std::forward<F>(functor)}));
+}
+
+} // namespace res
+
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace res {
+
+namespace detail {
+
+inline constexpr std::size_t mask_word_bits = 64;
+
+inline auto popcount64(std::uint64_t word) noexcept -> unsigned {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_popcountll(word));
+#else
+  word = word - ((word >> 1U) & 0x5555555555555555ULL);
+  word = (word & 0x3333333333333333ULL) + ((word >> 2U) & 0x3333333333333333ULL);
+  word = (word + (word >> 4U)) & 0x0F0F0F0F0F0F0F0FULL;
+  return static_cast<unsigned>((word * 0x0101010101010101ULL) >> 56U);
+#endif
+}
+
+// Index of the lowest set bit, word must not be zero.
+inline auto countr_zero64(std::uint64_t word) noexcept -> unsigned {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_ctzll(word));
+#else
+  unsigned index = 0;
+  while ((word & 1U) == 0) {
+    word >>= 1U;
+    ++index;
+  }
+  return index;
+#endif
+}
+
+} // namespace detail
+
+/// @brief A sequence of result<T, E> stored column by column.
+/// @details Values and errors live in two separate arrays and the ok/err state of every element is one bit of a packed
+/// mask, so count_ok and first_err look at 64 elements per word with a popcount or a count of trailing zeros. No
+/// explicit SIMD is used. Both arrays are dense: every element has a T and an E slot, and the one that does not match
+/// its state is a default-constructed placeholder. Both types must therefore be default constructible, and each
+/// element costs sizeof(T) + sizeof(E) whatever its state.
+template <typename T, typename E> class result_vector {
+  static_assert(!std::is_void_v<T>, "result_vector requires a value type");
+  static_assert(std::is_default_constructible_v<T> && std::is_default_constructible_v<E>,
+                "result_vector requires default constructible value and error types");
+
+  std::vector<T> values_;
+  std::vector<E> errors_;
+  std::vector<std::uint64_t> ok_mask_;
+
+  template <typename Vector> class proxy;
+
+public:
+  using value_type = T;
+  using error_type = E;
+  using result_type = result<T, E>;
+  using reference = proxy<result_vector>;
+  using const_reference = proxy<const result_vector>;
+
+  result_vector() = default;
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t { return values_.size(); }
+  [[nodiscard]] auto empty() const noexcept -> bool { return values_.empty(); }
+
+  void reserve(std::size_t capacity) {
+    values_.reserve(capacity);
+    errors_.reserve(capacity);
+    ok_mask_.reserve(word_count(capacity));
+  }
+
+  void clear() noexcept {
+    values_.clear();
+    errors_.clear();
+    ok_mask_.clear();
+  }
+
+  void push_back(const result_type &element) {
+    if (element.is_ok()) {
+      push_ok(element.value());
+    } else {
+      push_err(element.error());
+    }
+  }
+  void push_back(result_type &&element) {
+    if (element.is_ok()) {
+      push_ok(std::move(element).value());
+    } else {
+      push_err(std::move(element).error());
+    }
+  }
+
+  /// @brief Appends an ok element without building a result first.
+  void push_ok(T value) {
+    values_.push_back(std::move(value));
+    complete_push([this] { errors_.emplace_back(); });
+    ok_mask_.back() |= bit(size() - 1);
+  }
+  /// @brief Appends an err element without building a result first.
+  void push_err(E error) {
+    values_.emplace_back();
+    complete_push([&] { errors_.push_back(std::move(error)); });
+  }
+
+  [[nodiscard]] auto is_ok(std::size_t index) const noexcept -> bool {
+    return (ok_mask_[index / detail::mask_word_bits] & bit(index)) != 0;
+  }
+
+  auto operator[](std::size_t index) noexcept -> reference { return reference(*this, index); }
+  auto operator[](std::size_t index) const noexcept -> const_reference { return const_reference(*this, index); }
+
+  /// @brief Bounds-checked element access, throws std::out_of_range (aborts without exceptions).
+  auto at(std::size_t index) -> reference {
+    check_index(index);
+    return (*this)[index];
+  }
+  [[nodiscard]] auto at(std::size_t index) const -> const_reference {
+    check_index(index);
+    return (*this)[index];
+  }
+
+  /// @brief Number of ok elements, counted a mask word at a time.
+  [[nodiscard]] auto count_ok() const noexcept -> std::size_t {
+    std::size_t count = 0;
+    for (const std::uint64_t word : ok_mask_) { count += detail::popcount64(word); }
+    return count;
+  }
+  [[nodiscard]] auto count_err() const noexcept -> std::size_t { return size() - count_ok(); }
+
+  [[nodiscard]] auto all_ok() const noexcept -> bool { return first_err() == size(); }
+
+  /// @brief Index of the first err element, or size() when every element is ok.
+  [[nodiscard]] auto first_err() const noexcept -> std::size_t {
+    for (std::size_t word = 0; word < ok_mask_.size(); ++word) {
+      const std::uint64_t errs = ~ok_mask_[word] & lane_mask(word);
+      if (errs != 0) { return word * detail::mask_word_bits + detail::countr_zero64(errs); }
+    }
+    return size();
+  }
+
+  /// @brief Splits the elements into the values of the ok ones and the errors of the err ones, both in order.
+  /// @details Uniform mask words are copied as whole ranges, only mixed words are split element by element.
+  [[nodiscard]] auto partition() const & -> std::pair<std::vector<T>, std::vector<E>> { return split(*this); }
+  [[nodiscard]] auto partition() && -> std::pair<std::vector<T>, std::vector<E>> {
+    auto parts = split(std::move(*this));
+    clear();
+    return parts;
+  }
+
+  /// @brief Applies functor to the value of every ok element, errors are carried over unchanged.
+  /// @details Mask words with every lane ok run as a plain loop over 64 contiguous values, which the compiler is free to
+  /// vectorize; mixed words visit only their set bits and all-err words are skipped.
+  template <typename F>
+  auto map(F &&functor) const -> result_vector<std::decay_t<std::invoke_result_t<F &, const T &>>, E> {
+    using mapped_type = std::decay_t<std::invoke_result_t<F &, const T &>>;
+    result_vector<mapped_type, E> mapped;
+    mapped.values_.resize(size());
+    mapped.errors_ = errors_;
+    mapped.ok_mask_ = ok_mask_;
+    for (std::size_t word = 0; word < ok_mask_.size(); ++word) {
+      const std::uint64_t oks = ok_mask_[word];
+      const std::size_t base = word * detail::mask_word_bits;
+      if (oks == ~std::uint64_t{0}) {
+        for (std::size_t lane = 0; lane < detail::mask_word_bits; ++lane) {
+          mapped.values_[base + lane] = functor(values_[base + lane]);
+        }
+      } else {
+        for (std::uint64_t rest = oks; rest != 0; rest &= rest - 1) {
+          const std::size_t index = base + detail::countr_zero64(rest);
+          mapped.values_[index] = functor(values_[index]);
+        }
+      }
+    }
+    return mapped;
+  }
+
+private:
+  template <typename, typename> friend class result_vector;
+
+  static auto word_count(std::size_t elements) noexcept -> std::size_t {
+    return (elements + detail::mask_word_bits - 1) / detail::mask_word_bits;
+  }
+  static auto bit(std::size_t index) noexcept -> std::uint64_t {
+    return std::uint64_t{1} << (index % detail::mask_word_bits);
+  }
+  // Bits of the given mask word that correspond to existing elements.
+  [[nodiscard]] auto lane_mask(std::size_t word) const noexcept -> std::uint64_t {
+    const std::size_t tail = size() - word * detail::mask_word_bits;
+    return tail >= detail::mask_word_bits ? ~std::uint64_t{0} : (std::uint64_t{1} << tail) - 1;
+  }
+
+  // Finishes an element whose value slot was just pushed by pushing its error slot and growing the mask. If either
+  // throws, the slots pushed so far are removed again, so the columns and the mask keep describing the same elements.
+  template <typename PushError> void complete_push(PushError push_error) {
+#if RESULT_HAS_EXCEPTIONS
+    try {
+      push_error();
+    } catch (...) {
+      values_.pop_back();
+      throw;
+    }
+    try {
+      grow_mask();
+    } catch (...) {
+      values_.pop_back();
+      errors_.pop_back();
+      throw;
+    }
+#else
+    push_error();
+    grow_mask();
+#endif
+  }
+  void grow_mask() {
+    if (ok_mask_.size() < word_count(size())) { ok_mask_.push_back(0); }
+  }
+  void check_index(std::size_t index) const {
+    if (index >= size()) { detail::throw_or_abort<std::out_of_range>("result_vector index out of range"); }
+  }
+
+  template <typename Self> static auto split(Self &&self) -> std::pair<std::vector<T>, std::vector<E>> {
+    auto append = [](auto &dest, auto &source, std::size_t first, std::size_t last) {
+      if constexpr (std::is_lvalue_reference_v<Self>) {
+        dest.insert(dest.end(), source.begin() + first, source.begin() + last);
+      } else {
+        dest.insert(dest.end(), std::make_move_iterator(source.begin() + first),
+                    std::make_move_iterator(source.begin() + last));
+      }
+    };
+    std::pair<std::vector<T>, std::vector<E>> parts;
+    const std::size_t oks = self.count_ok();
+    parts.first.reserve(oks);
+    parts.second.reserve(self.size() - oks);
+    for (std::size_t word = 0; word < self.ok_mask_.size(); ++word) {
+      const std::uint64_t lanes = self.lane_mask(word);
+      const std::uint64_t word_oks = self.ok_mask_[word];
+      const std::size_t base = word * detail::mask_word_bits;
+      const std::size_t last = std::min(base + detail::mask_word_bits, self.size());
+      if (word_oks == lanes) {
+        append(parts.first, self.values_, base, last);
+      } else if (word_oks == 0) {
+        append(parts.second, self.errors_, base, last);
+      } else {
+        for (std::size_t index = base; index < last; ++index) {
+          if (self.is_ok(index)) {
+            append(parts.first, self.values_, index, index + 1);
+          } else {
+            append(parts.second, self.errors_, index, index + 1);
+          }
+        }
+      }
+    }
+    return parts;
+  }
+
+  void set(std::size_t index, const result_type &element) {
+    std::uint64_t &word = ok_mask_[index / detail::mask_word_bits];
+    if (element.is_ok()) {
+      values_[index] = element.value();
+      errors_[index] = E();
+      word |= bit(index);
+    } else {
+      values_[index] = T();
+      errors_[index] = element.error();
+      word &= ~bit(index);
+    }
+  }
+};
+
+/// @brief Element handle of a result_vector with the observers of result<T, E>.
+/// @details Converts to result<T, E>, and the mutable flavour accepts result<T, E> assignments.
+template <typename T, typename E>
+template <typename Vector>
+class result_vector<T, E>::proxy {
+  Vector *vector_;
+  std::size_t index_;
+
+  friend class result_vector;
+  proxy(Vector &vector, std::size_t index) noexcept : vector_(&vector), index_(index) {}
+
+public:
+  proxy(const proxy &) = default;
+
+  [[nodiscard]] auto is_ok() const noexcept -> bool { return vector_->is_ok(index_); }
+  [[nodiscard]] auto is_err() const noexcept -> bool { return !is_ok(); }
+  explicit operator bool() const noexcept { return is_ok(); }
+
+  [[nodiscard]] auto value() const -> decltype(vector_->values_[index_]) {
+    if constexpr (detail::checked_access) {
+      if (RESULT_UNLIKELY(!is_ok())) { detail::bad_result_access("value() called on result with error"); }
+    }
+    return vector_->values_[index_];
+  }
+  [[nodiscard]] auto error() const -> decltype(vector_->errors_[index_]) {
+    if constexpr (detail::checked_access) {
+      if (RESULT_UNLIKELY(is_ok())) { detail::bad_result_access("error() called on result with value"); }
+    }
+    return vector_->errors_[index_];
+  }
+
+  operator result_type() const { // NOLINT(google-explicit-constructor)
+    if (is_ok()) { return detail::result_access::make_ok<result_type>(vector_->values_[index_]); }
+    return detail::result_access::make_err<result_type>(vector_->errors_[index_]);
+  }
+
+  template <typename V = Vector, typename = std::enable_if_t<!std::is_const_v<V>>>
+  auto operator=(const result_type &element) const -> const proxy & {
+    vector_->set(index_, element);
+    return *this;
+  }
+  // Assigns the referenced element, like assigning through a reference, rather than rebinding the proxy.
+  auto operator=(const proxy &other) const -> const proxy & { return *this = static_cast<result_type>(other); }
+};
+
+} // namespace res
+
+
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace res {
+
+namespace detail {
+
+// Marks that collect and traverse should gather values into a std::vector.
+struct default_container {};
+
+template <typename Container, typename T>
+using collect_container_t = std::conditional_t<std::is_same_v<Container, default_container>, std::vector<T>, Container>;
+
+template <typename Range> using range_reference_t = decltype(*std::begin(std::declval<Range &>()));
+
+// Elements of rvalue ranges are handed out as rvalues so their values can be moved out.
+template <typename Range>
+using range_forward_t = std::conditional_t<std::is_lvalue_reference_v<Range>, range_reference_t<Range>,
+                                           std::remove_reference_t<range_reference_t<Range>> &&>;
+
+template <typename Container, typename = void> struct has_reserve : std::false_type {};
+template <typename Container>
+struct has_reserve<Container, std::void_t<decltype(std::declval<Container &>().reserve(std::size_t{}))>>
+    : std::true_type {};
+
+template <typename Range, typename = void> struct is_sized_range : std::false_type {};
+template <typename Range>
+struct is_sized_range<Range, std::void_t<decltype(std::size(std::declval<Range &>()))>> : std::true_type {};
+
+template <typename Container, typename Range> void reserve_for(Container &container, Range &range) {
+  if constexpr (has_reserve<Container>::value && is_sized_range<Range>::value) {
+    container.reserve(static_cast<std::size_t>(std::size(range)));
+  }
+}
+
+template <typename Container, typename = void> struct has_push_back : std::false_type {};
+template <typename Container>
+struct has_push_back<Container, std::void_t<decltype(std::declval<Container &>().push_back(
+                                    std::declval<typename Container::value_type>()))>> : std::true_type {};
+
+// Sequence containers take push_back, which unlike insert at end() needs no position handling.
+template <typename Container, typename V> void append(Container &container, V &&value) {
+  if constexpr (has_push_back<Container>::value) {
+    container.push_back(std::forward<V>(value));
+  } else {
+    container.insert(container.end(), std::forward<V>(value));
+  }
+}
+
+/// @brief Gathers the values of the results project yields for every element, stopping at the first error.
+template <typename Container, typename R, typename Range, typename Project>
+auto collect_with(Range &&range, Project &&project) -> R {
+  Container values;
+  reserve_for(values, range);
+  for (auto &&element : range) {
+    decltype(auto) projected = project(static_cast<range_forward_t<Range>>(element));
+    if (!projected.is_ok()) {
+      return result_access::make_err<R>(std::forward<decltype(projected)>(projected).error());
+    }
+    append(values, std::forward<decltype(projected)>(projected).value());
+  }
+  return result_access::make_ok<R>(std::move(values));
+}
+
+} // namespace detail
+
+/// @brief Turns a range of result<T, E> into a result holding a container of every value, or the first error.
+/// @details Iteration stops at the first error. The container defaults to std::vector<T>; any container with
+/// `push_back` or `insert(end(), value)` works and it is reserved up front when the range is sized. Values are moved
+/// out of rvalue ranges.
+template <typename Container = detail::default_container, typename Range,
+          typename Element = std::decay_t<detail::range_reference_t<Range>>>
+auto collect(Range &&range)
+    -> result<detail::collect_container_t<Container, typename Element::value_type>, typename Element::error_type> {
+  static_assert(detail::is_result_v<Element>, "collect requires a range of results");
+  using output =
+      result<detail::collect_container_t<Container, typename Element::value_type>, typename Element::error_type>;
+  return detail::collect_with<typename output::value_type, output>(
+      std::forward<Range>(range),
+      [](detail::range_forward_t<Range> element) -> detail::range_forward_t<Range> {
+        return static_cast<detail::range_forward_t<Range>>(element);
+      });
+}
+
+/// @brief Applies a fallible functor to every element of a range and collects the values it returns.
+/// @details Equivalent to collecting the results of functor over the range, without materializing them: iteration
+/// stops at the first error and the container defaults to std::vector. Elements of rvalue ranges are passed to
+/// functor as rvalues. A lambda or function object is inlined into the loop, a function name is called through a
+/// pointer.
+template <typename Container = detail::default_container, typename Range, typename F,
+          typename Mapped = std::decay_t<std::invoke_result_t<F &, detail::range_forward_t<Range>>>>
+auto traverse(Range &&range, F &&functor)
+    -> result<detail::collect_container_t<Container, typename Mapped::value_type>, typename Mapped::error_type> {
+  static_assert(detail::is_result_v<Mapped>, "traverse requires a functor that returns a result");
+  using output =
+      result<detail::collect_container_t<Container, typename Mapped::value_type>, typename Mapped::error_type>;
+  return detail::collect_with<typename output::value_type, output>(std::forward<Range>(range), functor);
+}
+
+} // namespace res
+
+
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+
+namespace res {
+
+class error_code;
+class formatted_error;
+
+/// @brief A string interned for the rest of the program by intern_text, usable as an error format argument.
+class interned_text {
+  std::string_view text_;
+
+  friend auto intern_text(std::string_view text) -> interned_text;
+  constexpr explicit interned_text(std::string_view text) noexcept : text_(text) {}
+
+public:
+  [[nodiscard]] constexpr auto view() const noexcept -> std::string_view { return text_; }
+};
+
+namespace detail {
+
+// Format arguments are captured without owning anything, so strings are only accepted when they live until the end of
+// the program: string literals, which are const char arrays, and interned_text. Arg is the forwarded argument type, so
+// a non-const char array such as a snprintf buffer is told apart from a literal and rejected, as are std::string,
+// std::string_view and char pointers. A const char array with automatic storage cannot be told apart from a literal
+// and must not be passed.
+template <typename Arg, typename V = std::remove_reference_t<Arg>>
+inline constexpr bool is_error_arg_v =
+    std::is_array_v<V> ? std::is_same_v<std::remove_extent_t<V>, const char>
+                       : std::is_arithmetic_v<std::remove_cv_t<V>> || std::is_enum_v<V> ||
+                             std::is_same_v<std::remove_cv_t<V>, interned_text>;
+
+template <typename... Args> using enable_if_error_args_t = std::enable_if_t<(is_error_arg_v<Args> && ...)>;
+
+} // namespace detail
+
+/// @brief Static description of an error: its category and a message template with `{}` placeholders.
+/// @details Descriptors are meant to be namespace-scope constants, so their address identifies the error:
+/// `inline constexpr res::error_descriptor cache_miss{"cache", "key {} not found in shard {}"};`. Calling a
+/// descriptor captures format arguments into a formatted_error, e.g. `res::err(cache_miss(key, shard))`.
+struct error_descriptor {
+  std::string_view category;
+  std::string_view format;
+
+  template <typename... Args, typename = detail::enable_if_error_args_t<Args...>>
+  constexpr auto operator()(Args &&...args) const noexcept -> formatted_error;
+};
+
+/// @brief An error that is a single pointer to its error_descriptor.
+/// @details Copying, comparing and returning it costs as much as a pointer, and nothing is allocated until the message
+/// is rendered. Codes compare equal when they refer to the same descriptor.
+class error_code {
+  const error_descriptor *descriptor_;
+
+public:
+  constexpr error_code(const error_descriptor &descriptor) noexcept // NOLINT(google-explicit-constructor)
+      : descriptor_(&descriptor) {}
+
+  [[nodiscard]] constexpr auto descriptor() const noexcept -> const error_descriptor & { return *descriptor_; }
+  [[nodiscard]] constexpr auto category() const noexcept -> std::string_view { return descriptor_->category; }
+  /// @brief The message template, placeholders included.
+  [[nodiscard]] constexpr auto format() const noexcept -> std::string_view { return descriptor_->format; }
+  [[nodiscard]] auto message() const -> std::string { return std::string(descriptor_->format); }
+
+  friend constexpr auto operator==(error_code lhs, error_code rhs) noexcept -> bool {
+    return lhs.descriptor_ == rhs.descriptor_;
+  }
+  friend constexpr auto operator!=(error_code lhs, error_code rhs) noexcept -> bool { return !(lhs == rhs); }
+  friend auto operator<<(std::ostream &stream, error_code code) -> std::ostream & {
+    return stream << code.category() << ": " << code.format();
+  }
+};
+
+static_assert(sizeof(error_code) == sizeof(void *));
+
+namespace detail {
+
+/// @brief Holds a spin lock for the intern tables, which are touched rarely and briefly; a spin lock keeps <mutex> out
+/// of result.h.
+class intern_lock {
+  std::atomic_flag &flag_;
+
+public:
+  explicit intern_lock(std::atomic_flag &flag) noexcept : flag_(flag) {
+    while (flag_.test_and_set(std::memory_order_acquire)) {}
+  }
+  intern_lock(const intern_lock &) = delete;
+  auto operator=(const intern_lock &) -> intern_lock & = delete;
+  ~intern_lock() { flag_.clear(std::memory_order_release); }
+};
+
+} // namespace detail
+
+/// @brief Interns descriptors created at run time, e.g. from configuration, so they can be used as error codes.
+/// @details Interning the same category and format twice yields the same code. The strings are copied once into the
+/// table and live until the end of the program. Interning takes a lock and allocates; codes made from it do not.
+inline auto intern_error(std::string_view category, std::string_view format) -> error_code {
+  struct entry {
+    std::string category;
+    std::string format;
+    error_descriptor descriptor;
+  };
+  static std::atomic_flag busy = ATOMIC_FLAG_INIT;
+  static std::deque<entry> table;
+
+  const detail::intern_lock lock(busy);
+  for (const auto &existing : table) {
+    if (existing.category == category && existing.format == format) { return existing.descriptor; }
+  }
+  auto &added = table.emplace_back(entry{std::string(category), std::string(format), {}});
+  added.descriptor = error_descriptor{added.category, added.format};
+  return added.descriptor;
+}
+
+/// @brief Interns a string built at run time, e.g. a key or a file name, so it can be a format argument.
+/// @details The string is copied once into a table and lives until the end of the program, so interning suits values
+/// from a bounded set; interning takes a lock and may allocate.
+inline auto intern_text(std::string_view text) -> interned_text {
+  static std::atomic_flag busy = ATOMIC_FLAG_INIT;
+  static std::unordered_set<std::string> table;
+
+  const detail::intern_lock lock(busy);
+  return interned_text(*table.emplace(text).first);
+}
+
+namespace detail {
+
+/// @brief A format argument captured by value in 16 bytes.
+/// @details Strings are captured as views, which is why only string literals and interned_text are accepted (see
+/// is_error_arg_v).
+class error_arg {
+  enum class kind : std::uint8_t { none, signed_integer, unsigned_integer, floating, text, boolean };
+
+  union {
+    std::int64_t signed_;
+    std::uint64_t unsigned_;
+    double floating_;
+    const char *text_;
+  };
+  std::uint32_t size_ = 0;
+  kind kind_ = kind::none;
+
+public:
+  constexpr error_arg() noexcept : signed_(0) {}
+
+  template <typename V> constexpr explicit error_arg(const V &value) noexcept : signed_(0) {
+    if constexpr (std::is_same_v<V, bool>) {
+      unsigned_ = value ? 1 : 0;
+      kind_ = kind::boolean;
+    } else if constexpr (std::is_integral_v<V> && std::is_signed_v<V>) {
+      signed_ = value;
+      kind_ = kind::signed_integer;
+    } else if constexpr (std::is_integral_v<V>) {
+      unsigned_ = value;
+      kind_ = kind::unsigned_integer;
+    } else if constexpr (std::is_enum_v<V>) {
+      signed_ = static_cast<std::int64_t>(value);
+      kind_ = kind::signed_integer;
+    } else if constexpr (std::is_floating_point_v<V>) {
+      floating_ = static_cast<double>(value);
+      kind_ = kind::floating;
+    } else {
+      static_assert(is_error_arg_v<const V &>, "format arguments are numbers, enums, string literals or interned_text");
+      std::string_view text;
+      if constexpr (std::is_same_v<V, interned_text>) {
+        text = value.view();
+      } else {
+        text = value;
+      }
+      text_ = text.data();
+      size_ = static_cast<std::uint32_t>(text.size());
+      kind_ = kind::text;
+    }
+  }
+
+  void append_to(std::string &out) const {
+    std::array<char, 32> buffer{};
+    switch (kind_) {
+    case kind::none: break;
+    case kind::signed_integer: {
+      const auto end = std::to_chars(buffer.data(), buffer.data() + buffer.size(), signed_).ptr;
+      out.append(buffer.data(), end);
+      break;
+    }
+    case kind::unsigned_integer: {
+      const auto end = std::to_chars(buffer.data(), buffer.data() + buffer.size(), unsigned_).ptr;
+      out.append(buffer.data(), end);
+      break;
+    }
+    case kind::floating: {
+      const int written = std::snprintf(buffer.data(), buffer.size(), "%g", floating_);
+      out.append(buffer.data(), static_cast<std::size_t>(written));
+      break;
+    }
+    case kind::text: out.append(text_, size_); break;
+    case kind::boolean: out.append(unsigned_ != 0 ? "true" : "false"); break;
+    }
+  }
+};
+
+static_assert(sizeof(error_arg) == 16);
+
+} // namespace detail
+
+/// @brief An error_code with up to max_args format arguments captured by value.
+/// @details It is trivially copyable and never allocates; the message is only rendered by message() or when streamed,
+/// so failure paths that are counted or retried rather than logged never pay for formatting. Placeholders without a
+/// matching argument are rendered as `{}`, and `{{` and `}}` stand for literal braces.
+class formatted_error {
+public:
+  static constexpr std::size_t max_args = 4;
+
+private:
+  error_code code_;
+  std::uint8_t count_ = 0;
+  std::array<detail::error_arg, max_args> args_{};
+
+public:
+  constexpr formatted_error(error_code code) noexcept : code_(code) {} // NOLINT(google-explicit-constructor)
+
+  template <typename... Args, typename = detail::enable_if_error_args_t<Args...>>
+  constexpr formatted_error(error_code code, Args &&...args) noexcept
+      : code_(code), count_(sizeof...(Args)), args_{detail::error_arg(args)...} {
+    static_assert(sizeof...(Args) <= max_args, "too many error format arguments");
+  }
+
+  [[nodiscard]] constexpr auto code() const noexcept -> error_code { return code_; }
+  [[nodiscard]] constexpr auto category() const noexcept -> std::string_view { return code_.category(); }
+
+  /// @brief Renders the message template with the captured arguments.
+  [[nodiscard]] auto message() const -> std::string {
+    std::string out;
+    const std::string_view format = code_.format();
+    out.reserve(format.size() + 8 * count_);
+    std::size_t next = 0;
+    for (std::size_t pos = 0; pos < format.size(); ++pos) {
+      const char chr = format[pos];
+      const bool doubled = pos + 1 < format.size() && format[pos + 1] == chr;
+      if ((chr == '{' || chr == '}') && doubled) {
+        out.push_back(chr);
+        ++pos;
+      } else if (chr == '{' && pos + 1 < format.size() && format[pos + 1] == '}') {
+        if (next < count_) {
+          args_[next++].append_to(out);
+        } else {
+          out.append("{}");
+        }
+        ++pos;
+      } else {
+        out.push_back(chr);
+      }
+    }
+    return out;
+  }
+
+  /// @brief Errors compare by code, the arguments are not compared.
+  friend constexpr auto operator==(const formatted_error &lhs, error_code rhs) noexcept -> bool {
+    return lhs.code_ == rhs;
+  }
+  friend constexpr auto operator!=(const formatted_error &lhs, error_code rhs) noexcept -> bool {
+    return !(lhs == rhs);
+  }
+  friend auto operator<<(std::ostream &stream, const formatted_error &error) -> std::ostream & {
+    return stream << error.category() << ": " << error.message();
+  }
+};
+
+template <typename... Args, typename>
+constexpr auto error_descriptor::operator()(Args &&...args) const noexcept -> formatted_error {
+  return formatted_error(*this, std::forward<Args>(args)...);
+}
+
+} // namespace res
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+
+namespace res {
+
+namespace detail {
+
+class context_chunk;
+
+/// @brief One context frame of a chain, allocated in a context_chunk.
+/// @details Frames are immutable once linked and shared between copies of a context_error, so they are reference
+/// counted: by every context_error whose chain starts at them and by the frame in front of them.
+struct context_frame {
+  std::atomic<std::uint32_t> refs{1};
+  context_frame *next = nullptr;
+  context_chunk *chunk = nullptr;
+  void (*render)(const context_frame &frame, std::ostream &stream) = nullptr;
+  void (*destroy)(context_frame &frame) = nullptr;
+};
+
+struct text_frame : context_frame {
+  std::size_t size = 0;
+
+  // The characters are stored right after the frame.
+  [[nodiscard]] auto characters() noexcept -> char * {
+    return reinterpret_cast<char *>(this + 1); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  }
+  [[nodiscard]] auto text() const noexcept -> std::string_view {
+    return {reinterpret_cast<const char *>(this + 1), size}; // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  }
+};
+
+template <typename F> struct lazy_frame : context_frame {
+  F functor;
+
+  explicit lazy_frame(F &&function) : functor(std::move(function)) {}
+};
+
+/// @brief A block of memory that context frames are bump allocated from.
+/// @details While the chunk is the current one of its arena, its owner thread counts allocations and releases in plain
+/// integers and holds a large credit on live_; only frames released on other threads touch live_ atomically. Once the
+/// owner retires the chunk it returns the unused credit, and live_ becomes the number of frames still alive, so the
+/// chunk is freed by whichever thread releases the last of them.
+class alignas(std::max_align_t) context_chunk {
+  static constexpr std::uint32_t owner_credit = std::uint32_t{1} << 31U;
+
+  std::atomic<std::uint32_t> live_;
+  std::uint32_t allocated_ = 0;
+  std::uint32_t returned_ = 0;
+  std::size_t capacity_;
+  std::size_t used_ = 0;
+
+  context_chunk(std::size_t capacity, std::uint32_t live) noexcept : live_(live), capacity_(capacity) {}
+
+  [[nodiscard]] auto storage() noexcept -> unsigned char * {
+    return reinterpret_cast<unsigned char *>(this + 1); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  }
+
+  void free() noexcept {
+    this->~context_chunk();
+    ::operator delete(static_cast<void *>(this));
+  }
+
+public:
+  /// @brief A chunk for an arena to allocate from.
+  static auto make_current(std::size_t capacity) -> context_chunk * {
+    return ::new (::operator new(sizeof(context_chunk) + capacity)) context_chunk(capacity, owner_credit);
+  }
+  /// @brief A chunk that holds a single frame and is freed with it.
+  static auto make_single(std::size_t capacity) -> context_chunk * {
+    return ::new (::operator new(sizeof(context_chunk) + capacity)) context_chunk(capacity, 1);
+  }
+
+  /// @brief Returns size bytes aligned to align, or nullptr when the chunk is full.
+  auto allocate(std::size_t size, std::size_t align) noexcept -> void * {
+    const std::size_t begin = (used_ + align - 1) & ~(align - 1);
+    if (begin + size > capacity_) { return nullptr; }
+    used_ = begin + size;
+    ++allocated_;
+    return storage() + begin;
+  }
+
+  /// @brief Reuses the current chunk from the start if every frame allocated from it has been released.
+  void try_rewind() noexcept {
+    if (live_.load(std::memory_order_acquire) + allocated_ - returned_ != owner_credit) { return; }
+    live_.store(owner_credit, std::memory_order_relaxed);
+    allocated_ = 0;
+    returned_ = 0;
+    used_ = 0;
+  }
+
+  /// @brief Releases a frame of the current chunk on the owner thread.
+  void release_local() noexcept { ++returned_; }
+  /// @brief Releases a frame of a chunk that is not current, or from another thread.
+  void release_shared() noexcept {
+    if (live_.fetch_sub(1, std::memory_order_acq_rel) == 1) { free(); }
+  }
+  /// @brief Called by the owner when the chunk stops being current.
+  void retire() noexcept {
+    const std::uint32_t unused_credit = owner_credit - (allocated_ - returned_);
+    if (live_.fetch_sub(unused_credit, std::memory_order_acq_rel) == unused_credit) { free(); }
+  }
+};
+
+// Storage starts right after the header, aligned like operator new memory.
+static_assert(sizeof(context_chunk) % alignof(std::max_align_t) == 0);
+
+/// @brief Thread-local bump allocator for context frames.
+/// @details Allocation is a pointer bump in the current chunk. Once every frame of the current chunk has been released
+/// it is reused from the start, so a thread that keeps creating and dropping errors cycles through a single chunk
+/// without any atomic read-modify-write.
+class context_arena {
+  context_chunk *current_ = nullptr;
+
+public:
+  static constexpr std::size_t chunk_size = 4096;
+
+  context_arena() = default;
+  context_arena(const context_arena &) = delete;
+  auto operator=(const context_arena &) -> context_arena & = delete;
+  context_arena(context_arena &&) = delete;
+  auto operator=(context_arena &&) -> context_arena & = delete;
+  ~context_arena() {
+    if (current_ != nullptr) { std::exchange(current_, nullptr)->retire(); }
+  }
+
+  static auto local() -> context_arena & {
+    thread_local context_arena arena;
+    return arena;
+  }
+
+  auto allocate(std::size_t size, std::size_t align, context_chunk *&chunk) -> void * {
+    if (current_ != nullptr) {
+      current_->try_rewind();
+      if (void *memory = current_->allocate(size, align)) {
+        chunk = current_;
+        return memory;
+      }
+    }
+    if (size + align > chunk_size / 4) {
+      chunk = context_chunk::make_single(size + align);
+      return chunk->allocate(size, align);
+    }
+    if (current_ != nullptr) { current_->retire(); }
+    current_ = context_chunk::make_current(chunk_size);
+    chunk = current_;
+    return current_->allocate(size, align);
+  }
+
+  void release(context_chunk &chunk) noexcept {
+    if (&chunk == current_) {
+      chunk.release_local();
+    } else {
+      chunk.release_shared();
+    }
+  }
+};
+
+inline void release_context(context_frame *frame) noexcept {
+  // A frame whose count is one has no other owner that could add a reference concurrently, so it skips the atomic
+  // decrement; chains are rarely shared.
+  while (frame != nullptr && (frame->refs.load(std::memory_order_acquire) == 1 ||
+                              frame->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)) {
+    context_frame *next = frame->next;
+    context_chunk &chunk = *frame->chunk;
+    if (frame->destroy != nullptr) { frame->destroy(*frame); }
+    context_arena::local().release(chunk);
+    frame = next;
+  }
+}
+
+} // namespace detail
+
+/// @brief An error of type E with a chain of context frames describing what was being done when it happened.
+/// @details Produced by result::context and result::with_context. Frames live in a thread-local arena and are shared
+/// between copies, so adding context costs a pointer bump and copying a context_error costs a reference count. The
+/// chain is only turned into text by message() or operator<<, outermost context first:
+/// `loading config: parsing line 3: unexpected token`. Rendering requires E to be streamable.
+template <typename E> class context_error {
+  E error_;
+  detail::context_frame *head_ = nullptr;
+
+public:
+  using error_type = E;
+
+  explicit context_error(E error) : error_(std::move(error)) {}
+
+  context_error(const context_error &other) : error_(other.error_), head_(other.head_) {
+    if (head_ != nullptr) { head_->refs.fetch_add(1, std::memory_order_relaxed); }
+  }
+  context_error(context_error &&other) noexcept(std::is_nothrow_move_constructible_v<E>)
+      : error_(std::move(other.error_)), head_(std::exchange(other.head_, nullptr)) {}
+  auto operator=(const context_error &other) -> context_error & {
+    if (this != &other) { *this = context_error(other); }
+    return *this;
+  }
+  auto operator=(context_error &&other) noexcept(std::is_nothrow_move_assignable_v<E>) -> context_error & {
+    if (this != &other) {
+      error_ = std::move(other.error_);
+      detail::release_context(std::exchange(head_, std::exchange(other.head_, nullptr)));
+    }
+    return *this;
+  }
+  ~context_error() { detail::release_context(head_); }
+
+  /// @brief The error the context was attached to.
+  [[nodiscard]] auto error() const & noexcept -> const E & { return error_; }
+  [[nodiscard]] auto error() && noexcept -> E && { return std::move(error_); }
+
+  /// @brief The number of context frames in the chain.
+  [[nodiscard]] auto depth() const noexcept -> std::size_t {
+    std::size_t depth = 0;
+    for (const auto *frame = head_; frame != nullptr; frame = frame->next) { ++depth; }
+    return depth;
+  }
+
+  /// @brief Adds text, copied into the arena, as the outermost context.
+  auto add_context(std::string_view text) && -> context_error && {
+    detail::context_chunk *chunk = nullptr;
+    void *memory = detail::context_arena::local().allocate(sizeof(detail::text_frame) + text.size(),
+                                                           alignof(detail::text_frame), chunk);
+    auto *frame = ::new (memory) detail::text_frame();
+    frame->size = text.size();
+    if (!text.empty()) { std::memcpy(frame->characters(), text.data(), text.size()); }
+    frame->render = [](const detail::context_frame &self, std::ostream &stream) {
+      stream << static_cast<const detail::text_frame &>(self).text();
+    };
+    link(*frame, chunk);
+    return std::move(*this);
+  }
+
+  /// @brief Adds the text functor() returns when the error is rendered as the outermost context.
+  template <typename F> auto add_lazy_context(F &&functor) && -> context_error && {
+    using frame_type = detail::lazy_frame<std::decay_t<F>>;
+    static_assert(alignof(frame_type) <= alignof(std::max_align_t), "over-aligned context functors are not supported");
+    detail::context_chunk *chunk = nullptr;
+    void *memory = detail::context_arena::local().allocate(sizeof(frame_type), alignof(frame_type), chunk);
+    auto *frame = ::new (memory) frame_type(std::decay_t<F>(std::forward<F>(functor)));
+    frame->render = [](const detail::context_frame &self, std::ostream &stream) {
+      stream << static_cast<const frame_type &>(self).functor();
+    };
+    if constexpr (!std::is_trivially_destructible_v<frame_type>) {
+      frame->destroy = [](detail::context_frame &self) { static_cast<frame_type &>(self).~frame_type(); };
+    }
+    link(*frame, chunk);
+    return std::move(*this);
+  }
+
+  /// @brief Renders the context chain followed by the error.
+  [[nodiscard]] auto message() const -> std::string {
+    std::ostringstream stream;
+    stream << *this;
+    return stream.str();
+  }
+
+  friend auto operator<<(std::ostream &stream, const context_error &error) -> std::ostream & {
+    for (const auto *frame = error.head_; frame != nullptr; frame = frame->next) {
+      frame->render(*frame, stream);
+      stream << ": ";
+    }
+    return stream << error.error_;
+  }
+
+private:
+  void link(detail::context_frame &frame, detail::context_chunk *chunk) noexcept {
+    frame.chunk = chunk;
+    frame.next = head_;
+    head_ = &frame;
+  }
+};
+
+namespace detail {
+
+// Adding context only happens on failure, so it is kept out of line for the success path of callers to inline.
+template <typename R, typename E> RESULT_NOINLINE auto add_text_context(E &&error, std::string_view text) -> R {
+  return result_access::make_err<R>(context_error_t<std::decay_t<E>>(std::forward<E>(error)).add_context(text));
+}
+
+template <typename R, typename E, typename F> RESULT_NOINLINE auto add_lazy_context(E &&error, F &&functor) -> R {
+  return result_access::make_err<R>(
+      context_error_t<std::decay_t<E>>(std::forward<E>(error)).add_lazy_context(std::forward<F>(functor)));
+}
+
+} // namespace detail
+
+} // namespace res
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace res {
+
+/// @brief Customization point describing how a value or error of type T is encoded by res::serialize.
+/// @details A specialization provides:
+/// - `using view_type`: what result_view hands out for T, typically a non-owning view into the buffer. T must be
+///   constructible from it for deserialize and result_view::to_result.
+/// - `static auto size(const T &) noexcept -> std::size_t`: the number of payload bytes.
+/// - `static void write(const T &, std::byte *out) noexcept`: writes exactly size() bytes.
+/// - `static auto fits(std::size_t size) noexcept -> bool`: whether a payload of size bytes can hold a T.
+/// - `static auto read(const std::byte *data, std::size_t size) noexcept -> view_type`: reads a payload that fits.
+///
+/// Built-in specializations cover trivially copyable types other than pointers, stored in host representation, and
+/// std::string and std::string_view, read back as std::string_view. Addresses mean nothing in another process, so
+/// error_code, formatted_error and interned_text are not covered; a trivially copyable type of your own that holds a
+/// pointer must not cross a process boundary either, unless it specializes wire_traits to encode what it points to.
+template <typename T, typename = void> struct wire_traits {};
+
+namespace detail {
+
+// Trivially copyable library types whose representation is an address.
+template <typename T>
+inline constexpr bool holds_address_v =
+    std::is_pointer_v<T> || std::is_member_pointer_v<T> || std::is_same_v<T, error_code> ||
+    std::is_same_v<T, formatted_error> || std::is_same_v<T, interned_text>;
+
+} // namespace detail
+
+template <typename T>
+struct wire_traits<T, std::enable_if_t<std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T> &&
+                                       !detail::holds_address_v<T> && !std::is_same_v<T, std::string_view>>> {
+  using view_type = T;
+
+  static auto size(const T & /*value*/) noexcept -> std::size_t { return sizeof(T); }
+  static void write(const T &value, std::byte *out) noexcept { std::memcpy(out, &value, sizeof(T)); }
+  static auto fits(std::size_t size) noexcept -> bool { return size == sizeof(T); }
+  // Payloads are not aligned in the buffer, so they are copied out rather than referenced.
+  static auto read(const std::byte *data, std::size_t /*size*/) noexcept -> T {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+  }
+};
+
+template <typename T>
+struct wire_traits<T, std::enable_if_t<std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>>> {
+  using view_type = std::string_view;
+
+  static auto size(std::string_view value) noexcept -> std::size_t { return value.size(); }
+  static void write(std::string_view value, std::byte *out) noexcept {
+    if (!value.empty()) { std::memcpy(out, value.data(), value.size()); }
+  }
+  static auto fits(std::size_t /*size*/) noexcept -> bool { return true; }
+  static auto read(const std::byte *data, std::size_t size) noexcept -> std::string_view {
+    return {reinterpret_cast<const char *>(data), size}; // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  }
+};
+
+/// @brief Why a buffer does not hold a serialized result.
+enum class wire_errc : std::uint8_t {
+  truncated,    // the buffer ends inside a record
+  bad_tag,      // the record is neither a value nor an error
+  bad_payload,  // the payload size does not fit the value or error type
+};
+
+namespace detail {
+
+// Record layout: a tag byte, the payload size as 4 little-endian bytes, then the payload. The size is always present
+// so readers can skip records without knowing their types.
+inline constexpr std::size_t wire_header_size = 5;
+inline constexpr std::size_t wire_max_payload = std::numeric_limits<std::uint32_t>::max();
+inline constexpr std::byte wire_ok_tag{0};
+inline constexpr std::byte wire_err_tag{1};
+
+template <typename T> struct wire_payload {
+  using traits = wire_traits<T>;
+  using view_type = typename traits::view_type;
+};
+// result<void, E> has no value payload.
+template <> struct wire_payload<void> {
+  struct traits {
+    static auto fits(std::size_t size) noexcept -> bool { return size == 0; }
+  };
+  using view_type = void;
+};
+
+// A larger payload would be written with a truncated size and misparsed, so it is reported as misuse instead.
+inline auto wire_record_size(std::size_t size) noexcept -> std::size_t {
+  if (RESULT_UNLIKELY(size > wire_max_payload)) { report_misuse("serialized payload exceeds the 4 GiB record limit"); }
+  return wire_header_size + size;
+}
+
+inline auto write_wire_header(std::byte *out, std::byte tag, std::size_t size) noexcept -> std::byte * {
+  wire_record_size(size);
+  out[0] = tag;
+  for (std::size_t index = 0; index < 4; ++index) { out[1 + index] = static_cast<std::byte>(size >> (8 * index)); }
+  return out + wire_header_size;
+}
+
+inline auto read_wire_size(const std::byte *data) noexcept -> std::size_t {
+  std::size_t size = 0;
+  for (std::size_t index = 0; index < 4; ++index) {
+    size |= std::to_integer<std::size_t>(data[1 + index]) << (8 * index);
+  }
+  return size;
+}
+
+} // namespace detail
+
+/// @brief Number of bytes serialize writes for value. A payload above 4 GiB is reported as misuse, which aborts.
+template <typename T, typename E> auto serialized_size(const result<T, E> &value) noexcept -> std::size_t {
+  if (value.is_ok()) {
+    if constexpr (std::is_void_v<T>) {
+      return detail::wire_header_size;
+    } else {
+      return detail::wire_record_size(wire_traits<std::decay_t<T>>::size(value.value_unchecked()));
+    }
+  }
+  return detail::wire_record_size(wire_traits<E>::size(value.error_unchecked()));
+}
+
+/// @brief Writes value to out, which must have room for serialized_size(value) bytes, and returns the end of the
+/// record. Payloads are limited to 4 GiB; a larger one is reported as misuse, which aborts.
+template <typename T, typename E> auto serialize(const result<T, E> &value, std::byte *out) noexcept -> std::byte * {
+  if (value.is_ok()) {
+    if constexpr (std::is_void_v<T>) {
+      return detail::write_wire_header(out, detail::wire_ok_tag, 0);
+    } else {
+      using traits = wire_traits<std::decay_t<T>>;
+      const std::size_t size = traits::size(value.value_unchecked());
+      traits::write(value.value_unchecked(), detail::write_wire_header(out, detail::wire_ok_tag, size));
+      return out + detail::wire_header_size + size;
+    }
+  }
+  const std::size_t size = wire_traits<E>::size(value.error_unchecked());
+  wire_traits<E>::write(value.error_unchecked(), detail::write_wire_header(out, detail::wire_err_tag, size));
+  return out + detail::wire_header_size + size;
+}
+
+/// @brief Appends the serialized value to out.
+template <typename T, typename E> void serialize(const result<T, E> &value, std::vector<std::byte> &out) {
+  const std::size_t offset = out.size();
+  out.resize(offset + serialized_size(value));
+  serialize(value, out.data() + offset);
+}
+
+/// @brief A serialized result<T, E> read in place from a buffer, e.g. a mapped file or a shared-memory queue.
+/// @details Nothing is copied or allocated: value() and error() return the view_type of wire_traits, which for strings
+/// points into the buffer, so the buffer must outlive the view. to_result() materializes an owning result.
+template <typename T, typename E> class result_view {
+  using value_payload = detail::wire_payload<std::conditional_t<std::is_void_v<T>, void, std::decay_t<T>>>;
+  using error_traits = wire_traits<E>;
+
+  const std::byte *payload_;
+  std::size_t size_;
+  bool ok_;
+
+  result_view(const std::byte *payload, std::size_t size, bool ok) noexcept : payload_(payload), size_(size), ok_(ok) {}
+
+public:
+  using value_type = typename value_payload::view_type;
+  using error_type = typename error_traits::view_type;
+
+  /// @brief Reads the record at the start of data, checking its header and payload size.
+  static auto parse(const std::byte *data, std::size_t size) noexcept -> result<result_view, wire_errc> {
+    if (size < detail::wire_header_size) { return err(wire_errc::truncated); }
+    const std::byte tag = data[0];
+    if (tag != detail::wire_ok_tag && tag != detail::wire_err_tag) { return err(wire_errc::bad_tag); }
+    const std::size_t payload_size = detail::read_wire_size(data);
+    if (payload_size > size - detail::wire_header_size) { return err(wire_errc::truncated); }
+    const bool is_value = tag == detail::wire_ok_tag;
+    if (is_value ? !value_payload::traits::fits(payload_size) : !error_traits::fits(payload_size)) {
+      return err(wire_errc::bad_payload);
+    }
+    return ok(result_view(data + detail::wire_header_size, payload_size, is_value));
+  }
+
+  [[nodiscard]] auto is_ok() const noexcept -> bool { return ok_; }
+  explicit operator bool() const noexcept { return ok_; }
+
+  /// @brief Size of the whole record, header included.
+  [[nodiscard]] auto encoded_size() const noexcept -> std::size_t { return detail::wire_header_size + size_; }
+
+  template <typename U = T, typename = std::enable_if_t<!std::is_void_v<U>>>
+  [[nodiscard]] auto value() const noexcept(!detail::throwing_access) -> value_type {
+    if constexpr (detail::checked_access) {
+      if (RESULT_UNLIKELY(!ok_)) { detail::bad_result_access("value() called on result_view with error"); }
+    }
+    return value_payload::traits::read(payload_, size_);
+  }
+
+  [[nodiscard]] auto error() const noexcept(!detail::throwing_access) -> error_type {
+    if constexpr (detail::checked_access) {
+      if (RESULT_UNLIKELY(ok_)) { detail::bad_result_access("error() called on result_view with value"); }
+    }
+    return error_traits::read(payload_, size_);
+  }
+
+  /// @brief An owning result with copies of the value or error.
+  [[nodiscard]] auto to_result() const -> result<T, E> {
+    if (!ok_) { return detail::result_access::make_err<result<T, E>>(E(error_traits::read(payload_, size_))); }
+    if constexpr (std::is_void_v<T>) {
+      return detail::result_access::make_ok<result<T, E>>();
+    } else {
+      using value_type = std::decay_t<T>;
+      return detail::result_access::make_ok<result<T, E>>(value_type(value_payload::traits::read(payload_, size_)));
+    }
+  }
+};
+
+/// @brief Reads the record at the start of data into an owning result.
+template <typename T, typename E>
+auto deserialize(const std::byte *data, std::size_t size) -> result<result<T, E>, wire_errc> {
+  return result_view<T, E>::parse(data, size).map([](const result_view<T, E> &view) { return view.to_result(); });
+}
+
+/// @brief Appends serialized results to a growing byte buffer, e.g. a batch of outcomes spilled to disk.
+/// @details Records are laid out back to back, so clearing and reusing the encoder between batches allocates only
+/// until the buffer has grown to the largest batch.
+class result_encoder {
+  std::vector<std::byte> buffer_;
+
+public:
+  template <typename T, typename E> void write(const result<T, E> &value) { serialize(value, buffer_); }
+
+  [[nodiscard]] auto data() const noexcept -> const std::byte * { return buffer_.data(); }
+  [[nodiscard]] auto size() const noexcept -> std::size_t { return buffer_.size(); }
+  [[nodiscard]] auto buffer() const noexcept -> const std::vector<std::byte> & { return buffer_; }
+  /// @brief Hands the encoded bytes over, leaving the encoder empty.
+  [[nodiscard]] auto take() noexcept -> std::vector<std::byte> { return std::exchange(buffer_, {}); }
+  void clear() noexcept { buffer_.clear(); }
+  void reserve(std::size_t size) { buffer_.reserve(size); }
+};
+
+/// @brief Reads a sequence of serialized result<T, E> records as views, in the order they were written.
+/// @details `while (!reader.done()) { RES_TRY_ASSIGN(auto view, reader.next()); ... }`. A malformed record ends the
+/// sequence: next() returns its error and done() is true afterwards.
+template <typename T, typename E> class result_reader {
+  const std::byte *data_;
+  std::size_t size_;
+  std::size_t offset_ = 0;
+
+public:
+  result_reader(const std::byte *data, std::size_t size) noexcept : data_(data), size_(size) {}
+  explicit result_reader(const std::vector<std::byte> &buffer) noexcept : data_(buffer.data()), size_(buffer.size()) {}
+
+  [[nodiscard]] auto done() const noexcept -> bool { return offset_ == size_; }
+  /// @brief Bytes of the buffer not read yet.
+  [[nodiscard]] auto remaining() const noexcept -> std::size_t { return size_ - offset_; }
+
+  auto next() noexcept -> result<result_view<T, E>, wire_errc> {
+    auto view = result_view<T, E>::parse(data_ + offset_, size_ - offset_);
+    offset_ = view.is_ok() ? offset_ + view.value_unchecked().encoded_size() : size_;
+    return view;
+  }
+};
+
+} // namespace res
+
+
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+namespace res {
+
+namespace detail {
+
+// The value of a combination of results: the tuple of the non-void values, or void when there are none.
+template <typename... Ts>
+using value_tuple_t = decltype(std::tuple_cat(
+    std::declval<std::conditional_t<std::is_void_v<Ts>, std::tuple<>, std::tuple<Ts>>>()...));
+template <typename... Ts>
+using combined_value_t = std::conditional_t<std::tuple_size_v<value_tuple_t<Ts...>> == 0, void, value_tuple_t<Ts...>>;
+
+template <typename R> using result_value_t = typename std::decay_t<R>::value_type;
+template <typename R> using result_error_t = typename std::decay_t<R>::error_type;
+
+template <typename First, typename... Rest> struct common_error {
+  static_assert((std::is_same_v<result_error_t<First>, result_error_t<Rest>> && ...),
+                "zip and apply require results with the same error type");
+  using type = result_error_t<First>;
+};
+
+// A reference to the value of source in a tuple of zero or one element, an rvalue reference for rvalue results. The
+// references are concatenated and then moved or copied once, into the combined tuple or the functor's parameters.
+template <typename R> constexpr auto forward_value_as_tuple(R &&source) {
+  if constexpr (std::is_void_v<result_value_t<R>>) {
+    return std::tuple<>();
+  } else {
+    return std::forward_as_tuple(std::forward<R>(source).value_unchecked());
+  }
+}
+
+template <typename... Rs>
+using forwarded_values_t = decltype(std::tuple_cat(forward_value_as_tuple(std::declval<Rs>())...));
+
+template <typename Output, typename First, typename... Rest>
+constexpr auto error_of_first_failed(First &&first, Rest &&...rest) -> Output {
+  if constexpr (sizeof...(Rest) > 0) {
+    if (first.is_ok()) { return error_of_first_failed<Output>(std::forward<Rest>(rest)...); }
+  }
+  return result_access::make_err<Output>(std::forward<First>(first).error_unchecked());
+}
+
+// Only reached when some result holds an error, so it is kept out of line and the all-ok path stays small.
+template <typename Output, typename... Rs> RESULT_NOINLINE constexpr auto first_error(Rs &&...results) -> Output {
+  return error_of_first_failed<Output>(std::forward<Rs>(results)...);
+}
+
+} // namespace detail
+
+/// @brief Combines independent results into a result of the tuple of their values, or the first error in argument
+/// order.
+/// @details `res::zip(parse_host(text), parse_port(text))` yields a result<std::tuple<host, port>, E>. The all-ok
+/// path tests every result with a single combined branch and moves the values of rvalue results into the tuple. Values
+/// of result<void, E> arguments are left out of the tuple, and the value is void when all of them are. All results must
+/// share the error type. Unlike res::zip_all, errors after the first are dropped.
+template <typename... Rs,
+          typename Output = result<detail::combined_value_t<detail::result_value_t<Rs>...>,
+                                   typename detail::common_error<Rs...>::type>>
+constexpr auto zip(Rs &&...results) -> Output {
+  static_assert((detail::is_result_v<std::decay_t<Rs>> && ...), "zip requires results");
+  // Counts the results holding a value: compilers turn a chain of && or even & back into a branch per result.
+  if (RESULT_LIKELY((static_cast<unsigned>(results.is_ok()) + ...) == sizeof...(Rs))) {
+    if constexpr (std::is_void_v<typename Output::value_type>) {
+      return detail::result_access::make_ok<Output>();
+    } else {
+      return detail::result_access::make_ok<Output>(
+          std::tuple_cat(detail::forward_value_as_tuple(std::forward<Rs>(results))...));
+    }
+  }
+  return detail::first_error<Output>(std::forward<Rs>(results)...);
+}
+
+/// @brief Calls functor with the values of results if all of them hold one, or returns the first error.
+/// @details The variadic counterpart of map: `res::apply([](host h, port p) { return endpoint{h, p}; }, host, port)`.
+/// Values of result<void, E> arguments are not passed, values of rvalue results are moved, and a functor returning
+/// void yields a result<void, E>.
+template <typename F, typename... Rs>
+constexpr auto apply(F &&functor, Rs &&...results) {
+  using error_type = typename detail::common_error<Rs...>::type;
+  using value_type = std::decay_t<decltype(std::apply(std::forward<F>(functor),
+                                                      std::declval<detail::forwarded_values_t<Rs...>>()))>;
+  using output = result<value_type, error_type>;
+  static_assert((detail::is_result_v<std::decay_t<Rs>> && ...), "apply requires results");
+  // A single branch for the all-ok path, as in zip.
+  if (RESULT_LIKELY((static_cast<unsigned>(results.is_ok()) + ...) == sizeof...(Rs))) {
+    auto values = std::tuple_cat(detail::forward_value_as_tuple(std::forward<Rs>(results))...);
+    if constexpr (std::is_void_v<value_type>) {
+      std::apply(std::forward<F>(functor), std::move(values));
+      return detail::result_access::make_ok<output>();
+    } else {
+      return detail::result_access::make_ok<output>(std::apply(std::forward<F>(functor), std::move(values)));
+    }
+  }
+  return detail::first_error<output>(std::forward<Rs>(results)...);
+}
+
+} // namespace res
+
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+namespace res {
+
+/// @brief Number of errors a validated keeps inline unless told otherwise.
+inline constexpr std::size_t default_inline_errors = 4;
+
+/// @brief The errors collected by a validated: a vector that keeps up to N errors inline and only allocates for more.
+/// @details Copying or moving an inline list copies or moves its elements; moving a list that spilled to the heap only
+/// steals its buffer.
+template <typename E, std::size_t N = default_inline_errors> class error_list {
+  static_assert(std::is_nothrow_move_constructible_v<E> || std::is_copy_constructible_v<E>,
+                "error_list requires a movable or copyable error type");
+
+  E *data_;
+  std::size_t size_ = 0;
+  std::size_t capacity_ = N;
+  alignas(E) unsigned char inline_[N == 0 ? 1 : N * sizeof(E)];
+
+  [[nodiscard]] auto inline_data() noexcept -> E * {
+    return reinterpret_cast<E *>(inline_); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  }
+
+public:
+  using value_type = E;
+  using iterator = E *;
+  using const_iterator = const E *;
+
+  error_list() noexcept : data_(inline_data()) {}
+
+  error_list(const error_list &other) : error_list() {
+    reserve(other.size_);
+    std::uninitialized_copy(other.begin(), other.end(), data_);
+    size_ = other.size_;
+  }
+  error_list(error_list &&other) noexcept(std::is_nothrow_move_constructible_v<E>) : error_list() {
+    take(std::move(other));
+  }
+  auto operator=(const error_list &other) -> error_list & {
+    if (this != &other) { *this = error_list(other); }
+    return *this;
+  }
+  auto operator=(error_list &&other) noexcept(std::is_nothrow_move_constructible_v<E>) -> error_list & {
+    if (this != &other) {
+      release();
+      take(std::move(other));
+    }
+    return *this;
+  }
+  ~error_list() { release(); }
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t { return size_; }
+  [[nodiscard]] auto empty() const noexcept -> bool { return size_ == 0; }
+  [[nodiscard]] auto capacity() const noexcept -> std::size_t { return capacity_; }
+  /// @brief Whether the errors are still stored inline, i.e. nothing has been allocated.
+  [[nodiscard]] auto is_inline() const noexcept -> bool {
+    return data_ == reinterpret_cast<const E *>(inline_); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  }
+
+  [[nodiscard]] auto begin() noexcept -> iterator { return data_; }
+  [[nodiscard]] auto end() noexcept -> iterator { return data_ + size_; }
+  [[nodiscard]] auto begin() const noexcept -> const_iterator { return data_; }
+  [[nodiscard]] auto end() const noexcept -> const_iterator { return data_ + size_; }
+  [[nodiscard]] auto data() const noexcept -> const E * { return data_; }
+
+  [[nodiscard]] auto operator[](std::size_t index) noexcept -> E & { return data_[index]; }
+  [[nodiscard]] auto operator[](std::size_t index) const noexcept -> const E & { return data_[index]; }
+  [[nodiscard]] auto front() const noexcept -> const E & { return data_[0]; }
+
+  template <typename... Args> auto emplace_back(Args &&...args) -> E & {
+    if (size_ == capacity_) { grow(std::max<std::size_t>(2 * capacity_, 1)); }
+    E *slot = ::new (static_cast<void *>(data_ + size_)) E(std::forward<Args>(args)...);
+    ++size_;
+    return *slot;
+  }
+  void push_back(const E &error) { emplace_back(error); }
+  void push_back(E &&error) { emplace_back(std::move(error)); }
+
+  /// @brief Appends the errors of other, after the ones already in the list.
+  void append(const error_list &other) {
+    reserve(size_ + other.size_);
+    for (const E &error : other) { emplace_back(error); }
+  }
+  void append(error_list &&other) {
+    if (empty() && !other.is_inline()) {
+      *this = std::move(other);
+      return;
+    }
+    reserve(size_ + other.size_);
+    for (E &error : other) { emplace_back(std::move_if_noexcept(error)); }
+    other.clear();
+  }
+
+  void reserve(std::size_t capacity) {
+    if (capacity > capacity_) { grow(std::max(capacity, 2 * capacity_)); }
+  }
+
+  void clear() noexcept {
+    std::destroy(begin(), end());
+    size_ = 0;
+  }
+
+private:
+  void grow(std::size_t capacity) {
+    // Frees the new buffer if copying an error into it throws.
+    const auto deallocate = [capacity](E *buffer) { std::allocator<E>().deallocate(buffer, capacity); };
+    std::unique_ptr<E, decltype(deallocate)> grown(std::allocator<E>().allocate(capacity), deallocate);
+    if constexpr (std::is_nothrow_move_constructible_v<E>) {
+      std::uninitialized_move(begin(), end(), grown.get());
+    } else {
+      std::uninitialized_copy(begin(), end(), grown.get());
+    }
+    const std::size_t size = size_;
+    release();
+    data_ = grown.release();
+    size_ = size;
+    capacity_ = capacity;
+  }
+
+  // Destroys the elements and frees a heap buffer, leaving the list empty and inline.
+  void release() noexcept {
+    clear();
+    if (!is_inline()) { std::allocator<E>().deallocate(data_, capacity_); }
+    data_ = inline_data();
+    capacity_ = N;
+  }
+
+  void take(error_list &&other) noexcept(std::is_nothrow_move_constructible_v<E>) {
+    if (other.is_inline()) {
+      for (E &error : other) { emplace_back(std::move_if_noexcept(error)); }
+      other.clear();
+    } else {
+      data_ = std::exchange(other.data_, other.inline_data());
+      size_ = std::exchange(other.size_, 0);
+      capacity_ = std::exchange(other.capacity_, N);
+    }
+  }
+};
+
+/// @brief The outcome of a validation that keeps going after the first problem: a value of type T, or every error of
+/// type E that was found.
+/// @details Up to N errors are stored inline, so validating a request with a few problems does not allocate. It is a
+/// result<T, error_list<E, N>> underneath: a result<T, E>, ok or err converts into a validated holding the value or a
+/// single error, and to_result() turns it back into a result. combine, zip_all and validate_all gather the errors of
+/// several validations in order.
+template <typename T, typename E, std::size_t N = default_inline_errors> class validated {
+public:
+  using value_type = T;
+  using error_type = E;
+  using errors_type = error_list<E, N>;
+  using result_type = result<T, errors_type>;
+
+private:
+  result_type result_;
+
+public:
+  // NOLINTBEGIN(google-explicit-constructor)
+  validated(result_type result) noexcept(std::is_nothrow_move_constructible_v<result_type>)
+      : result_(std::move(result)) {}
+  /// @brief Holds the value or the single error of source, which may be a result<T, E>, an ok or an err.
+  template <typename Source, typename = std::enable_if_t<std::is_convertible_v<Source, result<T, E>> &&
+                                                         !std::is_same_v<std::decay_t<Source>, validated>>>
+  validated(Source &&source) : result_(from_result(result<T, E>(std::forward<Source>(source)))) {}
+  // NOLINTEND(google-explicit-constructor)
+
+  [[nodiscard]] auto is_ok() const noexcept -> bool { return result_.is_ok(); }
+  explicit operator bool() const noexcept { return is_ok(); }
+  auto operator!() const noexcept -> bool { return !is_ok(); }
+
+  template <typename U = T, typename = std::enable_if_t<!std::is_void_v<U>>>
+  [[nodiscard]] auto value() const & noexcept(!detail::throwing_access) -> const U & {
+    return result_.value();
+  }
+  template <typename U = T, typename = std::enable_if_t<!std::is_void_v<U>>>
+  [[nodiscard]] auto value() && noexcept(!detail::throwing_access) -> U && {
+    return std::move(result_).value();
+  }
+
+  /// @brief Every error found, in the order the validations ran. Never empty.
+  [[nodiscard]] auto errors() const & noexcept(!detail::throwing_access) -> const errors_type & {
+    return result_.error();
+  }
+  [[nodiscard]] auto errors() && noexcept(!detail::throwing_access) -> errors_type && {
+    return std::move(result_).error();
+  }
+
+  [[nodiscard]] auto to_result() const & -> result_type { return result_; }
+  [[nodiscard]] auto to_result() && noexcept(std::is_nothrow_move_constructible_v<result_type>) -> result_type {
+    return std::move(result_);
+  }
+
+private:
+  static auto from_result(result<T, E> &&source) -> result_type {
+    if (!source.is_ok()) {
+      errors_type errors;
+      errors.push_back(std::move(source).error_unchecked());
+      return detail::result_access::make_err<result_type>(std::move(errors));
+    }
+    if constexpr (std::is_void_v<T>) {
+      return detail::result_access::make_ok<result_type>();
+    } else {
+      return detail::result_access::make_ok<result_type>(std::move(source).value_unchecked());
+    }
+  }
+};
+
+namespace detail {
+
+template <typename T, typename E, std::size_t N> auto take_value(validated<T, E, N> &&source) {
+  if constexpr (std::is_void_v<T>) {
+    return std::tuple<>();
+  } else {
+    return std::tuple<T>(std::move(source).value());
+  }
+}
+
+template <typename Subject, typename... Checks>
+using check_error_t = typename std::invoke_result_t<std::tuple_element_t<0, std::tuple<Checks...>> &,
+                                                    const Subject &>::error_type;
+
+template <typename E, std::size_t N, typename Subject, typename Check>
+void run_check(error_list<E, N> &errors, const Subject &subject, Check &check) {
+  auto outcome = std::invoke(check, subject);
+  static_assert(std::is_same_v<typename decltype(outcome)::error_type, E>,
+                "every check must return the same error type");
+  if (!outcome.is_ok()) { errors.push_back(std::move(outcome).error_unchecked()); }
+}
+
+} // namespace detail
+
+/// @brief Combines validations into one holding the tuple of their values, or the errors of every failed one in
+/// argument order.
+/// @details Values of validated<void, E, N> arguments are left out of the tuple, and the combined value is void when
+/// all of them are. When every validation succeeded the values are moved into the tuple; arguments passed as lvalues
+/// are copied first.
+template <typename E, std::size_t N, typename... Ts>
+auto combine(validated<Ts, E, N>... parts) -> validated<detail::combined_value_t<Ts...>, E, N> {
+  static_assert(sizeof...(Ts) > 0, "combine requires at least one validation");
+  using output = typename validated<detail::combined_value_t<Ts...>, E, N>::result_type;
+  if ((parts.is_ok() && ...)) {
+    if constexpr (std::is_void_v<detail::combined_value_t<Ts...>>) {
+      return detail::result_access::make_ok<output>();
+    } else {
+      return detail::result_access::make_ok<output>(std::tuple_cat(detail::take_value(std::move(parts))...));
+    }
+  }
+  error_list<E, N> errors;
+  ((parts.is_ok() ? void() : errors.append(std::move(parts).errors())), ...);
+  return detail::result_access::make_err<output>(std::move(errors));
+}
+
+/// @brief Like combine for plain results: the tuple of every value, or every error instead of only the first one.
+/// @details `res::zip_all(parse_name(form), parse_age(form))` reports both a bad name and a bad age. N sets how many
+/// errors are stored inline.
+template <std::size_t N = default_inline_errors, typename E, typename... Ts>
+auto zip_all(result<Ts, E>... results) -> validated<detail::combined_value_t<Ts...>, E, N> {
+  return combine(validated<Ts, E, N>(std::move(results))...);
+}
+
+/// @brief Runs every check on value and returns it if all of them pass, or the errors of every failing check.
+/// @details Each check is called with a const reference to value and returns a result whose error type is the same for
+/// all checks; its value is ignored. `res::validate_all(request, has_name, has_valid_age, has_known_country)`.
+template <std::size_t N = default_inline_errors, typename T, typename... Checks>
+auto validate_all(T &&value, Checks &&...checks)
+    -> validated<std::decay_t<T>, detail::check_error_t<std::decay_t<T>, Checks...>, N> {
+  static_assert(sizeof...(Checks) > 0, "validate_all requires at least one check");
+  using E = detail::check_error_t<std::decay_t<T>, Checks...>;
+  using output = typename validated<std::decay_t<T>, E, N>::result_type;
+  error_list<E, N> errors;
+  const std::decay_t<T> &subject = value;
+  (detail::run_check(errors, subject, checks), ...);
+  if (errors.empty()) { return detail::result_access::make_ok<output>(std::forward<T>(value)); }
+  return detail::result_access::make_err<output>(std::move(errors));
+}
+
+} // namespace res
+
+
+#include <cstddef>
+#include <new>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+
+/// @brief Bytes an any_error stores inline; larger error types are allocated on the heap.
+#ifndef RESULT_ANY_ERROR_INLINE_SIZE
+#define RESULT_ANY_ERROR_INLINE_SIZE 32
+#endif
+
+namespace res {
+
+class any_error;
+
+/// @brief Customization point for how any_error describes an error of type E.
+/// @details The defaults use what the type offers: category() is a `category()` member convertible to
+/// std::string_view, or one with a `name()` like std::error_code's, and is empty otherwise. message() is a `message()`
+/// member, what operator<< prints, the numeric value of an enum, or "unknown error", in that order of preference.
+template <typename E, typename = void> struct any_error_traits {
+  static auto category(const E &error) -> std::string_view;
+  static auto message(const E &error) -> std::string;
+};
+
+namespace detail {
+
+template <typename E, typename = void> struct has_category_view : std::false_type {};
+template <typename E>
+struct has_category_view<E, std::enable_if_t<std::is_convertible_v<decltype(std::declval<const E &>().category()),
+                                                                   std::string_view>>> : std::true_type {};
+
+template <typename E, typename = void> struct has_category_name : std::false_type {};
+template <typename E>
+struct has_category_name<E, std::enable_if_t<std::is_convertible_v<
+                                decltype(std::declval<const E &>().category().name()), std::string_view>>>
+    : std::true_type {};
+
+template <typename E, typename = void> struct has_message : std::false_type {};
+template <typename E>
+struct has_message<
+    E, std::enable_if_t<std::is_convertible_v<decltype(std::declval<const E &>().message()), std::string>>>
+    : std::true_type {};
+
+template <typename E, typename = void> struct is_streamable : std::false_type {};
+template <typename E>
+struct is_streamable<E, std::void_t<decltype(std::declval<std::ostream &>() << std::declval<const E &>())>>
+    : std::true_type {};
+
+template <typename E, typename = void> struct is_equality_comparable : std::false_type {};
+template <typename E>
+struct is_equality_comparable<
+    E, std::enable_if_t<std::is_convertible_v<decltype(std::declval<const E &>() == std::declval<const E &>()), bool>>>
+    : std::true_type {};
+
+inline constexpr std::size_t any_error_inline_size = RESULT_ANY_ERROR_INLINE_SIZE;
+inline constexpr std::size_t any_error_inline_align = alignof(void *);
+
+union any_error_storage {
+  void *heap;
+  alignas(any_error_inline_align) unsigned char buffer[any_error_inline_size];
+};
+
+// Error types are stored inline when they fit and can be moved without throwing, so moving an any_error never throws.
+template <typename E>
+inline constexpr bool stored_inline_v = sizeof(E) <= any_error_inline_size && alignof(E) <= any_error_inline_align &&
+                                        std::is_nothrow_move_constructible_v<E>;
+
+// Errors an any_error can hold by value. A pointer, such as a decayed string literal, is refused: any_error would keep
+// only the address and could not keep what it points to alive.
+template <typename E>
+inline constexpr bool holdable_error_v = std::is_copy_constructible_v<E> && !std::is_pointer_v<E>;
+
+// Its address identifies E without RTTI.
+template <typename E> struct any_error_type_id {
+  static constexpr char id = 0;
+};
+
+/// @brief The operations an any_error performs on the error it holds.
+struct any_error_vtable {
+  const void *type;
+  void (*destroy)(any_error_storage &storage) noexcept;
+  void (*move)(any_error_storage &source, any_error_storage &target) noexcept;
+  void (*copy)(const any_error_storage &source, any_error_storage &target);
+  auto (*category)(const any_error_storage &storage) -> std::string_view;
+  auto (*message)(const any_error_storage &storage) -> std::string;
+  auto (*equal)(const any_error_storage &lhs, const any_error_storage &rhs) -> bool;
+  bool heap;
+};
+
+template <typename E> auto any_error_object(any_error_storage &storage) noexcept -> E * {
+  if constexpr (stored_inline_v<E>) {
+    return std::launder(reinterpret_cast<E *>(storage.buffer)); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  } else {
+    return static_cast<E *>(storage.heap);
+  }
+}
+template <typename E> auto any_error_object(const any_error_storage &storage) noexcept -> const E * {
+  return any_error_object<E>(const_cast<any_error_storage &>(storage)); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+}
+
+template <typename E, typename... Args> void any_error_construct(any_error_storage &storage, Args &&...args) {
+  if constexpr (stored_inline_v<E>) {
+    ::new (static_cast<void *>(storage.buffer)) E(std::forward<Args>(args)...);
+  } else {
+    storage.heap = new E(std::forward<Args>(args)...);
+  }
+}
+
+template <typename E> inline constexpr any_error_vtable any_error_vtable_for = {
+    &any_error_type_id<E>::id,
+    [](any_error_storage &storage) noexcept {
+      if constexpr (stored_inline_v<E>) {
+        any_error_object<E>(storage)->~E();
+      } else {
+        delete any_error_object<E>(storage);
+      }
+    },
+    [](any_error_storage &source, any_error_storage &target) noexcept {
+      if constexpr (stored_inline_v<E>) {
+        E *object = any_error_object<E>(source);
+        ::new (static_cast<void *>(target.buffer)) E(std::move(*object));
+        object->~E();
+      } else {
+        target.heap = source.heap;
+      }
+    },
+    [](const any_error_storage &source, any_error_storage &target) {
+      any_error_construct<E>(target, *any_error_object<E>(source));
+    },
+    [](const any_error_storage &storage) -> std::string_view {
+      return any_error_traits<E>::category(*any_error_object<E>(storage));
+    },
+    [](const any_error_storage &storage) -> std::string {
+      return any_error_traits<E>::message(*any_error_object<E>(storage));
+    },
+    [](const any_error_storage &lhs, const any_error_storage &rhs) -> bool {
+      if constexpr (is_equality_comparable<E>::value) {
+        return *any_error_object<E>(lhs) == *any_error_object<E>(rhs);
+      } else {
+        return any_error_object<E>(lhs) == any_error_object<E>(rhs);
+      }
+    },
+    !stored_inline_v<E>,
+};
+
+} // namespace detail
+
+template <typename E, typename Enable>
+auto any_error_traits<E, Enable>::category(const E &error) -> std::string_view {
+  if constexpr (detail::has_category_view<E>::value) {
+    return error.category();
+  } else if constexpr (detail::has_category_name<E>::value) {
+    return error.category().name();
+  } else {
+    return {};
+  }
+}
+
+template <typename E, typename Enable> auto any_error_traits<E, Enable>::message(const E &error) -> std::string {
+  if constexpr (detail::has_message<E>::value) {
+    return error.message();
+  } else if constexpr (detail::is_streamable<E>::value) {
+    std::ostringstream stream;
+    stream << error;
+    return stream.str();
+  } else if constexpr (std::is_enum_v<E>) {
+    return std::to_string(static_cast<std::underlying_type_t<E>>(error));
+  } else {
+    return "unknown error";
+  }
+}
+
+/// @brief An error of any type, so that layers with their own error types can share result<T, any_error> without
+/// map_err conversions at every boundary.
+/// @details Error types of up to RESULT_ANY_ERROR_INLINE_SIZE bytes (32 by default) whose move constructor does not
+/// throw are stored inline, so wrapping typical errors never allocates; larger ones are allocated on the heap. The
+/// error is described through a static table of functions for its category, message and equality, and recovered with
+/// the checked downcasts is, as and downcast. Error types must be copyable and must not be pointers, so a string
+/// literal is wrapped in a std::string or an error_code first. A moved-from any_error holds no error, and its category
+/// and message are empty.
+class any_error {
+  detail::any_error_storage storage_{};
+  const detail::any_error_vtable *vtable_ = nullptr;
+
+public:
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  template <typename E, typename = std::enable_if_t<!std::is_same_v<std::decay_t<E>, any_error> &&
+                                                    detail::holdable_error_v<std::decay_t<E>>>>
+  any_error(E &&error) noexcept(detail::stored_inline_v<std::decay_t<E>> &&
+                                std::is_nothrow_constructible_v<std::decay_t<E>, E>)
+      : any_error(std::in_place_type<std::decay_t<E>>, std::forward<E>(error)) {}
+
+  template <typename E, typename... Args>
+  explicit any_error(std::in_place_type_t<E> /*type*/, Args &&...args)
+      : vtable_(&detail::any_error_vtable_for<E>) {
+    static_assert(std::is_copy_constructible_v<E>, "any_error requires a copyable error type");
+    static_assert(!std::is_pointer_v<E>, "any_error does not hold pointers, whose targets it cannot keep alive");
+    static_assert(!std::is_reference_v<E> && !std::is_const_v<E>, "any_error holds errors by value");
+    detail::any_error_construct<E>(storage_, std::forward<Args>(args)...);
+  }
+
+  any_error(const any_error &other) : vtable_(other.vtable_) {
+    if (vtable_ != nullptr) { vtable_->copy(other.storage_, storage_); }
+  }
+  any_error(any_error &&other) noexcept : vtable_(std::exchange(other.vtable_, nullptr)) {
+    if (vtable_ != nullptr) { vtable_->move(other.storage_, storage_); }
+  }
+  auto operator=(const any_error &other) -> any_error & {
+    if (this != &other) { *this = any_error(other); }
+    return *this;
+  }
+  auto operator=(any_error &&other) noexcept -> any_error & {
+    if (this != &other) {
+      reset();
+      vtable_ = std::exchange(other.vtable_, nullptr);
+      if (vtable_ != nullptr) { vtable_->move(other.storage_, storage_); }
+    }
+    return *this;
+  }
+  ~any_error() { reset(); }
+
+  [[nodiscard]] auto category() const -> std::string_view {
+    return vtable_ != nullptr ? vtable_->category(storage_) : std::string_view();
+  }
+  [[nodiscard]] auto message() const -> std::string {
+    return vtable_ != nullptr ? vtable_->message(storage_) : std::string();
+  }
+
+  /// @brief Whether the error is stored inside the any_error rather than on the heap.
+  [[nodiscard]] auto is_inline() const noexcept -> bool { return vtable_ == nullptr || !vtable_->heap; }
+
+  /// @brief Whether the error is of type E exactly.
+  template <typename E> [[nodiscard]] auto is() const noexcept -> bool {
+    return vtable_ != nullptr && vtable_->type == &detail::any_error_type_id<E>::id;
+  }
+  /// @brief The error if it is of type E, nullptr otherwise.
+  template <typename E> [[nodiscard]] auto as() const noexcept -> const E * {
+    return is<E>() ? detail::any_error_object<E>(storage_) : nullptr;
+  }
+  template <typename E> [[nodiscard]] auto as() noexcept -> E * {
+    return is<E>() ? detail::any_error_object<E>(storage_) : nullptr;
+  }
+  /// @brief Moves the error out if it is of type E, or returns the any_error itself as the error.
+  template <typename E> [[nodiscard]] auto downcast() && -> result<E, any_error> {
+    if (E *error = as<E>()) { return detail::result_access::make_ok<result<E, any_error>>(std::move(*error)); }
+    return detail::result_access::make_err<result<E, any_error>>(std::move(*this));
+  }
+
+  /// @brief Errors are equal when they have the same type and compare equal; errors of types without operator== are
+  /// only equal to themselves.
+  friend auto operator==(const any_error &lhs, const any_error &rhs) -> bool {
+    if (lhs.vtable_ == nullptr || rhs.vtable_ == nullptr) { return lhs.vtable_ == rhs.vtable_; }
+    return lhs.vtable_->type == rhs.vtable_->type && lhs.vtable_->equal(lhs.storage_, rhs.storage_);
+  }
+  friend auto operator!=(const any_error &lhs, const any_error &rhs) -> bool { return !(lhs == rhs); }
+
+  /// @brief Prints `category: message`, or only the message when the category is empty.
+  friend auto operator<<(std::ostream &stream, const any_error &error) -> std::ostream & {
+    const std::string_view category = error.category();
+    if (!category.empty()) { stream << category << ": "; }
+    return stream << error.message();
+  }
+
+private:
+  void reset() noexcept {
+    if (vtable_ != nullptr) { std::exchange(vtable_, nullptr)->destroy(storage_); }
+  }
+};
+
+} // namespace res
+
+
+#endif // RESULT_LIB
+
+#include <array>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+
+// Result coroutines need the object returned by get_return_object to be converted to result<T, E> only once the
+// coroutine has returned to its caller (see result_return). Clang converts it immediately before version 17, Apple
+// Clang before version 16, which would read the result before the coroutine has produced it.
+#if defined(__clang__)
+#if (defined(__apple_build_version__) && __clang_major__ < 16) ||                                                      \
+    (!defined(__apple_build_version__) && __clang_major__ < 17)
+#error "result_coro.h needs Clang 17 or newer (Apple Clang 16 or newer)"
+#endif
+#endif
+
+namespace res {
+
+template <typename T, typename E> class task;
+
+namespace detail {
+
+template <typename T> struct is_task : std::false_type {};
+template <typename T, typename E> struct is_task<task<T, E>> : std::true_type {};
+template <typename T> inline constexpr bool is_task_v = is_task<std::remove_cvref_t<T>>::value;
+
+/// @brief Thread-local cache of coroutine frames, kept in free lists per 64-byte size class.
+/// @details Result coroutines and tasks are created and destroyed at the rate of ordinary calls, so their frames are
+/// recycled instead of going back to the heap every time. Frames larger than the biggest class use the heap directly.
+class frame_cache {
+  static constexpr std::size_t granularity = 64;
+  static constexpr std::size_t classes = 16;
+
+  struct free_frame {
+    free_frame *next;
+  };
+
+  std::array<free_frame *, classes> free_{};
+
+  frame_cache() = default;
+
+public:
+  frame_cache(const frame_cache &) = delete;
+  auto operator=(const frame_cache &) -> frame_cache & = delete;
+  frame_cache(frame_cache &&) = delete;
+  auto operator=(frame_cache &&) -> frame_cache & = delete;
+  ~frame_cache() {
+    for (free_frame *head : free_) {
+      while (head != nullptr) { ::operator delete(std::exchange(head, head->next)); }
+    }
+  }
+
+  static auto allocate(std::size_t size) -> void * {
+    const std::size_t index = size_class(size);
+    if (index < classes) {
+      free_frame *&head = local().free_[index];
+      if (head != nullptr) { return std::exchange(head, head->next); }
+      return ::operator new((index + 1) * granularity);
+    }
+    return ::operator new(size);
+  }
+
+  static void deallocate(void *frame, std::size_t size) noexcept {
+    const std::size_t index = size_class(size);
+    if (index < classes) {
+      free_frame *&head = local().free_[index];
+      head = ::new (frame) free_frame{head};
+      return;
+    }
+    ::operator delete(frame);
+  }
+
+private:
+  static auto size_class(std::size_t size) noexcept -> std::size_t { return (size - 1) / granularity; }
+  static auto local() noexcept -> frame_cache & {
+    thread_local frame_cache cache;
+    return cache;
+  }
+};
+
+/// @brief Base of the promise types whose coroutine frames come from the frame_cache.
+struct cached_frame_promise {
+  static auto operator new(std::size_t size) -> void * { return frame_cache::allocate(size); }
+  static void operator delete(void *frame, std::size_t size) noexcept { frame_cache::deallocate(frame, size); }
+};
+
+/// @brief Awaiter behind `co_await result`: yields the value, or hands the error to the awaiting promise.
+/// @details Source is a reference to the awaited result; values are moved out of rvalue results. Only results are
+/// ever awaited this way, so the success path never suspends.
+template <typename Source> class unwrap_awaiter {
+  using value_type = typename std::remove_cvref_t<Source>::value_type;
+
+  Source source_;
+
+public:
+  explicit unwrap_awaiter(Source source) noexcept : source_(std::forward<Source>(source)) {}
+
+  [[nodiscard]] auto await_ready() const noexcept -> bool { return source_.is_ok(); }
+  template <typename Promise> auto await_suspend(std::coroutine_handle<Promise> handle) {
+    return handle.promise().fail(std::forward<Source>(source_).error(), handle);
+  }
+  auto await_resume()
+      -> std::conditional_t<std::is_lvalue_reference_v<Source>, std::add_lvalue_reference_t<const value_type>,
+                            value_type> {
+    if constexpr (!std::is_void_v<value_type>) {
+      return std::forward<Source>(source_).value();
+    }
+  }
+};
+
+template <typename T, typename E> class result_promise;
+
+/// @brief What a result coroutine returns to its caller before converting it to result<T, E>.
+/// @details The promise writes the final result into this object. Compilers convert it to the declared return type
+/// only when the coroutine first returns to its caller (GCC, MSVC and Clang 17 or newer), by which point a result
+/// coroutine has always finished.
+template <typename T, typename E> class result_return {
+  std::optional<result<T, E>> storage_;
+  result_promise<T, E> *promise_;
+
+public:
+  explicit result_return(result_promise<T, E> &promise) noexcept : promise_(&promise) {
+    promise_->slot_ = &storage_;
+  }
+  result_return(result_return &&other) noexcept : result_return(*other.promise_) {}
+  result_return(const result_return &) = delete;
+  auto operator=(const result_return &) -> result_return & = delete;
+  auto operator=(result_return &&) -> result_return & = delete;
+  ~result_return() = default;
+
+  operator result<T, E>() && { return std::move(*storage_); } // NOLINT(google-explicit-constructor)
+};
+
+/// @brief Promise of coroutines declared to return result<T, E>.
+/// @details The coroutine runs to completion inside the call: it never suspends on success and is destroyed as soon
+/// as an awaited result holds an error, so its frame never outlives the call and compilers may elide its allocation.
+template <typename T, typename E> class result_promise : public cached_frame_promise {
+  using result_type = result<T, E>;
+
+  std::optional<result_type> *slot_ = nullptr;
+
+  friend class result_return<T, E>;
+
+public:
+  auto get_return_object() noexcept -> result_return<T, E> { return result_return<T, E>(*this); }
+  static auto initial_suspend() noexcept -> std::suspend_never { return {}; }
+  static auto final_suspend() noexcept -> std::suspend_never { return {}; }
+#if RESULT_HAS_EXCEPTIONS
+  [[noreturn]] static void unhandled_exception() { throw; }
+#else
+  [[noreturn]] static void unhandled_exception() { std::terminate(); }
+#endif
+
+  template <typename V> void return_value(V &&value) { slot_->emplace(std::forward<V>(value)); }
+
+  template <typename R, typename = std::enable_if_t<is_result_v<std::remove_cvref_t<R>>>>
+  auto await_transform(R &&source) noexcept -> unwrap_awaiter<R &&> {
+    return unwrap_awaiter<R &&>(std::forward<R>(source));
+  }
+
+  template <typename V> void fail(V &&error, std::coroutine_handle<result_promise> handle) {
+    slot_->emplace(result_access::make_err<result_type>(std::forward<V>(error)));
+    handle.destroy();
+  }
+};
+
+/// @brief Promise of task<T, E>. The result lives in the promise, inside the coroutine frame.
+template <typename T, typename E> class task_promise : public cached_frame_promise {
+  using result_type = result<T, E>;
+
+  std::optional<result_type> result_;
+  std::exception_ptr exception_;
+  std::coroutine_handle<> continuation_ = std::noop_coroutine();
+  // Lets whoever awaits the task decide where control goes once it has finished.
+  using finish_hook = auto (*)(void *context) noexcept -> std::coroutine_handle<>;
+  finish_hook on_finish_ = nullptr;
+  void *finish_context_ = nullptr;
+
+  template <typename, typename> friend class task_promise;
+  friend class task<T, E>;
+
+  struct final_awaiter {
+    static auto await_ready() noexcept -> bool { return false; }
+    static auto await_suspend(std::coroutine_handle<task_promise> handle) noexcept -> std::coroutine_handle<> {
+      return handle.promise().next();
+    }
+    static void await_resume() noexcept {}
+  };
+
+  // Awaits another task from inside a task: yields its value or propagates its error like an awaited result.
+  template <typename Task> class task_unwrap_awaiter {
+    Task task_;
+    std::coroutine_handle<task_promise> parent_;
+
+  public:
+    explicit task_unwrap_awaiter(Task task) noexcept : task_(std::forward<Task>(task)) {}
+
+    static auto await_ready() noexcept -> bool { return false; }
+    auto await_suspend(std::coroutine_handle<task_promise> parent) noexcept -> std::coroutine_handle<> {
+      parent_ = parent;
+      task_.handle_.promise().finish_with(&finish, this);
+      return task_.handle_;
+    }
+    auto await_resume() -> typename std::remove_cvref_t<Task>::value_type {
+      auto &child = task_.handle_.promise();
+      if (child.exception_) { std::rethrow_exception(child.exception_); }
+      if constexpr (!std::is_void_v<typename std::remove_cvref_t<Task>::value_type>) {
+        return std::move(*child.result_).value();
+      }
+    }
+
+  private:
+    static auto finish(void *context) noexcept -> std::coroutine_handle<> {
+      auto &self = *static_cast<task_unwrap_awaiter *>(context);
+      auto &child = self.task_.handle_.promise();
+      if (child.exception_ || child.result_->is_ok()) { return self.parent_; }
+      return self.parent_.promise().fail(std::move(*child.result_).error(), self.parent_);
+    }
+  };
+
+public:
+  auto get_return_object() noexcept -> task<T, E> {
+    return task<T, E>(std::coroutine_handle<task_promise>::from_promise(*this));
+  }
+  static auto initial_suspend() noexcept -> std::suspend_always { return {}; }
+  static auto final_suspend() noexcept -> final_awaiter { return {}; }
+  void unhandled_exception() noexcept { exception_ = std::current_exception(); }
+
+  template <typename V> void return_value(V &&value) { result_.emplace(std::forward<V>(value)); }
+
+  template <typename R, std::enable_if_t<is_result_v<std::remove_cvref_t<R>>, int> = 0>
+  auto await_transform(R &&source) noexcept -> unwrap_awaiter<R &&> {
+    return unwrap_awaiter<R &&>(std::forward<R>(source));
+  }
+  template <typename Task, std::enable_if_t<is_task_v<Task>, int> = 0>
+  auto await_transform(Task &&child) noexcept -> task_unwrap_awaiter<Task &&> {
+    return task_unwrap_awaiter<Task &&>(std::forward<Task>(child));
+  }
+  // Any other awaitable is awaited unchanged.
+  template <typename A, std::enable_if_t<!is_result_v<std::remove_cvref_t<A>> && !is_task_v<A>, int> = 0>
+  auto await_transform(A &&awaitable) noexcept -> A && {
+    return std::forward<A>(awaitable);
+  }
+
+  /// @brief Replaces the continuation with on_finish(context), which returns the coroutine to resume.
+  void finish_with(finish_hook on_finish, void *context) noexcept {
+    on_finish_ = on_finish;
+    finish_context_ = context;
+  }
+
+  template <typename V> auto fail(V &&error, std::coroutine_handle<> /*self*/) -> std::coroutine_handle<> {
+    result_.emplace(result_access::make_err<result_type>(std::forward<V>(error)));
+    return next();
+  }
+
+private:
+  auto next() noexcept -> std::coroutine_handle<> {
+    if (on_finish_ != nullptr) { return on_finish_(finish_context_); }
+    return continuation_;
+  }
+};
+
+} // namespace detail
+
+/// @brief Lazily started coroutine producing result<T, E>.
+/// @details Inside a task, `co_await` on a result or on another task yields its value, or finishes the task with its
+/// error; other awaitables are awaited as usual. Awaiting a task from any other coroutine yields its result<T, E>, and
+/// sync_wait runs one from ordinary code. The task owns its frame and destroys it, so a task awaited in the scope that
+/// created it is a candidate for heap allocation elision. An exception escaping the task is rethrown where it is
+/// awaited.
+template <typename T, typename E> class [[nodiscard]] task {
+public:
+  using value_type = T;
+  using error_type = E;
+  using result_type = result<T, E>;
+  using promise_type = detail::task_promise<T, E>;
+
+  task(task &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+  auto operator=(task &&other) noexcept -> task & {
+    if (this != &other) {
+      if (handle_) { handle_.destroy(); }
+      handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+  task(const task &) = delete;
+  auto operator=(const task &) -> task & = delete;
+  ~task() {
+    if (handle_) { handle_.destroy(); }
+  }
+
+  /// @brief Starts the task when awaited and yields its result<T, E>.
+  auto operator co_await() && noexcept {
+    struct awaiter {
+      std::coroutine_handle<promise_type> handle_;
+
+      static auto await_ready() noexcept -> bool { return false; }
+      auto await_suspend(std::coroutine_handle<> continuation) noexcept -> std::coroutine_handle<> {
+        handle_.promise().continuation_ = continuation;
+        return handle_;
+      }
+      auto await_resume() -> result_type { return take(handle_); }
+    };
+    return awaiter{handle_};
+  }
+
+private:
+  std::coroutine_handle<promise_type> handle_;
+
+  template <typename, typename> friend class detail::task_promise;
+  template <typename U, typename F> friend auto sync_wait(task<U, F> work) -> result<U, F>;
+
+  explicit task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+  static auto take(std::coroutine_handle<promise_type> handle) -> result_type {
+    auto &promise = handle.promise();
+    if (promise.exception_) { std::rethrow_exception(promise.exception_); }
+    return std::move(*promise.result_);
+  }
+};
+
+/// @brief Runs a task to completion from ordinary code, blocking until it finishes, and returns its result.
+template <typename T, typename E> auto sync_wait(task<T, E> work) -> result<T, E> {
+  // The task may finish on another thread, which notifies under the lock so the waiter cannot return and destroy the
+  // state before notify_one is done with it.
+  struct completion {
+    std::mutex mutex;
+    std::condition_variable finished;
+    bool done = false;
+  } state;
+  work.handle_.promise().finish_with(
+      [](void *context) noexcept -> std::coroutine_handle<> {
+        auto &finishing = *static_cast<completion *>(context);
+        const std::lock_guard<std::mutex> lock(finishing.mutex);
+        finishing.done = true;
+        finishing.finished.notify_one();
+        return std::noop_coroutine();
+      },
+      &state);
+  work.handle_.resume();
+  {
+    std::unique_lock<std::mutex> lock(state.mutex);
+    state.finished.wait(lock, [&state] { return state.done; });
+  }
+  return task<T, E>::take(work.handle_);
+}
+
+} // namespace res
+
+template <typename T, typename E, typename... Args> struct std::coroutine_traits<res::result<T, E>, Args...> {
+  using promise_type = res::detail::result_promise<T, E>;
+};
+
+
+#endif // RESULT_CORO_LIB
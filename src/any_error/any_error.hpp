@@ -0,0 +1,277 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "../result/result.hpp"
+
+/// @brief Bytes an any_error stores inline; larger error types are allocated on the heap.
+#ifndef RESULT_ANY_ERROR_INLINE_SIZE
+#define RESULT_ANY_ERROR_INLINE_SIZE 32
+#endif
+
+namespace res {
+
+class any_error;
+
+/// @brief Customization point for how any_error describes an error of type E.
+/// @details The defaults use what the type offers: category() is a `category()` member convertible to
+/// std::string_view, or one with a `name()` like std::error_code's, and is empty otherwise. message() is a `message()`
+/// member, what operator<< prints, the numeric value of an enum, or "unknown error", in that order of preference.
+template <typename E, typename = void> struct any_error_traits {
+  static auto category(const E &error) -> std::string_view;
+  static auto message(const E &error) -> std::string;
+};
+
+namespace detail {
+
+template <typename E, typename = void> struct has_category_view : std::false_type {};
+template <typename E>
+struct has_category_view<E, std::enable_if_t<std::is_convertible_v<decltype(std::declval<const E &>().category()),
+                                                                   std::string_view>>> : std::true_type {};
+
+template <typename E, typename = void> struct has_category_name : std::false_type {};
+template <typename E>
+struct has_category_name<E, std::enable_if_t<std::is_convertible_v<
+                                decltype(std::declval<const E &>().category().name()), std::string_view>>>
+    : std::true_type {};
+
+template <typename E, typename = void> struct has_message : std::false_type {};
+template <typename E>
+struct has_message<
+    E, std::enable_if_t<std::is_convertible_v<decltype(std::declval<const E &>().message()), std::string>>>
+    : std::true_type {};
+
+template <typename E, typename = void> struct is_streamable : std::false_type {};
+template <typename E>
+struct is_streamable<E, std::void_t<decltype(std::declval<std::ostream &>() << std::declval<const E &>())>>
+    : std::true_type {};
+
+template <typename E, typename = void> struct is_equality_comparable : std::false_type {};
+template <typename E>
+struct is_equality_comparable<
+    E, std::enable_if_t<std::is_convertible_v<decltype(std::declval<const E &>() == std::declval<const E &>()), bool>>>
+    : std::true_type {};
+
+inline constexpr std::size_t any_error_inline_size = RESULT_ANY_ERROR_INLINE_SIZE;
+inline constexpr std::size_t any_error_inline_align = alignof(void *);
+
+union any_error_storage {
+  void *heap;
+  alignas(any_error_inline_align) unsigned char buffer[any_error_inline_size];
+};
+
+// Error types are stored inline when they fit and can be moved without throwing, so moving an any_error never throws.
+template <typename E>
+inline constexpr bool stored_inline_v = sizeof(E) <= any_error_inline_size && alignof(E) <= any_error_inline_align &&
+                                        std::is_nothrow_move_constructible_v<E>;
+
+// Errors an any_error can hold by value. A pointer, such as a decayed string literal, is refused: any_error would keep
+// only the address and could not keep what it points to alive.
+template <typename E>
+inline constexpr bool holdable_error_v = std::is_copy_constructible_v<E> && !std::is_pointer_v<E>;
+
+// Its address identifies E without RTTI.
+template <typename E> struct any_error_type_id {
+  static constexpr char id = 0;
+};
+
+/// @brief The operations an any_error performs on the error it holds.
+struct any_error_vtable {
+  const void *type;
+  void (*destroy)(any_error_storage &storage) noexcept;
+  void (*move)(any_error_storage &source, any_error_storage &target) noexcept;
+  void (*copy)(const any_error_storage &source, any_error_storage &target);
+  auto (*category)(const any_error_storage &storage) -> std::string_view;
+  auto (*message)(const any_error_storage &storage) -> std::string;
+  auto (*equal)(const any_error_storage &lhs, const any_error_storage &rhs) -> bool;
+  bool heap;
+};
+
+template <typename E> auto any_error_object(any_error_storage &storage) noexcept -> E * {
+  if constexpr (stored_inline_v<E>) {
+    return std::launder(reinterpret_cast<E *>(storage.buffer)); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  } else {
+    return static_cast<E *>(storage.heap);
+  }
+}
+template <typename E> auto any_error_object(const any_error_storage &storage) noexcept -> const E * {
+  return any_error_object<E>(const_cast<any_error_storage &>(storage)); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+}
+
+template <typename E, typename... Args> void any_error_construct(any_error_storage &storage, Args &&...args) {
+  if constexpr (stored_inline_v<E>) {
+    ::new (static_cast<void *>(storage.buffer)) E(std::forward<Args>(args)...);
+  } else {
+    storage.heap = new E(std::forward<Args>(args)...);
+  }
+}
+
+template <typename E> inline constexpr any_error_vtable any_error_vtable_for = {
+    &any_error_type_id<E>::id,
+    [](any_error_storage &storage) noexcept {
+      if constexpr (stored_inline_v<E>) {
+        any_error_object<E>(storage)->~E();
+      } else {
+        delete any_error_object<E>(storage);
+      }
+    },
+    [](any_error_storage &source, any_error_storage &target) noexcept {
+      if constexpr (stored_inline_v<E>) {
+        E *object = any_error_object<E>(source);
+        ::new (static_cast<void *>(target.buffer)) E(std::move(*object));
+        object->~E();
+      } else {
+        target.heap = source.heap;
+      }
+    },
+    [](const any_error_storage &source, any_error_storage &target) {
+      any_error_construct<E>(target, *any_error_object<E>(source));
+    },
+    [](const any_error_storage &storage) -> std::string_view {
+      return any_error_traits<E>::category(*any_error_object<E>(storage));
+    },
+    [](const any_error_storage &storage) -> std::string {
+      return any_error_traits<E>::message(*any_error_object<E>(storage));
+    },
+    [](const any_error_storage &lhs, const any_error_storage &rhs) -> bool {
+      if constexpr (is_equality_comparable<E>::value) {
+        return *any_error_object<E>(lhs) == *any_error_object<E>(rhs);
+      } else {
+        return any_error_object<E>(lhs) == any_error_object<E>(rhs);
+      }
+    },
+    !stored_inline_v<E>,
+};
+
+} // namespace detail
+
+template <typename E, typename Enable>
+auto any_error_traits<E, Enable>::category(const E &error) -> std::string_view {
+  if constexpr (detail::has_category_view<E>::value) {
+    return error.category();
+  } else if constexpr (detail::has_category_name<E>::value) {
+    return error.category().name();
+  } else {
+    return {};
+  }
+}
+
+template <typename E, typename Enable> auto any_error_traits<E, Enable>::message(const E &error) -> std::string {
+  if constexpr (detail::has_message<E>::value) {
+    return error.message();
+  } else if constexpr (detail::is_streamable<E>::value) {
+    std::ostringstream stream;
+    stream << error;
+    return stream.str();
+  } else if constexpr (std::is_enum_v<E>) {
+    return std::to_string(static_cast<std::underlying_type_t<E>>(error));
+  } else {
+    return "unknown error";
+  }
+}
+
+/// @brief An error of any type, so that layers with their own error types can share result<T, any_error> without
+/// map_err conversions at every boundary.
+/// @details Error types of up to RESULT_ANY_ERROR_INLINE_SIZE bytes (32 by default) whose move constructor does not
+/// throw are stored inline, so wrapping typical errors never allocates; larger ones are allocated on the heap. The
+/// error is described through a static table of functions for its category, message and equality, and recovered with
+/// the checked downcasts is, as and downcast. Error types must be copyable and must not be pointers, so a string
+/// literal is wrapped in a std::string or an error_code first. A moved-from any_error holds no error, and its category
+/// and message are empty.
+class any_error {
+  detail::any_error_storage storage_{};
+  const detail::any_error_vtable *vtable_ = nullptr;
+
+public:
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  template <typename E, typename = std::enable_if_t<!std::is_same_v<std::decay_t<E>, any_error> &&
+                                                    detail::holdable_error_v<std::decay_t<E>>>>
+  any_error(E &&error) noexcept(detail::stored_inline_v<std::decay_t<E>> &&
+                                std::is_nothrow_constructible_v<std::decay_t<E>, E>)
+      : any_error(std::in_place_type<std::decay_t<E>>, std::forward<E>(error)) {}
+
+  template <typename E, typename... Args>
+  explicit any_error(std::in_place_type_t<E> /*type*/, Args &&...args)
+      : vtable_(&detail::any_error_vtable_for<E>) {
+    static_assert(std::is_copy_constructible_v<E>, "any_error requires a copyable error type");
+    static_assert(!std::is_pointer_v<E>, "any_error does not hold pointers, whose targets it cannot keep alive");
+    static_assert(!std::is_reference_v<E> && !std::is_const_v<E>, "any_error holds errors by value");
+    detail::any_error_construct<E>(storage_, std::forward<Args>(args)...);
+  }
+
+  any_error(const any_error &other) : vtable_(other.vtable_) {
+    if (vtable_ != nullptr) { vtable_->copy(other.storage_, storage_); }
+  }
+  any_error(any_error &&other) noexcept : vtable_(std::exchange(other.vtable_, nullptr)) {
+    if (vtable_ != nullptr) { vtable_->move(other.storage_, storage_); }
+  }
+  auto operator=(const any_error &other) -> any_error & {
+    if (this != &other) { *this = any_error(other); }
+    return *this;
+  }
+  auto operator=(any_error &&other) noexcept -> any_error & {
+    if (this != &other) {
+      reset();
+      vtable_ = std::exchange(other.vtable_, nullptr);
+      if (vtable_ != nullptr) { vtable_->move(other.storage_, storage_); }
+    }
+    return *this;
+  }
+  ~any_error() { reset(); }
+
+  [[nodiscard]] auto category() const -> std::string_view {
+    return vtable_ != nullptr ? vtable_->category(storage_) : std::string_view();
+  }
+  [[nodiscard]] auto message() const -> std::string {
+    return vtable_ != nullptr ? vtable_->message(storage_) : std::string();
+  }
+
+  /// @brief Whether the error is stored inside the any_error rather than on the heap.
+  [[nodiscard]] auto is_inline() const noexcept -> bool { return vtable_ == nullptr || !vtable_->heap; }
+
+  /// @brief Whether the error is of type E exactly.
+  template <typename E> [[nodiscard]] auto is() const noexcept -> bool {
+    return vtable_ != nullptr && vtable_->type == &detail::any_error_type_id<E>::id;
+  }
+  /// @brief The error if it is of type E, nullptr otherwise.
+  template <typename E> [[nodiscard]] auto as() const noexcept -> const E * {
+    return is<E>() ? detail::any_error_object<E>(storage_) : nullptr;
+  }
+  template <typename E> [[nodiscard]] auto as() noexcept -> E * {
+    return is<E>() ? detail::any_error_object<E>(storage_) : nullptr;
+  }
+  /// @brief Moves the error out if it is of type E, or returns the any_error itself as the error.
+  template <typename E> [[nodiscard]] auto downcast() && -> result<E, any_error> {
+    if (E *error = as<E>()) { return detail::result_access::make_ok<result<E, any_error>>(std::move(*error)); }
+    return detail::result_access::make_err<result<E, any_error>>(std::move(*this));
+  }
+
+  /// @brief Errors are equal when they have the same type and compare equal; errors of types without operator== are
+  /// only equal to themselves.
+  friend auto operator==(const any_error &lhs, const any_error &rhs) -> bool {
+    if (lhs.vtable_ == nullptr || rhs.vtable_ == nullptr) { return lhs.vtable_ == rhs.vtable_; }
+    return lhs.vtable_->type == rhs.vtable_->type && lhs.vtable_->equal(lhs.storage_, rhs.storage_);
+  }
+  friend auto operator!=(const any_error &lhs, const any_error &rhs) -> bool { return !(lhs == rhs); }
+
+  /// @brief Prints `category: message`, or only the message when the category is empty.
+  friend auto operator<<(std::ostream &stream, const any_error &error) -> std::ostream & {
+    const std::string_view category = error.category();
+    if (!category.empty()) { stream << category << ": "; }
+    return stream << error.message();
+  }
+
+private:
+  void reset() noexcept {
+    if (vtable_ != nullptr) { std::exchange(vtable_, nullptr)->destroy(storage_); }
+  }
+};
+
+} // namespace res
@@ -0,0 +1,333 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "../result/result.hpp"
+
+namespace res {
+
+template <typename T, typename E> class async_result;
+template <typename T, typename E> class promise;
+
+/// @brief Executor that runs continuations immediately on the thread that completes the result.
+/// @details Executors are copied into every continuation and provide `post(job)`, which must eventually call `job()`
+/// exactly once.
+struct inline_executor {
+  template <typename Job> void post(Job &&job) const { std::forward<Job>(job)(); }
+};
+
+namespace detail {
+
+template <typename T, typename E> class async_state;
+
+template <typename T, typename E> class async_continuation {
+public:
+  // Consumes the finished source state and the reference to it that the continuation holds.
+  virtual void run(async_state<T, E> &source) noexcept = 0;
+
+protected:
+  async_continuation() = default;
+  async_continuation(const async_continuation &) = default;
+  async_continuation(async_continuation &&) noexcept = default;
+  auto operator=(const async_continuation &) -> async_continuation & = default;
+  auto operator=(async_continuation &&) noexcept -> async_continuation & = default;
+  ~async_continuation() = default;
+};
+
+/// @brief One-shot shared state between a promise and an async_result.
+/// @details The producer publishes the result with a single atomic exchange and the consumer attaches its continuation
+/// with a single compare-exchange; whichever comes second runs the continuation, so neither side ever blocks. The
+/// state is reference counted and released through destroy() so derived states can carry their own allocator.
+template <typename T, typename E> class async_state {
+  enum phase : int { pending, continued, ready };
+
+  std::atomic<int> phase_{pending};
+  std::atomic<unsigned> refs_{2};
+  async_continuation<T, E> *continuation_ = nullptr;
+  std::optional<result<T, E>> result_;
+
+public:
+  async_state() = default;
+  async_state(const async_state &) = delete;
+  auto operator=(const async_state &) -> async_state & = delete;
+  async_state(async_state &&) = delete;
+  auto operator=(async_state &&) -> async_state & = delete;
+
+  /// @brief Publishes the result and drops the producer reference.
+  void complete(result<T, E> value) noexcept {
+    result_.emplace(std::move(value));
+    publish();
+  }
+  /// @brief Publishes that no result will come and drops the producer reference.
+  void abandon() noexcept { publish(); }
+
+  void attach(async_continuation<T, E> &continuation) noexcept {
+    continuation_ = &continuation;
+    int expected = pending;
+    if (!phase_.compare_exchange_strong(expected, continued, std::memory_order_acq_rel)) { continuation.run(*this); }
+  }
+
+  [[nodiscard]] auto is_ready() const noexcept -> bool { return phase_.load(std::memory_order_acquire) == ready; }
+
+  /// @brief Moves the result out of a ready state, empty when the promise was abandoned.
+  auto take() noexcept -> std::optional<result<T, E>> { return std::move(result_); }
+
+  void release() noexcept {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) { destroy(); }
+  }
+
+protected:
+  virtual ~async_state() = default;
+  virtual void destroy() noexcept { delete this; }
+
+private:
+  void publish() noexcept {
+    if (phase_.exchange(ready, std::memory_order_acq_rel) == continued) { continuation_->run(*this); }
+    release();
+  }
+};
+
+template <typename T, typename E, typename Alloc> class allocated_async_state final : public async_state<T, E> {
+  using allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<allocated_async_state>;
+
+  allocator_type allocator_;
+
+public:
+  explicit allocated_async_state(const Alloc &allocator) : allocator_(allocator) {}
+
+  static auto make(const Alloc &allocator) -> allocated_async_state * {
+    allocator_type rebound(allocator);
+    auto *memory = std::allocator_traits<allocator_type>::allocate(rebound, 1);
+    return ::new (static_cast<void *>(memory)) allocated_async_state(allocator);
+  }
+
+protected:
+  void destroy() noexcept override {
+    allocator_type allocator(std::move(allocator_));
+    this->~allocated_async_state();
+    std::allocator_traits<allocator_type>::deallocate(allocator, this, 1);
+  }
+};
+
+struct then_kind {};
+struct map_kind {};
+struct map_err_kind {};
+
+template <typename Kind, typename F, typename T, typename E> struct chained_result;
+template <typename F, typename T, typename E> struct chained_result<then_kind, F, T, E> {
+  using type = std::invoke_result_t<F &, result<T, E> &&>;
+};
+template <typename F, typename T, typename E> struct chained_result<map_kind, F, T, E> {
+  using type = decltype(std::declval<result<T, E> &&>().map(std::declval<F &>()));
+};
+template <typename F, typename T, typename E> struct chained_result<map_err_kind, F, T, E> {
+  using type = decltype(std::declval<result<T, E> &&>().map_err(std::declval<F &>()));
+};
+
+/// @brief Shared state of a continuation's result that is also the continuation of the source state.
+/// @details Chaining allocates this single object, which stores the functor and the executor next to the result.
+template <typename Kind, typename F, typename Executor, typename T, typename E,
+          typename Output = typename chained_result<Kind, F, T, E>::type>
+class chained_state final : public async_state<typename Output::value_type, typename Output::error_type>,
+                            public async_continuation<T, E> {
+  F functor_;
+  Executor executor_;
+
+public:
+  chained_state(F functor, Executor executor) : functor_(std::move(functor)), executor_(std::move(executor)) {}
+
+  // The job may complete and destroy this state before post returns, so post is called on an executor moved out of
+  // it. run is called once, so the member is not needed afterwards.
+  void run(async_state<T, E> &source) noexcept override {
+    Executor executor(std::move(executor_));
+    executor.post([this, &source] { invoke(source); });
+  }
+
+private:
+  void invoke(async_state<T, E> &source) noexcept {
+    std::optional<result<T, E>> input = source.take();
+    source.release();
+    if (!input) {
+      this->abandon();
+      return;
+    }
+    if constexpr (std::is_same_v<Kind, then_kind>) {
+      this->complete(functor_(std::move(*input)));
+    } else if constexpr (std::is_same_v<Kind, map_kind>) {
+      this->complete(std::move(*input).map(functor_));
+    } else {
+      this->complete(std::move(*input).map_err(functor_));
+    }
+  }
+};
+
+} // namespace detail
+
+/// @brief Consumer side of a one-shot asynchronous result<T, E>.
+/// @details Obtained from promise<T, E>::get_async_result. Continuations attached with then, map and map_err run on
+/// the thread that completes the result, or on the executor given to them, so no thread blocks to chain work; get
+/// blocks only when the result is not ready yet. Continuations must not throw.
+template <typename T, typename E> class [[nodiscard]] async_result {
+  detail::async_state<T, E> *state_;
+
+  friend class promise<T, E>;
+  template <typename, typename> friend class async_result;
+
+  explicit async_result(detail::async_state<T, E> *state) noexcept : state_(state) {}
+
+public:
+  using value_type = T;
+  using error_type = E;
+  using result_type = result<T, E>;
+
+  async_result(async_result &&other) noexcept : state_(std::exchange(other.state_, nullptr)) {}
+  auto operator=(async_result &&other) noexcept -> async_result & {
+    if (this != &other) {
+      reset();
+      state_ = std::exchange(other.state_, nullptr);
+    }
+    return *this;
+  }
+  async_result(const async_result &) = delete;
+  auto operator=(const async_result &) -> async_result & = delete;
+  ~async_result() { reset(); }
+
+  [[nodiscard]] auto valid() const noexcept -> bool { return state_ != nullptr; }
+  /// @brief Whether the result has been set or abandoned. Calling it on an invalid async_result is reported as misuse.
+  [[nodiscard]] auto is_ready() const noexcept -> bool {
+    check_valid();
+    return state_->is_ready();
+  }
+
+  /// @brief Waits for the result and returns it. Throws std::logic_error if the promise was destroyed unfulfilled.
+  /// Calling it on an invalid async_result is reported as misuse.
+  auto get() && -> result_type {
+    check_valid();
+    auto *state = std::exchange(state_, nullptr);
+    std::optional<result_type> value;
+    if (state->is_ready()) {
+      value = state->take();
+      state->release();
+    } else {
+      struct waiter final : detail::async_continuation<T, E> {
+        std::mutex mutex;
+        std::condition_variable ready;
+        bool done = false;
+        std::optional<result_type> *value = nullptr;
+
+        void run(detail::async_state<T, E> &source) noexcept override {
+          *value = source.take();
+          source.release();
+          const std::lock_guard<std::mutex> lock(mutex);
+          done = true;
+          ready.notify_one();
+        }
+      } waiter;
+      waiter.value = &value;
+      state->attach(waiter);
+      std::unique_lock<std::mutex> lock(waiter.mutex);
+      waiter.ready.wait(lock, [&waiter] { return waiter.done; });
+    }
+    if (!value) { detail::throw_or_abort<std::logic_error>("async_result abandoned by its promise"); }
+    return std::move(*value);
+  }
+
+  /// @brief Continues with functor(result<T, E>), which returns the next result.
+  template <typename F, typename Executor = inline_executor>
+  auto then(F &&functor, Executor executor = {}) && {
+    return chain<detail::then_kind>(std::forward<F>(functor), std::move(executor));
+  }
+  /// @brief Continues with the result mapped like result::map.
+  template <typename F, typename Executor = inline_executor> auto map(F &&functor, Executor executor = {}) && {
+    return chain<detail::map_kind>(std::forward<F>(functor), std::move(executor));
+  }
+  /// @brief Continues with the result mapped like result::map_err.
+  template <typename F, typename Executor = inline_executor> auto map_err(F &&functor, Executor executor = {}) && {
+    return chain<detail::map_err_kind>(std::forward<F>(functor), std::move(executor));
+  }
+
+private:
+  template <typename Kind, typename F, typename Executor> auto chain(F &&functor, Executor executor) {
+    using state_type = detail::chained_state<Kind, std::decay_t<F>, Executor, T, E>;
+    using output = typename detail::chained_result<Kind, std::decay_t<F>, T, E>::type;
+    static_assert(detail::is_result_v<output>, "continuations must produce a result");
+    auto *next = new state_type(std::forward<F>(functor), std::move(executor));
+    std::exchange(state_, nullptr)->attach(*next);
+    return async_result<typename output::value_type, typename output::error_type>(next);
+  }
+
+  void reset() noexcept {
+    if (state_ != nullptr) { std::exchange(state_, nullptr)->release(); }
+  }
+  // A moved-from async_result, or one whose result was already taken, has no state to look at.
+  void check_valid() const noexcept {
+    if (RESULT_UNLIKELY(state_ == nullptr)) { detail::report_misuse("async_result used without a shared state"); }
+  }
+};
+
+/// @brief Producer side of a one-shot asynchronous result<T, E>.
+/// @details Destroying a promise without setting it abandons the result: continuations are skipped and get throws. The
+/// promise and its async_result may live on different threads, but each of them is used by one thread at a time.
+template <typename T, typename E> class promise {
+  detail::async_state<T, E> *state_;
+  bool retrieved_ = false;
+
+public:
+  promise() : state_(new detail::async_state<T, E>()) {}
+  /// @brief Allocates the shared state with allocator, e.g. a pool. It is released on whichever thread drops the last
+  /// reference, so allocator must be usable from both the producer and the consumer threads.
+  template <typename Alloc>
+  promise(std::allocator_arg_t /*tag*/, const Alloc &allocator)
+      : state_(detail::allocated_async_state<T, E, Alloc>::make(allocator)) {}
+
+  promise(promise &&other) noexcept
+      : state_(std::exchange(other.state_, nullptr)), retrieved_(std::exchange(other.retrieved_, true)) {}
+  auto operator=(promise &&other) noexcept -> promise & {
+    if (this != &other) {
+      abandon();
+      state_ = std::exchange(other.state_, nullptr);
+      retrieved_ = std::exchange(other.retrieved_, true);
+    }
+    return *this;
+  }
+  promise(const promise &) = delete;
+  auto operator=(const promise &) -> promise & = delete;
+  ~promise() { abandon(); }
+
+  /// @brief Returns the consumer side. Can be called once, throws std::logic_error afterwards (aborts without
+  /// exceptions).
+  auto get_async_result() -> async_result<T, E> {
+    if (retrieved_ || state_ == nullptr) {
+      detail::throw_or_abort<std::logic_error>("async_result already retrieved");
+    }
+    retrieved_ = true;
+    return async_result<T, E>(state_);
+  }
+
+  /// @brief Fulfills the promise, running an attached continuation on this thread. Can be called once.
+  void set_result(result<T, E> value) {
+    if (state_ == nullptr) { detail::throw_or_abort<std::logic_error>("promise already satisfied"); }
+    detach()->complete(std::move(value));
+  }
+
+private:
+  auto detach() noexcept -> detail::async_state<T, E> * {
+    auto *state = std::exchange(state_, nullptr);
+    // Nobody can consume a result whose consumer side was never retrieved, so drop that reference as well.
+    if (!retrieved_) { state->release(); }
+    return state;
+  }
+
+  void abandon() noexcept {
+    if (state_ != nullptr) { detach()->abandon(); }
+  }
+};
+
+} // namespace res
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../result/result.hpp"
+
+namespace res {
+
+namespace detail {
+
+// Marks that collect and traverse should gather values into a std::vector.
+struct default_container {};
+
+template <typename Container, typename T>
+using collect_container_t = std::conditional_t<std::is_same_v<Container, default_container>, std::vector<T>, Container>;
+
+template <typename Range> using range_reference_t = decltype(*std::begin(std::declval<Range &>()));
+
+// Elements of rvalue ranges are handed out as rvalues so their values can be moved out.
+template <typename Range>
+using range_forward_t = std::conditional_t<std::is_lvalue_reference_v<Range>, range_reference_t<Range>,
+                                           std::remove_reference_t<range_reference_t<Range>> &&>;
+
+template <typename Container, typename = void> struct has_reserve : std::false_type {};
+template <typename Container>
+struct has_reserve<Container, std::void_t<decltype(std::declval<Container &>().reserve(std::size_t{}))>>
+    : std::true_type {};
+
+template <typename Range, typename = void> struct is_sized_range : std::false_type {};
+template <typename Range>
+struct is_sized_range<Range, std::void_t<decltype(std::size(std::declval<Range &>()))>> : std::true_type {};
+
+template <typename Container, typename Range> void reserve_for(Container &container, Range &range) {
+  if constexpr (has_reserve<Container>::value && is_sized_range<Range>::value) {
+    container.reserve(static_cast<std::size_t>(std::size(range)));
+  }
+}
+
+template <typename Container, typename = void> struct has_push_back : std::false_type {};
+template <typename Container>
+struct has_push_back<Container, std::void_t<decltype(std::declval<Container &>().push_back(
+                                    std::declval<typename Container::value_type>()))>> : std::true_type {};
+
+// Sequence containers take push_back, which unlike insert at end() needs no position handling.
+template <typename Container, typename V> void append(Container &container, V &&value) {
+  if constexpr (has_push_back<Container>::value) {
+    container.push_back(std::forward<V>(value));
+  } else {
+    container.insert(container.end(), std::forward<V>(value));
+  }
+}
+
+/// @brief Gathers the values of the results project yields for every element, stopping at the first error.
+template <typename Container, typename R, typename Range, typename Project>
+auto collect_with(Range &&range, Project &&project) -> R {
+  Container values;
+  reserve_for(values, range);
+  for (auto &&element : range) {
+    decltype(auto) projected = project(static_cast<range_forward_t<Range>>(element));
+    if (!projected.is_ok()) {
+      return result_access::make_err<R>(std::forward<decltype(projected)>(projected).error());
+    }
+    append(values, std::forward<decltype(projected)>(projected).value());
+  }
+  return result_access::make_ok<R>(std::move(values));
+}
+
+} // namespace detail
+
+/// @brief Turns a range of result<T, E> into a result holding a container of every value, or the first error.
+/// @details Iteration stops at the first error. The container defaults to std::vector<T>; any container with
+/// `push_back` or `insert(end(), value)` works and it is reserved up front when the range is sized. Values are moved
+/// out of rvalue ranges.
+template <typename Container = detail::default_container, typename Range,
+          typename Element = std::decay_t<detail::range_reference_t<Range>>>
+auto collect(Range &&range)
+    -> result<detail::collect_container_t<Container, typename Element::value_type>, typename Element::error_type> {
+  static_assert(detail::is_result_v<Element>, "collect requires a range of results");
+  using output =
+      result<detail::collect_container_t<Container, typename Element::value_type>, typename Element::error_type>;
+  return detail::collect_with<typename output::value_type, output>(
+      std::forward<Range>(range),
+      [](detail::range_forward_t<Range> element) -> detail::range_forward_t<Range> {
+        return static_cast<detail::range_forward_t<Range>>(element);
+      });
+}
+
+/// @brief Applies a fallible functor to every element of a range and collects the values it returns.
+/// @details Equivalent to collecting the results of functor over the range, without materializing them: iteration
+/// stops at the first error and the container defaults to std::vector. Elements of rvalue ranges are passed to
+/// functor as rvalues. A lambda or function object is inlined into the loop, a function name is called through a
+/// pointer.
+template <typename Container = detail::default_container, typename Range, typename F,
+          typename Mapped = std::decay_t<std::invoke_result_t<F &, detail::range_forward_t<Range>>>>
+auto traverse(Range &&range, F &&functor)
+    -> result<detail::collect_container_t<Container, typename Mapped::value_type>, typename Mapped::error_type> {
+  static_assert(detail::is_result_v<Mapped>, "traverse requires a functor that returns a result");
+  using output =
+      result<detail::collect_container_t<Container, typename Mapped::value_type>, typename Mapped::error_type>;
+  return detail::collect_with<typename output::value_type, output>(std::forward<Range>(range), functor);
+}
+
+} // namespace res
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+/// @brief Whether the library may throw, detected from the compiler flags. With -fno-exceptions the default checking
+/// policy becomes RESULT_CHECKING_ABORT, and the few operations that would throw on misuse, such as an out of range
+/// result_vector::at, report it through the misuse handler instead (see res::set_misuse_handler).
+#ifndef RESULT_HAS_EXCEPTIONS
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define RESULT_HAS_EXCEPTIONS 1
+#else
+#define RESULT_HAS_EXCEPTIONS 0
+#endif
+#endif
+
+/// @brief Checking policies for value() and error() called on the wrong alternative of a result.
+/// @details Select one by defining RESULT_CHECKING before including result.h, the same in every translation unit:
+/// - RESULT_CHECKING_THROW, the default, throws std::logic_error.
+/// - RESULT_CHECKING_ABORT reports the misuse to the misuse handler and aborts. It is the default without exceptions.
+/// - RESULT_CHECKING_ASSERT aborts like RESULT_CHECKING_ABORT unless NDEBUG is defined, and does not check then.
+/// - RESULT_CHECKING_UNCHECKED never checks; calling the wrong accessor is undefined behavior.
+///
+/// value_unchecked() and error_unchecked() skip the check regardless of the policy.
+#define RESULT_CHECKING_THROW 0
+#define RESULT_CHECKING_ABORT 1
+#define RESULT_CHECKING_ASSERT 2
+#define RESULT_CHECKING_UNCHECKED 3
+
+#ifndef RESULT_CHECKING
+#if RESULT_HAS_EXCEPTIONS
+#define RESULT_CHECKING RESULT_CHECKING_THROW
+#else
+#define RESULT_CHECKING RESULT_CHECKING_ABORT
+#endif
+#endif
+
+#if RESULT_CHECKING == RESULT_CHECKING_THROW && !RESULT_HAS_EXCEPTIONS
+#error "RESULT_CHECKING_THROW needs exceptions, pick another RESULT_CHECKING policy"
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define RESULT_LIKELY(...) __builtin_expect(static_cast<bool>(__VA_ARGS__), 1)
+#define RESULT_UNLIKELY(...) __builtin_expect(static_cast<bool>(__VA_ARGS__), 0)
+#define RESULT_NOINLINE [[gnu::noinline]]
+#define RESULT_COLD [[gnu::cold, gnu::noinline]]
+#elif defined(_MSC_VER)
+#define RESULT_LIKELY(...) static_cast<bool>(__VA_ARGS__)
+#define RESULT_UNLIKELY(...) static_cast<bool>(__VA_ARGS__)
+#define RESULT_NOINLINE __declspec(noinline)
+#define RESULT_COLD __declspec(noinline)
+#else
+#define RESULT_LIKELY(...) static_cast<bool>(__VA_ARGS__)
+#define RESULT_UNLIKELY(...) static_cast<bool>(__VA_ARGS__)
+#define RESULT_NOINLINE
+#define RESULT_COLD
+#endif
+
+namespace res {
+
+/// @brief Receives the description of a misuse, e.g. value() called on an error, before the library aborts.
+/// @details A handler may end the program its own way, such as logging and flushing first; if it returns, the library
+/// calls std::abort. It is never called for misuse that throws.
+using misuse_handler = void (*)(const char *message);
+
+namespace detail {
+
+inline auto misuse_handler_slot() noexcept -> std::atomic<misuse_handler> & {
+  static std::atomic<misuse_handler> handler{nullptr};
+  return handler;
+}
+
+} // namespace detail
+
+/// @brief Installs handler for misuse that aborts and returns the previous one. nullptr restores the default handler,
+/// which prints the message to stderr.
+inline auto set_misuse_handler(misuse_handler handler) noexcept -> misuse_handler {
+  return detail::misuse_handler_slot().exchange(handler, std::memory_order_acq_rel);
+}
+
+namespace detail {
+
+inline constexpr bool checked_access =
+    RESULT_CHECKING == RESULT_CHECKING_THROW || RESULT_CHECKING == RESULT_CHECKING_ABORT ||
+#if defined(NDEBUG)
+    false;
+#else
+    RESULT_CHECKING == RESULT_CHECKING_ASSERT;
+#endif
+
+// Accessors are noexcept unless a wrong access throws.
+inline constexpr bool throwing_access = RESULT_CHECKING == RESULT_CHECKING_THROW;
+
+[[noreturn]] RESULT_COLD inline void report_misuse(const char *message) noexcept {
+  if (const misuse_handler handler = misuse_handler_slot().load(std::memory_order_acquire)) {
+    handler(message);
+  } else {
+    std::fputs(message, stderr);
+    std::fputc('\n', stderr);
+  }
+  std::abort();
+}
+
+/// @brief Throws Exception, or reports the misuse and aborts when exceptions are disabled.
+template <typename Exception> [[noreturn]] RESULT_COLD void throw_or_abort(const char *message) {
+#if RESULT_HAS_EXCEPTIONS
+  throw Exception(message);
+#else
+  report_misuse(message);
+#endif
+}
+
+/// @brief Reports value() or error() called on the wrong alternative according to RESULT_CHECKING.
+/// @details Kept out of line and cold so that checked accessors inline to a compare and a branch to this call.
+[[noreturn]] RESULT_COLD inline void bad_result_access(const char *message) {
+#if RESULT_CHECKING == RESULT_CHECKING_THROW
+  throw std::logic_error(message);
+#else
+  report_misuse(message);
+#endif
+}
+
+} // namespace detail
+
+} // namespace res
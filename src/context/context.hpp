@@ -0,0 +1,299 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "../result/result.hpp"
+
+namespace res {
+
+namespace detail {
+
+class context_chunk;
+
+/// @brief One context frame of a chain, allocated in a context_chunk.
+/// @details Frames are immutable once linked and shared between copies of a context_error, so they are reference
+/// counted: by every context_error whose chain starts at them and by the frame in front of them.
+struct context_frame {
+  std::atomic<std::uint32_t> refs{1};
+  context_frame *next = nullptr;
+  context_chunk *chunk = nullptr;
+  void (*render)(const context_frame &frame, std::ostream &stream) = nullptr;
+  void (*destroy)(context_frame &frame) = nullptr;
+};
+
+struct text_frame : context_frame {
+  std::size_t size = 0;
+
+  // The characters are stored right after the frame.
+  [[nodiscard]] auto characters() noexcept -> char * {
+    return reinterpret_cast<char *>(this + 1); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  }
+  [[nodiscard]] auto text() const noexcept -> std::string_view {
+    return {reinterpret_cast<const char *>(this + 1), size}; // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  }
+};
+
+template <typename F> struct lazy_frame : context_frame {
+  F functor;
+
+  explicit lazy_frame(F &&function) : functor(std::move(function)) {}
+};
+
+/// @brief A block of memory that context frames are bump allocated from.
+/// @details While the chunk is the current one of its arena, its owner thread counts allocations and releases in plain
+/// integers and holds a large credit on live_; only frames released on other threads touch live_ atomically. Once the
+/// owner retires the chunk it returns the unused credit, and live_ becomes the number of frames still alive, so the
+/// chunk is freed by whichever thread releases the last of them.
+class alignas(std::max_align_t) context_chunk {
+  static constexpr std::uint32_t owner_credit = std::uint32_t{1} << 31U;
+
+  std::atomic<std::uint32_t> live_;
+  std::uint32_t allocated_ = 0;
+  std::uint32_t returned_ = 0;
+  std::size_t capacity_;
+  std::size_t used_ = 0;
+
+  context_chunk(std::size_t capacity, std::uint32_t live) noexcept : live_(live), capacity_(capacity) {}
+
+  [[nodiscard]] auto storage() noexcept -> unsigned char * {
+    return reinterpret_cast<unsigned char *>(this + 1); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  }
+
+  void free() noexcept {
+    this->~context_chunk();
+    ::operator delete(static_cast<void *>(this));
+  }
+
+public:
+  /// @brief A chunk for an arena to allocate from.
+  static auto make_current(std::size_t capacity) -> context_chunk * {
+    return ::new (::operator new(sizeof(context_chunk) + capacity)) context_chunk(capacity, owner_credit);
+  }
+  /// @brief A chunk that holds a single frame and is freed with it.
+  static auto make_single(std::size_t capacity) -> context_chunk * {
+    return ::new (::operator new(sizeof(context_chunk) + capacity)) context_chunk(capacity, 1);
+  }
+
+  /// @brief Returns size bytes aligned to align, or nullptr when the chunk is full.
+  auto allocate(std::size_t size, std::size_t align) noexcept -> void * {
+    const std::size_t begin = (used_ + align - 1) & ~(align - 1);
+    if (begin + size > capacity_) { return nullptr; }
+    used_ = begin + size;
+    ++allocated_;
+    return storage() + begin;
+  }
+
+  /// @brief Reuses the current chunk from the start if every frame allocated from it has been released.
+  void try_rewind() noexcept {
+    if (live_.load(std::memory_order_acquire) + allocated_ - returned_ != owner_credit) { return; }
+    live_.store(owner_credit, std::memory_order_relaxed);
+    allocated_ = 0;
+    returned_ = 0;
+    used_ = 0;
+  }
+
+  /// @brief Releases a frame of the current chunk on the owner thread.
+  void release_local() noexcept { ++returned_; }
+  /// @brief Releases a frame of a chunk that is not current, or from another thread.
+  void release_shared() noexcept {
+    if (live_.fetch_sub(1, std::memory_order_acq_rel) == 1) { free(); }
+  }
+  /// @brief Called by the owner when the chunk stops being current.
+  void retire() noexcept {
+    const std::uint32_t unused_credit = owner_credit - (allocated_ - returned_);
+    if (live_.fetch_sub(unused_credit, std::memory_order_acq_rel) == unused_credit) { free(); }
+  }
+};
+
+// Storage starts right after the header, aligned like operator new memory.
+static_assert(sizeof(context_chunk) % alignof(std::max_align_t) == 0);
+
+/// @brief Thread-local bump allocator for context frames.
+/// @details Allocation is a pointer bump in the current chunk. Once every frame of the current chunk has been released
+/// it is reused from the start, so a thread that keeps creating and dropping errors cycles through a single chunk
+/// without any atomic read-modify-write.
+class context_arena {
+  context_chunk *current_ = nullptr;
+
+public:
+  static constexpr std::size_t chunk_size = 4096;
+
+  context_arena() = default;
+  context_arena(const context_arena &) = delete;
+  auto operator=(const context_arena &) -> context_arena & = delete;
+  context_arena(context_arena &&) = delete;
+  auto operator=(context_arena &&) -> context_arena & = delete;
+  ~context_arena() {
+    if (current_ != nullptr) { std::exchange(current_, nullptr)->retire(); }
+  }
+
+  static auto local() -> context_arena & {
+    thread_local context_arena arena;
+    return arena;
+  }
+
+  auto allocate(std::size_t size, std::size_t align, context_chunk *&chunk) -> void * {
+    if (current_ != nullptr) {
+      current_->try_rewind();
+      if (void *memory = current_->allocate(size, align)) {
+        chunk = current_;
+        return memory;
+      }
+    }
+    if (size + align > chunk_size / 4) {
+      chunk = context_chunk::make_single(size + align);
+      return chunk->allocate(size, align);
+    }
+    if (current_ != nullptr) { current_->retire(); }
+    current_ = context_chunk::make_current(chunk_size);
+    chunk = current_;
+    return current_->allocate(size, align);
+  }
+
+  void release(context_chunk &chunk) noexcept {
+    if (&chunk == current_) {
+      chunk.release_local();
+    } else {
+      chunk.release_shared();
+    }
+  }
+};
+
+inline void release_context(context_frame *frame) noexcept {
+  // A frame whose count is one has no other owner that could add a reference concurrently, so it skips the atomic
+  // decrement; chains are rarely shared.
+  while (frame != nullptr && (frame->refs.load(std::memory_order_acquire) == 1 ||
+                              frame->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)) {
+    context_frame *next = frame->next;
+    context_chunk &chunk = *frame->chunk;
+    if (frame->destroy != nullptr) { frame->destroy(*frame); }
+    context_arena::local().release(chunk);
+    frame = next;
+  }
+}
+
+} // namespace detail
+
+/// @brief An error of type E with a chain of context frames describing what was being done when it happened.
+/// @details Produced by result::context and result::with_context. Frames live in a thread-local arena and are shared
+/// between copies, so adding context costs a pointer bump and copying a context_error costs a reference count. The
+/// chain is only turned into text by message() or operator<<, outermost context first:
+/// `loading config: parsing line 3: unexpected token`. Rendering requires E to be streamable.
+template <typename E> class context_error {
+  E error_;
+  detail::context_frame *head_ = nullptr;
+
+public:
+  using error_type = E;
+
+  explicit context_error(E error) : error_(std::move(error)) {}
+
+  context_error(const context_error &other) : error_(other.error_), head_(other.head_) {
+    if (head_ != nullptr) { head_->refs.fetch_add(1, std::memory_order_relaxed); }
+  }
+  context_error(context_error &&other) noexcept(std::is_nothrow_move_constructible_v<E>)
+      : error_(std::move(other.error_)), head_(std::exchange(other.head_, nullptr)) {}
+  auto operator=(const context_error &other) -> context_error & {
+    if (this != &other) { *this = context_error(other); }
+    return *this;
+  }
+  auto operator=(context_error &&other) noexcept(std::is_nothrow_move_assignable_v<E>) -> context_error & {
+    if (this != &other) {
+      error_ = std::move(other.error_);
+      detail::release_context(std::exchange(head_, std::exchange(other.head_, nullptr)));
+    }
+    return *this;
+  }
+  ~context_error() { detail::release_context(head_); }
+
+  /// @brief The error the context was attached to.
+  [[nodiscard]] auto error() const & noexcept -> const E & { return error_; }
+  [[nodiscard]] auto error() && noexcept -> E && { return std::move(error_); }
+
+  /// @brief The number of context frames in the chain.
+  [[nodiscard]] auto depth() const noexcept -> std::size_t {
+    std::size_t depth = 0;
+    for (const auto *frame = head_; frame != nullptr; frame = frame->next) { ++depth; }
+    return depth;
+  }
+
+  /// @brief Adds text, copied into the arena, as the outermost context.
+  auto add_context(std::string_view text) && -> context_error && {
+    detail::context_chunk *chunk = nullptr;
+    void *memory = detail::context_arena::local().allocate(sizeof(detail::text_frame) + text.size(),
+                                                           alignof(detail::text_frame), chunk);
+    auto *frame = ::new (memory) detail::text_frame();
+    frame->size = text.size();
+    if (!text.empty()) { std::memcpy(frame->characters(), text.data(), text.size()); }
+    frame->render = [](const detail::context_frame &self, std::ostream &stream) {
+      stream << static_cast<const detail::text_frame &>(self).text();
+    };
+    link(*frame, chunk);
+    return std::move(*this);
+  }
+
+  /// @brief Adds the text functor() returns when the error is rendered as the outermost context.
+  template <typename F> auto add_lazy_context(F &&functor) && -> context_error && {
+    using frame_type = detail::lazy_frame<std::decay_t<F>>;
+    static_assert(alignof(frame_type) <= alignof(std::max_align_t), "over-aligned context functors are not supported");
+    detail::context_chunk *chunk = nullptr;
+    void *memory = detail::context_arena::local().allocate(sizeof(frame_type), alignof(frame_type), chunk);
+    auto *frame = ::new (memory) frame_type(std::decay_t<F>(std::forward<F>(functor)));
+    frame->render = [](const detail::context_frame &self, std::ostream &stream) {
+      stream << static_cast<const frame_type &>(self).functor();
+    };
+    if constexpr (!std::is_trivially_destructible_v<frame_type>) {
+      frame->destroy = [](detail::context_frame &self) { static_cast<frame_type &>(self).~frame_type(); };
+    }
+    link(*frame, chunk);
+    return std::move(*this);
+  }
+
+  /// @brief Renders the context chain followed by the error.
+  [[nodiscard]] auto message() const -> std::string {
+    std::ostringstream stream;
+    stream << *this;
+    return stream.str();
+  }
+
+  friend auto operator<<(std::ostream &stream, const context_error &error) -> std::ostream & {
+    for (const auto *frame = error.head_; frame != nullptr; frame = frame->next) {
+      frame->render(*frame, stream);
+      stream << ": ";
+    }
+    return stream << error.error_;
+  }
+
+private:
+  void link(detail::context_frame &frame, detail::context_chunk *chunk) noexcept {
+    frame.chunk = chunk;
+    frame.next = head_;
+    head_ = &frame;
+  }
+};
+
+namespace detail {
+
+// Adding context only happens on failure, so it is kept out of line for the success path of callers to inline.
+template <typename R, typename E> RESULT_NOINLINE auto add_text_context(E &&error, std::string_view text) -> R {
+  return result_access::make_err<R>(context_error_t<std::decay_t<E>>(std::forward<E>(error)).add_context(text));
+}
+
+template <typename R, typename E, typename F> RESULT_NOINLINE auto add_lazy_context(E &&error, F &&functor) -> R {
+  return result_access::make_err<R>(
+      context_error_t<std::decay_t<E>>(std::forward<E>(error)).add_lazy_context(std::forward<F>(functor)));
+}
+
+} // namespace detail
+
+} // namespace res
@@ -0,0 +1,361 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "../result/result.hpp"
+
+// Result coroutines need the object returned by get_return_object to be converted to result<T, E> only once the
+// coroutine has returned to its caller (see result_return). Clang converts it immediately before version 17, Apple
+// Clang before version 16, which would read the result before the coroutine has produced it.
+#if defined(__clang__)
+#if (defined(__apple_build_version__) && __clang_major__ < 16) ||                                                      \
+    (!defined(__apple_build_version__) && __clang_major__ < 17)
+#error "result_coro.h needs Clang 17 or newer (Apple Clang 16 or newer)"
+#endif
+#endif
+
+namespace res {
+
+template <typename T, typename E> class task;
+
+namespace detail {
+
+template <typename T> struct is_task : std::false_type {};
+template <typename T, typename E> struct is_task<task<T, E>> : std::true_type {};
+template <typename T> inline constexpr bool is_task_v = is_task<std::remove_cvref_t<T>>::value;
+
+/// @brief Thread-local cache of coroutine frames, kept in free lists per 64-byte size class.
+/// @details Result coroutines and tasks are created and destroyed at the rate of ordinary calls, so their frames are
+/// recycled instead of going back to the heap every time. Frames larger than the biggest class use the heap directly.
+class frame_cache {
+  static constexpr std::size_t granularity = 64;
+  static constexpr std::size_t classes = 16;
+
+  struct free_frame {
+    free_frame *next;
+  };
+
+  std::array<free_frame *, classes> free_{};
+
+  frame_cache() = default;
+
+public:
+  frame_cache(const frame_cache &) = delete;
+  auto operator=(const frame_cache &) -> frame_cache & = delete;
+  frame_cache(frame_cache &&) = delete;
+  auto operator=(frame_cache &&) -> frame_cache & = delete;
+  ~frame_cache() {
+    for (free_frame *head : free_) {
+      while (head != nullptr) { ::operator delete(std::exchange(head, head->next)); }
+    }
+  }
+
+  static auto allocate(std::size_t size) -> void * {
+    const std::size_t index = size_class(size);
+    if (index < classes) {
+      free_frame *&head = local().free_[index];
+      if (head != nullptr) { return std::exchange(head, head->next); }
+      return ::operator new((index + 1) * granularity);
+    }
+    return ::operator new(size);
+  }
+
+  static void deallocate(void *frame, std::size_t size) noexcept {
+    const std::size_t index = size_class(size);
+    if (index < classes) {
+      free_frame *&head = local().free_[index];
+      head = ::new (frame) free_frame{head};
+      return;
+    }
+    ::operator delete(frame);
+  }
+
+private:
+  static auto size_class(std::size_t size) noexcept -> std::size_t { return (size - 1) / granularity; }
+  static auto local() noexcept -> frame_cache & {
+    thread_local frame_cache cache;
+    return cache;
+  }
+};
+
+/// @brief Base of the promise types whose coroutine frames come from the frame_cache.
+struct cached_frame_promise {
+  static auto operator new(std::size_t size) -> void * { return frame_cache::allocate(size); }
+  static void operator delete(void *frame, std::size_t size) noexcept { frame_cache::deallocate(frame, size); }
+};
+
+/// @brief Awaiter behind `co_await result`: yields the value, or hands the error to the awaiting promise.
+/// @details Source is a reference to the awaited result; values are moved out of rvalue results. Only results are
+/// ever awaited this way, so the success path never suspends.
+template <typename Source> class unwrap_awaiter {
+  using value_type = typename std::remove_cvref_t<Source>::value_type;
+
+  Source source_;
+
+public:
+  explicit unwrap_awaiter(Source source) noexcept : source_(std::forward<Source>(source)) {}
+
+  [[nodiscard]] auto await_ready() const noexcept -> bool { return source_.is_ok(); }
+  template <typename Promise> auto await_suspend(std::coroutine_handle<Promise> handle) {
+    return handle.promise().fail(std::forward<Source>(source_).error(), handle);
+  }
+  auto await_resume()
+      -> std::conditional_t<std::is_lvalue_reference_v<Source>, std::add_lvalue_reference_t<const value_type>,
+                            value_type> {
+    if constexpr (!std::is_void_v<value_type>) {
+      return std::forward<Source>(source_).value();
+    }
+  }
+};
+
+template <typename T, typename E> class result_promise;
+
+/// @brief What a result coroutine returns to its caller before converting it to result<T, E>.
+/// @details The promise writes the final result into this object. Compilers convert it to the declared return type
+/// only when the coroutine first returns to its caller (GCC, MSVC and Clang 17 or newer), by which point a result
+/// coroutine has always finished.
+template <typename T, typename E> class result_return {
+  std::optional<result<T, E>> storage_;
+  result_promise<T, E> *promise_;
+
+public:
+  explicit result_return(result_promise<T, E> &promise) noexcept : promise_(&promise) {
+    promise_->slot_ = &storage_;
+  }
+  result_return(result_return &&other) noexcept : result_return(*other.promise_) {}
+  result_return(const result_return &) = delete;
+  auto operator=(const result_return &) -> result_return & = delete;
+  auto operator=(result_return &&) -> result_return & = delete;
+  ~result_return() = default;
+
+  operator result<T, E>() && { return std::move(*storage_); } // NOLINT(google-explicit-constructor)
+};
+
+/// @brief Promise of coroutines declared to return result<T, E>.
+/// @details The coroutine runs to completion inside the call: it never suspends on success and is destroyed as soon
+/// as an awaited result holds an error, so its frame never outlives the call and compilers may elide its allocation.
+template <typename T, typename E> class result_promise : public cached_frame_promise {
+  using result_type = result<T, E>;
+
+  std::optional<result_type> *slot_ = nullptr;
+
+  friend class result_return<T, E>;
+
+public:
+  auto get_return_object() noexcept -> result_return<T, E> { return result_return<T, E>(*this); }
+  static auto initial_suspend() noexcept -> std::suspend_never { return {}; }
+  static auto final_suspend() noexcept -> std::suspend_never { return {}; }
+#if RESULT_HAS_EXCEPTIONS
+  [[noreturn]] static void unhandled_exception() { throw; }
+#else
+  [[noreturn]] static void unhandled_exception() { std::terminate(); }
+#endif
+
+  template <typename V> void return_value(V &&value) { slot_->emplace(std::forward<V>(value)); }
+
+  template <typename R, typename = std::enable_if_t<is_result_v<std::remove_cvref_t<R>>>>
+  auto await_transform(R &&source) noexcept -> unwrap_awaiter<R &&> {
+    return unwrap_awaiter<R &&>(std::forward<R>(source));
+  }
+
+  template <typename V> void fail(V &&error, std::coroutine_handle<result_promise> handle) {
+    slot_->emplace(result_access::make_err<result_type>(std::forward<V>(error)));
+    handle.destroy();
+  }
+};
+
+/// @brief Promise of task<T, E>. The result lives in the promise, inside the coroutine frame.
+template <typename T, typename E> class task_promise : public cached_frame_promise {
+  using result_type = result<T, E>;
+
+  std::optional<result_type> result_;
+  std::exception_ptr exception_;
+  std::coroutine_handle<> continuation_ = std::noop_coroutine();
+  // Lets whoever awaits the task decide where control goes once it has finished.
+  using finish_hook = auto (*)(void *context) noexcept -> std::coroutine_handle<>;
+  finish_hook on_finish_ = nullptr;
+  void *finish_context_ = nullptr;
+
+  template <typename, typename> friend class task_promise;
+  friend class task<T, E>;
+
+  struct final_awaiter {
+    static auto await_ready() noexcept -> bool { return false; }
+    static auto await_suspend(std::coroutine_handle<task_promise> handle) noexcept -> std::coroutine_handle<> {
+      return handle.promise().next();
+    }
+    static void await_resume() noexcept {}
+  };
+
+  // Awaits another task from inside a task: yields its value or propagates its error like an awaited result.
+  template <typename Task> class task_unwrap_awaiter {
+    Task task_;
+    std::coroutine_handle<task_promise> parent_;
+
+  public:
+    explicit task_unwrap_awaiter(Task task) noexcept : task_(std::forward<Task>(task)) {}
+
+    static auto await_ready() noexcept -> bool { return false; }
+    auto await_suspend(std::coroutine_handle<task_promise> parent) noexcept -> std::coroutine_handle<> {
+      parent_ = parent;
+      task_.handle_.promise().finish_with(&finish, this);
+      return task_.handle_;
+    }
+    auto await_resume() -> typename std::remove_cvref_t<Task>::value_type {
+      auto &child = task_.handle_.promise();
+      if (child.exception_) { std::rethrow_exception(child.exception_); }
+      if constexpr (!std::is_void_v<typename std::remove_cvref_t<Task>::value_type>) {
+        return std::move(*child.result_).value();
+      }
+    }
+
+  private:
+    static auto finish(void *context) noexcept -> std::coroutine_handle<> {
+      auto &self = *static_cast<task_unwrap_awaiter *>(context);
+      auto &child = self.task_.handle_.promise();
+      if (child.exception_ || child.result_->is_ok()) { return self.parent_; }
+      return self.parent_.promise().fail(std::move(*child.result_).error(), self.parent_);
+    }
+  };
+
+public:
+  auto get_return_object() noexcept -> task<T, E> {
+    return task<T, E>(std::coroutine_handle<task_promise>::from_promise(*this));
+  }
+  static auto initial_suspend() noexcept -> std::suspend_always { return {}; }
+  static auto final_suspend() noexcept -> final_awaiter { return {}; }
+  void unhandled_exception() noexcept { exception_ = std::current_exception(); }
+
+  template <typename V> void return_value(V &&value) { result_.emplace(std::forward<V>(value)); }
+
+  template <typename R, std::enable_if_t<is_result_v<std::remove_cvref_t<R>>, int> = 0>
+  auto await_transform(R &&source) noexcept -> unwrap_awaiter<R &&> {
+    return unwrap_awaiter<R &&>(std::forward<R>(source));
+  }
+  template <typename Task, std::enable_if_t<is_task_v<Task>, int> = 0>
+  auto await_transform(Task &&child) noexcept -> task_unwrap_awaiter<Task &&> {
+    return task_unwrap_awaiter<Task &&>(std::forward<Task>(child));
+  }
+  // Any other awaitable is awaited unchanged.
+  template <typename A, std::enable_if_t<!is_result_v<std::remove_cvref_t<A>> && !is_task_v<A>, int> = 0>
+  auto await_transform(A &&awaitable) noexcept -> A && {
+    return std::forward<A>(awaitable);
+  }
+
+  /// @brief Replaces the continuation with on_finish(context), which returns the coroutine to resume.
+  void finish_with(finish_hook on_finish, void *context) noexcept {
+    on_finish_ = on_finish;
+    finish_context_ = context;
+  }
+
+  template <typename V> auto fail(V &&error, std::coroutine_handle<> /*self*/) -> std::coroutine_handle<> {
+    result_.emplace(result_access::make_err<result_type>(std::forward<V>(error)));
+    return next();
+  }
+
+private:
+  auto next() noexcept -> std::coroutine_handle<> {
+    if (on_finish_ != nullptr) { return on_finish_(finish_context_); }
+    return continuation_;
+  }
+};
+
+} // namespace detail
+
+/// @brief Lazily started coroutine producing result<T, E>.
+/// @details Inside a task, `co_await` on a result or on another task yields its value, or finishes the task with its
+/// error; other awaitables are awaited as usual. Awaiting a task from any other coroutine yields its result<T, E>, and
+/// sync_wait runs one from ordinary code. The task owns its frame and destroys it, so a task awaited in the scope that
+/// created it is a candidate for heap allocation elision. An exception escaping the task is rethrown where it is
+/// awaited.
+template <typename T, typename E> class [[nodiscard]] task {
+public:
+  using value_type = T;
+  using error_type = E;
+  using result_type = result<T, E>;
+  using promise_type = detail::task_promise<T, E>;
+
+  task(task &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+  auto operator=(task &&other) noexcept -> task & {
+    if (this != &other) {
+      if (handle_) { handle_.destroy(); }
+      handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+  task(const task &) = delete;
+  auto operator=(const task &) -> task & = delete;
+  ~task() {
+    if (handle_) { handle_.destroy(); }
+  }
+
+  /// @brief Starts the task when awaited and yields its result<T, E>.
+  auto operator co_await() && noexcept {
+    struct awaiter {
+      std::coroutine_handle<promise_type> handle_;
+
+      static auto await_ready() noexcept -> bool { return false; }
+      auto await_suspend(std::coroutine_handle<> continuation) noexcept -> std::coroutine_handle<> {
+        handle_.promise().continuation_ = continuation;
+        return handle_;
+      }
+      auto await_resume() -> result_type { return take(handle_); }
+    };
+    return awaiter{handle_};
+  }
+
+private:
+  std::coroutine_handle<promise_type> handle_;
+
+  template <typename, typename> friend class detail::task_promise;
+  template <typename U, typename F> friend auto sync_wait(task<U, F> work) -> result<U, F>;
+
+  explicit task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+  static auto take(std::coroutine_handle<promise_type> handle) -> result_type {
+    auto &promise = handle.promise();
+    if (promise.exception_) { std::rethrow_exception(promise.exception_); }
+    return std::move(*promise.result_);
+  }
+};
+
+/// @brief Runs a task to completion from ordinary code, blocking until it finishes, and returns its result.
+template <typename T, typename E> auto sync_wait(task<T, E> work) -> result<T, E> {
+  // The task may finish on another thread, which notifies under the lock so the waiter cannot return and destroy the
+  // state before notify_one is done with it.
+  struct completion {
+    std::mutex mutex;
+    std::condition_variable finished;
+    bool done = false;
+  } state;
+  work.handle_.promise().finish_with(
+      [](void *context) noexcept -> std::coroutine_handle<> {
+        auto &finishing = *static_cast<completion *>(context);
+        const std::lock_guard<std::mutex> lock(finishing.mutex);
+        finishing.done = true;
+        finishing.finished.notify_one();
+        return std::noop_coroutine();
+      },
+      &state);
+  work.handle_.resume();
+  {
+    std::unique_lock<std::mutex> lock(state.mutex);
+    state.finished.wait(lock, [&state] { return state.done; });
+  }
+  return task<T, E>::take(work.handle_);
+}
+
+} // namespace res
+
+template <typename T, typename E, typename... Args> struct std::coroutine_traits<res::result<T, E>, Args...> {
+  using promise_type = res::detail::result_promise<T, E>;
+};
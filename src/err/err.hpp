@@ -1,30 +1,104 @@
 #pragma once
 
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../telemetry/telemetry.hpp"
+
 namespace res {
 
 template <typename T, typename E> class result;
 template <typename E> class result<void, E>;
 
 /// @brief Err object represents an unsuccessful outcome and can be implicitly converted to a result.
-/// @details Err object holds an error of type E. Err object can't be empty, E must not be std::monostate.
+/// @details Err object holds an error of type E. Err object can't be empty, E must not be std::monostate. A temporary
+/// Err object moves its error into the result.
 /// @tparam E Type of the error.
 template <typename E> class err {
   E error_;
 
 public:
   err() = delete;
-  explicit err(E error) : error_(std::move(error)) {}
+#if RESULT_ENABLE_TELEMETRY
+  // The defaulted call site is evaluated where res::err is called.
+  constexpr explicit err(E error, const telemetry::call_site &site = telemetry::call_site::current())
+      : error_(std::move(error)) {
+    if (!RESULT_IS_CONSTANT_EVALUATED()) { telemetry::detail::record_error(site); }
+  }
+#else
+  constexpr explicit err(E error) noexcept(std::is_nothrow_move_constructible_v<E>) : error_(std::move(error)) {}
+#endif
 
-  template <typename T> operator result<T, E>() const; // NOLINT(google-explicit-constructor)
-  operator result<void, E>() const;                    // NOLINT(google-explicit-constructor)
+  // NOLINTBEGIN(google-explicit-constructor)
+  template <typename T> constexpr operator result<T, E>() const & noexcept(std::is_nothrow_copy_constructible_v<E>);
+  template <typename T> constexpr operator result<T, E>() && noexcept(std::is_nothrow_move_constructible_v<E>);
+  constexpr operator result<void, E>() const & noexcept(std::is_nothrow_copy_constructible_v<E>);
+  constexpr operator result<void, E>() && noexcept(std::is_nothrow_move_constructible_v<E>);
+  // NOLINTEND(google-explicit-constructor)
 };
 
-template <typename E> template <typename T> inline err<E>::operator result<T, E>() const {
+template <typename E>
+template <typename T>
+constexpr err<E>::operator result<T, E>() const & noexcept(std::is_nothrow_copy_constructible_v<E>) {
   return result<T, E>(result<T, E>::Unsuccessful::UNSUCCESSFUL, error_);
 }
 
-template <typename E> inline err<E>::operator result<void, E>() const {
+template <typename E>
+template <typename T>
+constexpr err<E>::operator result<T, E>() && noexcept(std::is_nothrow_move_constructible_v<E>) {
+  return result<T, E>(result<T, E>::Unsuccessful::UNSUCCESSFUL, std::move(error_));
+}
+
+template <typename E>
+constexpr err<E>::operator result<void, E>() const & noexcept(std::is_nothrow_copy_constructible_v<E>) {
   return result<void, E>(result<void, E>::Unsuccessful::UNSUCCESSFUL, error_);
 }
 
-} // namespace res
\ No newline at end of file
+template <typename E>
+constexpr err<E>::operator result<void, E>() && noexcept(std::is_nothrow_move_constructible_v<E>) {
+  return result<void, E>(result<void, E>::Unsuccessful::UNSUCCESSFUL, std::move(error_));
+}
+
+/// @brief Constructs the error of an unsuccessful result in place from the arguments it references.
+/// @details Returned by err_in_place. It only holds references, so it must be converted within the full expression
+/// that created it.
+template <typename E, typename... Args> class err_in_place_t {
+  std::tuple<Args &&...> args_;
+
+  template <typename R, std::size_t... I> constexpr auto build(std::index_sequence<I...> /*indices*/) -> R {
+    return R(R::Unsuccessful::UNSUCCESSFUL, std::forward<Args>(std::get<I>(args_))...);
+  }
+
+public:
+#if RESULT_ENABLE_TELEMETRY
+  // A call site cannot follow the arguments of err_in_place, so these errors are counted under err_in_place itself.
+  constexpr explicit err_in_place_t(Args &&...args, const telemetry::call_site &site)
+      : args_(std::forward<Args>(args)...) {
+    if (!RESULT_IS_CONSTANT_EVALUATED()) { telemetry::detail::record_error(site); }
+  }
+#else
+  constexpr explicit err_in_place_t(Args &&...args) noexcept : args_(std::forward<Args>(args)...) {}
+#endif
+
+  // The result is returned as a prvalue, so E is constructed directly in its final place and need not be movable.
+  template <typename T> constexpr operator result<T, E>() && { // NOLINT(google-explicit-constructor)
+    return build<result<T, E>>(std::index_sequence_for<Args...>{});
+  }
+  constexpr operator result<void, E>() && { // NOLINT(google-explicit-constructor)
+    return build<result<void, E>>(std::index_sequence_for<Args...>{});
+  }
+};
+
+/// @brief An unsuccessful result whose error is constructed in place from args, without a temporary E.
+template <typename E, typename... Args>
+constexpr auto err_in_place(Args &&...args) noexcept(!RESULT_ENABLE_TELEMETRY) -> err_in_place_t<E, Args...> {
+#if RESULT_ENABLE_TELEMETRY
+  return err_in_place_t<E, Args...>(std::forward<Args>(args)..., telemetry::call_site::current());
+#else
+  return err_in_place_t<E, Args...>(std::forward<Args>(args)...);
+#endif
+}
+
+} // namespace res
@@ -0,0 +1,286 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+
+namespace res {
+
+class error_code;
+class formatted_error;
+
+/// @brief A string interned for the rest of the program by intern_text, usable as an error format argument.
+class interned_text {
+  std::string_view text_;
+
+  friend auto intern_text(std::string_view text) -> interned_text;
+  constexpr explicit interned_text(std::string_view text) noexcept : text_(text) {}
+
+public:
+  [[nodiscard]] constexpr auto view() const noexcept -> std::string_view { return text_; }
+};
+
+namespace detail {
+
+// Format arguments are captured without owning anything, so strings are only accepted when they live until the end of
+// the program: string literals, which are const char arrays, and interned_text. Arg is the forwarded argument type, so
+// a non-const char array such as a snprintf buffer is told apart from a literal and rejected, as are std::string,
+// std::string_view and char pointers. A const char array with automatic storage cannot be told apart from a literal
+// and must not be passed.
+template <typename Arg, typename V = std::remove_reference_t<Arg>>
+inline constexpr bool is_error_arg_v =
+    std::is_array_v<V> ? std::is_same_v<std::remove_extent_t<V>, const char>
+                       : std::is_arithmetic_v<std::remove_cv_t<V>> || std::is_enum_v<V> ||
+                             std::is_same_v<std::remove_cv_t<V>, interned_text>;
+
+template <typename... Args> using enable_if_error_args_t = std::enable_if_t<(is_error_arg_v<Args> && ...)>;
+
+} // namespace detail
+
+/// @brief Static description of an error: its category and a message template with `{}` placeholders.
+/// @details Descriptors are meant to be namespace-scope constants, so their address identifies the error:
+/// `inline constexpr res::error_descriptor cache_miss{"cache", "key {} not found in shard {}"};`. Calling a
+/// descriptor captures format arguments into a formatted_error, e.g. `res::err(cache_miss(key, shard))`.
+struct error_descriptor {
+  std::string_view category;
+  std::string_view format;
+
+  template <typename... Args, typename = detail::enable_if_error_args_t<Args...>>
+  constexpr auto operator()(Args &&...args) const noexcept -> formatted_error;
+};
+
+/// @brief An error that is a single pointer to its error_descriptor.
+/// @details Copying, comparing and returning it costs as much as a pointer, and nothing is allocated until the message
+/// is rendered. Codes compare equal when they refer to the same descriptor.
+class error_code {
+  const error_descriptor *descriptor_;
+
+public:
+  constexpr error_code(const error_descriptor &descriptor) noexcept // NOLINT(google-explicit-constructor)
+      : descriptor_(&descriptor) {}
+
+  [[nodiscard]] constexpr auto descriptor() const noexcept -> const error_descriptor & { return *descriptor_; }
+  [[nodiscard]] constexpr auto category() const noexcept -> std::string_view { return descriptor_->category; }
+  /// @brief The message template, placeholders included.
+  [[nodiscard]] constexpr auto format() const noexcept -> std::string_view { return descriptor_->format; }
+  [[nodiscard]] auto message() const -> std::string { return std::string(descriptor_->format); }
+
+  friend constexpr auto operator==(error_code lhs, error_code rhs) noexcept -> bool {
+    return lhs.descriptor_ == rhs.descriptor_;
+  }
+  friend constexpr auto operator!=(error_code lhs, error_code rhs) noexcept -> bool { return !(lhs == rhs); }
+  friend auto operator<<(std::ostream &stream, error_code code) -> std::ostream & {
+    return stream << code.category() << ": " << code.format();
+  }
+};
+
+static_assert(sizeof(error_code) == sizeof(void *));
+
+namespace detail {
+
+/// @brief Holds a spin lock for the intern tables, which are touched rarely and briefly; a spin lock keeps <mutex> out
+/// of result.h.
+class intern_lock {
+  std::atomic_flag &flag_;
+
+public:
+  explicit intern_lock(std::atomic_flag &flag) noexcept : flag_(flag) {
+    while (flag_.test_and_set(std::memory_order_acquire)) {}
+  }
+  intern_lock(const intern_lock &) = delete;
+  auto operator=(const intern_lock &) -> intern_lock & = delete;
+  ~intern_lock() { flag_.clear(std::memory_order_release); }
+};
+
+} // namespace detail
+
+/// @brief Interns descriptors created at run time, e.g. from configuration, so they can be used as error codes.
+/// @details Interning the same category and format twice yields the same code. The strings are copied once into the
+/// table and live until the end of the program. Interning takes a lock and allocates; codes made from it do not.
+inline auto intern_error(std::string_view category, std::string_view format) -> error_code {
+  struct entry {
+    std::string category;
+    std::string format;
+    error_descriptor descriptor;
+  };
+  static std::atomic_flag busy = ATOMIC_FLAG_INIT;
+  static std::deque<entry> table;
+
+  const detail::intern_lock lock(busy);
+  for (const auto &existing : table) {
+    if (existing.category == category && existing.format == format) { return existing.descriptor; }
+  }
+  auto &added = table.emplace_back(entry{std::string(category), std::string(format), {}});
+  added.descriptor = error_descriptor{added.category, added.format};
+  return added.descriptor;
+}
+
+/// @brief Interns a string built at run time, e.g. a key or a file name, so it can be a format argument.
+/// @details The string is copied once into a table and lives until the end of the program, so interning suits values
+/// from a bounded set; interning takes a lock and may allocate.
+inline auto intern_text(std::string_view text) -> interned_text {
+  static std::atomic_flag busy = ATOMIC_FLAG_INIT;
+  static std::unordered_set<std::string> table;
+
+  const detail::intern_lock lock(busy);
+  return interned_text(*table.emplace(text).first);
+}
+
+namespace detail {
+
+/// @brief A format argument captured by value in 16 bytes.
+/// @details Strings are captured as views, which is why only string literals and interned_text are accepted (see
+/// is_error_arg_v).
+class error_arg {
+  enum class kind : std::uint8_t { none, signed_integer, unsigned_integer, floating, text, boolean };
+
+  union {
+    std::int64_t signed_;
+    std::uint64_t unsigned_;
+    double floating_;
+    const char *text_;
+  };
+  std::uint32_t size_ = 0;
+  kind kind_ = kind::none;
+
+public:
+  constexpr error_arg() noexcept : signed_(0) {}
+
+  template <typename V> constexpr explicit error_arg(const V &value) noexcept : signed_(0) {
+    if constexpr (std::is_same_v<V, bool>) {
+      unsigned_ = value ? 1 : 0;
+      kind_ = kind::boolean;
+    } else if constexpr (std::is_integral_v<V> && std::is_signed_v<V>) {
+      signed_ = value;
+      kind_ = kind::signed_integer;
+    } else if constexpr (std::is_integral_v<V>) {
+      unsigned_ = value;
+      kind_ = kind::unsigned_integer;
+    } else if constexpr (std::is_enum_v<V>) {
+      signed_ = static_cast<std::int64_t>(value);
+      kind_ = kind::signed_integer;
+    } else if constexpr (std::is_floating_point_v<V>) {
+      floating_ = static_cast<double>(value);
+      kind_ = kind::floating;
+    } else {
+      static_assert(is_error_arg_v<const V &>, "format arguments are numbers, enums, string literals or interned_text");
+      std::string_view text;
+      if constexpr (std::is_same_v<V, interned_text>) {
+        text = value.view();
+      } else {
+        text = value;
+      }
+      text_ = text.data();
+      size_ = static_cast<std::uint32_t>(text.size());
+      kind_ = kind::text;
+    }
+  }
+
+  void append_to(std::string &out) const {
+    std::array<char, 32> buffer{};
+    switch (kind_) {
+    case kind::none: break;
+    case kind::signed_integer: {
+      const auto end = std::to_chars(buffer.data(), buffer.data() + buffer.size(), signed_).ptr;
+      out.append(buffer.data(), end);
+      break;
+    }
+    case kind::unsigned_integer: {
+      const auto end = std::to_chars(buffer.data(), buffer.data() + buffer.size(), unsigned_).ptr;
+      out.append(buffer.data(), end);
+      break;
+    }
+    case kind::floating: {
+      const int written = std::snprintf(buffer.data(), buffer.size(), "%g", floating_);
+      out.append(buffer.data(), static_cast<std::size_t>(written));
+      break;
+    }
+    case kind::text: out.append(text_, size_); break;
+    case kind::boolean: out.append(unsigned_ != 0 ? "true" : "false"); break;
+    }
+  }
+};
+
+static_assert(sizeof(error_arg) == 16);
+
+} // namespace detail
+
+/// @brief An error_code with up to max_args format arguments captured by value.
+/// @details It is trivially copyable and never allocates; the message is only rendered by message() or when streamed,
+/// so failure paths that are counted or retried rather than logged never pay for formatting. Placeholders without a
+/// matching argument are rendered as `{}`, and `{{` and `}}` stand for literal braces.
+class formatted_error {
+public:
+  static constexpr std::size_t max_args = 4;
+
+private:
+  error_code code_;
+  std::uint8_t count_ = 0;
+  std::array<detail::error_arg, max_args> args_{};
+
+public:
+  constexpr formatted_error(error_code code) noexcept : code_(code) {} // NOLINT(google-explicit-constructor)
+
+  template <typename... Args, typename = detail::enable_if_error_args_t<Args...>>
+  constexpr formatted_error(error_code code, Args &&...args) noexcept
+      : code_(code), count_(sizeof...(Args)), args_{detail::error_arg(args)...} {
+    static_assert(sizeof...(Args) <= max_args, "too many error format arguments");
+  }
+
+  [[nodiscard]] constexpr auto code() const noexcept -> error_code { return code_; }
+  [[nodiscard]] constexpr auto category() const noexcept -> std::string_view { return code_.category(); }
+
+  /// @brief Renders the message template with the captured arguments.
+  [[nodiscard]] auto message() const -> std::string {
+    std::string out;
+    const std::string_view format = code_.format();
+    out.reserve(format.size() + 8 * count_);
+    std::size_t next = 0;
+    for (std::size_t pos = 0; pos < format.size(); ++pos) {
+      const char chr = format[pos];
+      const bool doubled = pos + 1 < format.size() && format[pos + 1] == chr;
+      if ((chr == '{' || chr == '}') && doubled) {
+        out.push_back(chr);
+        ++pos;
+      } else if (chr == '{' && pos + 1 < format.size() && format[pos + 1] == '}') {
+        if (next < count_) {
+          args_[next++].append_to(out);
+        } else {
+          out.append("{}");
+        }
+        ++pos;
+      } else {
+        out.push_back(chr);
+      }
+    }
+    return out;
+  }
+
+  /// @brief Errors compare by code, the arguments are not compared.
+  friend constexpr auto operator==(const formatted_error &lhs, error_code rhs) noexcept -> bool {
+    return lhs.code_ == rhs;
+  }
+  friend constexpr auto operator!=(const formatted_error &lhs, error_code rhs) noexcept -> bool {
+    return !(lhs == rhs);
+  }
+  friend auto operator<<(std::ostream &stream, const formatted_error &error) -> std::ostream & {
+    return stream << error.category() << ": " << error.message();
+  }
+};
+
+template <typename... Args, typename>
+constexpr auto error_descriptor::operator()(Args &&...args) const noexcept -> formatted_error {
+  return formatted_error(*this, std::forward<Args>(args)...);
+}
+
+} // namespace res
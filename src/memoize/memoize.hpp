@@ -0,0 +1,298 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include "../result/result.hpp"
+
+namespace res {
+
+/// @brief Capacity and time-to-live budgets of a memoized function, separately for ok and err outcomes.
+/// @details Capacities are totals over all shards, split as evenly as they divide; each shard keeps its share and
+/// evicts its least recently used outcome of the same kind once full. A capacity of 0 disables caching of that kind, which still deduplicates
+/// concurrent calls. Outcomes older than their time-to-live are computed again.
+struct memoize_policy {
+  std::size_t ok_capacity = 1024;
+  std::size_t err_capacity = 256;
+  std::chrono::nanoseconds ok_ttl = std::chrono::nanoseconds::max();
+  /// Errors such as a missing key or an upstream reject usually go away eventually, so they expire by default.
+  std::chrono::nanoseconds err_ttl = std::chrono::seconds(1);
+  /// Independent locks; raise it when many threads call the function at once.
+  std::size_t shards = 16;
+};
+
+/// @brief Counters of a memoized function, summed over its shards.
+struct memoize_stats {
+  std::uint64_t ok_hits = 0;
+  std::uint64_t err_hits = 0;
+  std::uint64_t misses = 0;
+  /// Calls that found the same arguments being computed by another thread and waited for its outcome.
+  std::uint64_t coalesced = 0;
+};
+
+namespace detail {
+
+/// @brief Parameter and return types of a function pointer or of a function object with a single call operator.
+template <typename F> struct call_signature : call_signature<decltype(&F::operator())> {};
+template <typename R, typename... Args> struct call_signature<R (*)(Args...)> {
+  using result_type = R;
+  using key_type = std::tuple<std::decay_t<Args>...>;
+};
+template <typename R, typename... Args>
+struct call_signature<R (*)(Args...) noexcept> : call_signature<R (*)(Args...)> {};
+template <typename R, typename C, typename... Args>
+struct call_signature<R (C::*)(Args...)> : call_signature<R (*)(Args...)> {};
+template <typename R, typename C, typename... Args>
+struct call_signature<R (C::*)(Args...) const> : call_signature<R (*)(Args...)> {};
+template <typename R, typename C, typename... Args>
+struct call_signature<R (C::*)(Args...) noexcept> : call_signature<R (*)(Args...)> {};
+template <typename R, typename C, typename... Args>
+struct call_signature<R (C::*)(Args...) const noexcept> : call_signature<R (*)(Args...)> {};
+
+struct tuple_hash {
+  template <typename... Ts> auto operator()(const std::tuple<Ts...> &key) const -> std::size_t {
+    return std::apply(
+        [](const auto &...elements) {
+          std::size_t seed = 0;
+          ((seed = hash_combine(seed, std::hash<std::decay_t<decltype(elements)>>()(elements))), ...);
+          return seed;
+        },
+        key);
+  }
+};
+
+} // namespace detail
+
+/// @brief A function returning result<T, E> whose outcomes, errors included, are cached by argument.
+/// @details Created by res::memoize. The cache is split into shards with a lock each. A miss computes the outcome
+/// without holding the lock, and concurrent calls with the same arguments wait for that computation instead of
+/// repeating it. Calls may come from any number of threads; the wrapped function is called concurrently for different
+/// arguments, so it must be safe to.
+template <typename F, typename Clock = std::chrono::steady_clock> class memoized {
+  using signature = detail::call_signature<F>;
+  using key_type = typename signature::key_type;
+  using time_point = typename Clock::time_point;
+
+public:
+  using result_type = std::decay_t<typename signature::result_type>;
+
+private:
+  static_assert(detail::is_result_v<result_type>, "memoize requires a function that returns a result");
+
+  // The outcome of a computation in progress, handed to the calls waiting for it.
+  struct flight {
+    std::condition_variable done_signal;
+    bool done = false;
+    std::optional<result_type> outcome;
+  };
+
+  struct entry {
+    result_type outcome;
+    time_point expires;
+    typename std::list<const key_type *>::iterator position;
+  };
+
+  struct shard {
+    std::mutex mutex;
+    std::unordered_map<key_type, entry, detail::tuple_hash> entries;
+    std::unordered_map<key_type, std::shared_ptr<flight>, detail::tuple_hash> flights;
+    // Keys of the cached outcomes of each kind, most recently used first. They point into entries, whose nodes
+    // do not move.
+    std::list<const key_type *> ok_order;
+    std::list<const key_type *> err_order;
+    std::size_t ok_capacity = 0;
+    std::size_t err_capacity = 0;
+    memoize_stats stats;
+  };
+
+  // Wakes the waiting calls even if computing or caching the outcome throws; without an outcome they then compute it
+  // themselves.
+  class flight_guard {
+    const memoized &owner_;
+    shard &shard_;
+    const key_type &key_;
+    std::shared_ptr<flight> flight_;
+    bool landed_ = false;
+
+    // Called with the shard locked.
+    void land() noexcept {
+      landed_ = true;
+      flight_->done = true;
+      shard_.flights.erase(key_);
+      flight_->done_signal.notify_all();
+    }
+
+  public:
+    flight_guard(const memoized &owner, shard &slot, const key_type &key, std::shared_ptr<flight> pending)
+        : owner_(owner), shard_(slot), key_(key), flight_(std::move(pending)) {}
+    flight_guard(const flight_guard &) = delete;
+    auto operator=(const flight_guard &) -> flight_guard & = delete;
+    flight_guard(flight_guard &&) = delete;
+    auto operator=(flight_guard &&) -> flight_guard & = delete;
+    ~flight_guard() {
+      if (landed_) { return; }
+      const std::lock_guard<std::mutex> lock(shard_.mutex);
+      land();
+    }
+
+    void finish(const result_type &outcome) {
+      const std::lock_guard<std::mutex> lock(shard_.mutex);
+      flight_->outcome.emplace(outcome);
+      owner_.store(shard_, key_, outcome);
+      land();
+    }
+  };
+
+  // Calling may change the state of a mutable lambda; the wrapper is still used through const references.
+  mutable F function_;
+  memoize_policy policy_;
+  std::unique_ptr<shard[]> shards_;
+
+public:
+  memoized(F function, memoize_policy policy)
+      : function_(std::move(function)), policy_(policy),
+        shards_(std::make_unique<shard[]>(policy.shards == 0 ? 1 : policy.shards)) {
+    if (policy_.shards == 0) { policy_.shards = 1; }
+    for (std::size_t index = 0; index < policy_.shards; ++index) {
+      shards_[index].ok_capacity = share(policy_.ok_capacity, index);
+      shards_[index].err_capacity = share(policy_.err_capacity, index);
+    }
+  }
+
+  /// @brief The cached outcome for args, or the outcome of calling the function with them.
+  template <typename... Args> auto operator()(Args &&...args) const -> result_type {
+    const key_type key(std::forward<Args>(args)...);
+    shard &slot = shard_for(key);
+    std::unique_lock<std::mutex> lock(slot.mutex);
+    while (true) {
+      if (auto cached = lookup(slot, key)) { return std::move(*cached); }
+      const auto in_flight = slot.flights.find(key);
+      if (in_flight == slot.flights.end()) { break; }
+      ++slot.stats.coalesced;
+      const std::shared_ptr<flight> pending = in_flight->second;
+      pending->done_signal.wait(lock, [&] { return pending->done; });
+      if (pending->outcome) { return *pending->outcome; }
+    }
+    ++slot.stats.misses;
+    auto pending = std::make_shared<flight>();
+    slot.flights.emplace(key, pending);
+    lock.unlock();
+    flight_guard guard(*this, slot, key, pending);
+    result_type outcome = std::apply(function_, key);
+    guard.finish(outcome);
+    return outcome;
+  }
+
+  [[nodiscard]] auto stats() const -> memoize_stats {
+    memoize_stats total;
+    for_each_shard([&](shard &slot) {
+      total.ok_hits += slot.stats.ok_hits;
+      total.err_hits += slot.stats.err_hits;
+      total.misses += slot.stats.misses;
+      total.coalesced += slot.stats.coalesced;
+    });
+    return total;
+  }
+
+  /// @brief Number of cached outcomes, expired ones included until they are looked up or evicted.
+  [[nodiscard]] auto size() const -> std::size_t {
+    std::size_t size = 0;
+    for_each_shard([&](shard &slot) { size += slot.entries.size(); });
+    return size;
+  }
+
+  /// @brief Drops every cached outcome. Computations in progress still hand their outcome to the calls waiting for
+  /// them, and cache it.
+  void clear() {
+    for_each_shard([](shard &slot) {
+      slot.ok_order.clear();
+      slot.err_order.clear();
+      slot.entries.clear();
+    });
+  }
+
+private:
+  // The first capacity % shards shards take one outcome more, so the shares add up to the capacity.
+  auto share(std::size_t capacity, std::size_t index) const noexcept -> std::size_t {
+    return capacity / policy_.shards + (index < capacity % policy_.shards ? 1 : 0);
+  }
+
+  auto shard_for(const key_type &key) const -> shard & {
+    // The maps of a shard bucket by the same hash, so the shard is chosen by differently mixed bits.
+    const std::size_t hash = detail::hash_combine(0x5bd1e995U, detail::tuple_hash()(key));
+    return shards_[hash % policy_.shards];
+  }
+
+  template <typename Visit> void for_each_shard(Visit &&visit) const {
+    for (std::size_t index = 0; index < policy_.shards; ++index) {
+      const std::lock_guard<std::mutex> lock(shards_[index].mutex);
+      visit(shards_[index]);
+    }
+  }
+
+  auto order_of(shard &slot, const result_type &outcome) const -> std::list<const key_type *> & {
+    return outcome.is_ok() ? slot.ok_order : slot.err_order;
+  }
+
+  auto lookup(shard &slot, const key_type &key) const -> std::optional<result_type> {
+    const auto found = slot.entries.find(key);
+    if (found == slot.entries.end()) { return std::nullopt; }
+    entry &cached = found->second;
+    auto &order = order_of(slot, cached.outcome);
+    if (Clock::now() >= cached.expires) {
+      order.erase(cached.position);
+      slot.entries.erase(found);
+      return std::nullopt;
+    }
+    order.splice(order.begin(), order, cached.position);
+    ++(cached.outcome.is_ok() ? slot.stats.ok_hits : slot.stats.err_hits);
+    return cached.outcome;
+  }
+
+  // Called with the shard locked.
+  void store(shard &slot, const key_type &key, const result_type &outcome) const {
+    const bool is_ok = outcome.is_ok();
+    const std::size_t capacity = is_ok ? slot.ok_capacity : slot.err_capacity;
+    if (capacity == 0 || slot.entries.count(key) != 0) { return; }
+    auto &order = order_of(slot, outcome);
+    if (order.size() == capacity) {
+      slot.entries.erase(*order.back());
+      order.pop_back();
+    }
+    const auto position = slot.entries.emplace(key, entry{outcome, expiry(is_ok), {}}).first;
+    order.push_front(&position->first);
+    position->second.position = order.begin();
+  }
+
+  auto expiry(bool is_ok) const -> time_point {
+    const auto now = Clock::now();
+    const auto ttl = is_ok ? policy_.ok_ttl : policy_.err_ttl;
+    // Saturates for long or unlimited lifetimes. Compared in floating point so neither side overflows.
+    using approximate = std::chrono::duration<double, std::nano>;
+    if (approximate(ttl) >= approximate(time_point::max() - now)) { return time_point::max(); }
+    return now + std::chrono::duration_cast<typename Clock::duration>(ttl);
+  }
+};
+
+/// @brief Wraps function, which returns a result<T, E>, in a concurrent cache of its outcomes keyed on its arguments.
+/// @details Unlike caching only values, errors are cached too (negative caching), so a recurring failure such as a
+/// missing key does not rerun the full cost of the call every time; policy gives errors their own capacity and
+/// time-to-live. function must have a single call operator or be a function pointer, and its decayed parameter types
+/// must be hashable and equality comparable. Clock is only replaced in tests.
+template <typename Clock = std::chrono::steady_clock, typename F>
+auto memoize(F &&function, memoize_policy policy = {}) -> memoized<std::decay_t<F>, Clock> {
+  return memoized<std::decay_t<F>, Clock>(std::forward<F>(function), policy);
+}
+
+} // namespace res
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "../config/config.hpp"
+#include "../storage/storage.hpp"
+
+namespace res {
+
+/// @brief Customization point describing spare representations of T that result can use as its discriminant.
+/// @details The primary template describes no niche. A specialization may describe one of two kinds of niche:
+///
+/// - Spare bits: `static constexpr unsigned spare_bits` (at least 1), `static auto to_bits(const T &) noexcept ->
+///   std::uintptr_t` and `static void store_bits(T &, std::uintptr_t) noexcept`. Every valid T has its lowest bit
+///   clear, store_bits overwrites the representation without releasing what T owns, and moving a T must carry its
+///   representation unchanged. result<T, E> then packs an integral or enum E smaller than T into T itself and is
+///   sizeof(T); wider errors keep the tagged union. Packed results are not usable in constant expressions.
+/// - Sentinel: `static constexpr auto sentinel() noexcept -> T` returning a value that is never a meaningful T.
+///   result<void, E> then stores a single E and is sizeof(E). Storing the sentinel as an error is reported as misuse
+///   when accesses are checked (see RESULT_CHECKING).
+///
+/// Built-in specializations cover object pointers with alignment above 1 and std::unique_ptr with the default deleter.
+/// Sentinels are never inferred, since any enumerator may be a real error; an enum opts in with its own specialization.
+template <typename T, typename = void> struct niche_traits {};
+
+template <typename T> struct niche_traits<T *, std::enable_if_t<std::is_object_v<T> && (alignof(T) > 1)>> {
+  static constexpr unsigned spare_bits = 1;
+  static auto to_bits(T *const &value) noexcept -> std::uintptr_t { return reinterpret_cast<std::uintptr_t>(value); }
+  static void store_bits(T *&value, std::uintptr_t bits) noexcept { value = reinterpret_cast<T *>(bits); }
+};
+
+template <typename T>
+struct niche_traits<std::unique_ptr<T>, std::enable_if_t<std::is_object_v<T> && (alignof(T) > 1)>> {
+  static constexpr unsigned spare_bits = 1;
+  static auto to_bits(const std::unique_ptr<T> &value) noexcept -> std::uintptr_t {
+    return reinterpret_cast<std::uintptr_t>(value.get());
+  }
+  static void store_bits(std::unique_ptr<T> &value, std::uintptr_t bits) noexcept {
+    (void)value.release();
+    value.reset(reinterpret_cast<T *>(bits));
+  }
+};
+
+namespace detail {
+
+template <typename T, typename = void> struct has_spare_bits : std::false_type {};
+template <typename T>
+struct has_spare_bits<T, std::enable_if_t<(niche_traits<T>::spare_bits > 0)>> : std::true_type {};
+
+template <typename T, typename = void> struct has_sentinel : std::false_type {};
+template <typename T>
+struct has_sentinel<T, std::void_t<decltype(niche_traits<T>::sentinel())>> : std::true_type {};
+
+// Errors that can be shifted above the spare bit of T and recovered losslessly: their representation must leave that
+// bit free both in T itself and in the std::uintptr_t the bits travel through.
+template <typename T, typename E>
+inline constexpr bool packable_error_v = (std::is_enum_v<E> || (std::is_integral_v<E> && !std::is_same_v<E, bool>)) &&
+                                         sizeof(E) < sizeof(T) && sizeof(E) < sizeof(std::uintptr_t);
+
+/// @brief Whether result<T, E> packs its error into the spare bits of T.
+/// @details That layout converts between T and its bits with reinterpret_cast, so such results, e.g.
+/// result<const int *, int>, cannot be used in constant expressions. Every other layout can.
+template <typename T, typename E>
+inline constexpr bool packs_error_v = has_spare_bits<T>::value && packable_error_v<T, E>;
+
+template <typename E, bool = std::is_enum_v<E>> struct packed_repr {
+  using type = std::make_unsigned_t<std::underlying_type_t<E>>;
+};
+template <typename E> struct packed_repr<E, false> {
+  using type = std::make_unsigned_t<E>;
+};
+
+/// @brief Storage for result<T, E> that packs E into the spare low bit of a pointer-like T.
+/// @details The lowest bit set means the storage holds an error whose bits are shifted above it.
+template <typename T, typename E, bool = std::is_trivially_copyable_v<T>> struct tagged_storage {
+  using traits = niche_traits<T>;
+  using error_const_reference = E;
+  using error_rvalue_reference = E;
+
+  T value_;
+
+  template <typename... Args>
+  explicit tagged_storage(in_place_ok_t /*tag*/, Args &&...args) : value_(std::forward<Args>(args)...) {}
+  template <typename... Args> explicit tagged_storage(in_place_err_t /*tag*/, Args &&...args) : value_() {
+    traits::store_bits(value_, encode(E(std::forward<Args>(args)...)));
+  }
+
+  [[nodiscard]] auto has_value() const noexcept -> bool { return (traits::to_bits(value_) & 1U) == 0; }
+  [[nodiscard]] auto value() const & noexcept -> const T & { return value_; }
+  [[nodiscard]] auto value() && noexcept -> T && { return std::move(value_); }
+  [[nodiscard]] auto error() const noexcept -> E { return decode(traits::to_bits(value_)); }
+
+  template <typename... Args> auto emplace_value(Args &&...args) -> T & {
+    *this = tagged_storage(in_place_ok, std::forward<Args>(args)...);
+    return value_;
+  }
+  template <typename... Args> void emplace_error(Args &&...args) {
+    *this = tagged_storage(in_place_err, std::forward<Args>(args)...);
+  }
+
+  static auto encode(E error) noexcept -> std::uintptr_t {
+    using repr = typename packed_repr<E>::type;
+    return (static_cast<std::uintptr_t>(static_cast<repr>(error)) << 1U) | 1U;
+  }
+  static auto decode(std::uintptr_t bits) noexcept -> E {
+    using repr = typename packed_repr<E>::type;
+    return static_cast<E>(static_cast<repr>(bits >> 1U));
+  }
+};
+
+// Owning pointer-like types must never see their tagged representation in a destructor or assignment.
+template <typename T, typename E> struct tagged_storage<T, E, false> : tagged_storage<T, E, true> {
+  using base = tagged_storage<T, E, true>;
+  using traits = typename base::traits;
+  using base::base;
+
+  tagged_storage(tagged_storage &&other) noexcept : base(in_place_ok, std::move(other.value_)) {
+    restore(other);
+  }
+  auto operator=(tagged_storage &&other) noexcept -> tagged_storage & {
+    if (this != &other) {
+      disarm();
+      this->value_ = std::move(other.value_);
+      restore(other);
+    }
+    return *this;
+  }
+  ~tagged_storage() { disarm(); }
+
+  // Emplacing goes through the move assignment above, which releases what the old value owns.
+  template <typename... Args> auto emplace_value(Args &&...args) -> T & {
+    *this = tagged_storage(in_place_ok, std::forward<Args>(args)...);
+    return this->value_;
+  }
+  template <typename... Args> void emplace_error(Args &&...args) {
+    *this = tagged_storage(in_place_err, std::forward<Args>(args)...);
+  }
+
+private:
+  void disarm() noexcept {
+    if (!this->has_value()) { traits::store_bits(this->value_, 0); }
+  }
+  // Moving transferred the tag, so put it back to keep the moved-from storage holding its error.
+  void restore(tagged_storage &other) noexcept {
+    if (!this->has_value()) { traits::store_bits(other.value_, traits::to_bits(this->value_)); }
+  }
+};
+
+/// @brief Storage for result<void, E> that uses the niche sentinel of E as the success state.
+template <typename E> struct sentinel_storage {
+  using traits = niche_traits<E>;
+  using error_const_reference = const E &;
+  using error_rvalue_reference = E &&;
+
+  E error_;
+
+  constexpr explicit sentinel_storage(in_place_ok_t /*tag*/) noexcept : error_(traits::sentinel()) {}
+  template <typename... Args>
+  constexpr explicit sentinel_storage(in_place_err_t /*tag*/, Args &&...args) noexcept
+      : error_(std::forward<Args>(args)...) {
+    check_error();
+  }
+
+  [[nodiscard]] constexpr auto has_value() const noexcept -> bool { return error_ == traits::sentinel(); }
+  [[nodiscard]] constexpr auto error() const & noexcept -> const E & { return error_; }
+  [[nodiscard]] constexpr auto error() && noexcept -> E && { return std::move(error_); }
+
+  constexpr void emplace_value() noexcept { error_ = traits::sentinel(); }
+  template <typename... Args> constexpr void emplace_error(Args &&...args) noexcept {
+    error_ = E(std::forward<Args>(args)...);
+    check_error();
+  }
+
+private:
+  // The sentinel would read back as success, silently dropping the error.
+  constexpr void check_error() const noexcept {
+    if constexpr (checked_access) {
+      if (RESULT_UNLIKELY(error_ == traits::sentinel())) {
+        report_misuse("result<void, E> cannot hold the niche sentinel of E as an error");
+      }
+    }
+  }
+};
+
+template <typename T, typename E, typename = void> struct storage_for {
+  using type = storage<T, E>;
+};
+template <typename T, typename E>
+struct storage_for<T, E, std::enable_if_t<packs_error_v<T, E>>> {
+  using type = tagged_storage<T, E>;
+};
+template <typename E>
+struct storage_for<std::monostate, E, std::enable_if_t<has_sentinel<E>::value && std::is_trivially_copyable_v<E>>> {
+  using type = sentinel_storage<E>;
+};
+
+/// @brief Storage layout result<T, E> uses: a niche layout when T or E has one, the tagged union otherwise.
+template <typename T, typename E> using storage_for_t = typename storage_for<T, E>::type;
+
+} // namespace detail
+
+} // namespace res
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <variant>
 
 namespace res {
@@ -8,25 +13,67 @@ template <typename T, typename E> class result;
 template <typename E> class result<void, E>;
 
 /// @brief Ok object represents a successful outcome and can be implicitly converted to a result.
-/// @details Ok object holds a value of type T. Empty Ok object can be created if T is std::monostate.
-/// @tparam T Type of the value. Defaults to std::monostate.
+/// @details Ok object holds a value of type T. Empty Ok object can be created if T is std::monostate. A temporary Ok
+/// object moves its value into the result, so move-only values can be returned with `return res::ok(std::move(x));`.
+/// @tparam T Type of the value. Defaults to std::monostate. An lvalue reference makes a result<T &, E>, which
+/// `res::ok(std::ref(x))` deduces.
 template <typename T = std::monostate> class ok {
   T value_;
 
 public:
   ok() = default;
-  explicit ok(T value) : value_(std::move(value)) {}
+  constexpr explicit ok(T value) noexcept(std::is_nothrow_move_constructible_v<T>) : value_(std::forward<T>(value)) {}
 
-  template <typename E> operator result<T, E>() const;    // NOLINT(google-explicit-constructor)
-  template <typename E> operator result<void, E>() const; // NOLINT(google-explicit-constructor)
+  // NOLINTBEGIN(google-explicit-constructor)
+  template <typename E> constexpr operator result<T, E>() const & noexcept(std::is_nothrow_copy_constructible_v<T>);
+  template <typename E> constexpr operator result<T, E>() && noexcept(std::is_nothrow_move_constructible_v<T>);
+  template <typename E> constexpr operator result<void, E>() const noexcept;
+  // NOLINTEND(google-explicit-constructor)
 };
 
-template <typename T> template <typename E> inline ok<T>::operator result<T, E>() const {
+template <typename T> ok(std::reference_wrapper<T>) -> ok<T &>;
+
+template <typename T>
+template <typename E>
+constexpr ok<T>::operator result<T, E>() const & noexcept(std::is_nothrow_copy_constructible_v<T>) {
   return result<T, E>(result<T, E>::Successful::SUCCESSFUL, value_);
 }
 
-template <typename T> template <typename E> inline ok<T>::operator result<void, E>() const {
+template <typename T>
+template <typename E>
+constexpr ok<T>::operator result<T, E>() && noexcept(std::is_nothrow_move_constructible_v<T>) {
+  return result<T, E>(result<T, E>::Successful::SUCCESSFUL, std::forward<T>(value_));
+}
+
+template <typename T> template <typename E> constexpr ok<T>::operator result<void, E>() const noexcept {
   return result<void, E>(result<void, E>::Successful::SUCCESSFUL);
 }
 
-} // namespace res
\ No newline at end of file
+/// @brief Constructs the value of a successful result in place from the arguments it references.
+/// @details Returned by ok_in_place. It only holds references, so it must be converted within the full expression
+/// that created it, which `return res::ok_in_place<T>(...);` does.
+template <typename T, typename... Args> class ok_in_place_t {
+  std::tuple<Args &&...> args_;
+
+  template <typename E, std::size_t... I> constexpr auto build(std::index_sequence<I...> /*indices*/) -> result<T, E> {
+    return result<T, E>(result<T, E>::Successful::SUCCESSFUL, std::forward<Args>(std::get<I>(args_))...);
+  }
+
+public:
+  constexpr explicit ok_in_place_t(Args &&...args) noexcept : args_(std::forward<Args>(args)...) {}
+
+  // The result is returned as a prvalue, so T is constructed directly in its final place and need not be movable.
+  template <typename E> constexpr operator result<T, E>() && { // NOLINT(google-explicit-constructor)
+    return build<E>(std::index_sequence_for<Args...>{});
+  }
+};
+
+/// @brief A successful result whose value is constructed in place from args, without a temporary T.
+/// @details `return res::ok_in_place<std::vector<int>>(size, 0);`. Works for types that can be neither copied nor
+/// moved.
+template <typename T, typename... Args>
+constexpr auto ok_in_place(Args &&...args) noexcept -> ok_in_place_t<T, Args...> {
+  return ok_in_place_t<T, Args...>(std::forward<Args>(args)...);
+}
+
+} // namespace res
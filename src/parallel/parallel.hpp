@@ -0,0 +1,182 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../collect/collect.hpp"
+#include "../result/result.hpp"
+
+namespace res {
+
+/// @brief Which error par_traverse reports when several elements fail.
+enum class error_order {
+  /// The error of the failing element with the lowest index, the same one traverse would return. Elements below a
+  /// known failure keep running until it is confirmed to be the first.
+  first_by_index,
+  /// The first error any worker produced. Every worker stops as soon as it is recorded.
+  first_in_time,
+};
+
+/// @brief Executor that runs par_traverse workers on freshly started threads.
+/// @details An executor provides `concurrency()`, the number of workers worth starting, and `execute(workers, job)`,
+/// which calls `job(index)` for every index below workers concurrently and returns once all calls have returned.
+/// Adapters over existing thread pools only need these two members.
+class thread_executor {
+  std::size_t threads_;
+
+public:
+  explicit thread_executor(std::size_t threads = std::thread::hardware_concurrency()) noexcept
+      : threads_(std::max<std::size_t>(threads, 1)) {}
+
+  [[nodiscard]] auto concurrency() const noexcept -> std::size_t { return threads_; }
+
+  template <typename Job> void execute(std::size_t workers, Job &job) const {
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (std::size_t index = 1; index < workers; ++index) { threads.emplace_back([&job, index] { job(index); }); }
+    job(0);
+    for (auto &thread : threads) { thread.join(); }
+  }
+};
+
+namespace detail {
+
+// Elements are written from several threads, so packed std::vector<bool> slots are never used.
+template <typename T>
+inline constexpr bool direct_slots_v = std::is_default_constructible_v<T> && !std::is_same_v<T, bool>;
+
+template <typename T> using par_slot_t = std::conditional_t<direct_slots_v<T>, T, std::optional<T>>;
+
+/// @brief State shared by the workers of one par_traverse call.
+/// @details cutoff_ is the index from which elements are skipped: the lowest failing index under first_by_index, zero
+/// once any error or exception is recorded under first_in_time.
+template <typename E> class par_cancellation {
+  std::atomic<std::size_t> cutoff_;
+  error_order order_;
+  std::mutex mutex_;
+  std::size_t error_index_;
+  std::optional<E> error_;
+  std::exception_ptr exception_;
+
+public:
+  par_cancellation(std::size_t size, error_order order) : cutoff_(size), order_(order), error_index_(size) {}
+
+  [[nodiscard]] auto skips(std::size_t index) const noexcept -> bool {
+    return index >= cutoff_.load(std::memory_order_relaxed);
+  }
+
+  template <typename V> void fail(std::size_t index, V &&error) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    const bool replaces = !error_.has_value() || (order_ == error_order::first_by_index && index < error_index_);
+    if (replaces) {
+      error_index_ = index;
+      error_.emplace(std::forward<V>(error));
+    }
+    lower_cutoff(order_ == error_order::first_by_index ? index : 0);
+  }
+
+  void abort(std::exception_ptr exception) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if (!exception_) { exception_ = std::move(exception); }
+    lower_cutoff(0);
+  }
+
+  // Called after every worker has returned.
+  [[nodiscard]] auto exception() const noexcept -> const std::exception_ptr & { return exception_; }
+  [[nodiscard]] auto error() && -> std::optional<E> { return std::move(error_); }
+
+private:
+  void lower_cutoff(std::size_t index) noexcept {
+    std::size_t current = cutoff_.load(std::memory_order_relaxed);
+    while (index < current && !cutoff_.compare_exchange_weak(current, index, std::memory_order_relaxed)) {}
+  }
+};
+
+} // namespace detail
+
+/// @brief Applies a fallible functor to every element of a random-access range on several threads.
+/// @details Returns the values in input order, or an error chosen by order. Workers claim chunks of consecutive
+/// elements from a shared counter, so faster workers take over the remaining work, and they stop claiming and running
+/// elements as soon as a recorded error makes them irrelevant. Exceptions thrown by functor cancel the other workers
+/// and are rethrown once they have stopped. functor is called concurrently from several threads. Elements of rvalue
+/// ranges are passed to functor as rvalues.
+template <typename Range, typename F, typename Executor,
+          typename Mapped = std::decay_t<std::invoke_result_t<F &, detail::range_forward_t<Range>>>>
+auto par_traverse(Range &&range, F &&functor, const Executor &executor,
+                  error_order order = error_order::first_by_index)
+    -> result<std::vector<typename Mapped::value_type>, typename Mapped::error_type> {
+  static_assert(detail::is_result_v<Mapped>, "par_traverse requires a functor that returns a result");
+  using value_type = typename Mapped::value_type;
+  using error_type = typename Mapped::error_type;
+  using output = result<std::vector<value_type>, error_type>;
+
+  const auto first = std::begin(range);
+  const auto size = static_cast<std::size_t>(std::distance(first, std::end(range)));
+  const std::size_t workers = std::max<std::size_t>(std::min(executor.concurrency(), size), 1);
+  // Several chunks per worker keep the load balanced without contending on the counter for every element.
+  const std::size_t grain = std::max<std::size_t>(size / (workers * 8), 1);
+
+  std::vector<detail::par_slot_t<value_type>> slots(size);
+  std::atomic<std::size_t> next{0};
+  detail::par_cancellation<error_type> cancellation(size, order);
+
+  auto work = [&] {
+    for (;;) {
+      const std::size_t begin = next.fetch_add(grain, std::memory_order_relaxed);
+      if (begin >= size || cancellation.skips(begin)) { return; }
+      const std::size_t end = std::min(begin + grain, size);
+      for (std::size_t index = begin; index < end && !cancellation.skips(index); ++index) {
+        auto mapped = functor(static_cast<detail::range_forward_t<Range>>(*(first + index)));
+        if (mapped.is_ok()) {
+          slots[index] = std::move(mapped).value();
+        } else {
+          cancellation.fail(index, std::move(mapped).error());
+        }
+      }
+    }
+  };
+  auto job = [&](std::size_t /*worker*/) {
+#if RESULT_HAS_EXCEPTIONS
+    try {
+      work();
+    } catch (...) {
+      cancellation.abort(std::current_exception());
+    }
+#else
+    work();
+#endif
+  };
+  executor.execute(workers, job);
+
+#if RESULT_HAS_EXCEPTIONS
+  if (cancellation.exception()) { std::rethrow_exception(cancellation.exception()); }
+#endif
+  if (auto error = std::move(cancellation).error()) {
+    return detail::result_access::make_err<output>(std::move(*error));
+  }
+  if constexpr (detail::direct_slots_v<value_type>) {
+    return detail::result_access::make_ok<output>(std::move(slots));
+  } else {
+    std::vector<value_type> values;
+    values.reserve(size);
+    for (auto &slot : slots) { values.push_back(std::move(*slot)); }
+    return detail::result_access::make_ok<output>(std::move(values));
+  }
+}
+
+/// @brief par_traverse on a thread_executor with one thread per hardware thread.
+template <typename Range, typename F>
+auto par_traverse(Range &&range, F &&functor, error_order order = error_order::first_by_index) {
+  return par_traverse(std::forward<Range>(range), std::forward<F>(functor), thread_executor(), order);
+}
+
+} // namespace res
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../result/result.hpp"
+
+namespace res {
+
+namespace detail {
+
+// Placeholder carried through the ok lane of a pipeline when the value type is void.
+struct void_value {};
+
+template <typename F, typename T, bool = std::is_void_v<T>> struct value_invoke_result {
+  using type = std::invoke_result_t<F, T>;
+};
+template <typename F, typename T> struct value_invoke_result<F, T, true> {
+  using type = std::invoke_result_t<F>;
+};
+template <typename F, typename T> using value_invoke_result_t = typename value_invoke_result<F, T>::type;
+
+template <typename F, typename V> constexpr decltype(auto) invoke_value(F &f, V &&value) {
+  if constexpr (std::is_same_v<std::decay_t<V>, void_value>) {
+    return f();
+  } else {
+    return f(std::forward<V>(value));
+  }
+}
+
+template <typename F> struct map_stage {
+  F functor;
+};
+template <typename F> struct and_then_stage {
+  F functor;
+};
+template <typename F> struct map_err_stage {
+  F functor;
+};
+template <typename F> struct or_else_stage {
+  F functor;
+};
+
+// Computes the result type a list of stages produces from result<T, E>.
+template <typename T, typename E, typename... Stages> struct pipeline_result {
+  using type = result<T, E>;
+};
+template <typename T, typename E, typename F, typename... Rest>
+struct pipeline_result<T, E, map_stage<F>, Rest...>
+    : pipeline_result<value_invoke_result_t<F &, T>, E, Rest...> {};
+template <typename T, typename E, typename F, typename... Rest>
+struct pipeline_result<T, E, and_then_stage<F>, Rest...>
+    : pipeline_result<typename value_invoke_result_t<F &, T>::value_type, E, Rest...> {
+  static_assert(std::is_same_v<typename value_invoke_result_t<F &, T>::error_type, E>,
+                "and_then stage must keep the error type");
+};
+template <typename T, typename E, typename F, typename... Rest>
+struct pipeline_result<T, E, map_err_stage<F>, Rest...> : pipeline_result<T, std::invoke_result_t<F &, E>, Rest...> {};
+template <typename T, typename E, typename F, typename... Rest>
+struct pipeline_result<T, E, or_else_stage<F>, Rest...>
+    : pipeline_result<T, typename std::invoke_result_t<F &, E>::error_type, Rest...> {
+  static_assert(std::is_same_v<typename std::invoke_result_t<F &, E>::value_type, T>,
+                "or_else stage must keep the value type");
+};
+
+/// @brief Runs a list of stages as one function.
+/// @details Values travel through the ok lane and errors through the err lane as plain T and E; only and_then and
+/// or_else stages test a discriminant and only the final result is ever constructed.
+template <typename Final, typename... Stages> struct pipeline_runner {
+  using stages_type = std::tuple<Stages...>;
+
+  template <std::size_t I, typename V> static constexpr auto run_ok(stages_type &stages, V &&value) -> Final {
+    if constexpr (I == sizeof...(Stages)) {
+      if constexpr (std::is_same_v<std::decay_t<V>, void_value>) {
+        return result_access::make_ok<Final>();
+      } else {
+        return result_access::make_ok<Final>(std::forward<V>(value));
+      }
+    } else {
+      using stage = std::tuple_element_t<I, stages_type>;
+      auto &functor = std::get<I>(stages).functor;
+      if constexpr (is_specialization_v<stage, map_stage>) {
+        if constexpr (std::is_void_v<decltype(invoke_value(functor, std::forward<V>(value)))>) {
+          invoke_value(functor, std::forward<V>(value));
+          return run_ok<I + 1>(stages, void_value{});
+        } else {
+          return run_ok<I + 1>(stages, invoke_value(functor, std::forward<V>(value)));
+        }
+      } else if constexpr (is_specialization_v<stage, and_then_stage>) {
+        auto next = invoke_value(functor, std::forward<V>(value));
+        if (next.is_ok()) { return run_ok_from<I + 1>(stages, std::move(next)); }
+        return run_err<I + 1>(stages, std::move(next).error());
+      } else {
+        return run_ok<I + 1>(stages, std::forward<V>(value));
+      }
+    }
+  }
+
+  template <std::size_t I, typename V> static constexpr auto run_err(stages_type &stages, V &&error) -> Final {
+    if constexpr (I == sizeof...(Stages)) {
+      return result_access::make_err<Final>(std::forward<V>(error));
+    } else {
+      using stage = std::tuple_element_t<I, stages_type>;
+      auto &functor = std::get<I>(stages).functor;
+      if constexpr (is_specialization_v<stage, map_err_stage>) {
+        return run_err<I + 1>(stages, functor(std::forward<V>(error)));
+      } else if constexpr (is_specialization_v<stage, or_else_stage>) {
+        auto next = functor(std::forward<V>(error));
+        if (next.is_ok()) { return run_ok_from<I + 1>(stages, std::move(next)); }
+        return run_err<I + 1>(stages, std::move(next).error());
+      } else {
+        return run_err<I + 1>(stages, std::forward<V>(error));
+      }
+    }
+  }
+
+  template <std::size_t I, typename R> static constexpr auto run_ok_from(stages_type &stages, R &&source) -> Final {
+    if constexpr (std::is_void_v<typename std::decay_t<R>::value_type>) {
+      return run_ok<I>(stages, void_value{});
+    } else {
+      return run_ok<I>(stages, std::forward<R>(source).value());
+    }
+  }
+
+  template <typename R> static constexpr auto run(stages_type &stages, R &&source) -> Final {
+    if (source.is_ok()) { return run_ok_from<0>(stages, std::forward<R>(source)); }
+    return run_err<0>(stages, std::forward<R>(source).error());
+  }
+
+private:
+  template <typename S, template <typename> class Stage> struct is_specialization : std::false_type {};
+  template <typename F, template <typename> class Stage>
+  struct is_specialization<Stage<F>, Stage> : std::true_type {};
+  template <typename S, template <typename> class Stage>
+  static constexpr bool is_specialization_v = is_specialization<S, Stage>::value;
+};
+
+} // namespace detail
+
+template <typename Source, typename P> class deferred_result;
+
+/// @brief A composition of map, and_then, map_err and or_else stages that runs as a single function.
+/// @details Pipelines are built with res::map, res::and_then, res::map_err and res::or_else and joined with `|`.
+/// Applying one to a result with `|` yields a deferred_result that is evaluated when converted to a result or when
+/// run() is called.
+template <typename... Stages> class pipeline {
+  std::tuple<Stages...> stages_;
+
+public:
+  constexpr explicit pipeline(std::tuple<Stages...> stages) : stages_(std::move(stages)) {}
+
+  /// @brief Releases the stages, used when pipelines are joined.
+  constexpr auto stages() && -> std::tuple<Stages...> { return std::move(stages_); }
+
+  template <typename... Other>
+  friend constexpr auto operator|(pipeline lhs, pipeline<Other...> rhs) -> pipeline<Stages..., Other...> {
+    return pipeline<Stages..., Other...>(std::tuple_cat(std::move(lhs.stages_), std::move(rhs).stages()));
+  }
+
+  /// @brief Applies the pipeline to a result. Rvalue results are moved into the deferred result, lvalues are
+  /// referenced.
+  template <typename R, typename = std::enable_if_t<detail::is_result_v<R>>>
+  friend constexpr auto operator|(R &&source, pipeline stages)
+      -> deferred_result<std::conditional_t<std::is_lvalue_reference_v<R>, const std::decay_t<R> &, std::decay_t<R>>,
+                         pipeline> {
+    using source_type = std::conditional_t<std::is_lvalue_reference_v<R>, const std::decay_t<R> &, std::decay_t<R>>;
+    return deferred_result<source_type, pipeline>(std::forward<R>(source), std::move(stages.stages_));
+  }
+};
+
+/// @brief A result with a pipeline applied to it that has not been evaluated yet.
+template <typename Source, typename... Stages> class deferred_result<Source, pipeline<Stages...>> {
+  using source_type = std::decay_t<Source>;
+  using stages_type = std::tuple<Stages...>;
+
+  Source source_;
+  stages_type stages_;
+
+public:
+  using result_type =
+      typename detail::pipeline_result<typename source_type::value_type, typename source_type::error_type,
+                                       Stages...>::type;
+
+  constexpr deferred_result(Source source, stages_type stages)
+      : source_(std::forward<Source>(source)), stages_(std::move(stages)) {}
+
+  /// @brief Evaluates every stage in a single pass and returns the final result.
+  constexpr auto run() && -> result_type {
+    return detail::pipeline_runner<result_type, Stages...>::run(stages_, std::forward<Source>(source_));
+  }
+  constexpr operator result_type() && { return std::move(*this).run(); } // NOLINT(google-explicit-constructor)
+
+  template <typename... Other>
+  friend constexpr auto operator|(deferred_result &&lhs, pipeline<Other...> rhs)
+      -> deferred_result<Source, pipeline<Stages..., Other...>> {
+    return deferred_result<Source, pipeline<Stages..., Other...>>(
+        std::forward<Source>(lhs.source_), std::tuple_cat(std::move(lhs.stages_), std::move(rhs).stages()));
+  }
+};
+
+/// @brief Pipeline stage equivalent to result::map.
+template <typename F> constexpr auto map(F &&functor) -> pipeline<detail::map_stage<std::decay_t<F>>> {
+  using stage = detail::map_stage<std::decay_t<F>>;
+  return pipeline<stage>(std::make_tuple(stage{std::forward<F>(functor)}));
+}
+
+/// @brief Pipeline stage equivalent to result::and_then.
+template <typename F> constexpr auto and_then(F &&functor) -> pipeline<detail::and_then_stage<std::decay_t<F>>> {
+  using stage = detail::and_then_stage<std::decay_t<F>>;
+  return pipeline<stage>(std::make_tuple(stage{std::forward<F>(functor)}));
+}
+
+/// @brief Pipeline stage equivalent to result::map_err.
+template <typename F> constexpr auto map_err(F &&functor) -> pipeline<detail::map_err_stage<std::decay_t<F>>> {
+  using stage = detail::map_err_stage<std::decay_t<F>>;
+  return pipeline<stage>(std::make_tuple(stage{std::forward<F>(functor)}));
+}
+
+/// @brief Pipeline stage equivalent to result::or_else.
+template <typename F> constexpr auto or_else(F &&functor) -> pipeline<detail::or_else_stage<std::decay_t<F>>> {
+  using stage = detail::or_else_stage<std::decay_t<F>>;
+  return pipeline<stage>(std::make_tuple(stage{std::forward<F>(functor)}));
+}
+
+} // namespace res
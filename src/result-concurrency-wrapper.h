@@ -0,0 +1,21 @@
+/// @file
+/// @brief Concurrency support for result: par_traverse on a thread pool, async_result with promise and continuations,
+/// and the thread-safe memoize cache.
+///
+/// This header is opt-in because it pulls in <thread>, <mutex> and <condition_variable>. It contains the whole library,
+/// so it can be used instead of result.h.
+/// @author GregoryKogan
+/// @par License
+/// This software is released under the GNU GENERAL PUBLIC LICENSE Version 3.
+/// @par Contact
+/// My github page: https://github.com/GregoryKogan
+
+#ifndef RESULT_CONCURRENCY_LIB
+#define RESULT_CONCURRENCY_LIB
+
+#include "result-wrapper.h"
+#include "parallel/parallel.hpp"
+#include "async/async.hpp"
+#include "memoize/memoize.hpp"
+
+#endif // RESULT_CONCURRENCY_LIB
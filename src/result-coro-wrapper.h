@@ -0,0 +1,18 @@
+/// @file
+/// @brief C++20 coroutine support for result: coroutines returning result<T, E> that propagate errors with co_await,
+/// and the lazy task<T, E>.
+///
+/// This header is opt-in and requires C++20. It contains the whole library, so it can be used instead of result.h.
+/// @author GregoryKogan
+/// @par License
+/// This software is released under the GNU GENERAL PUBLIC LICENSE Version 3.
+/// @par Contact
+/// My github page: https://github.com/GregoryKogan
+
+#ifndef RESULT_CORO_LIB
+#define RESULT_CORO_LIB
+
+#include "result-wrapper.h"
+#include "coro/coro.hpp"
+
+#endif // RESULT_CORO_LIB
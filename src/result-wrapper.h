@@ -15,5 +15,15 @@
 #define RESULT_LIB
 
 #include "result/result.hpp"
+#include "try/try.hpp"
+#include "pipeline/pipeline.hpp"
+#include "result_vector/result_vector.hpp"
+#include "collect/collect.hpp"
+#include "error_code/error_code.hpp"
+#include "context/context.hpp"
+#include "serialize/serialize.hpp"
+#include "zip/zip.hpp"
+#include "validated/validated.hpp"
+#include "any_error/any_error.hpp"
 
 #endif // RESULT_LIB
\ No newline at end of file
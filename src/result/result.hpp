@@ -1,60 +1,265 @@
 #pragma once
 
-#include <optional>
-#include <stdexcept>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 #include <variant>
 
+#include "../config/config.hpp"
 #include "../err/err.hpp"
 #include "../ok/ok.hpp"
+#include "../niche/niche.hpp"
 
 namespace res {
 
+template <typename E> class context_error;
+
+namespace detail {
+
+template <typename R> struct is_result : std::false_type {};
+template <typename T, typename E> struct is_result<result<T, E>> : std::true_type {};
+template <typename R>
+inline constexpr bool is_result_v = is_result<std::remove_cv_t<std::remove_reference_t<R>>>::value;
+
+template <typename Result> class error_forwarder;
+
+// Adding context to an error that already carries some extends its chain instead of nesting context_errors.
+template <typename E> struct context_error_for {
+  using type = context_error<E>;
+};
+template <typename E> struct context_error_for<context_error<E>> {
+  using type = context_error<E>;
+};
+template <typename E> using context_error_t = typename context_error_for<E>::type;
+
+// Failure paths of result::context and result::with_context, defined with context_error.
+template <typename R, typename E> auto add_text_context(E &&error, std::string_view text) -> R;
+template <typename R, typename E, typename F> auto add_lazy_context(E &&error, F &&functor) -> R;
+
+// result<T &, E> stores a pointer to the referenced object, which also lets it use the niche of pointers.
+template <typename T> struct stored_value {
+  using type = T;
+};
+template <typename T> struct stored_value<T &> {
+  using type = T *;
+};
+template <typename T> using stored_value_t = typename stored_value<T>::type;
+
+// Turns a constructor argument of result<T, E> into what its storage holds: the address for references, the argument
+// itself otherwise.
+template <typename T, typename Arg> constexpr auto store_value(Arg &&arg) noexcept -> decltype(auto) {
+  if constexpr (std::is_reference_v<T>) {
+    static_assert(std::is_lvalue_reference_v<Arg &&>, "result<T &, E> cannot refer to a temporary");
+    return std::addressof(arg);
+  } else {
+    return std::forward<Arg>(arg);
+  }
+}
+
+/// @brief Grants library components outside of result (pipelines, algorithms) access to its named constructors.
+struct result_access {
+  template <typename R, typename... Args> static constexpr auto make_ok(Args &&...args) -> R {
+    return R(R::SUCCESSFUL, std::forward<Args>(args)...);
+  }
+  template <typename R, typename... Args> static constexpr auto make_err(Args &&...args) -> R {
+    return R(R::UNSUCCESSFUL, std::forward<Args>(args)...);
+  }
+};
+
+} // namespace detail
+
 /// @brief `result` is a type that represents either success or failure.
 ///
 /// result<T, E> is the type used for returning and propagating errors. It holds either a successful value of type T or
 /// an error of type E.
+///
+/// Results are usable in constant expressions, except those that pack an integral or enum error into the spare bits of
+/// a pointer-like T (see niche_traits and detail::packs_error_v), which are runtime-only.
 /// @tparam T
 /// @tparam E
 template <typename T, typename E> class result {
   static_assert(!std::is_same_v<T, void>, "T (value type) must not be void");
   static_assert(!std::is_same_v<E, void>, "E (error type) must not be void");
+  static_assert(!std::is_rvalue_reference_v<T>, "T (value type) must not be an rvalue reference");
 
-  std::variant<T, E> content_;
+  using storage_type = detail::storage_for_t<detail::stored_value_t<T>, E>;
+  storage_type storage_;
 
   // Simulate named constructors
   enum Successful { SUCCESSFUL };
   enum Unsuccessful { UNSUCCESSFUL };
-  result(Successful successful, T value) { content_.template emplace<0>(std::move(value)); }
-  result(Unsuccessful unsuccessful, E error) { content_.template emplace<1>(std::move(error)); }
+  // Arguments are forwarded to the constructor of T or E, so the member is built once, in place.
+  template <typename... Args>
+  constexpr result(Successful /*tag*/, Args &&...args)
+      : storage_(detail::in_place_ok, detail::store_value<T>(std::forward<Args>(args))...) {}
+  template <typename... Args>
+  constexpr result(Unsuccessful /*tag*/, Args &&...args)
+      : storage_(detail::in_place_err, std::forward<Args>(args)...) {}
 
   template <typename U> friend class ok;
   template <typename U> friend class err;
+  template <typename U, typename... Args> friend class ok_in_place_t;
+  template <typename U, typename... Args> friend class err_in_place_t;
+  template <typename U, typename V> friend class result;
+  template <typename R> friend class detail::error_forwarder;
+  friend struct detail::result_access;
 
 public:
+  using value_type = T;
+  using error_type = E;
+
   // Observers
-  [[nodiscard]] auto is_ok() const -> bool { return content_.index() == 0; }
-  explicit operator bool() const { return is_ok(); }
-  auto operator!() const -> bool { return !is_ok(); }
+  [[nodiscard]] constexpr auto is_ok() const noexcept -> bool { return storage_.has_value(); }
+  constexpr explicit operator bool() const noexcept { return is_ok(); }
+  constexpr auto operator!() const noexcept -> bool { return !is_ok(); }
 
-  [[nodiscard]] auto value() const -> const T &;
-  [[nodiscard]] auto value_or(T &&default_value) const -> T;
-  [[nodiscard]] auto error() const -> const E &;
+  // Checked accessors are noexcept unless RESULT_CHECKING throws on a wrong access.
+  [[nodiscard]] constexpr auto value() const & noexcept(!detail::throwing_access) -> const T &;
+  [[nodiscard]] constexpr auto value() && noexcept(!detail::throwing_access) -> T &&;
+  [[nodiscard]] constexpr auto value_or(T &&default_value) const & noexcept(
+      std::is_nothrow_copy_constructible_v<T> && std::is_nothrow_move_constructible_v<T>) -> T;
+  [[nodiscard]] constexpr auto value_or(T &&default_value) && noexcept(std::is_nothrow_move_constructible_v<T>) -> T;
+  [[nodiscard]] constexpr auto error() const & noexcept(!detail::throwing_access) ->
+      typename storage_type::error_const_reference;
+  [[nodiscard]] constexpr auto error() && noexcept(!detail::throwing_access) ->
+      typename storage_type::error_rvalue_reference;
+
+  // Unchecked accessors skip the check whatever RESULT_CHECKING is; calling the wrong one is undefined behavior.
+  [[nodiscard]] constexpr auto value_unchecked() const & noexcept -> const T & {
+    if constexpr (std::is_reference_v<T>) {
+      return *storage_.value();
+    } else {
+      return storage_.value();
+    }
+  }
+  [[nodiscard]] constexpr auto value_unchecked() && noexcept -> T && {
+    if constexpr (std::is_reference_v<T>) {
+      return *storage_.value();
+    } else {
+      return std::move(storage_).value();
+    }
+  }
+  [[nodiscard]] constexpr auto error_unchecked() const & noexcept -> typename storage_type::error_const_reference {
+    return storage_.error();
+  }
+  [[nodiscard]] constexpr auto error_unchecked() && noexcept -> typename storage_type::error_rvalue_reference {
+    return std::move(storage_).error();
+  }
+
+  // Modifiers
+  // emplace destroys the value or error held and constructs a value from args in its place; emplace_error does the
+  // same for the error. If the constructor throws, the result keeps what it held, which requires the new member to be
+  // nothrow constructible from args or nothrow movable. For result<T &, E>, emplace rebinds the reference.
+  template <typename... Args>
+  auto emplace(Args &&...args) noexcept(std::is_nothrow_constructible_v<T, Args...>) -> T & {
+    static_assert(std::is_nothrow_constructible_v<T, Args...> || std::is_nothrow_move_constructible_v<T>,
+                  "emplace needs T to be nothrow constructible from the arguments or nothrow movable");
+    auto &stored = storage_.emplace_value(detail::store_value<T>(std::forward<Args>(args))...);
+    if constexpr (std::is_reference_v<T>) {
+      return *stored;
+    } else {
+      return stored;
+    }
+  }
+  template <typename... Args>
+  void emplace_error(Args &&...args) noexcept(std::is_nothrow_constructible_v<E, Args...>) {
+    static_assert(std::is_nothrow_constructible_v<E, Args...> || std::is_nothrow_move_constructible_v<E>,
+                  "emplace_error needs E to be nothrow constructible from the arguments or nothrow movable");
+    storage_.emplace_error(std::forward<Args>(args)...);
+  }
 
   // Monadic operations
   // map method gets functor F(T x) -> R as an argument and returns result of applying this functor to the value of the
   // result object. If the result object is an error, the functor is not called and the error is propagated. But the
   // result value type is changed to R.
-  template <typename F, typename R = std::invoke_result_t<F, T>> auto map(F &&functor) const -> result<R, E> {
-    if (is_ok()) { return ok<R>(std::forward<F>(functor)(value())); }
-    return err<E>(error());
+  template <typename F, typename R = std::invoke_result_t<F, T>>
+  constexpr auto map(F &&functor) const & -> result<R, E> {
+    if (is_ok()) { return result<R, E>(result<R, E>::SUCCESSFUL, std::forward<F>(functor)(value())); }
+    return result<R, E>(result<R, E>::UNSUCCESSFUL, error());
+  }
+  // Rvalue overload of map moves the value into the functor and the error into the returned result, so chains of
+  // map calls on temporaries never copy the payload.
+  template <typename F, typename R = std::invoke_result_t<F, T>>
+  constexpr auto map(F &&functor) && -> result<R, E> {
+    if (is_ok()) { return result<R, E>(result<R, E>::SUCCESSFUL, std::forward<F>(functor)(std::move(*this).value())); }
+    return result<R, E>(result<R, E>::UNSUCCESSFUL, std::move(*this).error());
   }
   // map_err method gets functor F(E x) -> U as an argument and returns result of applying this functor to the error of
   // the result object. If the result object is a success, the functor is not called and the value is propagated. But
   // the result error type is changed to U.
-  template <typename F, typename U = std::invoke_result_t<F, E>> auto map_err(F &&functor) const -> result<T, U> {
-    if (!is_ok()) { return err<U>(std::forward<F>(functor)(error())); }
-    return ok<T>(value());
+  template <typename F, typename U = std::invoke_result_t<F, E>>
+  constexpr auto map_err(F &&functor) const & -> result<T, U> {
+    if (!is_ok()) { return result<T, U>(result<T, U>::UNSUCCESSFUL, std::forward<F>(functor)(error())); }
+    return result<T, U>(result<T, U>::SUCCESSFUL, value());
+  }
+  // Rvalue overload of map_err moves the error into the functor and the value into the returned result.
+  template <typename F, typename U = std::invoke_result_t<F, E>>
+  constexpr auto map_err(F &&functor) && -> result<T, U> {
+    if (!is_ok()) {
+      return result<T, U>(result<T, U>::UNSUCCESSFUL, std::forward<F>(functor)(std::move(*this).error()));
+    }
+    return result<T, U>(result<T, U>::SUCCESSFUL, std::move(*this).value());
+  }
+  // and_then method gets functor F(T x) -> result<U, E> as an argument and returns the result of applying this functor
+  // to the value of the result object. If the result object is an error, the functor is not called and the error is
+  // propagated. Unlike map, it lets the next step fail without nesting results.
+  template <typename F, typename R = std::invoke_result_t<F, T>>
+  constexpr auto and_then(F &&functor) const & -> R {
+    static_assert(detail::is_result_v<R>, "and_then functor must return a result");
+    static_assert(std::is_same_v<typename R::error_type, E>, "and_then functor must keep the error type");
+    if (is_ok()) { return std::forward<F>(functor)(value()); }
+    return R(R::UNSUCCESSFUL, error());
+  }
+  template <typename F, typename R = std::invoke_result_t<F, T>>
+  constexpr auto and_then(F &&functor) && -> R {
+    static_assert(detail::is_result_v<R>, "and_then functor must return a result");
+    static_assert(std::is_same_v<typename R::error_type, E>, "and_then functor must keep the error type");
+    if (is_ok()) { return std::forward<F>(functor)(std::move(*this).value()); }
+    return R(R::UNSUCCESSFUL, std::move(*this).error());
+  }
+  // or_else method gets functor F(E x) -> result<T, U> as an argument and returns the result of applying this functor
+  // to the error of the result object. If the result object is a success, the functor is not called and the value is
+  // propagated. It lets an error be recovered from or replaced by a different one.
+  template <typename F, typename R = std::invoke_result_t<F, E>>
+  constexpr auto or_else(F &&functor) const & -> R {
+    static_assert(detail::is_result_v<R>, "or_else functor must return a result");
+    static_assert(std::is_same_v<typename R::value_type, T>, "or_else functor must keep the value type");
+    if (!is_ok()) { return std::forward<F>(functor)(error()); }
+    return R(R::SUCCESSFUL, value());
+  }
+  template <typename F, typename R = std::invoke_result_t<F, E>>
+  constexpr auto or_else(F &&functor) && -> R {
+    static_assert(detail::is_result_v<R>, "or_else functor must return a result");
+    static_assert(std::is_same_v<typename R::value_type, T>, "or_else functor must keep the value type");
+    if (!is_ok()) { return std::forward<F>(functor)(std::move(*this).error()); }
+    return R(R::SUCCESSFUL, std::move(*this).value());
+  }
+  // context method attaches a description of what was being done to the error, turning E into context_error<E>. The
+  // text is copied into a thread-local arena and only joined with the error when the context_error is formatted.
+  auto context(std::string_view text) const & -> result<T, detail::context_error_t<E>> {
+    using output = result<T, detail::context_error_t<E>>;
+    if (is_ok()) { return output(output::SUCCESSFUL, value()); }
+    return detail::add_text_context<output>(error(), text);
+  }
+  auto context(std::string_view text) && -> result<T, detail::context_error_t<E>> {
+    using output = result<T, detail::context_error_t<E>>;
+    if (is_ok()) { return output(output::SUCCESSFUL, std::move(*this).value()); }
+    return detail::add_text_context<output>(std::move(*this).error(), text);
+  }
+  // with_context method is the lazy form of context: functor() -> text is stored in the arena and only called when
+  // the error is formatted, so it must capture by value. It is not called at all if the result is a success.
+  template <typename F> auto with_context(F &&functor) const & -> result<T, detail::context_error_t<E>> {
+    using output = result<T, detail::context_error_t<E>>;
+    if (is_ok()) { return output(output::SUCCESSFUL, value()); }
+    return detail::add_lazy_context<output>(error(), std::forward<F>(functor));
+  }
+  template <typename F> auto with_context(F &&functor) && -> result<T, detail::context_error_t<E>> {
+    using output = result<T, detail::context_error_t<E>>;
+    if (is_ok()) { return output(output::SUCCESSFUL, std::move(*this).value()); }
+    return detail::add_lazy_context<output>(std::move(*this).error(), std::forward<F>(functor));
   }
 };
 
@@ -62,58 +267,255 @@ public:
 template <typename E> class result<void, E> {
   static_assert(!std::is_same_v<E, void>, "E (error type) must not be void");
 
-  std::optional<E> error_;
+  // std::monostate stands in for the missing value, so the void specialization shares the tagged union storage.
+  using storage_type = detail::storage_for_t<std::monostate, E>;
+  storage_type storage_;
 
   // Simulate named constructors
   enum Successful { SUCCESSFUL };
   enum Unsuccessful { UNSUCCESSFUL };
-  explicit result(Successful successful) {}
-  result(Unsuccessful unsuccessful, E error) : error_(std::move(error)) {}
+  constexpr explicit result(Successful /*tag*/) : storage_(detail::in_place_ok) {}
+  template <typename... Args>
+  constexpr result(Unsuccessful /*tag*/, Args &&...args)
+      : storage_(detail::in_place_err, std::forward<Args>(args)...) {}
 
   template <typename U> friend class ok;
   template <typename U> friend class err;
+  template <typename U, typename... Args> friend class err_in_place_t;
+  template <typename U, typename V> friend class result;
+  template <typename R> friend class detail::error_forwarder;
+  friend struct detail::result_access;
 
 public:
+  using value_type = void;
+  using error_type = E;
+
   // Observers
-  [[nodiscard]] auto is_ok() const -> bool { return !error_.has_value(); }
-  explicit operator bool() const { return is_ok(); }
-  auto operator!() const -> bool { return !is_ok(); }
+  [[nodiscard]] constexpr auto is_ok() const noexcept -> bool { return storage_.has_value(); }
+  constexpr explicit operator bool() const noexcept { return is_ok(); }
+  constexpr auto operator!() const noexcept -> bool { return !is_ok(); }
+
+  [[nodiscard]] constexpr auto error() const & noexcept(!detail::throwing_access) ->
+      typename storage_type::error_const_reference;
+  [[nodiscard]] constexpr auto error() && noexcept(!detail::throwing_access) ->
+      typename storage_type::error_rvalue_reference;
 
-  [[nodiscard]] auto error() const -> const E &;
+  [[nodiscard]] constexpr auto error_unchecked() const & noexcept -> typename storage_type::error_const_reference {
+    return storage_.error();
+  }
+  [[nodiscard]] constexpr auto error_unchecked() && noexcept -> typename storage_type::error_rvalue_reference {
+    return std::move(storage_).error();
+  }
+
+  // Modifiers
+  // emplace makes the result successful; emplace_error constructs a new error in place, see result<T, E>::emplace.
+  void emplace() noexcept { storage_.emplace_value(); }
+  template <typename... Args>
+  void emplace_error(Args &&...args) noexcept(std::is_nothrow_constructible_v<E, Args...>) {
+    static_assert(std::is_nothrow_constructible_v<E, Args...> || std::is_nothrow_move_constructible_v<E>,
+                  "emplace_error needs E to be nothrow constructible from the arguments or nothrow movable");
+    storage_.emplace_error(std::forward<Args>(args)...);
+  }
 
   // Monadic operations
   // map method gets functor F() -> R as an argument and returns result of applying this functor to the value of the
   // result object. If the result object is an error, the functor is not called and the error is propagated. But the
   // result value type is changed to R.
-  template <typename F, typename R = std::invoke_result_t<F>> auto map(F &&functor) const -> result<R, E> {
-    if (is_ok()) { return ok<R>(std::forward<F>(functor)()); }
-    return err<E>(error_.value());
+  template <typename F, typename R = std::invoke_result_t<F>>
+  constexpr auto map(F &&functor) const & -> result<R, E> {
+    if (is_ok()) { return result<R, E>(result<R, E>::SUCCESSFUL, std::forward<F>(functor)()); }
+    return result<R, E>(result<R, E>::UNSUCCESSFUL, error());
+  }
+  // Rvalue overload of map moves the error into the returned result.
+  template <typename F, typename R = std::invoke_result_t<F>>
+  constexpr auto map(F &&functor) && -> result<R, E> {
+    if (is_ok()) { return result<R, E>(result<R, E>::SUCCESSFUL, std::forward<F>(functor)()); }
+    return result<R, E>(result<R, E>::UNSUCCESSFUL, std::move(*this).error());
   }
   // map_err method for void value type is same as for non-void value type because it does not depend on the value type.
-  template <typename F, typename U = std::invoke_result_t<F, E>> auto map_err(F &&functor) const -> result<void, U> {
-    if (!is_ok()) { return err<U>(std::forward<F>(functor)(error_.value())); }
-    return ok();
+  template <typename F, typename U = std::invoke_result_t<F, E>>
+  constexpr auto map_err(F &&functor) const & -> result<void, U> {
+    if (!is_ok()) { return result<void, U>(result<void, U>::UNSUCCESSFUL, std::forward<F>(functor)(error())); }
+    return result<void, U>(result<void, U>::SUCCESSFUL);
+  }
+  // Rvalue overload of map_err moves the error into the functor.
+  template <typename F, typename U = std::invoke_result_t<F, E>>
+  constexpr auto map_err(F &&functor) && -> result<void, U> {
+    if (!is_ok()) {
+      return result<void, U>(result<void, U>::UNSUCCESSFUL, std::forward<F>(functor)(std::move(*this).error()));
+    }
+    return result<void, U>(result<void, U>::SUCCESSFUL);
+  }
+  // and_then method for void value type gets functor F() -> result<U, E>.
+  template <typename F, typename R = std::invoke_result_t<F>>
+  constexpr auto and_then(F &&functor) const & -> R {
+    static_assert(detail::is_result_v<R>, "and_then functor must return a result");
+    static_assert(std::is_same_v<typename R::error_type, E>, "and_then functor must keep the error type");
+    if (is_ok()) { return std::forward<F>(functor)(); }
+    return R(R::UNSUCCESSFUL, error());
+  }
+  template <typename F, typename R = std::invoke_result_t<F>>
+  constexpr auto and_then(F &&functor) && -> R {
+    static_assert(detail::is_result_v<R>, "and_then functor must return a result");
+    static_assert(std::is_same_v<typename R::error_type, E>, "and_then functor must keep the error type");
+    if (is_ok()) { return std::forward<F>(functor)(); }
+    return R(R::UNSUCCESSFUL, std::move(*this).error());
+  }
+  // or_else method for void value type gets functor F(E x) -> result<void, U>.
+  template <typename F, typename R = std::invoke_result_t<F, E>>
+  constexpr auto or_else(F &&functor) const & -> R {
+    static_assert(detail::is_result_v<R>, "or_else functor must return a result");
+    static_assert(std::is_same_v<typename R::value_type, void>, "or_else functor must keep the value type");
+    if (!is_ok()) { return std::forward<F>(functor)(error()); }
+    return R(R::SUCCESSFUL);
+  }
+  template <typename F, typename R = std::invoke_result_t<F, E>>
+  constexpr auto or_else(F &&functor) && -> R {
+    static_assert(detail::is_result_v<R>, "or_else functor must return a result");
+    static_assert(std::is_same_v<typename R::value_type, void>, "or_else functor must keep the value type");
+    if (!is_ok()) { return std::forward<F>(functor)(std::move(*this).error()); }
+    return R(R::SUCCESSFUL);
+  }
+  // context and with_context methods for void value type are same as for non-void value type.
+  auto context(std::string_view text) const & -> result<void, detail::context_error_t<E>> {
+    using output = result<void, detail::context_error_t<E>>;
+    if (is_ok()) { return output(output::SUCCESSFUL); }
+    return detail::add_text_context<output>(error(), text);
+  }
+  auto context(std::string_view text) && -> result<void, detail::context_error_t<E>> {
+    using output = result<void, detail::context_error_t<E>>;
+    if (is_ok()) { return output(output::SUCCESSFUL); }
+    return detail::add_text_context<output>(std::move(*this).error(), text);
+  }
+  template <typename F> auto with_context(F &&functor) const & -> result<void, detail::context_error_t<E>> {
+    using output = result<void, detail::context_error_t<E>>;
+    if (is_ok()) { return output(output::SUCCESSFUL); }
+    return detail::add_lazy_context<output>(error(), std::forward<F>(functor));
+  }
+  template <typename F> auto with_context(F &&functor) && -> result<void, detail::context_error_t<E>> {
+    using output = result<void, detail::context_error_t<E>>;
+    if (is_ok()) { return output(output::SUCCESSFUL); }
+    return detail::add_lazy_context<output>(std::move(*this).error(), std::forward<F>(functor));
   }
 };
 
-template <typename T, typename E> inline auto result<T, E>::value() const -> const T & {
-  if (!is_ok()) { throw std::logic_error("value() called on result with error"); }
-  return std::get<0>(content_);
+template <typename T, typename E>
+constexpr auto result<T, E>::value() const & noexcept(!detail::throwing_access) -> const T & {
+  if constexpr (detail::checked_access) {
+    if (RESULT_UNLIKELY(!is_ok())) { detail::bad_result_access("value() called on result with error"); }
+  }
+  return value_unchecked();
+}
+
+template <typename T, typename E> constexpr auto result<T, E>::value() && noexcept(!detail::throwing_access) -> T && {
+  if constexpr (detail::checked_access) {
+    if (RESULT_UNLIKELY(!is_ok())) { detail::bad_result_access("value() called on result with error"); }
+  }
+  return std::move(*this).value_unchecked();
+}
+
+template <typename T, typename E>
+constexpr auto result<T, E>::value_or(T &&default_value) const & noexcept(
+    std::is_nothrow_copy_constructible_v<T> && std::is_nothrow_move_constructible_v<T>) -> T {
+  if (is_ok()) { return value_unchecked(); }
+  return std::forward<T>(default_value);
+}
+
+template <typename T, typename E>
+constexpr auto result<T, E>::value_or(T &&default_value) && noexcept(std::is_nothrow_move_constructible_v<T>) -> T {
+  if (is_ok()) { return std::move(*this).value_unchecked(); }
+  return std::forward<T>(default_value);
+}
+
+template <typename T, typename E>
+constexpr auto result<T, E>::error() const & noexcept(!detail::throwing_access) ->
+    typename storage_type::error_const_reference {
+  if constexpr (detail::checked_access) {
+    if (RESULT_UNLIKELY(is_ok())) { detail::bad_result_access("error() called on result with value"); }
+  }
+  return storage_.error();
 }
 
-template <typename T, typename E> inline auto result<T, E>::value_or(T &&default_value) const -> T {
-  if (is_ok()) { return std::get<0>(content_); }
-  return std::move(default_value);
+template <typename T, typename E>
+constexpr auto result<T, E>::error() && noexcept(!detail::throwing_access) ->
+    typename storage_type::error_rvalue_reference {
+  if constexpr (detail::checked_access) {
+    if (RESULT_UNLIKELY(is_ok())) { detail::bad_result_access("error() called on result with value"); }
+  }
+  return std::move(storage_).error();
 }
 
-template <typename T, typename E> inline auto result<T, E>::error() const -> const E & {
-  if (is_ok()) { throw std::logic_error("error() called on result with value"); }
-  return std::get<1>(content_);
+template <typename E>
+constexpr auto result<void, E>::error() const & noexcept(!detail::throwing_access) ->
+    typename storage_type::error_const_reference {
+  if constexpr (detail::checked_access) {
+    if (RESULT_UNLIKELY(is_ok())) { detail::bad_result_access("error() called on result with value"); }
+  }
+  return storage_.error();
 }
 
-template <typename E> inline auto result<void, E>::error() const -> const E & {
-  if (is_ok()) { throw std::logic_error("error() called on result with value"); }
-  return error_.value();
+template <typename E>
+constexpr auto result<void, E>::error() && noexcept(!detail::throwing_access) ->
+    typename storage_type::error_rvalue_reference {
+  if constexpr (detail::checked_access) {
+    if (RESULT_UNLIKELY(is_ok())) { detail::bad_result_access("error() called on result with value"); }
+  }
+  return std::move(storage_).error();
 }
 
-} // namespace res
\ No newline at end of file
+/// @brief Results are equal when both hold equal values or both hold equal errors. Results of references compare the
+/// objects they refer to.
+template <typename T, typename E, typename U, typename F>
+constexpr auto operator==(const result<T, E> &lhs, const result<U, F> &rhs) -> bool {
+  static_assert(std::is_void_v<T> == std::is_void_v<U>, "a result<void, E> only compares with another one");
+  if (lhs.is_ok() != rhs.is_ok()) { return false; }
+  if (!lhs.is_ok()) { return lhs.error_unchecked() == rhs.error_unchecked(); }
+  if constexpr (std::is_void_v<T>) {
+    return true;
+  } else {
+    return lhs.value_unchecked() == rhs.value_unchecked();
+  }
+}
+
+template <typename T, typename E, typename U, typename F>
+constexpr auto operator!=(const result<T, E> &lhs, const result<U, F> &rhs) -> bool {
+  return !(lhs == rhs);
+}
+
+namespace detail {
+
+inline constexpr auto hash_combine(std::size_t seed, std::size_t value) noexcept -> std::size_t {
+  return seed ^ (value + static_cast<std::size_t>(0x9E3779B97F4A7C15ULL) + (seed << 6U) + (seed >> 2U));
+}
+
+template <typename T> inline constexpr bool is_hashable_v = std::is_default_constructible_v<std::hash<T>>;
+
+template <typename T, typename E,
+          bool = (std::is_void_v<T> || is_hashable_v<std::remove_cv_t<std::remove_reference_t<T>>>) &&
+                 is_hashable_v<E>>
+struct result_hash {
+  auto operator()(const result<T, E> &value) const -> std::size_t {
+    if (!value.is_ok()) { return hash_combine(2, std::hash<E>()(value.error_unchecked())); }
+    if constexpr (std::is_void_v<T>) {
+      return 1;
+    } else {
+      using plain = std::remove_cv_t<std::remove_reference_t<T>>;
+      return hash_combine(1, std::hash<plain>()(value.value_unchecked()));
+    }
+  }
+};
+
+// Disabled like std::hash of a type without a hash, so containers and traits can detect it.
+template <typename T, typename E> struct result_hash<T, E, false> {
+  result_hash() = delete;
+  result_hash(const result_hash &) = delete;
+  auto operator=(const result_hash &) -> result_hash & = delete;
+};
+
+} // namespace detail
+
+} // namespace res
+
+/// @brief Hashes whether the result holds a value and the value or error, so results can be keys of unordered
+/// containers. Enabled when T and E are hashable.
+template <typename T, typename E> struct std::hash<res::result<T, E>> : res::detail::result_hash<T, E> {};
\ No newline at end of file
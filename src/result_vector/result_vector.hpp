@@ -0,0 +1,325 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../result/result.hpp"
+
+namespace res {
+
+namespace detail {
+
+inline constexpr std::size_t mask_word_bits = 64;
+
+inline auto popcount64(std::uint64_t word) noexcept -> unsigned {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_popcountll(word));
+#else
+  word = word - ((word >> 1U) & 0x5555555555555555ULL);
+  word = (word & 0x3333333333333333ULL) + ((word >> 2U) & 0x3333333333333333ULL);
+  word = (word + (word >> 4U)) & 0x0F0F0F0F0F0F0F0FULL;
+  return static_cast<unsigned>((word * 0x0101010101010101ULL) >> 56U);
+#endif
+}
+
+// Index of the lowest set bit, word must not be zero.
+inline auto countr_zero64(std::uint64_t word) noexcept -> unsigned {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_ctzll(word));
+#else
+  unsigned index = 0;
+  while ((word & 1U) == 0) {
+    word >>= 1U;
+    ++index;
+  }
+  return index;
+#endif
+}
+
+} // namespace detail
+
+/// @brief A sequence of result<T, E> stored column by column.
+/// @details Values and errors live in two separate arrays and the ok/err state of every element is one bit of a packed
+/// mask, so count_ok and first_err look at 64 elements per word with a popcount or a count of trailing zeros. No
+/// explicit SIMD is used. Both arrays are dense: every element has a T and an E slot, and the one that does not match
+/// its state is a default-constructed placeholder. Both types must therefore be default constructible, and each
+/// element costs sizeof(T) + sizeof(E) whatever its state.
+template <typename T, typename E> class result_vector {
+  static_assert(!std::is_void_v<T>, "result_vector requires a value type");
+  static_assert(std::is_default_constructible_v<T> && std::is_default_constructible_v<E>,
+                "result_vector requires default constructible value and error types");
+
+  std::vector<T> values_;
+  std::vector<E> errors_;
+  std::vector<std::uint64_t> ok_mask_;
+
+  template <typename Vector> class proxy;
+
+public:
+  using value_type = T;
+  using error_type = E;
+  using result_type = result<T, E>;
+  using reference = proxy<result_vector>;
+  using const_reference = proxy<const result_vector>;
+
+  result_vector() = default;
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t { return values_.size(); }
+  [[nodiscard]] auto empty() const noexcept -> bool { return values_.empty(); }
+
+  void reserve(std::size_t capacity) {
+    values_.reserve(capacity);
+    errors_.reserve(capacity);
+    ok_mask_.reserve(word_count(capacity));
+  }
+
+  void clear() noexcept {
+    values_.clear();
+    errors_.clear();
+    ok_mask_.clear();
+  }
+
+  void push_back(const result_type &element) {
+    if (element.is_ok()) {
+      push_ok(element.value());
+    } else {
+      push_err(element.error());
+    }
+  }
+  void push_back(result_type &&element) {
+    if (element.is_ok()) {
+      push_ok(std::move(element).value());
+    } else {
+      push_err(std::move(element).error());
+    }
+  }
+
+  /// @brief Appends an ok element without building a result first.
+  void push_ok(T value) {
+    values_.push_back(std::move(value));
+    complete_push([this] { errors_.emplace_back(); });
+    ok_mask_.back() |= bit(size() - 1);
+  }
+  /// @brief Appends an err element without building a result first.
+  void push_err(E error) {
+    values_.emplace_back();
+    complete_push([&] { errors_.push_back(std::move(error)); });
+  }
+
+  [[nodiscard]] auto is_ok(std::size_t index) const noexcept -> bool {
+    return (ok_mask_[index / detail::mask_word_bits] & bit(index)) != 0;
+  }
+
+  auto operator[](std::size_t index) noexcept -> reference { return reference(*this, index); }
+  auto operator[](std::size_t index) const noexcept -> const_reference { return const_reference(*this, index); }
+
+  /// @brief Bounds-checked element access, throws std::out_of_range (aborts without exceptions).
+  auto at(std::size_t index) -> reference {
+    check_index(index);
+    return (*this)[index];
+  }
+  [[nodiscard]] auto at(std::size_t index) const -> const_reference {
+    check_index(index);
+    return (*this)[index];
+  }
+
+  /// @brief Number of ok elements, counted a mask word at a time.
+  [[nodiscard]] auto count_ok() const noexcept -> std::size_t {
+    std::size_t count = 0;
+    for (const std::uint64_t word : ok_mask_) { count += detail::popcount64(word); }
+    return count;
+  }
+  [[nodiscard]] auto count_err() const noexcept -> std::size_t { return size() - count_ok(); }
+
+  [[nodiscard]] auto all_ok() const noexcept -> bool { return first_err() == size(); }
+
+  /// @brief Index of the first err element, or size() when every element is ok.
+  [[nodiscard]] auto first_err() const noexcept -> std::size_t {
+    for (std::size_t word = 0; word < ok_mask_.size(); ++word) {
+      const std::uint64_t errs = ~ok_mask_[word] & lane_mask(word);
+      if (errs != 0) { return word * detail::mask_word_bits + detail::countr_zero64(errs); }
+    }
+    return size();
+  }
+
+  /// @brief Splits the elements into the values of the ok ones and the errors of the err ones, both in order.
+  /// @details Uniform mask words are copied as whole ranges, only mixed words are split element by element.
+  [[nodiscard]] auto partition() const & -> std::pair<std::vector<T>, std::vector<E>> { return split(*this); }
+  [[nodiscard]] auto partition() && -> std::pair<std::vector<T>, std::vector<E>> {
+    auto parts = split(std::move(*this));
+    clear();
+    return parts;
+  }
+
+  /// @brief Applies functor to the value of every ok element, errors are carried over unchanged.
+  /// @details Mask words with every lane ok run as a plain loop over 64 contiguous values, which the compiler is free to
+  /// vectorize; mixed words visit only their set bits and all-err words are skipped.
+  template <typename F>
+  auto map(F &&functor) const -> result_vector<std::decay_t<std::invoke_result_t<F &, const T &>>, E> {
+    using mapped_type = std::decay_t<std::invoke_result_t<F &, const T &>>;
+    result_vector<mapped_type, E> mapped;
+    mapped.values_.resize(size());
+    mapped.errors_ = errors_;
+    mapped.ok_mask_ = ok_mask_;
+    for (std::size_t word = 0; word < ok_mask_.size(); ++word) {
+      const std::uint64_t oks = ok_mask_[word];
+      const std::size_t base = word * detail::mask_word_bits;
+      if (oks == ~std::uint64_t{0}) {
+        for (std::size_t lane = 0; lane < detail::mask_word_bits; ++lane) {
+          mapped.values_[base + lane] = functor(values_[base + lane]);
+        }
+      } else {
+        for (std::uint64_t rest = oks; rest != 0; rest &= rest - 1) {
+          const std::size_t index = base + detail::countr_zero64(rest);
+          mapped.values_[index] = functor(values_[index]);
+        }
+      }
+    }
+    return mapped;
+  }
+
+private:
+  template <typename, typename> friend class result_vector;
+
+  static auto word_count(std::size_t elements) noexcept -> std::size_t {
+    return (elements + detail::mask_word_bits - 1) / detail::mask_word_bits;
+  }
+  static auto bit(std::size_t index) noexcept -> std::uint64_t {
+    return std::uint64_t{1} << (index % detail::mask_word_bits);
+  }
+  // Bits of the given mask word that correspond to existing elements.
+  [[nodiscard]] auto lane_mask(std::size_t word) const noexcept -> std::uint64_t {
+    const std::size_t tail = size() - word * detail::mask_word_bits;
+    return tail >= detail::mask_word_bits ? ~std::uint64_t{0} : (std::uint64_t{1} << tail) - 1;
+  }
+
+  // Finishes an element whose value slot was just pushed by pushing its error slot and growing the mask. If either
+  // throws, the slots pushed so far are removed again, so the columns and the mask keep describing the same elements.
+  template <typename PushError> void complete_push(PushError push_error) {
+#if RESULT_HAS_EXCEPTIONS
+    try {
+      push_error();
+    } catch (...) {
+      values_.pop_back();
+      throw;
+    }
+    try {
+      grow_mask();
+    } catch (...) {
+      values_.pop_back();
+      errors_.pop_back();
+      throw;
+    }
+#else
+    push_error();
+    grow_mask();
+#endif
+  }
+  void grow_mask() {
+    if (ok_mask_.size() < word_count(size())) { ok_mask_.push_back(0); }
+  }
+  void check_index(std::size_t index) const {
+    if (index >= size()) { detail::throw_or_abort<std::out_of_range>("result_vector index out of range"); }
+  }
+
+  template <typename Self> static auto split(Self &&self) -> std::pair<std::vector<T>, std::vector<E>> {
+    auto append = [](auto &dest, auto &source, std::size_t first, std::size_t last) {
+      if constexpr (std::is_lvalue_reference_v<Self>) {
+        dest.insert(dest.end(), source.begin() + first, source.begin() + last);
+      } else {
+        dest.insert(dest.end(), std::make_move_iterator(source.begin() + first),
+                    std::make_move_iterator(source.begin() + last));
+      }
+    };
+    std::pair<std::vector<T>, std::vector<E>> parts;
+    const std::size_t oks = self.count_ok();
+    parts.first.reserve(oks);
+    parts.second.reserve(self.size() - oks);
+    for (std::size_t word = 0; word < self.ok_mask_.size(); ++word) {
+      const std::uint64_t lanes = self.lane_mask(word);
+      const std::uint64_t word_oks = self.ok_mask_[word];
+      const std::size_t base = word * detail::mask_word_bits;
+      const std::size_t last = std::min(base + detail::mask_word_bits, self.size());
+      if (word_oks == lanes) {
+        append(parts.first, self.values_, base, last);
+      } else if (word_oks == 0) {
+        append(parts.second, self.errors_, base, last);
+      } else {
+        for (std::size_t index = base; index < last; ++index) {
+          if (self.is_ok(index)) {
+            append(parts.first, self.values_, index, index + 1);
+          } else {
+            append(parts.second, self.errors_, index, index + 1);
+          }
+        }
+      }
+    }
+    return parts;
+  }
+
+  void set(std::size_t index, const result_type &element) {
+    std::uint64_t &word = ok_mask_[index / detail::mask_word_bits];
+    if (element.is_ok()) {
+      values_[index] = element.value();
+      errors_[index] = E();
+      word |= bit(index);
+    } else {
+      values_[index] = T();
+      errors_[index] = element.error();
+      word &= ~bit(index);
+    }
+  }
+};
+
+/// @brief Element handle of a result_vector with the observers of result<T, E>.
+/// @details Converts to result<T, E>, and the mutable flavour accepts result<T, E> assignments.
+template <typename T, typename E>
+template <typename Vector>
+class result_vector<T, E>::proxy {
+  Vector *vector_;
+  std::size_t index_;
+
+  friend class result_vector;
+  proxy(Vector &vector, std::size_t index) noexcept : vector_(&vector), index_(index) {}
+
+public:
+  proxy(const proxy &) = default;
+
+  [[nodiscard]] auto is_ok() const noexcept -> bool { return vector_->is_ok(index_); }
+  [[nodiscard]] auto is_err() const noexcept -> bool { return !is_ok(); }
+  explicit operator bool() const noexcept { return is_ok(); }
+
+  [[nodiscard]] auto value() const -> decltype(vector_->values_[index_]) {
+    if constexpr (detail::checked_access) {
+      if (RESULT_UNLIKELY(!is_ok())) { detail::bad_result_access("value() called on result with error"); }
+    }
+    return vector_->values_[index_];
+  }
+  [[nodiscard]] auto error() const -> decltype(vector_->errors_[index_]) {
+    if constexpr (detail::checked_access) {
+      if (RESULT_UNLIKELY(is_ok())) { detail::bad_result_access("error() called on result with value"); }
+    }
+    return vector_->errors_[index_];
+  }
+
+  operator result_type() const { // NOLINT(google-explicit-constructor)
+    if (is_ok()) { return detail::result_access::make_ok<result_type>(vector_->values_[index_]); }
+    return detail::result_access::make_err<result_type>(vector_->errors_[index_]);
+  }
+
+  template <typename V = Vector, typename = std::enable_if_t<!std::is_const_v<V>>>
+  auto operator=(const result_type &element) const -> const proxy & {
+    vector_->set(index_, element);
+    return *this;
+  }
+  // Assigns the referenced element, like assigning through a reference, rather than rebinding the proxy.
+  auto operator=(const proxy &other) const -> const proxy & { return *this = static_cast<result_type>(other); }
+};
+
+} // namespace res
@@ -0,0 +1,272 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../error_code/error_code.hpp"
+#include "../result/result.hpp"
+
+namespace res {
+
+/// @brief Customization point describing how a value or error of type T is encoded by res::serialize.
+/// @details A specialization provides:
+/// - `using view_type`: what result_view hands out for T, typically a non-owning view into the buffer. T must be
+///   constructible from it for deserialize and result_view::to_result.
+/// - `static auto size(const T &) noexcept -> std::size_t`: the number of payload bytes.
+/// - `static void write(const T &, std::byte *out) noexcept`: writes exactly size() bytes.
+/// - `static auto fits(std::size_t size) noexcept -> bool`: whether a payload of size bytes can hold a T.
+/// - `static auto read(const std::byte *data, std::size_t size) noexcept -> view_type`: reads a payload that fits.
+///
+/// Built-in specializations cover trivially copyable types other than pointers, stored in host representation, and
+/// std::string and std::string_view, read back as std::string_view. Addresses mean nothing in another process, so
+/// error_code, formatted_error and interned_text are not covered; a trivially copyable type of your own that holds a
+/// pointer must not cross a process boundary either, unless it specializes wire_traits to encode what it points to.
+template <typename T, typename = void> struct wire_traits {};
+
+namespace detail {
+
+// Trivially copyable library types whose representation is an address.
+template <typename T>
+inline constexpr bool holds_address_v =
+    std::is_pointer_v<T> || std::is_member_pointer_v<T> || std::is_same_v<T, error_code> ||
+    std::is_same_v<T, formatted_error> || std::is_same_v<T, interned_text>;
+
+} // namespace detail
+
+template <typename T>
+struct wire_traits<T, std::enable_if_t<std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T> &&
+                                       !detail::holds_address_v<T> && !std::is_same_v<T, std::string_view>>> {
+  using view_type = T;
+
+  static auto size(const T & /*value*/) noexcept -> std::size_t { return sizeof(T); }
+  static void write(const T &value, std::byte *out) noexcept { std::memcpy(out, &value, sizeof(T)); }
+  static auto fits(std::size_t size) noexcept -> bool { return size == sizeof(T); }
+  // Payloads are not aligned in the buffer, so they are copied out rather than referenced.
+  static auto read(const std::byte *data, std::size_t /*size*/) noexcept -> T {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+  }
+};
+
+template <typename T>
+struct wire_traits<T, std::enable_if_t<std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>>> {
+  using view_type = std::string_view;
+
+  static auto size(std::string_view value) noexcept -> std::size_t { return value.size(); }
+  static void write(std::string_view value, std::byte *out) noexcept {
+    if (!value.empty()) { std::memcpy(out, value.data(), value.size()); }
+  }
+  static auto fits(std::size_t /*size*/) noexcept -> bool { return true; }
+  static auto read(const std::byte *data, std::size_t size) noexcept -> std::string_view {
+    return {reinterpret_cast<const char *>(data), size}; // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  }
+};
+
+/// @brief Why a buffer does not hold a serialized result.
+enum class wire_errc : std::uint8_t {
+  truncated,    // the buffer ends inside a record
+  bad_tag,      // the record is neither a value nor an error
+  bad_payload,  // the payload size does not fit the value or error type
+};
+
+namespace detail {
+
+// Record layout: a tag byte, the payload size as 4 little-endian bytes, then the payload. The size is always present
+// so readers can skip records without knowing their types.
+inline constexpr std::size_t wire_header_size = 5;
+inline constexpr std::size_t wire_max_payload = std::numeric_limits<std::uint32_t>::max();
+inline constexpr std::byte wire_ok_tag{0};
+inline constexpr std::byte wire_err_tag{1};
+
+template <typename T> struct wire_payload {
+  using traits = wire_traits<T>;
+  using view_type = typename traits::view_type;
+};
+// result<void, E> has no value payload.
+template <> struct wire_payload<void> {
+  struct traits {
+    static auto fits(std::size_t size) noexcept -> bool { return size == 0; }
+  };
+  using view_type = void;
+};
+
+// A larger payload would be written with a truncated size and misparsed, so it is reported as misuse instead.
+inline auto wire_record_size(std::size_t size) noexcept -> std::size_t {
+  if (RESULT_UNLIKELY(size > wire_max_payload)) { report_misuse("serialized payload exceeds the 4 GiB record limit"); }
+  return wire_header_size + size;
+}
+
+inline auto write_wire_header(std::byte *out, std::byte tag, std::size_t size) noexcept -> std::byte * {
+  wire_record_size(size);
+  out[0] = tag;
+  for (std::size_t index = 0; index < 4; ++index) { out[1 + index] = static_cast<std::byte>(size >> (8 * index)); }
+  return out + wire_header_size;
+}
+
+inline auto read_wire_size(const std::byte *data) noexcept -> std::size_t {
+  std::size_t size = 0;
+  for (std::size_t index = 0; index < 4; ++index) {
+    size |= std::to_integer<std::size_t>(data[1 + index]) << (8 * index);
+  }
+  return size;
+}
+
+} // namespace detail
+
+/// @brief Number of bytes serialize writes for value. A payload above 4 GiB is reported as misuse, which aborts.
+template <typename T, typename E> auto serialized_size(const result<T, E> &value) noexcept -> std::size_t {
+  if (value.is_ok()) {
+    if constexpr (std::is_void_v<T>) {
+      return detail::wire_header_size;
+    } else {
+      return detail::wire_record_size(wire_traits<std::decay_t<T>>::size(value.value_unchecked()));
+    }
+  }
+  return detail::wire_record_size(wire_traits<E>::size(value.error_unchecked()));
+}
+
+/// @brief Writes value to out, which must have room for serialized_size(value) bytes, and returns the end of the
+/// record. Payloads are limited to 4 GiB; a larger one is reported as misuse, which aborts.
+template <typename T, typename E> auto serialize(const result<T, E> &value, std::byte *out) noexcept -> std::byte * {
+  if (value.is_ok()) {
+    if constexpr (std::is_void_v<T>) {
+      return detail::write_wire_header(out, detail::wire_ok_tag, 0);
+    } else {
+      using traits = wire_traits<std::decay_t<T>>;
+      const std::size_t size = traits::size(value.value_unchecked());
+      traits::write(value.value_unchecked(), detail::write_wire_header(out, detail::wire_ok_tag, size));
+      return out + detail::wire_header_size + size;
+    }
+  }
+  const std::size_t size = wire_traits<E>::size(value.error_unchecked());
+  wire_traits<E>::write(value.error_unchecked(), detail::write_wire_header(out, detail::wire_err_tag, size));
+  return out + detail::wire_header_size + size;
+}
+
+/// @brief Appends the serialized value to out.
+template <typename T, typename E> void serialize(const result<T, E> &value, std::vector<std::byte> &out) {
+  const std::size_t offset = out.size();
+  out.resize(offset + serialized_size(value));
+  serialize(value, out.data() + offset);
+}
+
+/// @brief A serialized result<T, E> read in place from a buffer, e.g. a mapped file or a shared-memory queue.
+/// @details Nothing is copied or allocated: value() and error() return the view_type of wire_traits, which for strings
+/// points into the buffer, so the buffer must outlive the view. to_result() materializes an owning result.
+template <typename T, typename E> class result_view {
+  using value_payload = detail::wire_payload<std::conditional_t<std::is_void_v<T>, void, std::decay_t<T>>>;
+  using error_traits = wire_traits<E>;
+
+  const std::byte *payload_;
+  std::size_t size_;
+  bool ok_;
+
+  result_view(const std::byte *payload, std::size_t size, bool ok) noexcept : payload_(payload), size_(size), ok_(ok) {}
+
+public:
+  using value_type = typename value_payload::view_type;
+  using error_type = typename error_traits::view_type;
+
+  /// @brief Reads the record at the start of data, checking its header and payload size.
+  static auto parse(const std::byte *data, std::size_t size) noexcept -> result<result_view, wire_errc> {
+    if (size < detail::wire_header_size) { return err(wire_errc::truncated); }
+    const std::byte tag = data[0];
+    if (tag != detail::wire_ok_tag && tag != detail::wire_err_tag) { return err(wire_errc::bad_tag); }
+    const std::size_t payload_size = detail::read_wire_size(data);
+    if (payload_size > size - detail::wire_header_size) { return err(wire_errc::truncated); }
+    const bool is_value = tag == detail::wire_ok_tag;
+    if (is_value ? !value_payload::traits::fits(payload_size) : !error_traits::fits(payload_size)) {
+      return err(wire_errc::bad_payload);
+    }
+    return ok(result_view(data + detail::wire_header_size, payload_size, is_value));
+  }
+
+  [[nodiscard]] auto is_ok() const noexcept -> bool { return ok_; }
+  explicit operator bool() const noexcept { return ok_; }
+
+  /// @brief Size of the whole record, header included.
+  [[nodiscard]] auto encoded_size() const noexcept -> std::size_t { return detail::wire_header_size + size_; }
+
+  template <typename U = T, typename = std::enable_if_t<!std::is_void_v<U>>>
+  [[nodiscard]] auto value() const noexcept(!detail::throwing_access) -> value_type {
+    if constexpr (detail::checked_access) {
+      if (RESULT_UNLIKELY(!ok_)) { detail::bad_result_access("value() called on result_view with error"); }
+    }
+    return value_payload::traits::read(payload_, size_);
+  }
+
+  [[nodiscard]] auto error() const noexcept(!detail::throwing_access) -> error_type {
+    if constexpr (detail::checked_access) {
+      if (RESULT_UNLIKELY(ok_)) { detail::bad_result_access("error() called on result_view with value"); }
+    }
+    return error_traits::read(payload_, size_);
+  }
+
+  /// @brief An owning result with copies of the value or error.
+  [[nodiscard]] auto to_result() const -> result<T, E> {
+    if (!ok_) { return detail::result_access::make_err<result<T, E>>(E(error_traits::read(payload_, size_))); }
+    if constexpr (std::is_void_v<T>) {
+      return detail::result_access::make_ok<result<T, E>>();
+    } else {
+      using value_type = std::decay_t<T>;
+      return detail::result_access::make_ok<result<T, E>>(value_type(value_payload::traits::read(payload_, size_)));
+    }
+  }
+};
+
+/// @brief Reads the record at the start of data into an owning result.
+template <typename T, typename E>
+auto deserialize(const std::byte *data, std::size_t size) -> result<result<T, E>, wire_errc> {
+  return result_view<T, E>::parse(data, size).map([](const result_view<T, E> &view) { return view.to_result(); });
+}
+
+/// @brief Appends serialized results to a growing byte buffer, e.g. a batch of outcomes spilled to disk.
+/// @details Records are laid out back to back, so clearing and reusing the encoder between batches allocates only
+/// until the buffer has grown to the largest batch.
+class result_encoder {
+  std::vector<std::byte> buffer_;
+
+public:
+  template <typename T, typename E> void write(const result<T, E> &value) { serialize(value, buffer_); }
+
+  [[nodiscard]] auto data() const noexcept -> const std::byte * { return buffer_.data(); }
+  [[nodiscard]] auto size() const noexcept -> std::size_t { return buffer_.size(); }
+  [[nodiscard]] auto buffer() const noexcept -> const std::vector<std::byte> & { return buffer_; }
+  /// @brief Hands the encoded bytes over, leaving the encoder empty.
+  [[nodiscard]] auto take() noexcept -> std::vector<std::byte> { return std::exchange(buffer_, {}); }
+  void clear() noexcept { buffer_.clear(); }
+  void reserve(std::size_t size) { buffer_.reserve(size); }
+};
+
+/// @brief Reads a sequence of serialized result<T, E> records as views, in the order they were written.
+/// @details `while (!reader.done()) { RES_TRY_ASSIGN(auto view, reader.next()); ... }`. A malformed record ends the
+/// sequence: next() returns its error and done() is true afterwards.
+template <typename T, typename E> class result_reader {
+  const std::byte *data_;
+  std::size_t size_;
+  std::size_t offset_ = 0;
+
+public:
+  result_reader(const std::byte *data, std::size_t size) noexcept : data_(data), size_(size) {}
+  explicit result_reader(const std::vector<std::byte> &buffer) noexcept : data_(buffer.data()), size_(buffer.size()) {}
+
+  [[nodiscard]] auto done() const noexcept -> bool { return offset_ == size_; }
+  /// @brief Bytes of the buffer not read yet.
+  [[nodiscard]] auto remaining() const noexcept -> std::size_t { return size_ - offset_; }
+
+  auto next() noexcept -> result<result_view<T, E>, wire_errc> {
+    auto view = result_view<T, E>::parse(data_ + offset_, size_ - offset_);
+    offset_ = view.is_ok() ? offset_ + view.value_unchecked().encoded_size() : size_;
+    return view;
+  }
+};
+
+} // namespace res
@@ -0,0 +1,335 @@
+#pragma once
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace res::detail {
+
+// Tags selecting which member of the storage union is constructed.
+struct in_place_ok_t {
+  explicit in_place_ok_t() = default;
+};
+struct in_place_err_t {
+  explicit in_place_err_t() = default;
+};
+struct uninitialized_t {
+  explicit uninitialized_t() = default;
+};
+inline constexpr in_place_ok_t in_place_ok{};
+inline constexpr in_place_err_t in_place_err{};
+inline constexpr uninitialized_t uninitialized{};
+
+/// @brief Discriminated union of T and E.
+/// @details Unlike std::variant this storage keeps every special member trivial whenever T and E have trivial ones, so
+/// small results such as result<int, int> are trivially copyable and returned in registers.
+template <typename T, typename E, bool = std::is_trivially_destructible_v<T> && std::is_trivially_destructible_v<E>>
+struct storage_base {
+  union {
+    char dummy_;
+    T value_;
+    E error_;
+  };
+  bool has_value_;
+
+  constexpr explicit storage_base(uninitialized_t /*tag*/) noexcept : dummy_(), has_value_(false) {}
+  template <typename... Args>
+  constexpr explicit storage_base(in_place_ok_t /*tag*/, Args &&...args)
+      : value_(std::forward<Args>(args)...), has_value_(true) {}
+  template <typename... Args>
+  constexpr explicit storage_base(in_place_err_t /*tag*/, Args &&...args)
+      : error_(std::forward<Args>(args)...), has_value_(false) {}
+
+  void destroy() noexcept {}
+};
+
+template <typename T, typename E> struct storage_base<T, E, false> {
+  union {
+    char dummy_;
+    T value_;
+    E error_;
+  };
+  bool has_value_;
+
+  constexpr explicit storage_base(uninitialized_t /*tag*/) noexcept : dummy_(), has_value_(false) {}
+  template <typename... Args>
+  constexpr explicit storage_base(in_place_ok_t /*tag*/, Args &&...args)
+      : value_(std::forward<Args>(args)...), has_value_(true) {}
+  template <typename... Args>
+  constexpr explicit storage_base(in_place_err_t /*tag*/, Args &&...args)
+      : error_(std::forward<Args>(args)...), has_value_(false) {}
+
+  storage_base(const storage_base &) = default;
+  storage_base(storage_base &&) = default;
+  auto operator=(const storage_base &) -> storage_base & = default;
+  auto operator=(storage_base &&) -> storage_base & = default;
+  ~storage_base() { destroy(); }
+
+  void destroy() noexcept {
+    if (has_value_) {
+      value_.~T();
+    } else {
+      error_.~E();
+    }
+  }
+};
+
+// Shared helpers used by the non-trivial special member layers below.
+template <typename T, typename E> struct storage_ops : storage_base<T, E> {
+  using storage_base<T, E>::storage_base;
+
+  template <typename Other> void construct_from(Other &&other) {
+    if (other.has_value_) {
+      ::new (static_cast<void *>(std::addressof(this->value_))) T(std::forward<Other>(other).value_);
+    } else {
+      ::new (static_cast<void *>(std::addressof(this->error_))) E(std::forward<Other>(other).error_);
+    }
+    this->has_value_ = other.has_value_;
+  }
+
+  template <typename... Args> auto emplace_value(Args &&...args) -> T & {
+    emplace_member<T>(this->value_, std::forward<Args>(args)...);
+    this->has_value_ = true;
+    return this->value_;
+  }
+  template <typename... Args> void emplace_error(Args &&...args) {
+    emplace_member<E>(this->error_, std::forward<Args>(args)...);
+    this->has_value_ = false;
+  }
+
+  template <typename Other> void assign_from(Other &&other) {
+    if (this->has_value_ && other.has_value_) {
+      this->value_ = std::forward<Other>(other).value_;
+    } else if (!this->has_value_ && !other.has_value_) {
+      this->error_ = std::forward<Other>(other).error_;
+    } else if (other.has_value_) {
+      // Build the new member before destroying the old one so a throwing copy leaves *this untouched.
+      T tmp(std::forward<Other>(other).value_);
+      this->destroy();
+      ::new (static_cast<void *>(std::addressof(this->value_))) T(std::move(tmp));
+      this->has_value_ = true;
+    } else {
+      E tmp(std::forward<Other>(other).error_);
+      this->destroy();
+      ::new (static_cast<void *>(std::addressof(this->error_))) E(std::move(tmp));
+      this->has_value_ = false;
+    }
+  }
+
+private:
+  // Destroys the current member and constructs member in its place. Unless the constructor cannot throw, the new
+  // member is built aside first so a throwing constructor leaves *this untouched; result::emplace requires moving it
+  // in to be nothrow then.
+  template <typename M, typename... Args> void emplace_member(M &member, Args &&...args) {
+    if constexpr (std::is_nothrow_constructible_v<M, Args...>) {
+      this->destroy();
+      ::new (static_cast<void *>(std::addressof(member))) M(std::forward<Args>(args)...);
+    } else {
+      M tmp(std::forward<Args>(args)...);
+      this->destroy();
+      ::new (static_cast<void *>(std::addressof(member))) M(std::move(tmp));
+    }
+  }
+};
+
+template <typename T, typename E>
+inline constexpr bool trivially_copy_constructible_v =
+    std::is_trivially_copy_constructible_v<T> && std::is_trivially_copy_constructible_v<E>;
+template <typename T, typename E>
+inline constexpr bool trivially_move_constructible_v =
+    std::is_trivially_move_constructible_v<T> && std::is_trivially_move_constructible_v<E>;
+template <typename T, typename E>
+inline constexpr bool trivially_copy_assignable_v =
+    trivially_copy_constructible_v<T, E> && std::is_trivially_copy_assignable_v<T> &&
+    std::is_trivially_copy_assignable_v<E> && std::is_trivially_destructible_v<T> &&
+    std::is_trivially_destructible_v<E>;
+template <typename T, typename E>
+inline constexpr bool trivially_move_assignable_v =
+    trivially_move_constructible_v<T, E> && std::is_trivially_move_assignable_v<T> &&
+    std::is_trivially_move_assignable_v<E> && std::is_trivially_destructible_v<T> &&
+    std::is_trivially_destructible_v<E>;
+
+// Each layer either defaults one special member (keeping it trivial) or implements it through storage_ops.
+template <typename T, typename E, bool = trivially_copy_constructible_v<T, E>>
+struct copy_construct_layer : storage_ops<T, E> {
+  using storage_ops<T, E>::storage_ops;
+};
+
+template <typename T, typename E> struct copy_construct_layer<T, E, false> : storage_ops<T, E> {
+  using storage_ops<T, E>::storage_ops;
+
+  copy_construct_layer(const copy_construct_layer &other) : storage_ops<T, E>(uninitialized) {
+    this->construct_from(other);
+  }
+  copy_construct_layer(copy_construct_layer &&) = default;
+  auto operator=(const copy_construct_layer &) -> copy_construct_layer & = default;
+  auto operator=(copy_construct_layer &&) -> copy_construct_layer & = default;
+  ~copy_construct_layer() = default;
+};
+
+template <typename T, typename E, bool = trivially_move_constructible_v<T, E>>
+struct move_construct_layer : copy_construct_layer<T, E> {
+  using copy_construct_layer<T, E>::copy_construct_layer;
+};
+
+template <typename T, typename E> struct move_construct_layer<T, E, false> : copy_construct_layer<T, E> {
+  using copy_construct_layer<T, E>::copy_construct_layer;
+
+  move_construct_layer(const move_construct_layer &) = default;
+  move_construct_layer(move_construct_layer &&other) noexcept(
+      std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_constructible_v<E>)
+      : copy_construct_layer<T, E>(uninitialized) {
+    this->construct_from(std::move(other));
+  }
+  auto operator=(const move_construct_layer &) -> move_construct_layer & = default;
+  auto operator=(move_construct_layer &&) -> move_construct_layer & = default;
+  ~move_construct_layer() = default;
+};
+
+template <typename T, typename E, bool = trivially_copy_assignable_v<T, E>>
+struct copy_assign_layer : move_construct_layer<T, E> {
+  using move_construct_layer<T, E>::move_construct_layer;
+};
+
+template <typename T, typename E> struct copy_assign_layer<T, E, false> : move_construct_layer<T, E> {
+  using move_construct_layer<T, E>::move_construct_layer;
+
+  copy_assign_layer(const copy_assign_layer &) = default;
+  copy_assign_layer(copy_assign_layer &&) = default;
+  auto operator=(const copy_assign_layer &other) -> copy_assign_layer & {
+    this->assign_from(other);
+    return *this;
+  }
+  auto operator=(copy_assign_layer &&) -> copy_assign_layer & = default;
+  ~copy_assign_layer() = default;
+};
+
+template <typename T, typename E, bool = trivially_move_assignable_v<T, E>>
+struct move_assign_layer : copy_assign_layer<T, E> {
+  using copy_assign_layer<T, E>::copy_assign_layer;
+};
+
+template <typename T, typename E> struct move_assign_layer<T, E, false> : copy_assign_layer<T, E> {
+  using copy_assign_layer<T, E>::copy_assign_layer;
+
+  move_assign_layer(const move_assign_layer &) = default;
+  move_assign_layer(move_assign_layer &&) = default;
+  auto operator=(const move_assign_layer &) -> move_assign_layer & = default;
+  auto operator=(move_assign_layer &&other) noexcept(
+      std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T> &&
+      std::is_nothrow_move_constructible_v<E> && std::is_nothrow_move_assignable_v<E>) -> move_assign_layer & {
+    this->assign_from(std::move(other));
+    return *this;
+  }
+  ~move_assign_layer() = default;
+};
+
+// Empty bases that delete the special members T or E do not support, so type traits on result stay truthful.
+template <bool Enable> struct enable_copy_construct {};
+template <> struct enable_copy_construct<false> {
+  enable_copy_construct() = default;
+  enable_copy_construct(const enable_copy_construct &) = delete;
+  enable_copy_construct(enable_copy_construct &&) = default;
+  auto operator=(const enable_copy_construct &) -> enable_copy_construct & = default;
+  auto operator=(enable_copy_construct &&) -> enable_copy_construct & = default;
+  ~enable_copy_construct() = default;
+};
+
+template <bool Enable> struct enable_move_construct {};
+template <> struct enable_move_construct<false> {
+  enable_move_construct() = default;
+  enable_move_construct(const enable_move_construct &) = default;
+  enable_move_construct(enable_move_construct &&) = delete;
+  auto operator=(const enable_move_construct &) -> enable_move_construct & = default;
+  auto operator=(enable_move_construct &&) -> enable_move_construct & = default;
+  ~enable_move_construct() = default;
+};
+
+template <bool Enable> struct enable_copy_assign {};
+template <> struct enable_copy_assign<false> {
+  enable_copy_assign() = default;
+  enable_copy_assign(const enable_copy_assign &) = default;
+  enable_copy_assign(enable_copy_assign &&) = default;
+  auto operator=(const enable_copy_assign &) -> enable_copy_assign & = delete;
+  auto operator=(enable_copy_assign &&) -> enable_copy_assign & = default;
+  ~enable_copy_assign() = default;
+};
+
+template <bool Enable> struct enable_move_assign {};
+template <> struct enable_move_assign<false> {
+  enable_move_assign() = default;
+  enable_move_assign(const enable_move_assign &) = default;
+  enable_move_assign(enable_move_assign &&) = default;
+  auto operator=(const enable_move_assign &) -> enable_move_assign & = default;
+  auto operator=(enable_move_assign &&) -> enable_move_assign & = delete;
+  ~enable_move_assign() = default;
+};
+
+template <typename T, typename E>
+inline constexpr bool trivial_storage_v = trivially_copy_assignable_v<T, E> && trivially_move_assignable_v<T, E>;
+
+/// @brief Storage used by result: a tagged union whose triviality follows T and E.
+/// @details The fully trivial case is a flat struct on purpose: GCC stops scalarizing return values through base
+/// classes, which would force small results through the stack instead of RAX/RDX.
+template <typename T, typename E, bool = trivial_storage_v<T, E>> struct storage {
+  union {
+    char dummy_;
+    T value_;
+    E error_;
+  };
+  bool has_value_;
+
+  using error_const_reference = const E &;
+  using error_rvalue_reference = E &&;
+
+  template <typename... Args>
+  constexpr explicit storage(in_place_ok_t /*tag*/, Args &&...args)
+      : value_(std::forward<Args>(args)...), has_value_(true) {}
+  template <typename... Args>
+  constexpr explicit storage(in_place_err_t /*tag*/, Args &&...args)
+      : error_(std::forward<Args>(args)...), has_value_(false) {}
+
+  [[nodiscard]] constexpr auto has_value() const noexcept -> bool { return has_value_; }
+  [[nodiscard]] constexpr auto value() const & noexcept -> const T & { return value_; }
+  [[nodiscard]] constexpr auto value() && noexcept -> T && { return std::move(value_); }
+  [[nodiscard]] constexpr auto error() const & noexcept -> const E & { return error_; }
+  [[nodiscard]] constexpr auto error() && noexcept -> E && { return std::move(error_); }
+
+  // Members are trivially copyable, so building the new one aside costs nothing and keeps a throwing constructor from
+  // clobbering the old one.
+  template <typename... Args> auto emplace_value(Args &&...args) -> T & {
+    const T tmp(std::forward<Args>(args)...);
+    ::new (static_cast<void *>(std::addressof(value_))) T(tmp);
+    has_value_ = true;
+    return value_;
+  }
+  template <typename... Args> void emplace_error(Args &&...args) {
+    const E tmp(std::forward<Args>(args)...);
+    ::new (static_cast<void *>(std::addressof(error_))) E(tmp);
+    has_value_ = false;
+  }
+};
+
+template <typename T, typename E>
+struct storage<T, E, false>
+    : move_assign_layer<T, E>,
+      enable_copy_construct<std::is_copy_constructible_v<T> && std::is_copy_constructible_v<E>>,
+      enable_move_construct<std::is_move_constructible_v<T> && std::is_move_constructible_v<E>>,
+      enable_copy_assign<std::is_copy_constructible_v<T> && std::is_copy_assignable_v<T> &&
+                         std::is_copy_constructible_v<E> && std::is_copy_assignable_v<E>>,
+      enable_move_assign<std::is_move_constructible_v<T> && std::is_move_assignable_v<T> &&
+                         std::is_move_constructible_v<E> && std::is_move_assignable_v<E>> {
+  using move_assign_layer<T, E>::move_assign_layer;
+
+  using error_const_reference = const E &;
+  using error_rvalue_reference = E &&;
+
+  [[nodiscard]] constexpr auto has_value() const noexcept -> bool { return this->has_value_; }
+  [[nodiscard]] constexpr auto value() const & noexcept -> const T & { return this->value_; }
+  [[nodiscard]] constexpr auto value() && noexcept -> T && { return std::move(this->value_); }
+  [[nodiscard]] constexpr auto error() const & noexcept -> const E & { return this->error_; }
+  [[nodiscard]] constexpr auto error() && noexcept -> E && { return std::move(this->error_); }
+};
+
+} // namespace res::detail
\ No newline at end of file
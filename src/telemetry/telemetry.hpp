@@ -0,0 +1,276 @@
+#pragma once
+
+#include "../config/config.hpp"
+
+/// @brief Error telemetry, off unless RESULT_ENABLE_TELEMETRY is defined to 1 in every translation unit.
+/// @details When enabled, every res::err records the call site that created it: a per-thread counter per call site and
+/// an entry in a per-thread ring of recent errors. telemetry::take_snapshot() aggregates both across threads. When
+/// disabled, none of it is declared and res::err is unchanged.
+#ifndef RESULT_ENABLE_TELEMETRY
+#define RESULT_ENABLE_TELEMETRY 0
+#endif
+
+#if RESULT_ENABLE_TELEMETRY
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+/// @brief Number of distinct call sites each thread counts; errors from further call sites are only counted in total.
+#ifndef RESULT_TELEMETRY_SITES
+#define RESULT_TELEMETRY_SITES 256
+#endif
+/// @brief Number of recent errors each thread keeps.
+#ifndef RESULT_TELEMETRY_RECENT
+#define RESULT_TELEMETRY_RECENT 64
+#endif
+/// @brief Whether recent errors are timestamped. Reading the clock is most of the cost of recording an error; without
+/// it recent errors are only ordered within each thread.
+#ifndef RESULT_TELEMETRY_TIMESTAMPS
+#define RESULT_TELEMETRY_TIMESTAMPS 1
+#endif
+
+// Recording is skipped while err is constant evaluated, so res::err stays usable in constant expressions.
+#if defined(__cpp_lib_is_constant_evaluated)
+#define RESULT_IS_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#elif (defined(__GNUC__) && __GNUC__ >= 9) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#define RESULT_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+#define RESULT_IS_CONSTANT_EVALUATED() false
+#endif
+
+namespace res::telemetry {
+
+/// @brief Where an error was created.
+struct call_site {
+  const char *file = "";
+  const char *function = "";
+  unsigned line = 0;
+
+  /// @brief The call site of the expression this is a default argument of.
+  static constexpr auto current(const char *file = __builtin_FILE(), const char *function = __builtin_FUNCTION(),
+                                unsigned line = __builtin_LINE()) noexcept -> call_site {
+    return {file, function, line};
+  }
+};
+
+struct site_count {
+  call_site site;
+  std::uint64_t count = 0;
+};
+
+struct recorded_error {
+  call_site site;
+  /// Index of the recorder of the thread that created the error. Recorders of finished threads are reused.
+  std::size_t thread = 0;
+  /// Position of the error among all errors recorded by the same recorder.
+  std::uint64_t sequence = 0;
+  /// The epoch of the clock when RESULT_TELEMETRY_TIMESTAMPS is 0.
+  std::chrono::steady_clock::time_point time;
+};
+
+struct snapshot {
+  /// Errors per call site summed over all threads, most frequent first.
+  std::vector<site_count> sites;
+  /// The most recent errors of every thread, oldest first.
+  std::vector<recorded_error> recent;
+  /// Errors from call sites that did not fit into the counters of their thread.
+  std::uint64_t untracked = 0;
+};
+
+namespace detail {
+
+/// @brief Telemetry of one thread.
+/// @details Only the owning thread writes, so counters are bumped with a plain load and store rather than a
+/// read-modify-write, and snapshots read them concurrently. Ring entries are guarded by a sequence number that is odd
+/// while the entry is being written, so readers skip entries that change under them.
+class thread_recorder {
+  struct site_slot {
+    std::atomic<const char *> file{nullptr};
+    std::atomic<const char *> function{nullptr};
+    std::atomic<unsigned> line{0};
+    std::atomic<std::uint64_t> count{0};
+  };
+  struct recent_slot {
+    std::atomic<std::uint64_t> sequence{0};
+    std::atomic<const char *> file{nullptr};
+    std::atomic<const char *> function{nullptr};
+    std::atomic<unsigned> line{0};
+    std::atomic<std::chrono::steady_clock::rep> ticks{0};
+  };
+
+  static_assert((RESULT_TELEMETRY_SITES & (RESULT_TELEMETRY_SITES - 1)) == 0, "site count must be a power of two");
+
+  std::array<site_slot, RESULT_TELEMETRY_SITES> sites_;
+  std::array<recent_slot, RESULT_TELEMETRY_RECENT> recent_;
+  std::atomic<std::uint64_t> untracked_{0};
+  std::uint64_t recorded_ = 0;
+  std::size_t index_;
+
+  template <typename V> static void bump(std::atomic<V> &counter) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+public:
+  explicit thread_recorder(std::size_t index) noexcept : index_(index) {}
+
+  void record(const call_site &site) noexcept {
+    count(site);
+    auto &slot = recent_[recorded_ % recent_.size()];
+    const std::uint64_t sequence = 2 * recorded_++;
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.file.store(site.file, std::memory_order_relaxed);
+    slot.function.store(site.function, std::memory_order_relaxed);
+    slot.line.store(site.line, std::memory_order_relaxed);
+#if RESULT_TELEMETRY_TIMESTAMPS
+    slot.ticks.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+#endif
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+  }
+
+  void collect(snapshot &into) const {
+    for (const auto &slot : sites_) {
+      const std::uint64_t hits = slot.count.load(std::memory_order_acquire);
+      if (hits == 0) { continue; }
+      const call_site site{slot.file.load(std::memory_order_relaxed), slot.function.load(std::memory_order_relaxed),
+                           slot.line.load(std::memory_order_relaxed)};
+      into.sites.push_back({site, hits});
+    }
+    for (const auto &slot : recent_) {
+      const std::uint64_t before = slot.sequence.load(std::memory_order_acquire);
+      if (before == 0 || before % 2 == 1) { continue; }
+      const call_site site{slot.file.load(std::memory_order_relaxed), slot.function.load(std::memory_order_relaxed),
+                           slot.line.load(std::memory_order_relaxed)};
+      const auto ticks = slot.ticks.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.sequence.load(std::memory_order_relaxed) != before) { continue; }
+      using clock = std::chrono::steady_clock;
+      into.recent.push_back({site, index_, before / 2 - 1, clock::time_point(clock::duration(ticks))});
+    }
+    into.untracked += untracked_.load(std::memory_order_relaxed);
+  }
+
+private:
+  // Open addressing on the file pointer and line. The same site reached through different copies of a file name
+  // literal takes several slots, which take_snapshot merges again.
+  void count(const call_site &site) noexcept {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto address = reinterpret_cast<std::uintptr_t>(site.file);
+    const std::uintptr_t hash = address ^ (std::uintptr_t{site.line} * 0x9E3779B1U);
+    for (std::size_t probe = 0; probe < sites_.size(); ++probe) {
+      auto &slot = sites_[(hash + probe) & (sites_.size() - 1)];
+      const char *file = slot.file.load(std::memory_order_relaxed);
+      if (file == site.file && slot.line.load(std::memory_order_relaxed) == site.line) {
+        bump(slot.count);
+        return;
+      }
+      if (file == nullptr) {
+        slot.file.store(site.file, std::memory_order_relaxed);
+        slot.function.store(site.function, std::memory_order_relaxed);
+        slot.line.store(site.line, std::memory_order_relaxed);
+        slot.count.store(1, std::memory_order_release);
+        return;
+      }
+    }
+    bump(untracked_);
+  }
+};
+
+/// @brief Owns the recorders of all threads. Recorders outlive their threads so their counts stay in snapshots, and
+/// are handed to threads started later.
+class recorder_registry {
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<thread_recorder>> recorders_;
+  std::vector<thread_recorder *> idle_;
+
+public:
+  // Never destroyed, so threads that outlive static destruction can still hand their recorder back.
+  static auto instance() -> recorder_registry & {
+    static auto *registry = new recorder_registry();
+    return *registry;
+  }
+
+  auto acquire() -> thread_recorder * {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if (!idle_.empty()) {
+      auto *recorder = idle_.back();
+      idle_.pop_back();
+      return recorder;
+    }
+    recorders_.push_back(std::make_unique<thread_recorder>(recorders_.size()));
+    return recorders_.back().get();
+  }
+
+  void release(thread_recorder *recorder) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    idle_.push_back(recorder);
+  }
+
+  auto take_snapshot() -> snapshot {
+    snapshot result;
+    {
+      const std::lock_guard<std::mutex> lock(mutex_);
+      for (const auto &recorder : recorders_) { recorder->collect(result); }
+    }
+    auto &sites = result.sites;
+    const auto same_site = [](const call_site &lhs, const call_site &rhs) {
+      return lhs.line == rhs.line && std::strcmp(lhs.file, rhs.file) == 0;
+    };
+    std::sort(sites.begin(), sites.end(), [](const site_count &lhs, const site_count &rhs) {
+      const int file = std::strcmp(lhs.site.file, rhs.site.file);
+      return file != 0 ? file < 0 : lhs.site.line < rhs.site.line;
+    });
+    std::size_t merged = 0;
+    for (std::size_t index = 0; index < sites.size(); ++index) {
+      if (merged > 0 && same_site(sites[merged - 1].site, sites[index].site)) {
+        sites[merged - 1].count += sites[index].count;
+      } else {
+        sites[merged++] = sites[index];
+      }
+    }
+    sites.resize(merged);
+    std::stable_sort(sites.begin(), sites.end(),
+                     [](const site_count &lhs, const site_count &rhs) { return lhs.count > rhs.count; });
+    std::sort(result.recent.begin(), result.recent.end(), [](const recorded_error &lhs, const recorded_error &rhs) {
+      if (lhs.time != rhs.time) { return lhs.time < rhs.time; }
+      return lhs.thread != rhs.thread ? lhs.thread < rhs.thread : lhs.sequence < rhs.sequence;
+    });
+    return result;
+  }
+};
+
+struct recorder_handle {
+  thread_recorder *recorder = recorder_registry::instance().acquire();
+
+  recorder_handle() = default;
+  recorder_handle(const recorder_handle &) = delete;
+  auto operator=(const recorder_handle &) -> recorder_handle & = delete;
+  recorder_handle(recorder_handle &&) = delete;
+  auto operator=(recorder_handle &&) -> recorder_handle & = delete;
+  ~recorder_handle() { recorder_registry::instance().release(recorder); }
+};
+
+/// @brief Called by res::err. Kept out of line so err construction only grows by a call.
+RESULT_NOINLINE inline void record_error(const call_site &site) {
+  thread_local recorder_handle handle;
+  handle.recorder->record(site);
+}
+
+} // namespace detail
+
+/// @brief Aggregates the telemetry of every thread that has created an error so far.
+/// @details Safe to call while other threads keep recording; errors recorded meanwhile may or may not be included.
+inline auto take_snapshot() -> snapshot { return detail::recorder_registry::instance().take_snapshot(); }
+
+} // namespace res::telemetry
+
+#endif // RESULT_ENABLE_TELEMETRY
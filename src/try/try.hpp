@@ -0,0 +1,99 @@
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+#include "../result/result.hpp"
+
+namespace res::detail {
+
+template <typename From, typename To, typename = void> struct is_non_narrowing : std::false_type {};
+template <typename From, typename To>
+struct is_non_narrowing<From, To, std::void_t<decltype(To{std::declval<From>()})>> : std::true_type {};
+
+/// @brief Whether an error of type From propagates into an error of type To: the conversion must be implicit and,
+/// between arithmetic types, must not narrow.
+template <typename From, typename To>
+inline constexpr bool forwards_error_v =
+    std::is_convertible_v<From, To> &&
+    (!(std::is_arithmetic_v<std::remove_cv_t<std::remove_reference_t<From>>> && std::is_arithmetic_v<To>) ||
+     is_non_narrowing<From, To>::value);
+
+/// @brief Converts to any result whose error type the source's error implicitly converts to, by forwarding the error
+/// out of the source result.
+/// @details Returned by RES_TRY on the error path, so the error goes straight into the caller's return slot instead of
+/// being copied through err<E>. Result is an lvalue reference when RES_TRY was given an lvalue, whose error is then
+/// copied rather than moved. The error type usually stays the same; a wider one such as res::any_error lets a layer
+/// propagate the errors of the layers below it without map_err. Explicit constructors are never called, so an int
+/// error does not become, say, a std::vector<int> of that many elements, and arithmetic errors only widen, so an int
+/// error code is not silently turned into a bool or truncated to an unsigned char.
+template <typename Result> class error_forwarder {
+  using source_error_t = decltype(std::declval<Result &&>().error());
+  template <typename F>
+  using enable_if_convertible_t = std::enable_if_t<forwards_error_v<source_error_t, F>>;
+
+  std::remove_reference_t<Result> &source_;
+
+public:
+  constexpr explicit error_forwarder(std::remove_reference_t<Result> &source) : source_(source) {}
+
+  // NOLINTBEGIN(google-explicit-constructor)
+  template <typename T, typename F, typename = enable_if_convertible_t<F>> constexpr operator result<T, F>() && {
+    return result<T, F>(result<T, F>::UNSUCCESSFUL, std::forward<Result>(source_).error());
+  }
+  template <typename F, typename = enable_if_convertible_t<F>> constexpr operator result<void, F>() && {
+    return result<void, F>(result<void, F>::UNSUCCESSFUL, std::forward<Result>(source_).error());
+  }
+  // NOLINTEND(google-explicit-constructor)
+};
+
+template <typename Result> constexpr auto forward_error(Result &&source) -> error_forwarder<Result> {
+  return error_forwarder<Result>(source);
+}
+
+// A named result is left intact: its value is copied out rather than moved.
+template <typename T, typename E> constexpr auto unwrap(const result<T, E> &source) -> const T & {
+  return source.value();
+}
+template <typename T, typename E> constexpr auto unwrap(result<T, E> &&source) -> T && {
+  return std::move(source).value();
+}
+template <typename E> constexpr void unwrap(const result<void, E> & /*source*/) {}
+template <typename E> constexpr void unwrap(result<void, E> && /*source*/) {}
+
+} // namespace res::detail
+
+#define RES_CONCAT_IMPL(lhs, rhs) lhs##rhs
+#define RES_CONCAT(lhs, rhs) RES_CONCAT_IMPL(lhs, rhs)
+// Moves out of the checked result only when the expression given to RES_TRY was an rvalue.
+#define RES_TRY_FORWARD(name) std::forward<decltype(name)>(name)
+
+/// @brief Evaluates an expression returning a result and returns its error from the enclosing function on failure.
+/// @details With GCC and Clang statement expressions RES_TRY(expr) is an expression yielding the value, e.g.
+/// `int port = RES_TRY(parse_port(text));`. Other compilers only get the statement form, which discards the value and
+/// is meant for result<void, E>; use RES_TRY_ASSIGN there to keep it.
+#if defined(__GNUC__) || defined(__clang__)
+#define RESULT_HAS_STATEMENT_EXPRESSIONS 1
+#define RES_TRY(...)                                                                                                   \
+  __extension__({                                                                                                      \
+    auto &&res_try_result_ = (__VA_ARGS__);                                                                            \
+    if (!res_try_result_) { return ::res::detail::forward_error(RES_TRY_FORWARD(res_try_result_)); }                   \
+    ::res::detail::unwrap(RES_TRY_FORWARD(res_try_result_));                                                           \
+  })
+#else
+#define RESULT_HAS_STATEMENT_EXPRESSIONS 0
+#define RES_TRY(...)                                                                                                   \
+  do {                                                                                                                 \
+    auto &&res_try_result_ = (__VA_ARGS__);                                                                            \
+    if (!res_try_result_) { return ::res::detail::forward_error(RES_TRY_FORWARD(res_try_result_)); }                   \
+  } while (false)
+#endif
+
+/// @brief Portable statement form of RES_TRY that binds the value to a declaration, e.g.
+/// `RES_TRY_ASSIGN(int port, parse_port(text));`.
+#define RES_TRY_ASSIGN(declaration, ...)                                                                               \
+  auto &&RES_CONCAT(res_try_result_, __LINE__) = (__VA_ARGS__);                                                        \
+  if (!RES_CONCAT(res_try_result_, __LINE__)) {                                                                        \
+    return ::res::detail::forward_error(RES_TRY_FORWARD(RES_CONCAT(res_try_result_, __LINE__)));                       \
+  }                                                                                                                    \
+  declaration = ::res::detail::unwrap(RES_TRY_FORWARD(RES_CONCAT(res_try_result_, __LINE__)))
@@ -0,0 +1,288 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../result/result.hpp"
+#include "../zip/zip.hpp"
+
+namespace res {
+
+/// @brief Number of errors a validated keeps inline unless told otherwise.
+inline constexpr std::size_t default_inline_errors = 4;
+
+/// @brief The errors collected by a validated: a vector that keeps up to N errors inline and only allocates for more.
+/// @details Copying or moving an inline list copies or moves its elements; moving a list that spilled to the heap only
+/// steals its buffer.
+template <typename E, std::size_t N = default_inline_errors> class error_list {
+  static_assert(std::is_nothrow_move_constructible_v<E> || std::is_copy_constructible_v<E>,
+                "error_list requires a movable or copyable error type");
+
+  E *data_;
+  std::size_t size_ = 0;
+  std::size_t capacity_ = N;
+  alignas(E) unsigned char inline_[N == 0 ? 1 : N * sizeof(E)];
+
+  [[nodiscard]] auto inline_data() noexcept -> E * {
+    return reinterpret_cast<E *>(inline_); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  }
+
+public:
+  using value_type = E;
+  using iterator = E *;
+  using const_iterator = const E *;
+
+  error_list() noexcept : data_(inline_data()) {}
+
+  error_list(const error_list &other) : error_list() {
+    reserve(other.size_);
+    std::uninitialized_copy(other.begin(), other.end(), data_);
+    size_ = other.size_;
+  }
+  error_list(error_list &&other) noexcept(std::is_nothrow_move_constructible_v<E>) : error_list() {
+    take(std::move(other));
+  }
+  auto operator=(const error_list &other) -> error_list & {
+    if (this != &other) { *this = error_list(other); }
+    return *this;
+  }
+  auto operator=(error_list &&other) noexcept(std::is_nothrow_move_constructible_v<E>) -> error_list & {
+    if (this != &other) {
+      release();
+      take(std::move(other));
+    }
+    return *this;
+  }
+  ~error_list() { release(); }
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t { return size_; }
+  [[nodiscard]] auto empty() const noexcept -> bool { return size_ == 0; }
+  [[nodiscard]] auto capacity() const noexcept -> std::size_t { return capacity_; }
+  /// @brief Whether the errors are still stored inline, i.e. nothing has been allocated.
+  [[nodiscard]] auto is_inline() const noexcept -> bool {
+    return data_ == reinterpret_cast<const E *>(inline_); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  }
+
+  [[nodiscard]] auto begin() noexcept -> iterator { return data_; }
+  [[nodiscard]] auto end() noexcept -> iterator { return data_ + size_; }
+  [[nodiscard]] auto begin() const noexcept -> const_iterator { return data_; }
+  [[nodiscard]] auto end() const noexcept -> const_iterator { return data_ + size_; }
+  [[nodiscard]] auto data() const noexcept -> const E * { return data_; }
+
+  [[nodiscard]] auto operator[](std::size_t index) noexcept -> E & { return data_[index]; }
+  [[nodiscard]] auto operator[](std::size_t index) const noexcept -> const E & { return data_[index]; }
+  [[nodiscard]] auto front() const noexcept -> const E & { return data_[0]; }
+
+  template <typename... Args> auto emplace_back(Args &&...args) -> E & {
+    if (size_ == capacity_) { grow(std::max<std::size_t>(2 * capacity_, 1)); }
+    E *slot = ::new (static_cast<void *>(data_ + size_)) E(std::forward<Args>(args)...);
+    ++size_;
+    return *slot;
+  }
+  void push_back(const E &error) { emplace_back(error); }
+  void push_back(E &&error) { emplace_back(std::move(error)); }
+
+  /// @brief Appends the errors of other, after the ones already in the list.
+  void append(const error_list &other) {
+    reserve(size_ + other.size_);
+    for (const E &error : other) { emplace_back(error); }
+  }
+  void append(error_list &&other) {
+    if (empty() && !other.is_inline()) {
+      *this = std::move(other);
+      return;
+    }
+    reserve(size_ + other.size_);
+    for (E &error : other) { emplace_back(std::move_if_noexcept(error)); }
+    other.clear();
+  }
+
+  void reserve(std::size_t capacity) {
+    if (capacity > capacity_) { grow(std::max(capacity, 2 * capacity_)); }
+  }
+
+  void clear() noexcept {
+    std::destroy(begin(), end());
+    size_ = 0;
+  }
+
+private:
+  void grow(std::size_t capacity) {
+    // Frees the new buffer if copying an error into it throws.
+    const auto deallocate = [capacity](E *buffer) { std::allocator<E>().deallocate(buffer, capacity); };
+    std::unique_ptr<E, decltype(deallocate)> grown(std::allocator<E>().allocate(capacity), deallocate);
+    if constexpr (std::is_nothrow_move_constructible_v<E>) {
+      std::uninitialized_move(begin(), end(), grown.get());
+    } else {
+      std::uninitialized_copy(begin(), end(), grown.get());
+    }
+    const std::size_t size = size_;
+    release();
+    data_ = grown.release();
+    size_ = size;
+    capacity_ = capacity;
+  }
+
+  // Destroys the elements and frees a heap buffer, leaving the list empty and inline.
+  void release() noexcept {
+    clear();
+    if (!is_inline()) { std::allocator<E>().deallocate(data_, capacity_); }
+    data_ = inline_data();
+    capacity_ = N;
+  }
+
+  void take(error_list &&other) noexcept(std::is_nothrow_move_constructible_v<E>) {
+    if (other.is_inline()) {
+      for (E &error : other) { emplace_back(std::move_if_noexcept(error)); }
+      other.clear();
+    } else {
+      data_ = std::exchange(other.data_, other.inline_data());
+      size_ = std::exchange(other.size_, 0);
+      capacity_ = std::exchange(other.capacity_, N);
+    }
+  }
+};
+
+/// @brief The outcome of a validation that keeps going after the first problem: a value of type T, or every error of
+/// type E that was found.
+/// @details Up to N errors are stored inline, so validating a request with a few problems does not allocate. It is a
+/// result<T, error_list<E, N>> underneath: a result<T, E>, ok or err converts into a validated holding the value or a
+/// single error, and to_result() turns it back into a result. combine, zip_all and validate_all gather the errors of
+/// several validations in order.
+template <typename T, typename E, std::size_t N = default_inline_errors> class validated {
+public:
+  using value_type = T;
+  using error_type = E;
+  using errors_type = error_list<E, N>;
+  using result_type = result<T, errors_type>;
+
+private:
+  result_type result_;
+
+public:
+  // NOLINTBEGIN(google-explicit-constructor)
+  validated(result_type result) noexcept(std::is_nothrow_move_constructible_v<result_type>)
+      : result_(std::move(result)) {}
+  /// @brief Holds the value or the single error of source, which may be a result<T, E>, an ok or an err.
+  template <typename Source, typename = std::enable_if_t<std::is_convertible_v<Source, result<T, E>> &&
+                                                         !std::is_same_v<std::decay_t<Source>, validated>>>
+  validated(Source &&source) : result_(from_result(result<T, E>(std::forward<Source>(source)))) {}
+  // NOLINTEND(google-explicit-constructor)
+
+  [[nodiscard]] auto is_ok() const noexcept -> bool { return result_.is_ok(); }
+  explicit operator bool() const noexcept { return is_ok(); }
+  auto operator!() const noexcept -> bool { return !is_ok(); }
+
+  template <typename U = T, typename = std::enable_if_t<!std::is_void_v<U>>>
+  [[nodiscard]] auto value() const & noexcept(!detail::throwing_access) -> const U & {
+    return result_.value();
+  }
+  template <typename U = T, typename = std::enable_if_t<!std::is_void_v<U>>>
+  [[nodiscard]] auto value() && noexcept(!detail::throwing_access) -> U && {
+    return std::move(result_).value();
+  }
+
+  /// @brief Every error found, in the order the validations ran. Never empty.
+  [[nodiscard]] auto errors() const & noexcept(!detail::throwing_access) -> const errors_type & {
+    return result_.error();
+  }
+  [[nodiscard]] auto errors() && noexcept(!detail::throwing_access) -> errors_type && {
+    return std::move(result_).error();
+  }
+
+  [[nodiscard]] auto to_result() const & -> result_type { return result_; }
+  [[nodiscard]] auto to_result() && noexcept(std::is_nothrow_move_constructible_v<result_type>) -> result_type {
+    return std::move(result_);
+  }
+
+private:
+  static auto from_result(result<T, E> &&source) -> result_type {
+    if (!source.is_ok()) {
+      errors_type errors;
+      errors.push_back(std::move(source).error_unchecked());
+      return detail::result_access::make_err<result_type>(std::move(errors));
+    }
+    if constexpr (std::is_void_v<T>) {
+      return detail::result_access::make_ok<result_type>();
+    } else {
+      return detail::result_access::make_ok<result_type>(std::move(source).value_unchecked());
+    }
+  }
+};
+
+namespace detail {
+
+template <typename T, typename E, std::size_t N> auto take_value(validated<T, E, N> &&source) {
+  if constexpr (std::is_void_v<T>) {
+    return std::tuple<>();
+  } else {
+    return std::tuple<T>(std::move(source).value());
+  }
+}
+
+template <typename Subject, typename... Checks>
+using check_error_t = typename std::invoke_result_t<std::tuple_element_t<0, std::tuple<Checks...>> &,
+                                                    const Subject &>::error_type;
+
+template <typename E, std::size_t N, typename Subject, typename Check>
+void run_check(error_list<E, N> &errors, const Subject &subject, Check &check) {
+  auto outcome = std::invoke(check, subject);
+  static_assert(std::is_same_v<typename decltype(outcome)::error_type, E>,
+                "every check must return the same error type");
+  if (!outcome.is_ok()) { errors.push_back(std::move(outcome).error_unchecked()); }
+}
+
+} // namespace detail
+
+/// @brief Combines validations into one holding the tuple of their values, or the errors of every failed one in
+/// argument order.
+/// @details Values of validated<void, E, N> arguments are left out of the tuple, and the combined value is void when
+/// all of them are. When every validation succeeded the values are moved into the tuple; arguments passed as lvalues
+/// are copied first.
+template <typename E, std::size_t N, typename... Ts>
+auto combine(validated<Ts, E, N>... parts) -> validated<detail::combined_value_t<Ts...>, E, N> {
+  static_assert(sizeof...(Ts) > 0, "combine requires at least one validation");
+  using output = typename validated<detail::combined_value_t<Ts...>, E, N>::result_type;
+  if ((parts.is_ok() && ...)) {
+    if constexpr (std::is_void_v<detail::combined_value_t<Ts...>>) {
+      return detail::result_access::make_ok<output>();
+    } else {
+      return detail::result_access::make_ok<output>(std::tuple_cat(detail::take_value(std::move(parts))...));
+    }
+  }
+  error_list<E, N> errors;
+  ((parts.is_ok() ? void() : errors.append(std::move(parts).errors())), ...);
+  return detail::result_access::make_err<output>(std::move(errors));
+}
+
+/// @brief Like combine for plain results: the tuple of every value, or every error instead of only the first one.
+/// @details `res::zip_all(parse_name(form), parse_age(form))` reports both a bad name and a bad age. N sets how many
+/// errors are stored inline.
+template <std::size_t N = default_inline_errors, typename E, typename... Ts>
+auto zip_all(result<Ts, E>... results) -> validated<detail::combined_value_t<Ts...>, E, N> {
+  return combine(validated<Ts, E, N>(std::move(results))...);
+}
+
+/// @brief Runs every check on value and returns it if all of them pass, or the errors of every failing check.
+/// @details Each check is called with a const reference to value and returns a result whose error type is the same for
+/// all checks; its value is ignored. `res::validate_all(request, has_name, has_valid_age, has_known_country)`.
+template <std::size_t N = default_inline_errors, typename T, typename... Checks>
+auto validate_all(T &&value, Checks &&...checks)
+    -> validated<std::decay_t<T>, detail::check_error_t<std::decay_t<T>, Checks...>, N> {
+  static_assert(sizeof...(Checks) > 0, "validate_all requires at least one check");
+  using E = detail::check_error_t<std::decay_t<T>, Checks...>;
+  using output = typename validated<std::decay_t<T>, E, N>::result_type;
+  error_list<E, N> errors;
+  const std::decay_t<T> &subject = value;
+  (detail::run_check(errors, subject, checks), ...);
+  if (errors.empty()) { return detail::result_access::make_ok<output>(std::forward<T>(value)); }
+  return detail::result_access::make_err<output>(std::move(errors));
+}
+
+} // namespace res
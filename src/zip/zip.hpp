@@ -0,0 +1,105 @@
+#pragma once
+
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../result/result.hpp"
+
+namespace res {
+
+namespace detail {
+
+// The value of a combination of results: the tuple of the non-void values, or void when there are none.
+template <typename... Ts>
+using value_tuple_t = decltype(std::tuple_cat(
+    std::declval<std::conditional_t<std::is_void_v<Ts>, std::tuple<>, std::tuple<Ts>>>()...));
+template <typename... Ts>
+using combined_value_t = std::conditional_t<std::tuple_size_v<value_tuple_t<Ts...>> == 0, void, value_tuple_t<Ts...>>;
+
+template <typename R> using result_value_t = typename std::decay_t<R>::value_type;
+template <typename R> using result_error_t = typename std::decay_t<R>::error_type;
+
+template <typename First, typename... Rest> struct common_error {
+  static_assert((std::is_same_v<result_error_t<First>, result_error_t<Rest>> && ...),
+                "zip and apply require results with the same error type");
+  using type = result_error_t<First>;
+};
+
+// A reference to the value of source in a tuple of zero or one element, an rvalue reference for rvalue results. The
+// references are concatenated and then moved or copied once, into the combined tuple or the functor's parameters.
+template <typename R> constexpr auto forward_value_as_tuple(R &&source) {
+  if constexpr (std::is_void_v<result_value_t<R>>) {
+    return std::tuple<>();
+  } else {
+    return std::forward_as_tuple(std::forward<R>(source).value_unchecked());
+  }
+}
+
+template <typename... Rs>
+using forwarded_values_t = decltype(std::tuple_cat(forward_value_as_tuple(std::declval<Rs>())...));
+
+template <typename Output, typename First, typename... Rest>
+constexpr auto error_of_first_failed(First &&first, Rest &&...rest) -> Output {
+  if constexpr (sizeof...(Rest) > 0) {
+    if (first.is_ok()) { return error_of_first_failed<Output>(std::forward<Rest>(rest)...); }
+  }
+  return result_access::make_err<Output>(std::forward<First>(first).error_unchecked());
+}
+
+// Only reached when some result holds an error, so it is kept out of line and the all-ok path stays small.
+template <typename Output, typename... Rs> RESULT_NOINLINE constexpr auto first_error(Rs &&...results) -> Output {
+  return error_of_first_failed<Output>(std::forward<Rs>(results)...);
+}
+
+} // namespace detail
+
+/// @brief Combines independent results into a result of the tuple of their values, or the first error in argument
+/// order.
+/// @details `res::zip(parse_host(text), parse_port(text))` yields a result<std::tuple<host, port>, E>. The all-ok
+/// path tests every result with a single combined branch and moves the values of rvalue results into the tuple. Values
+/// of result<void, E> arguments are left out of the tuple, and the value is void when all of them are. All results must
+/// share the error type. Unlike res::zip_all, errors after the first are dropped.
+template <typename... Rs,
+          typename Output = result<detail::combined_value_t<detail::result_value_t<Rs>...>,
+                                   typename detail::common_error<Rs...>::type>>
+constexpr auto zip(Rs &&...results) -> Output {
+  static_assert((detail::is_result_v<std::decay_t<Rs>> && ...), "zip requires results");
+  // Counts the results holding a value: compilers turn a chain of && or even & back into a branch per result.
+  if (RESULT_LIKELY((static_cast<unsigned>(results.is_ok()) + ...) == sizeof...(Rs))) {
+    if constexpr (std::is_void_v<typename Output::value_type>) {
+      return detail::result_access::make_ok<Output>();
+    } else {
+      return detail::result_access::make_ok<Output>(
+          std::tuple_cat(detail::forward_value_as_tuple(std::forward<Rs>(results))...));
+    }
+  }
+  return detail::first_error<Output>(std::forward<Rs>(results)...);
+}
+
+/// @brief Calls functor with the values of results if all of them hold one, or returns the first error.
+/// @details The variadic counterpart of map: `res::apply([](host h, port p) { return endpoint{h, p}; }, host, port)`.
+/// Values of result<void, E> arguments are not passed, values of rvalue results are moved, and a functor returning
+/// void yields a result<void, E>.
+template <typename F, typename... Rs>
+constexpr auto apply(F &&functor, Rs &&...results) {
+  using error_type = typename detail::common_error<Rs...>::type;
+  using value_type = std::decay_t<decltype(std::apply(std::forward<F>(functor),
+                                                      std::declval<detail::forwarded_values_t<Rs...>>()))>;
+  using output = result<value_type, error_type>;
+  static_assert((detail::is_result_v<std::decay_t<Rs>> && ...), "apply requires results");
+  // A single branch for the all-ok path, as in zip.
+  if (RESULT_LIKELY((static_cast<unsigned>(results.is_ok()) + ...) == sizeof...(Rs))) {
+    auto values = std::tuple_cat(detail::forward_value_as_tuple(std::forward<Rs>(results))...);
+    if constexpr (std::is_void_v<value_type>) {
+      std::apply(std::forward<F>(functor), std::move(values));
+      return detail::result_access::make_ok<output>();
+    } else {
+      return detail::result_access::make_ok<output>(std::apply(std::forward<F>(functor), std::move(values)));
+    }
+  }
+  return detail::first_error<output>(std::forward<Rs>(results)...);
+}
+
+} // namespace res
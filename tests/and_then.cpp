@@ -0,0 +1,68 @@
+#include "../result.h"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace {
+
+auto half(int val) -> res::result<int, std::string> {
+  if (val % 2 != 0) { return res::err(std::string("odd")); }
+  return res::ok(val / 2);
+}
+
+} // namespace
+
+TEST(AndThen, Ok) {
+  res::result<int, std::string> result = res::ok(42);
+  auto chained = result.and_then(half);
+  EXPECT_TRUE(chained);
+  EXPECT_EQ(chained.value(), 21);
+}
+
+TEST(AndThen, OkToErr) {
+  res::result<int, std::string> result = res::ok(21);
+  auto chained = result.and_then(half);
+  EXPECT_FALSE(chained);
+  EXPECT_EQ(chained.error(), "odd");
+}
+
+TEST(AndThen, ErrSkipsFunctor) {
+  res::result<int, std::string> result = res::err(std::string("error"));
+  bool called = false;
+  auto chained = result.and_then([&called](int val) -> res::result<int, std::string> {
+    called = true;
+    return res::ok(val);
+  });
+  EXPECT_FALSE(called);
+  EXPECT_FALSE(chained);
+  EXPECT_EQ(chained.error(), "error");
+}
+
+TEST(AndThen, ChangeType) {
+  res::result<int, std::string> result = res::ok(42);
+  auto chained = result.and_then([](int val) -> res::result<std::string, std::string> {
+    return res::ok(std::to_string(val));
+  });
+  EXPECT_TRUE(chained);
+  EXPECT_EQ(chained.value(), "42");
+}
+
+TEST(AndThen, Chained) {
+  res::result<int, std::string> result = res::ok(84);
+  auto chained = std::move(result).and_then(half).and_then(half).and_then(half);
+  EXPECT_FALSE(chained);
+  EXPECT_EQ(chained.error(), "odd");
+}
+
+TEST(AndThen, OkVoid) {
+  res::result<void, std::string> result = res::ok();
+  auto chained = result.and_then([]() { return half(42); });
+  EXPECT_TRUE(chained);
+  EXPECT_EQ(chained.value(), 21);
+}
+
+TEST(AndThen, ErrVoid) {
+  res::result<void, std::string> result = res::err(std::string("error"));
+  auto chained = result.and_then([]() { return half(42); });
+  EXPECT_FALSE(chained);
+  EXPECT_EQ(chained.error(), "error");
+}
@@ -0,0 +1,225 @@
+#include "../result.h"
+#include <array>
+#include <gtest/gtest.h>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace {
+
+enum class parse_errc { empty, not_a_number };
+
+struct io_error {
+  int code = 0;
+  std::string_view path;
+
+  [[nodiscard]] auto category() const -> std::string_view { return "io"; }
+  [[nodiscard]] auto message() const -> std::string { return "cannot open " + std::string(path); }
+  friend auto operator==(const io_error &lhs, const io_error &rhs) -> bool {
+    return lhs.code == rhs.code && lhs.path == rhs.path;
+  }
+};
+
+struct streamed_error {
+  int line = 0;
+  friend auto operator<<(std::ostream &stream, const streamed_error &error) -> std::ostream & {
+    return stream << "syntax error on line " << error.line;
+  }
+};
+
+// Larger than the inline buffer, so it goes on the heap.
+struct large_error {
+  std::array<char, 64> detail{};
+  int code = 0;
+};
+
+// Just over the inline buffer as well: a std::string is 32 bytes with libstdc++ and libc++.
+struct described_error {
+  int code = 0;
+  std::string description;
+};
+
+// Counts live instances to check that every stored error is destroyed exactly once.
+struct counted_error {
+  static inline int live = 0;
+  counted_error() { ++live; }
+  counted_error(const counted_error & /*other*/) { ++live; }
+  counted_error(counted_error && /*other*/) noexcept { ++live; }
+  auto operator=(const counted_error &) -> counted_error & = default;
+  auto operator=(counted_error &&) noexcept -> counted_error & = default;
+  ~counted_error() { --live; }
+};
+
+constexpr res::error_descriptor disk_full{"storage", "disk full"};
+
+auto parse(const std::string &text) -> res::result<int, parse_errc> {
+  if (text.empty()) { return res::err(parse_errc::empty); }
+  if (text.find_first_not_of("0123456789") != std::string::npos) { return res::err(parse_errc::not_a_number); }
+  return res::ok(std::stoi(text));
+}
+
+auto open(const std::string &path) -> res::result<int, io_error> {
+  if (path.empty()) { return res::err(io_error{2, "<none>"}); }
+  return res::ok(3);
+}
+
+// Two layers with their own error types joined without map_err.
+auto load(const std::string &path, const std::string &text) -> res::result<int, res::any_error> {
+  RES_TRY_ASSIGN(const int handle, open(path));
+  RES_TRY_ASSIGN(const int value, parse(text));
+  return res::ok(handle + value);
+}
+
+} // namespace
+
+static_assert(sizeof(res::any_error) == RESULT_ANY_ERROR_INLINE_SIZE + sizeof(void *));
+static_assert(sizeof(res::result<int, res::any_error>) <= 48);
+static_assert(std::is_nothrow_move_constructible_v<res::any_error>);
+static_assert(std::is_nothrow_move_constructible_v<res::result<int, res::any_error>>);
+static_assert(!std::is_convertible_v<std::unique_ptr<int>, res::any_error>);
+static_assert(!std::is_convertible_v<const char *, res::any_error>);
+static_assert(!std::is_convertible_v<const char (&)[6], res::any_error>);
+static_assert(!std::is_convertible_v<io_error *, res::any_error>);
+
+TEST(AnyError, StoresTypicalErrorsInline) {
+  EXPECT_TRUE(res::any_error(parse_errc::empty).is_inline());
+  EXPECT_TRUE(res::any_error(io_error{1, "a"}).is_inline());
+  EXPECT_TRUE(res::any_error(std::string("a long message that does not fit a small string")).is_inline());
+  EXPECT_TRUE(res::any_error(res::error_code(disk_full)).is_inline());
+  EXPECT_TRUE(res::any_error(std::make_error_code(std::errc::timed_out)).is_inline());
+  EXPECT_FALSE(res::any_error(large_error{}).is_inline());
+  EXPECT_EQ(res::any_error(described_error{}).is_inline(), sizeof(described_error) <= RESULT_ANY_ERROR_INLINE_SIZE);
+}
+
+TEST(AnyError, DowncastsToTheStoredType) {
+  res::any_error error = io_error{5, "/etc/passwd"};
+  EXPECT_TRUE(error.is<io_error>());
+  EXPECT_FALSE(error.is<parse_errc>());
+  EXPECT_EQ(error.as<parse_errc>(), nullptr);
+  ASSERT_NE(error.as<io_error>(), nullptr);
+  EXPECT_EQ(error.as<io_error>()->code, 5);
+  error.as<io_error>()->code = 6;
+
+  const auto moved = std::move(error).downcast<io_error>();
+  ASSERT_TRUE(moved.is_ok());
+  EXPECT_EQ(moved.value().code, 6);
+  EXPECT_EQ(moved.value().path, "/etc/passwd");
+}
+
+TEST(AnyError, FailedDowncastKeepsTheError) {
+  res::any_error error = parse_errc::not_a_number;
+  const auto downcast = std::move(error).downcast<io_error>();
+  ASSERT_FALSE(downcast.is_ok());
+  EXPECT_EQ(downcast.error(), res::any_error(parse_errc::not_a_number));
+}
+
+TEST(AnyError, DowncastsHeapStoredErrors) {
+  large_error source;
+  source.code = 9;
+  res::any_error error = source;
+  ASSERT_NE(error.as<large_error>(), nullptr);
+  EXPECT_EQ(error.as<large_error>()->code, 9);
+  const res::any_error copy = error;
+  EXPECT_NE(copy.as<large_error>(), error.as<large_error>());
+  EXPECT_EQ(std::move(error).downcast<large_error>().value().code, 9);
+}
+
+TEST(AnyError, DescribesTheStoredError) {
+  const res::any_error io = io_error{2, "/tmp/x"};
+  EXPECT_EQ(io.category(), "io");
+  EXPECT_EQ(io.message(), "cannot open /tmp/x");
+
+  const res::any_error code = res::error_code(disk_full);
+  EXPECT_EQ(code.category(), "storage");
+  EXPECT_EQ(code.message(), "disk full");
+
+  const res::any_error standard = std::make_error_code(std::errc::timed_out);
+  EXPECT_EQ(standard.category(), "generic");
+  EXPECT_EQ(standard.message(), std::make_error_code(std::errc::timed_out).message());
+
+  const res::any_error streamed = streamed_error{12};
+  EXPECT_EQ(streamed.category(), "");
+  EXPECT_EQ(streamed.message(), "syntax error on line 12");
+
+  EXPECT_EQ(res::any_error(parse_errc::not_a_number).message(), "1");
+  EXPECT_EQ(res::any_error(std::string("plain")).message(), "plain");
+  EXPECT_EQ(res::any_error(large_error{}).message(), "unknown error");
+}
+
+TEST(AnyError, Prints) {
+  std::ostringstream stream;
+  stream << res::any_error(io_error{2, "/tmp/x"}) << '|' << res::any_error(streamed_error{3});
+  EXPECT_EQ(stream.str(), "io: cannot open /tmp/x|syntax error on line 3");
+}
+
+TEST(AnyError, ComparesByTypeAndValue) {
+  EXPECT_EQ(res::any_error(io_error{1, "a"}), res::any_error(io_error{1, "a"}));
+  EXPECT_NE(res::any_error(io_error{1, "a"}), res::any_error(io_error{1, "b"}));
+  EXPECT_NE(res::any_error(1), res::any_error(1L));
+  EXPECT_EQ(res::any_error(parse_errc::empty), res::any_error(parse_errc::empty));
+
+  // Without operator==, an error only equals itself.
+  const res::any_error streamed = streamed_error{1};
+  EXPECT_EQ(streamed, streamed);
+  EXPECT_NE(streamed, res::any_error(streamed_error{1}));
+}
+
+TEST(AnyError, MovedFromHoldsNoError) {
+  res::any_error source = io_error{1, "a"};
+  const res::any_error target = std::move(source);
+  EXPECT_TRUE(target.is<io_error>());
+  EXPECT_FALSE(source.is<io_error>()); // NOLINT(bugprone-use-after-move)
+  EXPECT_EQ(source.message(), "");
+  EXPECT_EQ(source.category(), "");
+  res::any_error other = parse_errc::empty;
+  const res::any_error drained = std::move(other);
+  EXPECT_EQ(source, other); // NOLINT(bugprone-use-after-move)
+  EXPECT_NE(source, drained);
+}
+
+TEST(AnyError, DestroysEveryStoredError) {
+  counted_error::live = 0;
+  {
+    res::any_error first = counted_error();
+    res::any_error second = first;
+    res::any_error third = std::move(first);
+    EXPECT_EQ(counted_error::live, 2);
+    second = third;
+    EXPECT_EQ(counted_error::live, 2);
+    second = res::any_error(parse_errc::empty);
+    EXPECT_EQ(counted_error::live, 1);
+    third = std::move(second);
+    EXPECT_EQ(counted_error::live, 0);
+  }
+  EXPECT_EQ(counted_error::live, 0);
+}
+
+TEST(AnyError, JoinsLayersWithDifferentErrorTypes) {
+  EXPECT_EQ(load("data", "4").value(), 7);
+
+  const auto missing = load("", "4");
+  ASSERT_FALSE(missing.is_ok());
+  EXPECT_TRUE(missing.error().is<io_error>());
+  EXPECT_EQ(missing.error().category(), "io");
+
+  const auto bad = load("data", "x");
+  ASSERT_FALSE(bad.is_ok());
+  ASSERT_NE(bad.error().as<parse_errc>(), nullptr);
+  EXPECT_EQ(*bad.error().as<parse_errc>(), parse_errc::not_a_number);
+}
+
+TEST(AnyError, ConvertsThroughMapErr) {
+  const auto unified = parse("").map_err([](parse_errc errc) { return res::any_error(errc); });
+  EXPECT_TRUE(unified.error().is<parse_errc>());
+  const res::result<int, res::any_error> copy = unified;
+  EXPECT_EQ(copy, unified);
+}
+
+TEST(AnyError, InPlaceConstruction) {
+  const res::any_error error(std::in_place_type<std::string>, 3, 'x');
+  ASSERT_TRUE(error.is<std::string>());
+  EXPECT_EQ(error.message(), "xxx");
+}
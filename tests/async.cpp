@@ -0,0 +1,163 @@
+#include "../result_concurrency.h"
+#include "misuse.hpp"
+#include <atomic>
+#include <functional>
+#include <gtest/gtest.h>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Queues jobs until run() is called, to observe where continuations execute.
+struct queue_executor {
+  std::shared_ptr<std::vector<std::function<void()>>> jobs = std::make_shared<std::vector<std::function<void()>>>();
+
+  template <typename Job> void post(Job &&job) const { jobs->emplace_back(std::forward<Job>(job)); }
+  void run() const {
+    for (auto &job : *jobs) { job(); }
+    jobs->clear();
+  }
+};
+
+// Runs jobs inline and then records the post through its own state, like an executor that counts its work.
+struct counting_executor {
+  std::shared_ptr<int> posted = std::make_shared<int>(0);
+
+  template <typename Job> void post(Job &&job) const {
+    std::forward<Job>(job)();
+    ++*posted;
+  }
+};
+
+} // namespace
+
+TEST(Async, SetBeforeGet) {
+  res::promise<int, std::string> promise;
+  auto future = promise.get_async_result();
+  EXPECT_FALSE(future.is_ready());
+  promise.set_result(res::ok(42));
+  EXPECT_TRUE(future.is_ready());
+  EXPECT_EQ(std::move(future).get().value(), 42);
+}
+
+TEST(Async, GetWaitsForOtherThread) {
+  res::promise<int, std::string> promise;
+  auto future = promise.get_async_result();
+  std::thread producer([promise = std::move(promise)]() mutable { promise.set_result(res::err(std::string("e"))); });
+  const auto result = std::move(future).get();
+  producer.join();
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error(), "e");
+}
+
+TEST(Async, ContinuationsRunInlineWhenSet) {
+  res::promise<int, std::string> promise;
+  bool ran = false;
+  auto chained = promise.get_async_result()
+                     .map([&ran](int val) {
+                       ran = true;
+                       return val * 2;
+                     })
+                     .then([](res::result<int, std::string> &&result) -> res::result<std::string, int> {
+                       if (result) { return res::ok(std::to_string(result.value())); }
+                       return res::err(static_cast<int>(result.error().size()));
+                     });
+  EXPECT_FALSE(ran);
+  promise.set_result(res::ok(21));
+  EXPECT_TRUE(ran);
+  EXPECT_TRUE(chained.is_ready());
+  EXPECT_EQ(std::move(chained).get().value(), "42");
+}
+
+TEST(Async, ContinuationOnReadyResultRunsImmediately) {
+  res::promise<int, std::string> promise;
+  auto future = promise.get_async_result();
+  promise.set_result(res::err(std::string("error")));
+  auto mapped = std::move(future).map_err([](const std::string &err) { return err + "!"; });
+  ASSERT_TRUE(mapped.is_ready());
+  EXPECT_EQ(std::move(mapped).get().error(), "error!");
+}
+
+TEST(Async, ContinuationsOnExecutor) {
+  const queue_executor executor;
+  res::promise<int, int> promise;
+  auto mapped = promise.get_async_result().map([](int val) { return val + 1; }, executor);
+  promise.set_result(res::ok(1));
+  EXPECT_FALSE(mapped.is_ready());
+  executor.run();
+  ASSERT_TRUE(mapped.is_ready());
+  EXPECT_EQ(std::move(mapped).get().value(), 2);
+}
+
+TEST(Async, AbandonedPromise) {
+  auto future = res::promise<int, int>().get_async_result();
+  auto mapped = std::move(future).map([](int val) { return val; });
+  ASSERT_TRUE(mapped.is_ready());
+  EXPECT_MISUSE((void)std::move(mapped).get(), std::logic_error);
+}
+
+TEST(Async, ExecutorOutlivesTheContinuationItRuns) {
+  const counting_executor executor;
+  res::promise<int, int> promise;
+  auto mapped = promise.get_async_result().map([](int val) { return val * 3; }, executor);
+  // Dropping the consumer first lets the chained state be destroyed inside post.
+  { const auto dropped = std::move(mapped); }
+  promise.set_result(res::ok(5));
+  EXPECT_EQ(*executor.posted, 1);
+}
+
+TEST(Async, InvalidResultIsMisuse) {
+  res::promise<int, int> promise;
+  auto future = promise.get_async_result();
+  auto moved = std::move(future);
+  EXPECT_DEATH((void)future.is_ready(), "without a shared state"); // NOLINT(bugprone-use-after-move)
+  EXPECT_DEATH((void)std::move(future).get(), "without a shared state");
+  EXPECT_TRUE(moved.valid());
+}
+
+TEST(Async, SingleRetrieval) {
+  res::promise<int, int> promise;
+  auto future = promise.get_async_result();
+  EXPECT_MISUSE((void)promise.get_async_result(), std::logic_error);
+  promise.set_result(res::ok(1));
+  EXPECT_MISUSE(promise.set_result(res::ok(2)), std::logic_error);
+}
+
+TEST(Async, PooledState) {
+  std::pmr::synchronized_pool_resource pool;
+  const std::pmr::polymorphic_allocator<std::byte> allocator(&pool);
+  for (int i = 0; i < 100; ++i) {
+    res::promise<int, int> promise(std::allocator_arg, allocator);
+    auto future = promise.get_async_result();
+    promise.set_result(res::ok(i));
+    EXPECT_EQ(std::move(future).get().value(), i);
+  }
+}
+
+TEST(Async, RacingProducersAndContinuations) {
+  constexpr int count = 2000;
+  std::vector<res::promise<int, int>> promises(count);
+  std::vector<res::async_result<int, int>> futures;
+  futures.reserve(count);
+  for (auto &promise : promises) { futures.push_back(promise.get_async_result()); }
+
+  std::atomic<int> sum{0};
+  std::thread producer([&promises] {
+    for (auto &promise : promises) { promise.set_result(res::ok(static_cast<int>(&promise - promises.data()))); }
+  });
+  std::vector<res::async_result<int, int>> chained;
+  chained.reserve(count);
+  for (auto &future : futures) {
+    chained.push_back(std::move(future).map([&sum](int val) {
+      sum.fetch_add(val, std::memory_order_relaxed);
+      return val;
+    }));
+  }
+  for (auto &result : chained) { EXPECT_TRUE(std::move(result).get()); }
+  producer.join();
+  EXPECT_EQ(sum.load(), count * (count - 1) / 2);
+}
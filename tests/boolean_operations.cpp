@@ -1,4 +1,5 @@
 #include "../result.h"
+#include "misuse.hpp"
 #include <gtest/gtest.h>
 #include <string>
 
@@ -10,7 +11,7 @@ TEST(BooleanOperations, Ok) {
   EXPECT_TRUE(result.is_ok());
   EXPECT_FALSE(!result.is_ok());
   EXPECT_EQ(result.value(), 42);
-  EXPECT_THROW(auto val = result.error(), std::logic_error); // NOLINT
+  EXPECT_MISUSE((void)result.error(), std::logic_error);
 }
 
 TEST(BooleanOperations, Err) {
@@ -21,7 +22,7 @@ TEST(BooleanOperations, Err) {
   EXPECT_FALSE(result.is_ok());
   EXPECT_TRUE(!result.is_ok());
   EXPECT_EQ(result.error(), "error");
-  EXPECT_THROW(auto val = result.value(), std::logic_error); // NOLINT
+  EXPECT_MISUSE((void)result.value(), std::logic_error);
 }
 
 TEST(BooleanOperations, VoidOk) {
@@ -30,7 +31,7 @@ TEST(BooleanOperations, VoidOk) {
   EXPECT_FALSE(!result);
   EXPECT_TRUE(result.is_ok());
   EXPECT_FALSE(!result.is_ok());
-  EXPECT_THROW(auto val = result.error(), std::logic_error); // NOLINT
+  EXPECT_MISUSE((void)result.error(), std::logic_error);
 }
 
 TEST(BooleanOperations, VoidErr) {
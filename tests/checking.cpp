@@ -0,0 +1,92 @@
+#include "../result.h"
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#if RESULT_HAS_EXCEPTIONS
+TEST(Checking, DefaultPolicyThrows) {
+  static_assert(RESULT_CHECKING == RESULT_CHECKING_THROW);
+  static_assert(res::detail::checked_access);
+  const res::result<int, std::string> failed = res::err(std::string("boom"));
+  const res::result<int, std::string> succeeded = res::ok(1);
+  EXPECT_THROW((void)failed.value(), std::logic_error);
+  EXPECT_THROW((void)succeeded.error(), std::logic_error);
+  const res::result<void, int> void_succeeded = res::ok();
+  EXPECT_THROW((void)void_succeeded.error(), std::logic_error);
+}
+
+TEST(Checking, MessageNamesTheAccessor) {
+  const res::result<int, int> failed = res::err(3);
+  try {
+    (void)failed.value();
+    FAIL() << "value() did not throw";
+  } catch (const std::logic_error &error) {
+    EXPECT_STREQ(error.what(), "value() called on result with error");
+  }
+}
+#else
+TEST(Checking, DefaultPolicyAbortsWithoutExceptions) {
+  static_assert(RESULT_CHECKING == RESULT_CHECKING_ABORT);
+  static_assert(res::detail::checked_access);
+  const res::result<int, std::string> failed = res::err(std::string("boom"));
+  const res::result<void, int> void_succeeded = res::ok();
+  EXPECT_DEATH((void)failed.value(), "value\\(\\) called on result with error");
+  EXPECT_DEATH((void)void_succeeded.error(), "error\\(\\) called on result with value");
+}
+
+TEST(Checking, MisuseHandlerSeesTheMessage) {
+  const res::result<int, int> failed = res::err(3);
+  EXPECT_DEATH(
+      {
+        res::set_misuse_handler([](const char *message) {
+          std::fputs("handled: ", stderr);
+          std::fputs(message, stderr);
+        });
+        (void)failed.value();
+      },
+      "handled: value\\(\\) called on result with error");
+}
+#endif
+
+TEST(Checking, SetMisuseHandlerReturnsThePreviousOne) {
+  const res::misuse_handler handler = [](const char * /*message*/) {};
+  EXPECT_EQ(res::set_misuse_handler(handler), nullptr);
+  EXPECT_EQ(res::set_misuse_handler(nullptr), handler);
+}
+
+TEST(Checking, AccessorsAreNoexceptUnlessTheyThrow) {
+  const res::result<int, std::string> succeeded = res::ok(1);
+  const res::result<void, int> void_succeeded = res::ok();
+  static_assert(noexcept(succeeded.value()) == !res::detail::throwing_access);
+  static_assert(noexcept(succeeded.error()) == !res::detail::throwing_access);
+  static_assert(noexcept(void_succeeded.error()) == !res::detail::throwing_access);
+  EXPECT_EQ(succeeded.value(), 1);
+}
+
+TEST(Checking, UncheckedAccessors) {
+  const res::result<int, std::string> succeeded = res::ok(7);
+  const res::result<int, std::string> failed = res::err(std::string("boom"));
+  EXPECT_EQ(succeeded.value_unchecked(), 7);
+  EXPECT_EQ(failed.error_unchecked(), "boom");
+  const res::result<void, int> void_failed = res::err(4);
+  EXPECT_EQ(void_failed.error_unchecked(), 4);
+}
+
+TEST(Checking, UncheckedAccessorsMoveFromRvalues) {
+  auto owned = res::result<int, std::string>(res::ok(1)).map([](int value) { return std::make_unique<int>(value); });
+  const std::unique_ptr<int> moved = std::move(owned).value_unchecked();
+  ASSERT_NE(moved, nullptr);
+  EXPECT_EQ(*moved, 1);
+  res::result<int, std::string> failed = res::err(std::string("a long error message that is not inlined"));
+  const std::string error = std::move(failed).error_unchecked();
+  EXPECT_EQ(error, "a long error message that is not inlined");
+}
+
+TEST(Checking, UncheckedAccessorsAreConstexpr) {
+  constexpr res::result<int, int> succeeded = res::ok(5);
+  static_assert(succeeded.value_unchecked() == 5);
+  static_assert(succeeded.value() == 5);
+  static_assert(noexcept(succeeded.value_unchecked()));
+}
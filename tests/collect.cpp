@@ -0,0 +1,85 @@
+#include "../result.h"
+#include <deque>
+#include <gtest/gtest.h>
+#include <list>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+auto parse(const std::string &text) -> res::result<int, std::string> {
+  if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) { return res::err("bad: " + text); }
+  return res::ok(std::stoi(text));
+}
+
+} // namespace
+
+TEST(Collect, AllOk) {
+  const std::vector<res::result<int, std::string>> results = {res::ok(1), res::ok(2), res::ok(3)};
+  const auto collected = res::collect(results);
+  ASSERT_TRUE(collected);
+  EXPECT_EQ(collected.value(), (std::vector<int>{1, 2, 3}));
+}
+
+TEST(Collect, FirstError) {
+  const std::vector<res::result<int, std::string>> results = {res::ok(1), res::err(std::string("first")),
+                                                              res::err(std::string("second"))};
+  const auto collected = res::collect(results);
+  ASSERT_FALSE(collected);
+  EXPECT_EQ(collected.error(), "first");
+}
+
+TEST(Collect, Empty) {
+  const std::list<res::result<int, std::string>> results;
+  const auto collected = res::collect(results);
+  ASSERT_TRUE(collected);
+  EXPECT_TRUE(collected.value().empty());
+}
+
+TEST(Collect, CustomContainer) {
+  const std::vector<res::result<int, std::string>> results = {res::ok(3), res::ok(1), res::ok(3)};
+  const auto collected = res::collect<std::set<int>>(results);
+  ASSERT_TRUE(collected);
+  EXPECT_EQ(collected.value(), (std::set<int>{1, 3}));
+}
+
+TEST(Collect, MovesFromRvalueRange) {
+  const auto make_owned = [](int val) { return std::make_unique<int>(val); };
+  std::vector<res::result<std::unique_ptr<int>, std::string>> results;
+  results.push_back(res::result<int, std::string>(res::ok(1)).map(make_owned));
+  results.push_back(res::result<int, std::string>(res::ok(2)).map(make_owned));
+  const auto collected = res::collect(std::move(results));
+  ASSERT_TRUE(collected);
+  ASSERT_EQ(collected.value().size(), 2);
+  EXPECT_EQ(*collected.value()[1], 2);
+}
+
+TEST(Traverse, AllOk) {
+  const std::vector<std::string> inputs = {"1", "22", "333"};
+  const auto parsed = res::traverse(inputs, parse);
+  ASSERT_TRUE(parsed);
+  EXPECT_EQ(parsed.value(), (std::vector<int>{1, 22, 333}));
+}
+
+TEST(Traverse, StopsAtFirstError) {
+  const std::vector<std::string> inputs = {"1", "x", "2", "y"};
+  int calls = 0;
+  const auto parsed = res::traverse<std::deque<int>>(inputs, [&calls](const std::string &text) {
+    ++calls;
+    return parse(text);
+  });
+  ASSERT_FALSE(parsed);
+  EXPECT_EQ(parsed.error(), "bad: x");
+  EXPECT_EQ(calls, 2);
+}
+
+TEST(Traverse, MovesElementsOfRvalueRange) {
+  std::vector<std::string> inputs = {std::string(32, 'a'), std::string(32, 'b')};
+  const auto lengths = res::traverse(std::move(inputs), [](std::string &&text) -> res::result<std::string, int> {
+    return res::ok(std::move(text));
+  });
+  ASSERT_TRUE(lengths);
+  EXPECT_EQ(lengths.value()[1], std::string(32, 'b'));
+}
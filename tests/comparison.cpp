@@ -0,0 +1,66 @@
+#include "../result.h"
+#include <functional>
+#include <gtest/gtest.h>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+struct unhashable {
+  auto operator==(const unhashable & /*other*/) const -> bool { return true; }
+};
+
+} // namespace
+
+TEST(Comparison, EqualValuesAndErrors) {
+  const res::result<int, std::string> one = res::ok(1);
+  const res::result<int, std::string> other_one = res::ok(1);
+  const res::result<int, std::string> two = res::ok(2);
+  const res::result<int, std::string> failed = res::err(std::string("1"));
+  EXPECT_EQ(one, other_one);
+  EXPECT_NE(one, two);
+  EXPECT_NE(one, failed);
+  EXPECT_EQ(failed, (res::result<int, std::string>(res::err(std::string("1")))));
+}
+
+TEST(Comparison, MixedTypes) {
+  const res::result<int, std::string> integer = res::ok(3);
+  const res::result<long, const char *> wide = res::ok(3L);
+  EXPECT_TRUE(integer == wide);
+
+  int value = 3;
+  const res::result<int &, std::string> reference = res::ok(std::ref(value));
+  EXPECT_EQ(reference, integer);
+}
+
+TEST(Comparison, VoidResults) {
+  const res::result<void, int> done = res::ok();
+  const res::result<void, int> failed = res::err(4);
+  EXPECT_EQ(done, (res::result<void, int>(res::ok())));
+  EXPECT_NE(done, failed);
+  EXPECT_EQ(failed, (res::result<void, int>(res::err(4))));
+}
+
+TEST(Hash, ResultsAreUnorderedKeys) {
+  std::unordered_map<res::result<int, std::string>, int> counts;
+  ++counts[res::ok(1)];
+  ++counts[res::ok(1)];
+  ++counts[res::err(std::string("missing"))];
+  EXPECT_EQ(counts.size(), 2U);
+  EXPECT_EQ((counts[res::ok(1)]), 2);
+
+  // An error never collides with a value that hashes the same.
+  const std::hash<res::result<int, int>> hash;
+  EXPECT_NE(hash(res::ok(7)), hash(res::err(7)));
+  EXPECT_EQ((std::hash<res::result<void, int>>()(res::ok())), (std::hash<res::result<void, int>>()(res::ok())));
+}
+
+TEST(Hash, DisabledForUnhashablePayloads) {
+  static_assert(std::is_default_constructible_v<std::hash<res::result<int, std::string>>>);
+  static_assert(!std::is_default_constructible_v<std::hash<res::result<unhashable, int>>>);
+  static_assert(!std::is_default_constructible_v<std::hash<res::result<int, unhashable>>>);
+  using unhashable_result = res::result<unhashable, int>;
+  EXPECT_EQ(unhashable_result(res::ok(unhashable{})), unhashable_result(res::ok(unhashable{})));
+}
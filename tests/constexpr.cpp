@@ -0,0 +1,93 @@
+#include "../result.h"
+#include "misuse.hpp"
+#include <array>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <string_view>
+
+namespace {
+
+enum class parse_errc { empty, not_a_digit, out_of_range, invalid };
+
+constexpr auto parse_port(std::string_view text) -> res::result<int, parse_errc> {
+  if (text.empty()) { return res::err(parse_errc::empty); }
+  int port = 0;
+  for (const char chr : text) {
+    if (chr < '0' || chr > '9') { return res::err(parse_errc::not_a_digit); }
+    port = port * 10 + (chr - '0');
+    if (port > 65535) { return res::err(parse_errc::out_of_range); }
+  }
+  return res::ok(port);
+}
+
+constexpr auto check_not_zero(int port) -> res::result<void, parse_errc> {
+  if (port == 0) { return res::err(parse_errc::out_of_range); }
+  return res::ok();
+}
+
+struct endpoint {
+  std::string_view name;
+  int port;
+};
+
+// Configuration table validated entirely at compile time.
+constexpr std::array<std::string_view, 3> raw_ports = {"80", "443", "8080"};
+
+constexpr auto build_endpoints() -> std::array<endpoint, raw_ports.size()> {
+  std::array<endpoint, raw_ports.size()> endpoints{};
+  for (std::size_t i = 0; i < raw_ports.size(); ++i) {
+    endpoints[i] = endpoint{raw_ports[i], parse_port(raw_ports[i]).value()};
+  }
+  return endpoints;
+}
+
+constexpr auto endpoints = build_endpoints();
+
+constexpr int answer = 42;
+
+// A pointer result with an error too wide to pack keeps the tagged union, so it stays usable at compile time.
+constexpr auto find_answer(bool found) -> res::result<const int *, std::string_view> {
+  if (!found) { return res::err(std::string_view("missing")); }
+  return res::ok(&answer);
+}
+
+} // namespace
+
+// Packing an error into a pointer's spare bits needs reinterpret_cast, so only those results are runtime-only.
+static_assert(res::detail::packs_error_v<const int *, int>);
+static_assert(!res::detail::packs_error_v<const int *, std::string_view>);
+static_assert(!res::detail::packs_error_v<int, parse_errc>);
+static_assert(*find_answer(true).value() == 42);
+static_assert(find_answer(false).error() == "missing");
+
+static_assert(parse_port("8080").is_ok());
+static_assert(parse_port("8080").value() == 8080);
+static_assert(!parse_port("80a"));
+static_assert(parse_port("80a").error() == parse_errc::not_a_digit);
+static_assert(parse_port("").error() == parse_errc::empty);
+static_assert(parse_port("99999").value_or(-1) == -1);
+
+static_assert(parse_port("21").map([](int port) { return port + 1; }).value() == 22);
+static_assert(parse_port("x").map([](int port) { return port + 1; }).error() == parse_errc::not_a_digit);
+static_assert(parse_port("x").map_err([](parse_errc errc) { return static_cast<int>(errc); }).error() == 1);
+static_assert(parse_port("21").map_err([](parse_errc errc) { return static_cast<int>(errc); }).value() == 21);
+
+static_assert(check_not_zero(1).is_ok());
+static_assert(check_not_zero(0).error() == parse_errc::out_of_range);
+static_assert(check_not_zero(1).map([]() { return 42; }).value() == 42);
+static_assert(check_not_zero(0).map_err([](parse_errc) { return 'e'; }).error() == 'e');
+
+static_assert(endpoints[0].port == 80);
+static_assert(endpoints[2].port == 8080);
+
+TEST(Constexpr, ThrowingPathAtRuntime) {
+  constexpr auto result = parse_port("abc");
+  EXPECT_MISUSE((void)result.value(), std::logic_error);
+  EXPECT_EQ(result.error(), parse_errc::not_a_digit);
+}
+
+TEST(Constexpr, SameFunctionAtRuntime) {
+  const std::string_view text = "443";
+  EXPECT_EQ(parse_port(text).value(), 443);
+  EXPECT_EQ(endpoints[1].port, 443);
+}
@@ -1,4 +1,5 @@
 #include "../result.h"
+#include "misuse.hpp"
 #include <gtest/gtest.h>
 #include <string>
 
@@ -7,7 +8,7 @@ TEST(ConstructionEdgeCases, SameTypeOk) {
   res::result<int, int> result = res::ok(value);
   ASSERT_TRUE(result);
   EXPECT_EQ(result.value(), 42);
-  EXPECT_THROW(auto val = result.error(), std::logic_error); // NOLINT
+  EXPECT_MISUSE((void)result.error(), std::logic_error);
 }
 
 TEST(ConstructionEdgeCases, SameTypeErr) {
@@ -15,5 +16,5 @@ TEST(ConstructionEdgeCases, SameTypeErr) {
   res::result<int, int> result = res::err(value);
   ASSERT_FALSE(result);
   EXPECT_EQ(result.error(), 42);
-  EXPECT_THROW(auto val = result.value(), std::logic_error); // NOLINT
+  EXPECT_MISUSE((void)result.value(), std::logic_error);
 }
\ No newline at end of file
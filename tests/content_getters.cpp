@@ -1,4 +1,5 @@
 #include "../result.h"
+#include "misuse.hpp"
 #include <gtest/gtest.h>
 #include <string>
 
@@ -6,19 +7,19 @@ TEST(ContentGetters, Ok) {
   const int value = 42;
   res::result<int, std::string> result = res::ok(value);
   EXPECT_EQ(result.value(), 42);
-  EXPECT_THROW(auto val = result.error(), std::logic_error); // NOLINT
+  EXPECT_MISUSE((void)result.error(), std::logic_error);
 }
 
 TEST(ContentGetters, Err) {
   const std::string error = "error";
   res::result<int, std::string> result = res::err(error);
-  EXPECT_THROW(auto val = result.value(), std::logic_error); // NOLINT
+  EXPECT_MISUSE((void)result.value(), std::logic_error);
   EXPECT_EQ(result.error(), "error");
 }
 
 TEST(ContentGetters, VoidOk) {
   res::result<void, std::string> result = res::ok();
-  EXPECT_THROW(auto val = result.error(), std::logic_error); // NOLINT
+  EXPECT_MISUSE((void)result.error(), std::logic_error);
   // EXPECT_NO_THROW(auto val = result.value()); - Should not compile
 }
 
@@ -0,0 +1,108 @@
+#include "../result.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+auto read_file(bool fails) -> res::result<int, std::string> {
+  if (fails) { return res::err(std::string("file not found")); }
+  return res::ok(42);
+}
+
+auto load(bool fails) -> res::result<int, res::context_error<std::string>> {
+  return read_file(fails).context("reading settings.toml").context("loading config");
+}
+
+} // namespace
+
+TEST(Context, OkPassesThrough) {
+  const auto loaded = load(false);
+  ASSERT_TRUE(loaded);
+  EXPECT_EQ(loaded.value(), 42);
+}
+
+TEST(Context, ChainIsRenderedOutermostFirst) {
+  const auto loaded = load(true);
+  ASSERT_FALSE(loaded);
+  EXPECT_EQ(loaded.error().depth(), 2);
+  EXPECT_EQ(loaded.error().error(), "file not found");
+  EXPECT_EQ(loaded.error().message(), "loading config: reading settings.toml: file not found");
+}
+
+TEST(Context, TextIsCopied) {
+  res::result<int, res::context_error<std::string>> loaded = res::err(res::context_error<std::string>("boom"));
+  {
+    std::string text = "temporary text";
+    loaded = std::move(loaded).context(text);
+    text.assign(text.size(), 'x');
+  }
+  EXPECT_EQ(loaded.error().message(), "temporary text: boom");
+}
+
+TEST(Context, LazyContextOnlyRunsWhenRendered) {
+  int calls = 0;
+  const auto loaded = read_file(true).with_context([&calls] {
+    ++calls;
+    return std::string("user 7");
+  });
+  EXPECT_EQ(calls, 0);
+  EXPECT_EQ(loaded.error().message(), "user 7: file not found");
+  EXPECT_EQ(calls, 1);
+
+  const auto succeeded = read_file(false).with_context([&calls] { return ++calls; });
+  EXPECT_TRUE(succeeded);
+  EXPECT_EQ(calls, 1);
+}
+
+TEST(Context, LazyContextCapturesAreDestroyed) {
+  auto tracked = std::make_shared<int>(3);
+  {
+    const auto loaded = read_file(true).with_context([tracked] { return *tracked; });
+    EXPECT_EQ(tracked.use_count(), 2);
+    EXPECT_EQ(loaded.error().message(), "3: file not found");
+  }
+  EXPECT_EQ(tracked.use_count(), 1);
+}
+
+TEST(Context, CopiesShareTheChain) {
+  const auto original = load(true);
+  auto copy = original;
+  auto extended = std::move(copy).context("starting up");
+  EXPECT_EQ(original.error().message(), "loading config: reading settings.toml: file not found");
+  EXPECT_EQ(extended.error().message(), "starting up: loading config: reading settings.toml: file not found");
+}
+
+TEST(Context, VoidResult) {
+  const res::result<void, int> failed = res::err(5);
+  EXPECT_EQ(failed.context("flushing").error().message(), "flushing: 5");
+}
+
+TEST(Context, WorksWithErrorCodes) {
+  constexpr res::error_descriptor timeout{"net", "timed out after {} ms"};
+  const res::result<int, res::formatted_error> failed = res::err(timeout(250));
+  std::ostringstream stream;
+  stream << failed.context("fetching /index").error();
+  EXPECT_EQ(stream.str(), "fetching /index: net: timed out after 250 ms");
+}
+
+TEST(Context, ArenaSurvivesManyErrors) {
+  std::vector<res::result<int, res::context_error<std::string>>> kept;
+  for (int index = 0; index < 10000; ++index) {
+    auto loaded = load(true).context(std::string(static_cast<std::size_t>(index % 2000), 'c'));
+    if (index % 100 == 0) { kept.push_back(std::move(loaded)); }
+  }
+  EXPECT_EQ(kept.size(), 100);
+  EXPECT_EQ(kept.back().error().depth(), 3);
+  EXPECT_EQ(kept.back().error().message().size(), 1900 + 2 + load(true).error().message().size());
+}
+
+TEST(Context, ErrorsCanDieOnAnotherThread) {
+  std::vector<res::result<int, res::context_error<std::string>>> errors;
+  for (int index = 0; index < 1000; ++index) { errors.push_back(load(true)); }
+  std::thread([moved = std::move(errors)]() mutable { moved.clear(); }).join();
+  EXPECT_EQ(load(true).error().depth(), 2);
+}
@@ -0,0 +1,88 @@
+#include "../../result_coro.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+auto parse(const std::string &text) -> res::result<int, std::string> {
+  if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) { return res::err("bad: " + text); }
+  return res::ok(std::stoi(text));
+}
+
+auto sum(const std::string &lhs, const std::string &rhs) -> res::result<int, std::string> {
+  const int left = co_await parse(lhs);
+  const int right = co_await parse(rhs);
+  co_return res::ok(left + right);
+}
+
+auto check(int value) -> res::result<void, std::string> {
+  if (value < 0) { co_return res::err(std::string("negative")); }
+  co_return res::ok();
+}
+
+} // namespace
+
+TEST(Coro, Ok) {
+  const auto result = sum("40", "2");
+  ASSERT_TRUE(result);
+  EXPECT_EQ(result.value(), 42);
+}
+
+TEST(Coro, PropagatesFirstError) {
+  const auto result = sum("x", "y");
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error(), "bad: x");
+}
+
+TEST(Coro, StopsAtError) {
+  int reached = 0;
+  auto coroutine = [&reached](const std::string &text) -> res::result<int, std::string> {
+    const int value = co_await parse(text);
+    ++reached;
+    co_return res::ok(value);
+  };
+  EXPECT_FALSE(coroutine("x"));
+  EXPECT_EQ(reached, 0);
+  EXPECT_TRUE(coroutine("1"));
+  EXPECT_EQ(reached, 1);
+}
+
+TEST(Coro, Void) {
+  auto coroutine = [](int value) -> res::result<int, std::string> {
+    co_await check(value);
+    co_return res::ok(value * 2);
+  };
+  EXPECT_EQ(coroutine(21).value(), 42);
+  EXPECT_EQ(coroutine(-1).error(), "negative");
+}
+
+TEST(Coro, AwaitsLvalues) {
+  auto coroutine = [](const res::result<std::string, std::string> &source) -> res::result<std::size_t, std::string> {
+    const std::string &value = co_await source;
+    co_return res::ok(value.size());
+  };
+  const res::result<std::string, std::string> source = res::ok(std::string("value"));
+  EXPECT_EQ(coroutine(source).value(), 5);
+  EXPECT_EQ(source.value(), "value");
+}
+
+TEST(Coro, MovesFromRvalues) {
+  auto coroutine = []() -> res::result<int, std::string> {
+    auto owned = co_await res::result<int, std::string>(res::ok(42)).map([](int val) {
+      return std::make_unique<int>(val);
+    });
+    co_return res::ok(*owned);
+  };
+  EXPECT_EQ(coroutine().value(), 42);
+}
+
+TEST(Coro, Exceptions) {
+  auto coroutine = []() -> res::result<int, std::string> {
+    const int value = co_await parse("1");
+    if (value == 1) { throw std::runtime_error("boom"); }
+    co_return res::ok(value);
+  };
+  EXPECT_THROW(auto result = coroutine(), std::runtime_error); // NOLINT
+}
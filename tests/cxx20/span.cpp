@@ -0,0 +1,43 @@
+#include "../../result.h"
+#include <array>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <span>
+#include <type_traits>
+
+namespace {
+
+enum class parse_errc : std::uint8_t { truncated };
+
+// Returns the payload of a length-prefixed frame as a view into the buffer.
+auto payload(std::span<const std::uint8_t> frame) -> res::result<std::span<const std::uint8_t>, parse_errc> {
+  if (frame.empty() || frame.size() < 1U + frame[0]) { return res::err(parse_errc::truncated); }
+  return res::ok(frame.subspan(1, frame[0]));
+}
+
+} // namespace
+
+static_assert(std::is_trivially_copyable_v<res::result<std::span<const std::uint8_t>, parse_errc>>);
+
+TEST(Span, ViewIntoTheBuffer) {
+  const std::array<std::uint8_t, 4> frame{2, 7, 9, 0};
+  auto result = payload(frame);
+  ASSERT_TRUE(result);
+  EXPECT_EQ(result.value().size(), 2U);
+  EXPECT_EQ(result.value().data(), frame.data() + 1);
+}
+
+TEST(Span, Error) {
+  const std::array<std::uint8_t, 2> frame{3, 1};
+  EXPECT_EQ(payload(frame).error(), parse_errc::truncated);
+}
+
+TEST(Span, MapOverTheView) {
+  const std::array<std::uint8_t, 4> frame{3, 1, 2, 3};
+  auto sum = payload(frame).map([](std::span<const std::uint8_t> bytes) {
+    int total = 0;
+    for (const auto byte : bytes) { total += byte; }
+    return total;
+  });
+  EXPECT_EQ(sum.value(), 6);
+}
@@ -0,0 +1,93 @@
+#include "../../result_coro.h"
+#include <coroutine>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace {
+
+auto fetch(int key) -> res::task<int, std::string> {
+  if (key < 0) { co_return res::err(std::string("missing")); }
+  co_return res::ok(key * 10);
+}
+
+auto fetch_pair(int first, int second) -> res::task<int, std::string> {
+  const int lhs = co_await fetch(first);
+  const int rhs = co_await fetch(second);
+  co_return res::ok(lhs + rhs);
+}
+
+// Resumes the awaiting coroutine on another thread.
+struct resume_on_new_thread {
+  static auto await_ready() noexcept -> bool { return false; }
+  static void await_suspend(std::coroutine_handle<> handle) { std::thread([handle] { handle.resume(); }).detach(); }
+  static void await_resume() noexcept {}
+};
+
+} // namespace
+
+TEST(Task, IsLazy) {
+  bool started = false;
+  auto work = [&started]() -> res::task<int, std::string> {
+    started = true;
+    co_return res::ok(1);
+  };
+  auto pending = work();
+  EXPECT_FALSE(started);
+  EXPECT_EQ(res::sync_wait(std::move(pending)).value(), 1);
+  EXPECT_TRUE(started);
+}
+
+TEST(Task, AwaitsTasks) {
+  const auto result = res::sync_wait(fetch_pair(1, 2));
+  ASSERT_TRUE(result);
+  EXPECT_EQ(result.value(), 30);
+}
+
+TEST(Task, PropagatesErrorsThroughTasks) {
+  auto outer = []() -> res::task<int, std::string> {
+    const int value = co_await fetch_pair(1, -1);
+    ADD_FAILURE() << "unreachable with " << value;
+    co_return res::ok(value);
+  };
+  const auto result = res::sync_wait(outer());
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error(), "missing");
+}
+
+TEST(Task, AwaitsResults) {
+  auto work = [](res::result<int, std::string> source) -> res::task<int, std::string> {
+    const int value = co_await source;
+    co_return res::ok(value + 1);
+  };
+  EXPECT_EQ(res::sync_wait(work(res::ok(1))).value(), 2);
+  EXPECT_EQ(res::sync_wait(work(res::err(std::string("error")))).error(), "error");
+}
+
+TEST(Task, OtherAwaitables) {
+  auto work = []() -> res::task<std::thread::id, std::string> {
+    co_await resume_on_new_thread{};
+    co_return res::ok(std::this_thread::get_id());
+  };
+  const auto result = res::sync_wait(work());
+  ASSERT_TRUE(result);
+  EXPECT_NE(result.value(), std::this_thread::get_id());
+}
+
+TEST(Task, VoidTask) {
+  auto work = [](bool fail) -> res::task<void, int> {
+    if (fail) { co_return res::err(7); }
+    co_return res::ok();
+  };
+  EXPECT_TRUE(res::sync_wait(work(false)));
+  EXPECT_EQ(res::sync_wait(work(true)).error(), 7);
+}
+
+TEST(Task, Exceptions) {
+  auto work = []() -> res::task<int, std::string> {
+    co_await fetch(1);
+    throw std::runtime_error("boom");
+  };
+  EXPECT_THROW(auto result = res::sync_wait(work()), std::runtime_error); // NOLINT
+}
@@ -0,0 +1,97 @@
+#include "../result.h"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+namespace {
+
+constexpr res::error_descriptor cache_miss{"cache", "key {} not found in shard {}"};
+constexpr res::error_descriptor out_of_range{"validation", "{} is outside [{}, {}]"};
+constexpr res::error_descriptor disk_full{"io", "disk full"};
+
+auto lookup(int key) -> res::result<int, res::formatted_error> {
+  if (key < 0) { return res::err(cache_miss(key, "eu-1")); }
+  return res::ok(key * 2);
+}
+
+} // namespace
+
+static_assert(sizeof(res::error_code) == 8 || sizeof(void *) != 8);
+static_assert(std::is_trivially_copyable_v<res::error_code>);
+static_assert(std::is_trivially_copyable_v<res::formatted_error>);
+static_assert(std::is_trivially_copyable_v<res::result<int, res::error_code>>);
+
+// Strings that may not outlive the error are rejected instead of being captured as dangling views.
+static_assert(std::is_invocable_v<const res::error_descriptor &, const char (&)[3]>);
+static_assert(std::is_invocable_v<const res::error_descriptor &, res::interned_text>);
+static_assert(!std::is_invocable_v<const res::error_descriptor &, std::string>);
+static_assert(!std::is_invocable_v<const res::error_descriptor &, std::string_view>);
+static_assert(!std::is_invocable_v<const res::error_descriptor &, const char *>);
+// A non-const buffer, e.g. filled by snprintf on the stack, is not a literal.
+static_assert(!std::is_invocable_v<const res::error_descriptor &, char (&)[16]>);
+static_assert(!std::is_invocable_v<const res::error_descriptor &, char (&&)[16]>);
+static_assert(!std::is_constructible_v<res::formatted_error, res::error_code, char (&)[16]>);
+static_assert(!std::is_constructible_v<res::formatted_error, res::error_code, std::string>);
+
+TEST(ErrorCode, ComparesByDescriptor) {
+  const res::error_code code = disk_full;
+  EXPECT_EQ(code, disk_full);
+  EXPECT_NE(code, cache_miss);
+  EXPECT_EQ(code.category(), "io");
+  EXPECT_EQ(code.message(), "disk full");
+}
+
+TEST(ErrorCode, ConstexprHandle) {
+  constexpr res::error_code code = cache_miss;
+  static_assert(code == cache_miss);
+  static_assert(code.category() == "cache");
+}
+
+TEST(ErrorCode, FormatsOnInspection) {
+  const auto looked_up = lookup(-7);
+  ASSERT_FALSE(looked_up);
+  EXPECT_EQ(looked_up.error(), cache_miss);
+  EXPECT_EQ(looked_up.error().message(), "key -7 not found in shard eu-1");
+  EXPECT_EQ(lookup(4).value(), 8);
+}
+
+TEST(ErrorCode, ArgumentKinds) {
+  EXPECT_EQ(out_of_range(2.5, 0U, true).message(), "2.5 is outside [0, true]");
+  EXPECT_EQ(out_of_range("x", 'a', -1L).message(), "x is outside [97, -1]");
+}
+
+TEST(ErrorCode, InternedTextOutlivesItsSource) {
+  const res::formatted_error error = [] {
+    std::string key = "user:";
+    key += std::to_string(42);
+    return cache_miss(res::intern_text(key), 3);
+  }();
+  const std::string overwrite(64, '#');
+  EXPECT_EQ(error.message(), "key user:42 not found in shard 3");
+  EXPECT_EQ(res::intern_text("user:42").view().data(), res::intern_text(std::string("user:42")).view().data());
+}
+
+TEST(ErrorCode, MissingArgumentsAndBraces) {
+  constexpr res::error_descriptor braces{"misc", "{{literal}} {} {}"};
+  EXPECT_EQ(braces(1).message(), "{literal} 1 {}");
+  EXPECT_EQ(res::formatted_error(disk_full).message(), "disk full");
+}
+
+TEST(ErrorCode, Streams) {
+  std::ostringstream stream;
+  stream << cache_miss(1, "us") << "; " << res::error_code(disk_full);
+  EXPECT_EQ(stream.str(), "cache: key 1 not found in shard us; io: disk full");
+}
+
+TEST(ErrorCode, InternedCodesAreStable) {
+  std::string category = "config";
+  std::string format = "unknown option {}";
+  const res::error_code first = res::intern_error(category, format);
+  category.clear();
+  format.clear();
+  const res::error_code second = res::intern_error("config", "unknown option {}");
+  EXPECT_EQ(first, second);
+  EXPECT_NE(first, res::intern_error("config", "missing option {}"));
+  EXPECT_EQ(res::formatted_error(first, "verbose").message(), "unknown option verbose");
+}
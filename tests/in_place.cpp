@@ -0,0 +1,213 @@
+#include "../result.h"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+enum class io_errc : std::uint8_t { closed, timed_out };
+
+// Counts deep copies and moves of its payload.
+struct counted {
+  static int copies;
+  static int moves;
+  std::vector<int> data;
+
+  explicit counted(std::vector<int> data) : data(std::move(data)) {}
+  counted(std::size_t size, int value) : data(size, value) {}
+  counted(const counted &other) : data(other.data) { ++copies; }
+  counted(counted &&other) noexcept : data(std::move(other.data)) { ++moves; }
+  auto operator=(const counted &) -> counted & = delete;
+  auto operator=(counted &&) -> counted & = delete;
+  ~counted() = default;
+};
+
+int counted::copies = 0;
+int counted::moves = 0;
+
+// Can be neither copied nor moved, like types that hand out their own address.
+struct pinned {
+  std::mutex mutex;
+  int first;
+  int second;
+
+  pinned(int first, int second) noexcept : first(first), second(second) {}
+  pinned(const pinned &) = delete;
+  pinned(pinned &&) = delete;
+  auto operator=(const pinned &) -> pinned & = delete;
+  auto operator=(pinned &&) -> pinned & = delete;
+  ~pinned() = default;
+};
+
+#if RESULT_HAS_EXCEPTIONS
+// Throws from a constructor but moves without throwing.
+struct fragile {
+  std::string text;
+
+  explicit fragile(const std::string &text) : text(text) {
+    if (text.empty()) { throw std::invalid_argument("empty"); }
+  }
+};
+#endif
+
+auto open_handle(bool succeed) -> res::result<std::unique_ptr<int>, std::string> {
+  if (!succeed) { return res::err(std::string("no handle")); }
+  return res::ok(std::make_unique<int>(7));
+}
+
+auto make_pinned(bool succeed) -> res::result<pinned, std::string> {
+  if (!succeed) { return res::err_in_place<std::string>(3, 'x'); }
+  return res::ok_in_place<pinned>(1, 2);
+}
+
+} // namespace
+
+static_assert(!std::is_copy_constructible_v<res::result<pinned, std::string>>);
+static_assert(!std::is_move_constructible_v<res::result<pinned, std::string>>);
+
+TEST(InPlace, MoveOnlyOk) {
+  auto result = open_handle(true);
+  ASSERT_TRUE(result);
+  EXPECT_EQ(*result.value(), 7);
+  const std::unique_ptr<int> handle = std::move(result).value();
+  EXPECT_EQ(*handle, 7);
+}
+
+TEST(InPlace, MoveOnlyErr) {
+  res::result<int, std::unique_ptr<std::string>> result = res::err(std::make_unique<std::string>("boom"));
+  ASSERT_FALSE(result);
+  EXPECT_EQ(*result.error(), "boom");
+  EXPECT_EQ(open_handle(false).error(), "no handle");
+}
+
+TEST(InPlace, MoveOnlyNiche) {
+  res::result<std::unique_ptr<int>, io_errc> result = res::ok(std::make_unique<int>(3));
+  ASSERT_TRUE(result);
+  EXPECT_EQ(*result.value(), 3);
+  result = res::err(io_errc::timed_out);
+  EXPECT_EQ(result.error(), io_errc::timed_out);
+}
+
+TEST(InPlace, TemporaryOkAndErrMove) {
+  counted::copies = 0;
+  counted::moves = 0;
+  res::result<counted, counted> good = res::ok(counted(std::vector<int>{1, 2}));
+  res::result<counted, counted> bad = res::err(counted(std::vector<int>{3}));
+  res::result<void, counted> bad_void = res::err(counted(std::vector<int>{4}));
+  EXPECT_EQ(counted::copies, 0);
+  EXPECT_EQ(good.value().data, std::vector<int>({1, 2}));
+  EXPECT_EQ(bad.error().data, std::vector<int>({3}));
+  EXPECT_EQ(bad_void.error().data, std::vector<int>({4}));
+}
+
+TEST(InPlace, NamedOkCopies) {
+  counted::copies = 0;
+  const auto value = res::ok(counted(std::vector<int>{1}));
+  res::result<counted, int> first = value;
+  res::result<counted, int> second = value;
+  EXPECT_EQ(counted::copies, 2);
+  EXPECT_EQ(first.value().data, second.value().data);
+}
+
+TEST(InPlace, OkInPlaceNeitherCopiesNorMoves) {
+  counted::copies = 0;
+  counted::moves = 0;
+  res::result<counted, std::string> result = res::ok_in_place<counted>(std::size_t{3}, 9);
+  EXPECT_EQ(counted::copies, 0);
+  EXPECT_EQ(counted::moves, 0);
+  EXPECT_EQ(result.value().data, std::vector<int>({9, 9, 9}));
+}
+
+TEST(InPlace, ErrInPlaceNeitherCopiesNorMoves) {
+  counted::copies = 0;
+  counted::moves = 0;
+  res::result<int, counted> result = res::err_in_place<counted>(std::size_t{2}, 5);
+  res::result<void, counted> void_result = res::err_in_place<counted>(std::size_t{1}, 6);
+  EXPECT_EQ(counted::copies, 0);
+  EXPECT_EQ(counted::moves, 0);
+  EXPECT_EQ(result.error().data, std::vector<int>({5, 5}));
+  EXPECT_EQ(void_result.error().data, std::vector<int>({6}));
+}
+
+TEST(InPlace, InPlaceForwardsLvalues) {
+  std::vector<int> source{1, 2, 3};
+  res::result<std::vector<int>, int> copied = res::ok_in_place<std::vector<int>>(source);
+  EXPECT_EQ(source.size(), 3U);
+  res::result<std::vector<int>, int> moved = res::ok_in_place<std::vector<int>>(std::move(source));
+  EXPECT_EQ(copied.value(), moved.value());
+}
+
+TEST(InPlace, NonMovablePayload) {
+  const auto good = make_pinned(true);
+  ASSERT_TRUE(good);
+  EXPECT_EQ(good.value().first, 1);
+  EXPECT_EQ(good.value().second, 2);
+
+  const auto bad = make_pinned(false);
+  ASSERT_FALSE(bad);
+  EXPECT_EQ(bad.error(), "xxx");
+}
+
+TEST(InPlace, EmplaceSwitchesAlternative) {
+  res::result<std::string, std::vector<int>> result = res::err(std::vector<int>{1});
+  std::string &value = result.emplace(2, 'a');
+  EXPECT_EQ(value, "aa");
+  EXPECT_EQ(result.value(), "aa");
+  result.emplace("replaced");
+  EXPECT_EQ(result.value(), "replaced");
+  result.emplace_error(std::size_t{2}, 4);
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error(), std::vector<int>({4, 4}));
+}
+
+TEST(InPlace, EmplaceTrivial) {
+  res::result<int, double> result = res::ok(1);
+  result.emplace_error(2.5);
+  EXPECT_EQ(result.error(), 2.5);
+  EXPECT_EQ(result.emplace(3), 3);
+  EXPECT_EQ(result.value(), 3);
+}
+
+TEST(InPlace, EmplaceNonMovable) {
+  res::result<pinned, std::string> result = res::err(std::string("unset"));
+  pinned &value = result.emplace(3, 4);
+  const std::lock_guard<std::mutex> lock(value.mutex);
+  EXPECT_EQ(result.value().first, 3);
+  EXPECT_EQ(result.value().second, 4);
+}
+
+TEST(InPlace, EmplaceNiche) {
+  res::result<std::unique_ptr<int>, io_errc> result = res::err(io_errc::closed);
+  result.emplace(new int(5)); // NOLINT(cppcoreguidelines-owning-memory)
+  EXPECT_EQ(*result.value(), 5);
+  result.emplace_error(io_errc::timed_out);
+  EXPECT_EQ(result.error(), io_errc::timed_out);
+  result.emplace(std::make_unique<int>(6));
+  EXPECT_EQ(*result.value(), 6);
+}
+
+TEST(InPlace, EmplaceVoid) {
+  res::result<void, std::string> result = res::ok();
+  result.emplace_error(2, '!');
+  EXPECT_EQ(result.error(), "!!");
+  result.emplace();
+  EXPECT_TRUE(result);
+}
+
+#if RESULT_HAS_EXCEPTIONS
+TEST(InPlace, ThrowingEmplaceKeepsContents) {
+  res::result<fragile, std::string> result = res::err(std::string("kept"));
+  EXPECT_THROW(result.emplace(std::string()), std::invalid_argument);
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error(), "kept");
+
+  result.emplace(std::string("set"));
+  EXPECT_THROW(result.emplace(std::string()), std::invalid_argument);
+  EXPECT_EQ(result.value().text, "set");
+}
+#endif
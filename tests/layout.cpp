@@ -0,0 +1,64 @@
+#include "../result.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+// Layout is part of the contract: small results must stay trivially copyable so the ABI returns them in registers.
+template <typename R> constexpr bool is_register_friendly_v =
+    std::is_trivially_copyable_v<R> && std::is_trivially_destructible_v<R>;
+
+static_assert(sizeof(res::result<int, int>) == 8);
+static_assert(alignof(res::result<int, int>) == alignof(int));
+static_assert(is_register_friendly_v<res::result<int, int>>);
+
+static_assert(sizeof(res::result<int, std::errc>) == 8);
+static_assert(is_register_friendly_v<res::result<int, std::errc>>);
+
+static_assert(sizeof(res::result<char, char>) == 2);
+static_assert(is_register_friendly_v<res::result<char, char>>);
+
+static_assert(sizeof(res::result<double, int>) == 16);
+static_assert(alignof(res::result<double, int>) == alignof(double));
+static_assert(is_register_friendly_v<res::result<double, int>>);
+
+static_assert(sizeof(res::result<void, int>) == 8);
+static_assert(sizeof(res::result<void, std::errc>) == 8);
+static_assert(is_register_friendly_v<res::result<void, std::errc>>);
+
+static_assert(!std::is_trivially_copyable_v<res::result<std::string, int>>);
+static_assert(std::is_copy_constructible_v<res::result<std::string, int>>);
+static_assert(std::is_nothrow_move_constructible_v<res::result<std::string, int>>);
+
+static_assert(!std::is_copy_constructible_v<res::result<std::unique_ptr<int>, std::string>>);
+static_assert(!std::is_copy_assignable_v<res::result<std::unique_ptr<int>, std::string>>);
+static_assert(std::is_move_constructible_v<res::result<std::unique_ptr<int>, std::string>>);
+static_assert(std::is_move_assignable_v<res::result<std::unique_ptr<int>, std::string>>);
+
+TEST(Layout, CopyKeepsState) {
+  res::result<int, int> result = res::err(42);
+  const auto copy = result;
+  EXPECT_FALSE(copy);
+  EXPECT_EQ(copy.error(), 42);
+}
+
+TEST(Layout, AssignAcrossStates) {
+  res::result<std::string, int> result = res::ok(std::string("value"));
+  const res::result<std::string, int> error = res::err(42);
+  result = error;
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error(), 42);
+  result = res::ok(std::string("again"));
+  ASSERT_TRUE(result);
+  EXPECT_EQ(result.value(), "again");
+}
+
+TEST(Layout, VoidAssignAcrossStates) {
+  res::result<void, std::string> result = res::ok();
+  result = res::err(std::string("error"));
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error(), "error");
+  result = res::ok();
+  EXPECT_TRUE(result);
+}
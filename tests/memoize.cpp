@@ -0,0 +1,190 @@
+#include "../result_concurrency.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+enum class lookup_errc { missing, rejected };
+
+// A clock the tests move by hand.
+struct test_clock {
+  using duration = std::chrono::nanoseconds;
+  using rep = duration::rep;
+  using period = duration::period;
+  using time_point = std::chrono::time_point<test_clock>;
+  static constexpr bool is_steady = true;
+
+  static inline duration elapsed{0};
+  static auto now() noexcept -> time_point { return time_point(elapsed); }
+};
+
+class Memoize : public ::testing::Test {
+protected:
+  void SetUp() override { test_clock::elapsed = {}; }
+};
+
+} // namespace
+
+TEST_F(Memoize, CachesValuesAndErrors) {
+  int calls = 0;
+  auto lookup = res::memoize([&](int key) -> res::result<std::string, lookup_errc> {
+    ++calls;
+    if (key < 0) { return res::err(lookup_errc::missing); }
+    return res::ok(std::to_string(key));
+  });
+  EXPECT_EQ(lookup(4).value(), "4");
+  EXPECT_EQ(lookup(4).value(), "4");
+  EXPECT_EQ(lookup(-1).error(), lookup_errc::missing);
+  EXPECT_EQ(lookup(-1).error(), lookup_errc::missing);
+  EXPECT_EQ(calls, 2);
+
+  const auto stats = lookup.stats();
+  EXPECT_EQ(stats.ok_hits, 1U);
+  EXPECT_EQ(stats.err_hits, 1U);
+  EXPECT_EQ(stats.misses, 2U);
+  EXPECT_EQ(lookup.size(), 2U);
+}
+
+TEST_F(Memoize, SeparateTimeToLive) {
+  int calls = 0;
+  res::memoize_policy policy;
+  policy.ok_ttl = std::chrono::seconds(10);
+  policy.err_ttl = std::chrono::seconds(1);
+  auto lookup = res::memoize<test_clock>(
+      [&](int key) -> res::result<int, lookup_errc> {
+        ++calls;
+        if (key < 0) { return res::err(lookup_errc::rejected); }
+        return res::ok(key);
+      },
+      policy);
+  static_cast<void>(lookup(1));
+  static_cast<void>(lookup(-1));
+  test_clock::elapsed = std::chrono::seconds(2);
+  static_cast<void>(lookup(1));
+  static_cast<void>(lookup(-1));
+  EXPECT_EQ(calls, 3);
+  test_clock::elapsed = std::chrono::seconds(11);
+  static_cast<void>(lookup(1));
+  EXPECT_EQ(calls, 4);
+}
+
+TEST_F(Memoize, SeparateCapacities) {
+  int calls = 0;
+  res::memoize_policy policy;
+  policy.shards = 1;
+  policy.ok_capacity = 2;
+  policy.err_capacity = 0;
+  auto lookup = res::memoize(
+      [&](int key) -> res::result<int, lookup_errc> {
+        ++calls;
+        if (key < 0) { return res::err(lookup_errc::missing); }
+        return res::ok(key);
+      },
+      policy);
+  static_cast<void>(lookup(1));
+  static_cast<void>(lookup(2));
+  static_cast<void>(lookup(1)); // 2 is now the least recently used
+  static_cast<void>(lookup(3));
+  EXPECT_EQ(calls, 3);
+  static_cast<void>(lookup(1));
+  EXPECT_EQ(calls, 3);
+  static_cast<void>(lookup(2));
+  EXPECT_EQ(calls, 4);
+
+  static_cast<void>(lookup(-1));
+  static_cast<void>(lookup(-1));
+  EXPECT_EQ(calls, 6);
+  EXPECT_EQ(lookup.size(), 2U);
+}
+
+TEST_F(Memoize, CapacitiesAreTotalsOverShards) {
+  res::memoize_policy policy;
+  policy.shards = 4;
+  policy.ok_capacity = 5;
+  policy.err_capacity = 2;
+  auto lookup = res::memoize(
+      [](int key) -> res::result<int, lookup_errc> {
+        if (key < 0) { return res::err(lookup_errc::missing); }
+        return res::ok(key);
+      },
+      policy);
+  for (int key = 1; key <= 100; ++key) {
+    static_cast<void>(lookup(key));
+    static_cast<void>(lookup(-key));
+  }
+  EXPECT_EQ(lookup.size(), 7U);
+}
+
+TEST_F(Memoize, MutableFunctionObject) {
+  const auto lookup = res::memoize([calls = 0](int key) mutable -> res::result<int, lookup_errc> {
+    ++calls;
+    return res::ok(key * 10 + calls);
+  });
+  EXPECT_EQ(lookup(1).value(), 11);
+  EXPECT_EQ(lookup(2).value(), 22);
+  EXPECT_EQ(lookup(1).value(), 11);
+}
+
+TEST_F(Memoize, SeveralArgumentsAndFunctionPointers) {
+  auto join = res::memoize([](const std::string &lhs, int rhs) -> res::result<std::string, lookup_errc> {
+    return res::ok(lhs + std::to_string(rhs));
+  });
+  EXPECT_EQ(join("a", 1).value(), "a1");
+  EXPECT_EQ(join(std::string("a"), 1).value(), "a1");
+  EXPECT_EQ(join.stats().ok_hits, 1U);
+
+  auto checked = res::memoize(+[](int key) -> res::result<void, lookup_errc> {
+    if (key == 0) { return res::err(lookup_errc::missing); }
+    return res::ok();
+  });
+  EXPECT_TRUE(checked(1));
+  EXPECT_FALSE(checked(0));
+}
+
+TEST_F(Memoize, ConcurrentMissesComputeOnce) {
+  std::atomic<int> calls{0};
+  std::mutex mutex;
+  std::condition_variable released;
+  bool release = false;
+  auto lookup = res::memoize([&](int key) -> res::result<int, lookup_errc> {
+    ++calls;
+    std::unique_lock<std::mutex> lock(mutex);
+    released.wait(lock, [&] { return release; });
+    return res::ok(key * 2);
+  });
+
+  std::vector<std::thread> threads;
+  std::atomic<int> sum{0};
+  for (int index = 0; index < 4; ++index) {
+    threads.emplace_back([&] { sum += lookup(21).value(); });
+  }
+  while (lookup.stats().coalesced < 3) { std::this_thread::yield(); }
+  {
+    const std::lock_guard<std::mutex> lock(mutex);
+    release = true;
+  }
+  released.notify_all();
+  for (auto &thread : threads) { thread.join(); }
+  EXPECT_EQ(calls.load(), 1);
+  EXPECT_EQ(sum.load(), 4 * 42);
+  EXPECT_EQ(lookup.stats().misses, 1U);
+}
+
+#if RESULT_HAS_EXCEPTIONS
+TEST_F(Memoize, ThrowingCallIsNotCached) {
+  int calls = 0;
+  auto lookup = res::memoize([&](int key) -> res::result<int, lookup_errc> {
+    if (++calls == 1) { throw std::runtime_error("flaky"); }
+    return res::ok(key);
+  });
+  EXPECT_THROW(static_cast<void>(lookup(1)), std::runtime_error);
+  EXPECT_EQ(lookup(1).value(), 1);
+  EXPECT_EQ(calls, 2);
+}
+#endif
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+// Misuse throws when the suite is built with exceptions and aborts through the misuse handler without them, so tests
+// of misuse expect whichever of the two the build does.
+#if RESULT_HAS_EXCEPTIONS
+#define EXPECT_MISUSE(statement, exception) EXPECT_THROW(statement, exception)
+#else
+#define EXPECT_MISUSE(statement, exception) EXPECT_DEATH(statement, "")
+#endif
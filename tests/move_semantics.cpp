@@ -0,0 +1,90 @@
+#include "../result.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Heap-owning payload that counts how many times it was deep-copied.
+struct tracked {
+  static int copies;
+  std::vector<int> data;
+
+  explicit tracked(std::vector<int> data) : data(std::move(data)) {}
+  tracked(const tracked &other) : data(other.data) { ++copies; }
+  tracked(tracked &&other) noexcept = default;
+  auto operator=(const tracked &other) -> tracked & {
+    data = other.data;
+    ++copies;
+    return *this;
+  }
+  auto operator=(tracked &&other) noexcept -> tracked & = default;
+  ~tracked() = default;
+};
+
+int tracked::copies = 0;
+
+auto push(int value) {
+  return [value](tracked payload) -> tracked {
+    payload.data.push_back(value);
+    return payload;
+  };
+}
+
+} // namespace
+
+TEST(MoveSemantics, OkChainDoesNotCopy) {
+  res::result<tracked, tracked> result = res::ok(tracked({1}));
+  tracked::copies = 0;
+  auto chained = std::move(result)
+                     .map(push(2))
+                     .map(push(3))
+                     .map_err(push(-1))
+                     .map(push(4))
+                     .map(push(5));
+  EXPECT_EQ(tracked::copies, 0);
+  ASSERT_TRUE(chained);
+  EXPECT_EQ(std::move(chained).value().data, std::vector<int>({1, 2, 3, 4, 5}));
+  EXPECT_EQ(tracked::copies, 0);
+}
+
+TEST(MoveSemantics, ErrChainDoesNotCopy) {
+  res::result<tracked, tracked> result = res::err(tracked({1}));
+  tracked::copies = 0;
+  auto chained = std::move(result)
+                     .map(push(2))
+                     .map_err(push(-1))
+                     .map(push(3))
+                     .map_err(push(-2))
+                     .map(push(4));
+  EXPECT_EQ(tracked::copies, 0);
+  ASSERT_FALSE(chained);
+  EXPECT_EQ(std::move(chained).error().data, std::vector<int>({1, -1, -2}));
+  EXPECT_EQ(tracked::copies, 0);
+}
+
+TEST(MoveSemantics, VoidChainDoesNotCopy) {
+  res::result<void, tracked> result = res::err(tracked({1}));
+  tracked::copies = 0;
+  auto chained = std::move(result).map_err(push(2)).map([]() -> int { return 0; }).map_err(push(3));
+  EXPECT_EQ(tracked::copies, 0);
+  ASSERT_FALSE(chained);
+  EXPECT_EQ(std::move(chained).error().data, std::vector<int>({1, 2, 3}));
+}
+
+TEST(MoveSemantics, LvalueChainCopiesOnce) {
+  res::result<tracked, std::string> result = res::ok(tracked({1}));
+  tracked::copies = 0;
+  auto mapped = result.map(push(2));
+  EXPECT_EQ(tracked::copies, 1);
+  EXPECT_EQ(result.value().data, std::vector<int>({1}));
+  EXPECT_EQ(mapped.value().data, std::vector<int>({1, 2}));
+}
+
+TEST(MoveSemantics, ValueOrMovesOut) {
+  res::result<tracked, std::string> result = res::ok(tracked({1, 2}));
+  tracked::copies = 0;
+  const tracked value = std::move(result).value_or(tracked({}));
+  EXPECT_EQ(tracked::copies, 0);
+  EXPECT_EQ(value.data, std::vector<int>({1, 2}));
+}
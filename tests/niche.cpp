@@ -0,0 +1,147 @@
+#include "../result.h"
+#include "misuse.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+namespace {
+
+enum class lookup_errc : std::uint8_t { not_found, expired, invalid };
+enum class plain_errc : std::uint8_t { not_found, expired };
+enum class status_errc : std::uint8_t { none, not_found, expired };
+
+struct incomplete;
+
+// A 4-byte handle whose valid ids are even, leaving the low bit spare.
+struct handle {
+  std::uint32_t id = 0;
+};
+
+} // namespace
+
+template <> struct res::niche_traits<handle> {
+  static constexpr unsigned spare_bits = 1;
+  static auto to_bits(const handle &value) noexcept -> std::uintptr_t { return value.id; }
+  static void store_bits(handle &value, std::uintptr_t bits) noexcept { value.id = static_cast<std::uint32_t>(bits); }
+};
+
+template <> struct res::niche_traits<status_errc> {
+  static constexpr auto sentinel() noexcept -> status_errc { return status_errc::none; }
+};
+
+static_assert(sizeof(res::result<int *, lookup_errc>) == sizeof(int *));
+static_assert(sizeof(res::result<const double *, int>) == sizeof(double *));
+static_assert(sizeof(res::result<std::unique_ptr<int>, plain_errc>) == sizeof(int *));
+static_assert(sizeof(res::result<void, status_errc>) == sizeof(status_errc));
+static_assert(std::is_trivially_copyable_v<res::result<int *, lookup_errc>>);
+static_assert(std::is_trivially_copyable_v<res::result<void, status_errc>>);
+
+// Types without a niche keep the tagged union layout.
+static_assert(sizeof(res::result<char *, lookup_errc>) == 2 * sizeof(char *));
+static_assert(sizeof(res::result<int *, std::string>) == sizeof(std::string) + alignof(std::string));
+static_assert(sizeof(res::result<void, plain_errc>) == 2);
+// Errors are only packed when they leave the spare bit free inside T, not merely inside a std::uintptr_t.
+static_assert(sizeof(res::result<handle, std::uint16_t>) == sizeof(handle));
+static_assert(sizeof(res::result<handle, std::uint32_t>) == 2 * sizeof(handle));
+// Sentinels are opt-in, so an enumerator named invalid is still an ordinary error.
+static_assert(sizeof(res::result<void, lookup_errc>) == 2);
+static_assert(sizeof(res::result<incomplete *, int>) == 2 * sizeof(incomplete *));
+
+TEST(Niche, PointerOk) {
+  int value = 42;
+  res::result<int *, lookup_errc> result = res::ok(&value);
+  ASSERT_TRUE(result);
+  EXPECT_EQ(result.value(), &value);
+  EXPECT_MISUSE((void)result.error(), std::logic_error);
+}
+
+TEST(Niche, PointerErr) {
+  res::result<int *, lookup_errc> result = res::err(lookup_errc::expired);
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error(), lookup_errc::expired);
+  EXPECT_MISUSE((void)result.value(), std::logic_error);
+}
+
+TEST(Niche, PointerNullIsOk) {
+  res::result<int *, int> result = res::ok(static_cast<int *>(nullptr));
+  ASSERT_TRUE(result);
+  EXPECT_EQ(result.value(), nullptr);
+}
+
+TEST(Niche, NegativeErrorRoundTrips) {
+  res::result<int *, int> result = res::err(-42);
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error(), -42);
+}
+
+TEST(Niche, PointerMap) {
+  int value = 42;
+  res::result<int *, lookup_errc> result = res::ok(&value);
+  auto mapped = result.map([](int *ptr) -> int { return *ptr; });
+  ASSERT_TRUE(mapped);
+  EXPECT_EQ(mapped.value(), 42);
+
+  res::result<int *, lookup_errc> error = res::err(lookup_errc::not_found);
+  auto mapped_err = error.map_err([](lookup_errc errc) -> int { return static_cast<int>(errc) + 1; });
+  ASSERT_FALSE(mapped_err);
+  EXPECT_EQ(mapped_err.error(), 1);
+}
+
+TEST(Niche, UserHandleKeepsWideErrors) {
+  res::result<handle, std::uint32_t> wide = res::err(std::uint32_t{0xFFFFFFFF});
+  ASSERT_FALSE(wide);
+  EXPECT_EQ(wide.error(), 0xFFFFFFFFU);
+  wide = res::ok(handle{8});
+  ASSERT_TRUE(wide);
+  EXPECT_EQ(wide.value().id, 8U);
+
+  const res::result<handle, std::uint16_t> packed = res::err(std::uint16_t{0xFFFF});
+  ASSERT_FALSE(packed);
+  EXPECT_EQ(packed.error(), 0xFFFFU);
+}
+
+TEST(Niche, SentinelVoid) {
+  res::result<void, status_errc> result = res::ok();
+  EXPECT_TRUE(result);
+  result = res::err(status_errc::not_found);
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error(), status_errc::not_found);
+  result.emplace();
+  EXPECT_TRUE(result);
+}
+
+TEST(Niche, InvalidEnumeratorIsAnError) {
+  const res::result<void, lookup_errc> result = res::err(lookup_errc::invalid);
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error(), lookup_errc::invalid);
+}
+
+TEST(Niche, SentinelErrorIsMisuse) {
+  using status_result = res::result<void, status_errc>;
+  EXPECT_DEATH((void)status_result(res::err(status_errc::none)), "niche sentinel");
+  status_result result = res::ok();
+  EXPECT_DEATH(result.emplace_error(status_errc::none), "niche sentinel");
+}
+
+TEST(Niche, UniquePtrOwnership) {
+  const res::result<int, plain_errc> source = res::ok(42);
+  auto owned = source.map([](int val) { return std::make_unique<int>(val); });
+  ASSERT_TRUE(owned);
+  EXPECT_EQ(*owned.value(), 42);
+
+  auto moved = std::move(owned);
+  ASSERT_TRUE(moved);
+  EXPECT_EQ(*moved.value(), 42);
+
+  const res::result<int, plain_errc> failed = res::err(plain_errc::expired);
+  moved = failed.map([](int val) { return std::make_unique<int>(val); });
+  ASSERT_FALSE(moved);
+  EXPECT_EQ(moved.error(), plain_errc::expired);
+
+  auto moved_err = std::move(moved);
+  ASSERT_FALSE(moved_err);
+  EXPECT_EQ(moved_err.error(), plain_errc::expired);
+  EXPECT_FALSE(moved);
+}
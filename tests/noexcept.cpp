@@ -0,0 +1,68 @@
+#include "../result.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Counts copies; its move constructor is noexcept only when Nothrow is.
+template <bool Nothrow> struct payload {
+  static int copies;
+  std::string text;
+
+  explicit payload(std::string text) : text(std::move(text)) {}
+  payload(const payload &other) : text(other.text) { ++copies; }
+  payload(payload &&other) noexcept(Nothrow) : text(std::move(other.text)) {}
+  auto operator=(const payload &) -> payload & = default;
+  auto operator=(payload &&) noexcept(Nothrow) -> payload & = default;
+  ~payload() = default;
+};
+
+template <bool Nothrow> int payload<Nothrow>::copies = 0;
+
+using nothrow_result = res::result<payload<true>, std::string>;
+using throwing_result = res::result<payload<false>, std::string>;
+
+} // namespace
+
+// Special members follow the payload, so containers move results when they reallocate.
+static_assert(std::is_nothrow_move_constructible_v<nothrow_result>);
+static_assert(std::is_nothrow_move_assignable_v<nothrow_result>);
+static_assert(!std::is_nothrow_move_constructible_v<throwing_result>);
+static_assert(std::is_nothrow_move_constructible_v<res::result<void, std::string>>);
+static_assert(std::is_nothrow_move_constructible_v<res::result<std::unique_ptr<int>, int>>);
+
+// Construction through ok and err.
+static_assert(std::is_nothrow_constructible_v<res::ok<std::string>, std::string>);
+static_assert(noexcept(static_cast<res::result<std::string, int>>(std::declval<res::ok<std::string>>())));
+static_assert(!noexcept(static_cast<res::result<std::string, int>>(std::declval<const res::ok<std::string> &>())));
+static_assert(noexcept(static_cast<res::result<int, std::string>>(std::declval<res::err<std::string>>())));
+static_assert(noexcept(static_cast<res::result<void, int>>(std::declval<res::err<int>>())));
+static_assert(noexcept(static_cast<res::result<void, std::string>>(std::declval<res::ok<>>())));
+
+// Observers and value_or.
+static_assert(noexcept(std::declval<const throwing_result &>().is_ok()));
+static_assert(noexcept(static_cast<bool>(std::declval<const throwing_result &>())));
+static_assert(noexcept(std::declval<nothrow_result>().value_or(std::declval<payload<true>>())));
+static_assert(!noexcept(std::declval<throwing_result>().value_or(std::declval<payload<false>>())));
+static_assert(noexcept(std::declval<res::result<int, int> &>().emplace(1)));
+static_assert(!noexcept(std::declval<res::result<std::string, int> &>().emplace("text")));
+
+TEST(Noexcept, VectorGrowthMovesResults) {
+  std::vector<nothrow_result> results;
+  payload<true>::copies = 0;
+  for (int index = 0; index < 100; ++index) { results.push_back(res::ok(payload<true>(std::to_string(index)))); }
+  EXPECT_EQ(payload<true>::copies, 0);
+  EXPECT_EQ(results[42].value().text, "42");
+}
+
+TEST(Noexcept, VectorGrowthCopiesThrowingMoves) {
+  std::vector<throwing_result> results;
+  payload<false>::copies = 0;
+  for (int index = 0; index < 100; ++index) { results.push_back(res::ok(payload<false>(std::to_string(index)))); }
+  EXPECT_GT(payload<false>::copies, 0);
+  EXPECT_EQ(results[42].value().text, "42");
+}
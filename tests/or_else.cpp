@@ -0,0 +1,49 @@
+#include "../result.h"
+#include <gtest/gtest.h>
+#include <string>
+
+TEST(OrElse, ErrRecovered) {
+  res::result<int, std::string> result = res::err(std::string("error"));
+  auto recovered = result.or_else([](const std::string &) -> res::result<int, std::string> { return res::ok(0); });
+  EXPECT_TRUE(recovered);
+  EXPECT_EQ(recovered.value(), 0);
+}
+
+TEST(OrElse, ErrReplaced) {
+  res::result<int, std::string> result = res::err(std::string("error"));
+  auto replaced =
+      result.or_else([](const std::string &val) -> res::result<int, std::size_t> { return res::err(val.size()); });
+  EXPECT_FALSE(replaced);
+  EXPECT_EQ(replaced.error(), 5);
+}
+
+TEST(OrElse, OkSkipsFunctor) {
+  res::result<int, std::string> result = res::ok(42);
+  bool called = false;
+  auto recovered = result.or_else([&called](const std::string &) -> res::result<int, std::string> {
+    called = true;
+    return res::ok(0);
+  });
+  EXPECT_FALSE(called);
+  EXPECT_TRUE(recovered);
+  EXPECT_EQ(recovered.value(), 42);
+}
+
+TEST(OrElse, Rvalue) {
+  auto recovered = res::result<int, std::string>(res::err(std::string("error")))
+                       .or_else([](std::string &&val) -> res::result<int, std::string> { return res::err(val + "!"); });
+  EXPECT_FALSE(recovered);
+  EXPECT_EQ(recovered.error(), "error!");
+}
+
+TEST(OrElse, ErrVoid) {
+  res::result<void, std::string> result = res::err(std::string("error"));
+  auto recovered = result.or_else([](const std::string &) -> res::result<void, int> { return res::ok(); });
+  EXPECT_TRUE(recovered);
+}
+
+TEST(OrElse, OkVoid) {
+  res::result<void, std::string> result = res::ok();
+  auto recovered = result.or_else([](const std::string &) -> res::result<void, int> { return res::err(1); });
+  EXPECT_TRUE(recovered);
+}
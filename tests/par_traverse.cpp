@@ -0,0 +1,87 @@
+#include "../result_concurrency.h"
+#include <atomic>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+auto make_inputs(int size) -> std::vector<int> {
+  std::vector<int> inputs(static_cast<std::size_t>(size));
+  std::iota(inputs.begin(), inputs.end(), 0);
+  return inputs;
+}
+
+} // namespace
+
+TEST(ParTraverse, KeepsInputOrder) {
+  const auto inputs = make_inputs(10000);
+  const auto squared = res::par_traverse(
+      inputs, [](int val) -> res::result<long, std::string> { return res::ok(static_cast<long>(val) * val); },
+      res::thread_executor(4));
+  ASSERT_TRUE(squared);
+  ASSERT_EQ(squared.value().size(), inputs.size());
+  for (std::size_t i = 0; i < inputs.size(); ++i) { EXPECT_EQ(squared.value()[i], static_cast<long>(i * i)); }
+}
+
+TEST(ParTraverse, Empty) {
+  const std::vector<int> inputs;
+  const auto mapped = res::par_traverse(
+      inputs, [](int val) -> res::result<int, int> { return res::ok(val); }, res::error_order::first_in_time);
+  ASSERT_TRUE(mapped);
+  EXPECT_TRUE(mapped.value().empty());
+}
+
+TEST(ParTraverse, FirstByIndexIsDeterministic) {
+  const auto inputs = make_inputs(20000);
+  auto fails_on_multiples = [](int val) -> res::result<int, int> {
+    if (val > 0 && val % 997 == 0) { return res::err(val); }
+    return res::ok(val);
+  };
+  for (int run = 0; run < 20; ++run) {
+    const auto mapped = res::par_traverse(inputs, fails_on_multiples, res::thread_executor(8));
+    ASSERT_FALSE(mapped);
+    EXPECT_EQ(mapped.error(), 997);
+  }
+}
+
+TEST(ParTraverse, FirstInTimeStopsEveryWorker) {
+  const auto inputs = make_inputs(1000000);
+  std::atomic<int> calls{0};
+  const auto mapped = res::par_traverse(
+      inputs,
+      [&calls](int val) -> res::result<int, int> {
+        calls.fetch_add(1, std::memory_order_relaxed);
+        if (val % 1000 == 10) { return res::err(val); }
+        return res::ok(val);
+      },
+      res::thread_executor(4), res::error_order::first_in_time);
+  ASSERT_FALSE(mapped);
+  EXPECT_EQ(mapped.error() % 1000, 10);
+  EXPECT_LT(calls.load(), static_cast<int>(inputs.size()));
+}
+
+TEST(ParTraverse, NonDefaultConstructibleValues) {
+  const auto inputs = make_inputs(100);
+  const auto owned = res::par_traverse(inputs, [](int val) -> res::result<std::unique_ptr<int>, int> {
+    return res::result<int, int>(res::ok(val)).map([](int inner) { return std::make_unique<int>(inner); });
+  });
+  ASSERT_TRUE(owned);
+  EXPECT_EQ(*owned.value()[42], 42);
+}
+
+#if RESULT_HAS_EXCEPTIONS
+TEST(ParTraverse, RethrowsExceptions) {
+  const auto inputs = make_inputs(1000);
+  auto throws = [](int val) -> res::result<int, int> {
+    if (val == 500) { throw std::runtime_error("boom"); }
+    return res::ok(val);
+  };
+  EXPECT_THROW(auto mapped = res::par_traverse(inputs, throws, res::thread_executor(4)), // NOLINT
+               std::runtime_error);
+}
+#endif
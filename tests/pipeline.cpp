@@ -0,0 +1,90 @@
+#include "../result.h"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace {
+
+auto half(int val) -> res::result<int, std::string> {
+  if (val % 2 != 0) { return res::err(std::string("odd")); }
+  return res::ok(val / 2);
+}
+
+} // namespace
+
+TEST(Pipeline, Ok) {
+  res::result<int, std::string> result = res::ok(20);
+  res::result<std::string, std::string> fused =
+      result | res::map([](int val) { return val * 2; }) | res::and_then(half) |
+      res::map([](int val) { return std::to_string(val); });
+  ASSERT_TRUE(fused);
+  EXPECT_EQ(fused.value(), "20");
+  EXPECT_EQ(result.value(), 20);
+}
+
+TEST(Pipeline, MatchesEagerChain) {
+  for (const int input : {8, 12, 6, 7}) {
+    res::result<int, std::string> result = res::ok(input);
+    auto eager = result.and_then(half).map([](int val) { return val + 1; }).and_then(half).map_err([](auto err) {
+      return err.size();
+    });
+    auto fused = (result | res::and_then(half) | res::map([](int val) { return val + 1; }) | res::and_then(half) |
+                  res::map_err([](auto err) { return err.size(); }))
+                     .run();
+    ASSERT_EQ(eager.is_ok(), fused.is_ok());
+    if (eager) {
+      EXPECT_EQ(eager.value(), fused.value());
+    } else {
+      EXPECT_EQ(eager.error(), fused.error());
+    }
+  }
+}
+
+TEST(Pipeline, ErrSkipsValueStages) {
+  int calls = 0;
+  auto count = [&calls](int val) {
+    ++calls;
+    return val;
+  };
+  res::result<int, std::string> fused = res::result<int, std::string>(res::ok(3)) | res::and_then(half) |
+                                        res::map(count) | res::map(count) |
+                                        res::map_err([](std::string err) { return err + "!"; });
+  EXPECT_EQ(calls, 0);
+  ASSERT_FALSE(fused);
+  EXPECT_EQ(fused.error(), "odd!");
+}
+
+TEST(Pipeline, OrElseRecovers) {
+  res::result<int, std::string> result = res::err(std::string("error"));
+  res::result<int, int> fused = result | res::map([](int val) { return val + 1; }) |
+                                res::or_else([](const std::string &) -> res::result<int, std::string> {
+                                  return res::ok(0);
+                                }) |
+                                res::map([](int val) { return val + 1; }) |
+                                res::map_err([](const std::string &err) { return static_cast<int>(err.size()); });
+  ASSERT_TRUE(fused);
+  EXPECT_EQ(fused.value(), 1);
+}
+
+TEST(Pipeline, ReusableComposition) {
+  auto steps = res::and_then(half) | res::map([](int val) { return val * 3; });
+  res::result<int, std::string> first = res::result<int, std::string>(res::ok(4)) | steps;
+  res::result<int, std::string> second = res::result<int, std::string>(res::ok(5)) | steps;
+  EXPECT_EQ(first.value(), 6);
+  EXPECT_EQ(second.error(), "odd");
+}
+
+TEST(Pipeline, Void) {
+  res::result<void, std::string> result = res::ok();
+  res::result<int, std::string> fused = result | res::map([]() { return 42; }) | res::and_then(half);
+  ASSERT_TRUE(fused);
+  EXPECT_EQ(fused.value(), 21);
+}
+
+TEST(Pipeline, Constexpr) {
+  constexpr res::result<int, int> source = res::ok(20);
+  constexpr auto fused = (source | res::map([](int val) { return val + 1; }) |
+                          res::map_err([](int err) { return static_cast<char>(err); }))
+                             .run();
+  static_assert(fused.value() == 21);
+  EXPECT_TRUE(fused);
+}
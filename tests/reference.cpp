@@ -0,0 +1,149 @@
+#include "../result.h"
+#include "misuse.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace {
+
+enum class lookup_errc : std::uint8_t { missing, evicted };
+
+// Cached object that counts how many times it was copied.
+struct entry {
+  static int copies;
+  std::string name;
+  std::string payload;
+
+  entry(std::string name, std::string payload) : name(std::move(name)), payload(std::move(payload)) {}
+  entry(const entry &other) : name(other.name), payload(other.payload) { ++copies; }
+  entry(entry &&other) noexcept = default;
+  auto operator=(const entry &) -> entry & = delete;
+  auto operator=(entry &&) -> entry & = delete;
+  ~entry() = default;
+};
+
+int entry::copies = 0;
+
+class cache {
+  std::map<int, entry> entries_;
+
+public:
+  cache() {
+    entries_.emplace(1, entry("one", std::string(4096, 'a')));
+    entries_.emplace(2, entry("two", std::string(4096, 'b')));
+  }
+
+  auto find(int key) const -> res::result<const entry &, lookup_errc> {
+    const auto found = entries_.find(key);
+    if (found == entries_.end()) { return res::err(lookup_errc::missing); }
+    return res::ok(std::ref(found->second));
+  }
+
+  auto name_of(int key) const -> res::result<std::string_view, lookup_errc> {
+    return find(key).map([](const entry &found) { return std::string_view(found.name); });
+  }
+};
+
+auto name_length(const cache &source, int key) -> res::result<std::size_t, lookup_errc> {
+  RES_TRY_ASSIGN(const entry &found, source.find(key));
+  return res::ok(found.name.size());
+}
+
+} // namespace
+
+static_assert(std::is_same_v<decltype(res::ok(std::ref(std::declval<int &>()))), res::ok<int &>>);
+static_assert(std::is_trivially_copyable_v<res::result<const entry &, lookup_errc>>);
+static_assert(sizeof(res::result<const entry &, lookup_errc>) == sizeof(entry *));
+static_assert(sizeof(res::result<int &, std::string>) == sizeof(res::result<int *, std::string>));
+
+TEST(Reference, RefersToTheSameObject) {
+  const cache source;
+  entry::copies = 0;
+  auto found = source.find(1);
+  ASSERT_TRUE(found);
+  EXPECT_EQ(found.value().name, "one");
+  EXPECT_EQ(&found.value(), &source.find(1).value());
+  EXPECT_EQ(entry::copies, 0);
+}
+
+TEST(Reference, Error) {
+  const cache source;
+  auto found = source.find(3);
+  ASSERT_FALSE(found);
+  EXPECT_EQ(found.error(), lookup_errc::missing);
+  EXPECT_MISUSE((void)found.value(), std::logic_error);
+}
+
+TEST(Reference, MutableReference) {
+  int counter = 1;
+  res::result<int &, std::string> result = res::ok<int &>(counter);
+  result.value() += 1;
+  std::move(result).value() += 1;
+  EXPECT_EQ(counter, 3);
+}
+
+TEST(Reference, MapPassesTheReference) {
+  const cache source;
+  entry::copies = 0;
+  auto name = source.find(2).map([](const entry &found) -> const std::string & { return found.name; });
+  static_assert(std::is_same_v<decltype(name), res::result<const std::string &, lookup_errc>>);
+  ASSERT_TRUE(name);
+  EXPECT_EQ(&name.value(), &source.find(2).value().name);
+  EXPECT_EQ(source.name_of(2).value(), "two");
+  EXPECT_EQ(entry::copies, 0);
+}
+
+TEST(Reference, ChainsKeepTheReference) {
+  const cache source;
+  entry::copies = 0;
+  auto found = source.find(1)
+                   .map_err([](lookup_errc) { return std::string("lost"); })
+                   .and_then([](const entry &found) -> res::result<const entry &, std::string> {
+                     return res::ok(std::ref(found));
+                   })
+                   .context("looking up");
+  ASSERT_TRUE(found);
+  EXPECT_EQ(&found.value(), &source.find(1).value());
+  EXPECT_EQ(entry::copies, 0);
+}
+
+TEST(Reference, ValueOrFallsBackToAnotherObject) {
+  const cache source;
+  const entry fallback("fallback", "");
+  EXPECT_EQ(&source.find(3).value_or(fallback), &fallback);
+  EXPECT_EQ(source.find(1).value_or(fallback).name, "one");
+}
+
+TEST(Reference, EmplaceRebinds) {
+  int first = 1;
+  int second = 2;
+  res::result<int &, lookup_errc> result = res::err(lookup_errc::evicted);
+  EXPECT_EQ(&result.emplace(first), &first);
+  result.emplace(second) = 20;
+  EXPECT_EQ(first, 1);
+  EXPECT_EQ(second, 20);
+  result.emplace_error(lookup_errc::missing);
+  EXPECT_EQ(result.error(), lookup_errc::missing);
+}
+
+TEST(Reference, Try) {
+  const cache source;
+  entry::copies = 0;
+  EXPECT_EQ(name_length(source, 1).value(), 3U);
+  EXPECT_EQ(name_length(source, 5).error(), lookup_errc::missing);
+  EXPECT_EQ(entry::copies, 0);
+}
+
+TEST(Reference, StringView) {
+  const std::string text = "key=value";
+  res::result<std::string_view, lookup_errc> key = res::ok(std::string_view(text).substr(0, 3));
+  ASSERT_TRUE(key);
+  EXPECT_EQ(key.value(), "key");
+  EXPECT_EQ(key.value().data(), text.data());
+  auto length = key.map([](std::string_view view) { return view.size(); });
+  EXPECT_EQ(length.value(), 3U);
+}
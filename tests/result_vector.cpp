@@ -0,0 +1,151 @@
+#include "../result.h"
+#include "misuse.hpp"
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// Every third element fails, spanning several mask words and a partial tail word.
+auto make_vector(std::size_t size) -> res::result_vector<int, std::string> {
+  res::result_vector<int, std::string> results;
+  for (std::size_t i = 0; i < size; ++i) {
+    if (i % 3 == 2) {
+      results.push_back(res::err("error " + std::to_string(i)));
+    } else {
+      results.push_back(res::ok(static_cast<int>(i)));
+    }
+  }
+  return results;
+}
+
+#if RESULT_HAS_EXCEPTIONS
+// An error whose copies, and therefore moves, throw while armed.
+struct fragile_error {
+  static inline bool armed = false;
+  int code = 0;
+
+  fragile_error() = default;
+  explicit fragile_error(int value) : code(value) {}
+  fragile_error(const fragile_error &other) : code(other.code) {
+    if (armed) { throw std::runtime_error("copy failed"); }
+  }
+  auto operator=(const fragile_error &other) -> fragile_error & = default;
+  ~fragile_error() = default;
+};
+#endif
+
+} // namespace
+
+TEST(ResultVector, Empty) {
+  const res::result_vector<int, std::string> results;
+  EXPECT_TRUE(results.empty());
+  EXPECT_EQ(results.count_ok(), 0);
+  EXPECT_TRUE(results.all_ok());
+  EXPECT_EQ(results.first_err(), 0);
+}
+
+TEST(ResultVector, ElementAccess) {
+  const auto results = make_vector(5);
+  ASSERT_EQ(results.size(), 5);
+  EXPECT_TRUE(results[1].is_ok());
+  EXPECT_EQ(results[1].value(), 1);
+  EXPECT_TRUE(results[2].is_err());
+  EXPECT_EQ(results[2].error(), "error 2");
+  EXPECT_MISUSE((void)results[2].value(), std::logic_error);
+  EXPECT_MISUSE((void)results.at(5), std::out_of_range);
+
+  const res::result<int, std::string> element = results[2];
+  ASSERT_FALSE(element);
+  EXPECT_EQ(element.error(), "error 2");
+}
+
+TEST(ResultVector, AssignThroughProxy) {
+  auto results = make_vector(5);
+  results[2] = res::ok(42);
+  results[0] = res::err(std::string("replaced"));
+  results[4] = results[0];
+  EXPECT_EQ(results[2].value(), 42);
+  EXPECT_EQ(results[0].error(), "replaced");
+  EXPECT_EQ(results[4].error(), "replaced");
+  EXPECT_EQ(results.count_ok(), 3);
+  EXPECT_EQ(results.first_err(), 0);
+}
+
+TEST(ResultVector, Counts) {
+  const auto results = make_vector(200);
+  EXPECT_EQ(results.count_ok(), 134);
+  EXPECT_EQ(results.count_err(), 66);
+  EXPECT_FALSE(results.all_ok());
+  EXPECT_EQ(results.first_err(), 2);
+}
+
+TEST(ResultVector, FirstErrPastFullWords) {
+  res::result_vector<int, int> results;
+  for (int i = 0; i < 130; ++i) { results.push_back(res::ok(i)); }
+  EXPECT_TRUE(results.all_ok());
+  EXPECT_EQ(results.first_err(), 130);
+  results.push_back(res::err(7));
+  EXPECT_FALSE(results.all_ok());
+  EXPECT_EQ(results.first_err(), 130);
+}
+
+TEST(ResultVector, Partition) {
+  auto results = make_vector(200);
+  // Make the second mask word uniformly ok so it is copied as one range.
+  for (std::size_t i = 64; i < 128; ++i) { results[i] = res::ok(static_cast<int>(i)); }
+  const auto [values, errors] = results.partition();
+  ASSERT_EQ(values.size(), results.count_ok());
+  ASSERT_EQ(errors.size(), results.count_err());
+  EXPECT_EQ(values[0], 0);
+  EXPECT_EQ(values[2], 3);
+  EXPECT_EQ(errors.front(), "error 2");
+  EXPECT_EQ(errors.back(), "error 197");
+
+  const auto [moved_values, moved_errors] = std::move(results).partition();
+  EXPECT_EQ(moved_values, values);
+  EXPECT_EQ(moved_errors, errors);
+}
+
+TEST(ResultVector, MapSkipsErrors) {
+  const auto results = make_vector(130);
+  int calls = 0;
+  const auto mapped = results.map([&calls](int val) {
+    ++calls;
+    return val * 2.0;
+  });
+  EXPECT_EQ(calls, static_cast<int>(results.count_ok()));
+  ASSERT_EQ(mapped.size(), results.size());
+  EXPECT_EQ(mapped[4].value(), 8.0);
+  EXPECT_EQ(mapped[5].error(), "error 5");
+}
+
+TEST(ResultVector, MapFullWords) {
+  res::result_vector<int, int> results;
+  for (int i = 0; i < 128; ++i) { results.push_ok(i); }
+  const auto mapped = results.map([](int val) { return val + 1; });
+  EXPECT_TRUE(mapped.all_ok());
+  EXPECT_EQ(mapped[127].value(), 128);
+}
+
+#if RESULT_HAS_EXCEPTIONS
+TEST(ResultVector, ThrowingPushLeavesVectorUnchanged) {
+  res::result_vector<int, fragile_error> results;
+  for (int i = 0; i < 64; ++i) { results.push_ok(i); }
+
+  fragile_error::armed = true;
+  EXPECT_THROW(results.push_err(fragile_error(1)), std::runtime_error);
+  fragile_error::armed = false;
+  EXPECT_EQ(results.size(), 64);
+  EXPECT_TRUE(results.all_ok());
+
+  results.push_err(fragile_error(2));
+  results.push_ok(65);
+  ASSERT_EQ(results.size(), 66);
+  EXPECT_EQ(results.count_ok(), 65);
+  EXPECT_EQ(results.first_err(), 64);
+  EXPECT_EQ(results[64].error().code, 2);
+  EXPECT_EQ(results[65].value(), 65);
+}
+#endif
@@ -0,0 +1,181 @@
+#include "../result.h"
+#include "misuse.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+enum class job_errc : std::uint16_t { cancelled = 3, timed_out = 7 };
+
+struct sample {
+  std::int32_t id;
+  double value;
+};
+
+// Claims a payload above the 4 GiB record limit without holding one.
+struct oversized {};
+
+template <typename T, typename = void> struct has_wire_traits : std::false_type {};
+template <typename T> struct has_wire_traits<T, std::void_t<typename res::wire_traits<T>::view_type>> : std::true_type {};
+
+template <typename T, typename E> auto encode(const res::result<T, E> &value) -> std::vector<std::byte> {
+  std::vector<std::byte> buffer;
+  res::serialize(value, buffer);
+  return buffer;
+}
+
+} // namespace
+
+template <> struct res::wire_traits<oversized> {
+  using view_type = oversized;
+
+  static auto size(const oversized & /*value*/) noexcept -> std::size_t { return std::size_t{1} << 32U; }
+  static void write(const oversized & /*value*/, std::byte * /*out*/) noexcept {}
+  static auto fits(std::size_t /*size*/) noexcept -> bool { return true; }
+  static auto read(const std::byte * /*data*/, std::size_t /*size*/) noexcept -> oversized { return {}; }
+};
+
+static_assert(std::is_trivially_copyable_v<res::result_view<std::string, job_errc>>);
+
+// Trivially copyable types that hold addresses are not serialized in host representation.
+static_assert(has_wire_traits<sample>::value);
+static_assert(!has_wire_traits<int *>::value);
+static_assert(!has_wire_traits<res::error_code>::value);
+static_assert(!has_wire_traits<res::formatted_error>::value);
+
+TEST(Serialize, TrivialValueRoundTrip) {
+  const res::result<sample, job_errc> original = res::ok(sample{42, 2.5});
+  const auto buffer = encode(original);
+  EXPECT_EQ(buffer.size(), 5 + sizeof(sample));
+  EXPECT_EQ(buffer.size(), res::serialized_size(original));
+
+  auto decoded = res::deserialize<sample, job_errc>(buffer.data(), buffer.size());
+  ASSERT_TRUE(decoded);
+  ASSERT_TRUE(decoded.value());
+  EXPECT_EQ(decoded.value().value().id, 42);
+  EXPECT_EQ(decoded.value().value().value, 2.5);
+}
+
+TEST(Serialize, ErrorRoundTrip) {
+  const res::result<sample, job_errc> original = res::err(job_errc::timed_out);
+  const auto buffer = encode(original);
+  EXPECT_EQ(buffer.size(), 5 + sizeof(job_errc));
+  auto decoded = res::deserialize<sample, job_errc>(buffer.data(), buffer.size());
+  ASSERT_TRUE(decoded);
+  EXPECT_EQ(decoded.value().error(), job_errc::timed_out);
+}
+
+TEST(Serialize, ViewPointsIntoTheBuffer) {
+  const res::result<std::string, std::string> original = res::ok(std::string("payload bytes"));
+  const auto buffer = encode(original);
+  auto view = res::result_view<std::string, std::string>::parse(buffer.data(), buffer.size());
+  ASSERT_TRUE(view);
+  ASSERT_TRUE(view.value());
+  const std::string_view text = view.value().value();
+  EXPECT_EQ(text, "payload bytes");
+  EXPECT_EQ(static_cast<const void *>(text.data()), static_cast<const void *>(buffer.data() + 5));
+  EXPECT_EQ(view.value().encoded_size(), buffer.size());
+  EXPECT_EQ(view.value().to_result().value(), "payload bytes");
+}
+
+TEST(Serialize, StringViewRoundTrip) {
+  const std::string text = "borrowed";
+  const res::result<std::string_view, int> original = res::ok(std::string_view(text));
+  const auto buffer = encode(original);
+  EXPECT_EQ(buffer.size(), 5 + text.size());
+  auto decoded = res::deserialize<std::string_view, int>(buffer.data(), buffer.size());
+  ASSERT_TRUE(decoded);
+  ASSERT_TRUE(decoded.value());
+  EXPECT_EQ(decoded.value().value(), "borrowed");
+  EXPECT_EQ(static_cast<const void *>(decoded.value().value().data()), static_cast<const void *>(buffer.data() + 5));
+}
+
+TEST(Serialize, VoidAndReferenceResults) {
+  const res::result<void, std::string> done = res::ok();
+  const auto done_buffer = encode(done);
+  EXPECT_EQ(done_buffer.size(), 5U);
+  EXPECT_TRUE((res::deserialize<void, std::string>(done_buffer.data(), done_buffer.size()).value()));
+
+  const std::string stored = "by reference";
+  const res::result<const std::string &, job_errc> ref = res::ok(std::cref(stored));
+  const auto ref_buffer = encode(ref);
+  auto decoded = res::deserialize<std::string, job_errc>(ref_buffer.data(), ref_buffer.size());
+  EXPECT_EQ(decoded.value().value(), "by reference");
+}
+
+TEST(Serialize, RejectsMalformedRecords) {
+  const auto buffer = encode(res::result<std::int32_t, job_errc>(res::ok(7)));
+  EXPECT_EQ((res::deserialize<std::int32_t, job_errc>(buffer.data(), 3).error()), res::wire_errc::truncated);
+  EXPECT_EQ((res::deserialize<std::int32_t, job_errc>(buffer.data(), buffer.size() - 1).error()),
+            res::wire_errc::truncated);
+  EXPECT_EQ((res::deserialize<std::int64_t, job_errc>(buffer.data(), buffer.size()).error()),
+            res::wire_errc::bad_payload);
+
+  auto corrupted = buffer;
+  corrupted[0] = std::byte{9};
+  EXPECT_EQ((res::deserialize<std::int32_t, job_errc>(corrupted.data(), corrupted.size()).error()),
+            res::wire_errc::bad_tag);
+}
+
+TEST(Serialize, RejectsPayloadsAboveTheRecordLimit) {
+  if constexpr (sizeof(std::size_t) > sizeof(std::uint32_t)) {
+    const res::result<oversized, int> original = res::ok(oversized{});
+    EXPECT_DEATH((void)res::serialized_size(original), "4 GiB");
+    std::vector<std::byte> buffer(16);
+    EXPECT_DEATH((void)res::serialize(original, buffer.data()), "4 GiB");
+  }
+}
+
+TEST(Serialize, ViewAccessorsAreChecked) {
+  const auto buffer = encode(res::result<std::int32_t, job_errc>(res::err(job_errc::cancelled)));
+  const auto view = res::result_view<std::int32_t, job_errc>::parse(buffer.data(), buffer.size()).value();
+  EXPECT_FALSE(view);
+  EXPECT_EQ(view.error(), job_errc::cancelled);
+  EXPECT_MISUSE((void)view.value(), std::logic_error);
+}
+
+TEST(Serialize, StreamOfResults) {
+  res::result_encoder encoder;
+  for (int index = 0; index < 10; ++index) {
+    if (index % 3 == 0) {
+      encoder.write(res::result<std::string, job_errc>(res::err(job_errc::cancelled)));
+    } else {
+      encoder.write(res::result<std::string, job_errc>(res::ok(std::to_string(index))));
+    }
+  }
+  const auto bytes = encoder.take();
+  EXPECT_EQ(encoder.size(), 0U);
+
+  res::result_reader<std::string, job_errc> reader(bytes);
+  std::string values;
+  int errors = 0;
+  while (!reader.done()) {
+    auto view = reader.next();
+    ASSERT_TRUE(view);
+    if (view.value()) {
+      values += view.value().value();
+    } else {
+      ++errors;
+    }
+  }
+  EXPECT_EQ(values, "124578");
+  EXPECT_EQ(errors, 4);
+}
+
+TEST(Serialize, ReaderStopsAtMalformedRecords) {
+  res::result_encoder encoder;
+  encoder.write(res::result<std::int32_t, job_errc>(res::ok(1)));
+  encoder.write(res::result<std::int32_t, job_errc>(res::ok(2)));
+  std::vector<std::byte> bytes = encoder.buffer();
+  bytes.pop_back();
+
+  res::result_reader<std::int32_t, job_errc> reader(bytes);
+  EXPECT_EQ(reader.next().value().value(), 1);
+  EXPECT_EQ(reader.next().error(), res::wire_errc::truncated);
+  EXPECT_TRUE(reader.done());
+}
@@ -0,0 +1,78 @@
+#include "../../result.h"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+auto parse(const std::string &text) -> res::result<int, std::string> {
+  if (text.empty()) { return res::err(std::string("empty")); }
+  return res::ok(static_cast<int>(text.size()));
+}
+
+auto parse_line() -> unsigned { return __LINE__ - 4; }
+
+auto count_of(const res::telemetry::snapshot &snapshot, unsigned line) -> std::uint64_t {
+  std::uint64_t count = 0;
+  for (const auto &site : snapshot.sites) {
+    if (site.site.line == line && std::string(site.site.file).find("telemetry.cpp") != std::string::npos) {
+      count += site.count;
+    }
+  }
+  return count;
+}
+
+// Telemetry skips constant evaluation, so err keeps working in constant expressions.
+constexpr res::result<int, int> constant = res::err(3);
+static_assert(!constant.is_ok());
+
+} // namespace
+
+TEST(Telemetry, CountsCallSites) {
+  const auto before = count_of(res::telemetry::take_snapshot(), parse_line());
+  for (int index = 0; index < 10; ++index) { (void)parse(""); }
+  (void)parse("ok");
+  const auto snapshot = res::telemetry::take_snapshot();
+  EXPECT_EQ(count_of(snapshot, parse_line()) - before, 10);
+  const auto site = std::find_if(snapshot.sites.begin(), snapshot.sites.end(),
+                                 [](const auto &entry) { return entry.site.line == parse_line(); });
+  ASSERT_NE(site, snapshot.sites.end());
+  EXPECT_NE(std::string(site->site.function).find("parse"), std::string::npos);
+}
+
+TEST(Telemetry, RecentErrorsAreOrdered) {
+  (void)parse("");
+  [[maybe_unused]] const res::result<int, int> last = res::err(1);
+  const unsigned last_line = __LINE__ - 1;
+  const auto snapshot = res::telemetry::take_snapshot();
+  ASSERT_GE(snapshot.recent.size(), 2);
+  EXPECT_EQ(snapshot.recent.back().site.line, last_line);
+  EXPECT_TRUE(std::is_sorted(snapshot.recent.begin(), snapshot.recent.end(),
+                             [](const auto &lhs, const auto &rhs) { return lhs.time < rhs.time; }));
+}
+
+TEST(Telemetry, RingKeepsTheMostRecentErrors) {
+  for (int index = 0; index < 3 * RESULT_TELEMETRY_RECENT; ++index) { (void)parse(""); }
+  const auto snapshot = res::telemetry::take_snapshot();
+  const auto from_parse = std::count_if(snapshot.recent.begin(), snapshot.recent.end(),
+                                        [](const auto &entry) { return entry.site.line == parse_line(); });
+  EXPECT_EQ(from_parse, RESULT_TELEMETRY_RECENT);
+  const auto last = snapshot.recent.back();
+  EXPECT_GE(last.sequence, 3 * RESULT_TELEMETRY_RECENT - 1);
+}
+
+TEST(Telemetry, AggregatesAcrossThreads) {
+  const auto before = count_of(res::telemetry::take_snapshot(), parse_line());
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < 4; ++thread) {
+    threads.emplace_back([] {
+      for (int index = 0; index < 1000; ++index) { (void)parse(""); }
+    });
+  }
+  // Snapshots taken while the threads record must not disturb them.
+  for (int index = 0; index < 20; ++index) { (void)res::telemetry::take_snapshot(); }
+  for (auto &thread : threads) { thread.join(); }
+  EXPECT_EQ(count_of(res::telemetry::take_snapshot(), parse_line()) - before, 4000);
+}
@@ -0,0 +1,153 @@
+#include "../result.h"
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+auto parse_digit(char chr) -> res::result<int, std::string> {
+  if (chr < '0' || chr > '9') { return res::err(std::string("not a digit: ") + chr); }
+  return res::ok(chr - '0');
+}
+
+auto check_positive(int val) -> res::result<void, std::string> {
+  if (val <= 0) { return res::err(std::string("not positive")); }
+  return res::ok();
+}
+
+auto sum_assign(char lhs, char rhs) -> res::result<int, std::string> {
+  RES_TRY_ASSIGN(const int left, parse_digit(lhs));
+  RES_TRY_ASSIGN(const int right, parse_digit(rhs));
+  return res::ok(left + right);
+}
+
+auto checked_sum(char lhs, char rhs) -> res::result<void, std::string> {
+  RES_TRY_ASSIGN(const int sum, sum_assign(lhs, rhs));
+  RES_TRY(check_positive(sum));
+  return res::ok();
+}
+
+struct wrapped_error {
+  std::string message;
+  wrapped_error(std::string text) : message(std::move(text)) {} // NOLINT(google-explicit-constructor)
+};
+
+// The error of parse_digit is converted into the error type of the caller.
+auto wrapped_digit(char chr) -> res::result<int, wrapped_error> {
+  RES_TRY_ASSIGN(const int digit, parse_digit(chr));
+  return res::ok(digit);
+}
+
+// Named results are checked without moving their payloads out.
+auto length_of(res::result<std::string, std::string> &named) -> res::result<std::size_t, std::string> {
+  RES_TRY_ASSIGN(const std::string text, named);
+  return res::ok(text.size());
+}
+
+auto length_of_const(const res::result<std::string, std::string> &named) -> res::result<std::size_t, std::string> {
+  RES_TRY_ASSIGN(const std::string text, named);
+  return res::ok(text.size());
+}
+
+#if RESULT_HAS_STATEMENT_EXPRESSIONS
+auto sum_expression(char lhs, char rhs) -> res::result<int, std::string> {
+  return res::ok(RES_TRY(parse_digit(lhs)) + RES_TRY(parse_digit(rhs)));
+}
+
+auto make_owned(int val) -> res::result<std::unique_ptr<int>, int> {
+  const res::result<int, int> source = res::ok(val);
+  return source.map([](int inner) { return std::make_unique<int>(inner); });
+}
+
+auto unwrap_owned(int val) -> res::result<int, int> {
+  const std::unique_ptr<int> owned = RES_TRY(make_owned(val));
+  return res::ok(*owned);
+}
+
+auto expression_length_of(res::result<std::string, std::string> &named) -> res::result<std::size_t, std::string> {
+  return res::ok(RES_TRY(named).size());
+}
+
+auto expression_length_of_const(const res::result<std::string, std::string> &named)
+    -> res::result<std::size_t, std::string> {
+  return res::ok(RES_TRY(named).size());
+}
+#endif
+
+} // namespace
+
+// Errors only propagate through implicit conversions, and arithmetic errors only through widening ones.
+using int_error_forwarder = res::detail::error_forwarder<res::result<int, int>>;
+static_assert(std::is_convertible_v<int_error_forwarder, res::result<int, long>>);
+static_assert(std::is_convertible_v<int_error_forwarder, res::result<void, res::any_error>>);
+static_assert(!std::is_convertible_v<int_error_forwarder, res::result<int, std::vector<int>>>);
+static_assert(!std::is_convertible_v<int_error_forwarder, res::result<void, std::vector<int>>>);
+static_assert(!std::is_convertible_v<int_error_forwarder, res::result<int, bool>>);
+static_assert(!std::is_convertible_v<int_error_forwarder, res::result<int, unsigned char>>);
+static_assert(!std::is_convertible_v<int_error_forwarder, res::result<void, double>>);
+
+TEST(Try, AssignOk) {
+  auto result = sum_assign('4', '2');
+  ASSERT_TRUE(result);
+  EXPECT_EQ(result.value(), 6);
+}
+
+TEST(Try, AssignErr) {
+  auto result = sum_assign('4', 'x');
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.error(), "not a digit: x");
+}
+
+TEST(Try, Void) {
+  EXPECT_TRUE(checked_sum('1', '2'));
+  EXPECT_EQ(checked_sum('0', '0').error(), "not positive");
+  EXPECT_EQ(checked_sum('a', '0').error(), "not a digit: a");
+}
+
+#if RESULT_HAS_STATEMENT_EXPRESSIONS
+TEST(Try, Expression) {
+  EXPECT_EQ(sum_expression('4', '2').value(), 6);
+  EXPECT_EQ(sum_expression('x', '2').error(), "not a digit: x");
+  EXPECT_EQ(sum_expression('4', 'y').error(), "not a digit: y");
+}
+
+TEST(Try, ExpressionMovesValue) {
+  EXPECT_EQ(unwrap_owned(42).value(), 42);
+}
+
+TEST(Try, ExpressionKeepsLvalues) {
+  res::result<std::string, std::string> named = res::ok(std::string("payload"));
+  EXPECT_EQ(expression_length_of(named).value(), 7U);
+  EXPECT_EQ(named.value(), "payload");
+
+  res::result<std::string, std::string> failed = res::err(std::string("broken"));
+  EXPECT_EQ(expression_length_of(failed).error(), "broken");
+  EXPECT_EQ(failed.error(), "broken");
+
+  const res::result<std::string, std::string> constant = res::ok(std::string("constant"));
+  EXPECT_EQ(expression_length_of_const(constant).value(), 8U);
+  EXPECT_EQ(constant.value(), "constant");
+}
+#endif
+
+TEST(Try, AssignKeepsLvalues) {
+  res::result<std::string, std::string> named = res::ok(std::string("payload"));
+  EXPECT_EQ(length_of(named).value(), 7U);
+  EXPECT_EQ(named.value(), "payload");
+
+  res::result<std::string, std::string> failed = res::err(std::string("broken"));
+  EXPECT_EQ(length_of(failed).error(), "broken");
+  EXPECT_EQ(failed.error(), "broken");
+
+  const res::result<std::string, std::string> constant = res::err(std::string("constant"));
+  EXPECT_EQ(length_of_const(constant).error(), "constant");
+  EXPECT_EQ(constant.error(), "constant");
+}
+
+TEST(Try, ConvertsToAWiderErrorType) {
+  EXPECT_EQ(wrapped_digit('7').value(), 7);
+  EXPECT_EQ(wrapped_digit('x').error().message, "not a digit: x");
+}
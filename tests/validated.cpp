@@ -0,0 +1,167 @@
+#include "../result.h"
+#include "misuse.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+enum class field_error { missing_name, bad_age, unknown_country, too_long };
+
+struct request {
+  std::string name;
+  int age = 0;
+  std::string country;
+};
+
+auto has_name(const request &input) -> res::result<void, field_error> {
+  if (input.name.empty()) { return res::err(field_error::missing_name); }
+  return res::ok();
+}
+auto has_valid_age(const request &input) -> res::result<void, field_error> {
+  if (input.age < 0 || input.age > 150) { return res::err(field_error::bad_age); }
+  return res::ok();
+}
+auto has_known_country(const request &input) -> res::result<int, field_error> {
+  if (input.country != "NL" && input.country != "DE") { return res::err(field_error::unknown_country); }
+  return res::ok(static_cast<int>(input.country.size()));
+}
+
+auto parse(const std::string &text) -> res::result<int, std::string> {
+  if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) { return res::err("bad: " + text); }
+  return res::ok(std::stoi(text));
+}
+
+template <std::size_t N> auto errors_of(const res::error_list<field_error, N> &errors) -> std::vector<field_error> {
+  return {errors.begin(), errors.end()};
+}
+
+} // namespace
+
+TEST(Validated, ValidateAllPasses) {
+  const auto checked = res::validate_all(request{"ann", 30, "NL"}, has_name, has_valid_age, has_known_country);
+  ASSERT_TRUE(checked);
+  EXPECT_EQ(checked.value().name, "ann");
+}
+
+TEST(Validated, ValidateAllCollectsEveryError) {
+  const auto checked = res::validate_all(request{"", 200, "XX"}, has_name, has_valid_age, has_known_country);
+  ASSERT_FALSE(checked);
+  EXPECT_EQ(errors_of(checked.errors()),
+            (std::vector<field_error>{field_error::missing_name, field_error::bad_age, field_error::unknown_country}));
+  EXPECT_TRUE(checked.errors().is_inline());
+}
+
+TEST(Validated, ZipAllReturnsTheTupleOfValues) {
+  const auto zipped = res::zip_all(parse("1"), parse("22"), parse("333"));
+  ASSERT_TRUE(zipped);
+  EXPECT_EQ(zipped.value(), std::make_tuple(1, 22, 333));
+}
+
+TEST(Validated, ZipAllReportsEveryFailure) {
+  const auto zipped = res::zip_all(parse("x"), parse("2"), parse("y"));
+  ASSERT_FALSE(zipped);
+  ASSERT_EQ(zipped.errors().size(), 2U);
+  EXPECT_EQ(zipped.errors()[0], "bad: x");
+  EXPECT_EQ(zipped.errors()[1], "bad: y");
+}
+
+TEST(Validated, CombineLeavesVoidValuesOut) {
+  const request input{"ann", 30, "DE"};
+  const res::validated<void, field_error> name = has_name(input);
+  const res::validated<int, field_error> country = has_known_country(input);
+  const auto combined = res::combine(name, country, res::validated<void, field_error>(has_valid_age(input)));
+  static_assert(std::is_same_v<decltype(combined)::value_type, std::tuple<int>>);
+  ASSERT_TRUE(combined);
+  EXPECT_EQ(std::get<0>(combined.value()), 2);
+
+  const auto all_void = res::combine(name, res::validated<void, field_error>(has_valid_age(input)));
+  static_assert(std::is_same_v<decltype(all_void)::value_type, void>);
+  EXPECT_TRUE(all_void);
+}
+
+TEST(Validated, CombineKeepsArgumentOrder) {
+  const res::validated<int, field_error, 2> first = res::validate_all<2>(5, [](int) -> res::result<void, field_error> {
+    return res::err(field_error::too_long);
+  });
+  const res::validated<std::string, field_error, 2> second = res::err(field_error::bad_age);
+  const auto combined = res::combine(first, second);
+  ASSERT_FALSE(combined);
+  EXPECT_EQ(errors_of(combined.errors()), (std::vector<field_error>{field_error::too_long, field_error::bad_age}));
+}
+
+TEST(Validated, MovesValuesIntoTheTuple) {
+  res::validated<std::unique_ptr<int>, std::string> owned = res::ok(std::make_unique<int>(7));
+  res::validated<std::unique_ptr<int>, std::string> other = res::ok(std::make_unique<int>(8));
+  auto combined = res::combine(std::move(owned), std::move(other));
+  ASSERT_TRUE(combined);
+  auto values = std::move(combined).value();
+  EXPECT_EQ(*std::get<0>(values) + *std::get<1>(values), 15);
+}
+
+TEST(Validated, ConvertsToAndFromResult) {
+  const res::validated<int, std::string> from_ok = parse("4");
+  EXPECT_EQ(from_ok.value(), 4);
+  const res::validated<int, std::string> from_err = parse("z");
+  ASSERT_FALSE(from_err);
+  EXPECT_EQ(from_err.errors().size(), 1U);
+
+  const auto back = res::zip_all(parse("a"), parse("b")).to_result().map_err(
+      [](const res::error_list<std::string> &errors) { return errors.size(); });
+  EXPECT_EQ(back.error(), 2U);
+}
+
+TEST(Validated, AccessorsAreChecked) {
+  const res::validated<int, std::string> failed = parse("z");
+  EXPECT_MISUSE(static_cast<void>(failed.value()), std::logic_error);
+  const res::validated<int, std::string> passed = parse("1");
+  EXPECT_MISUSE(static_cast<void>(passed.errors()), std::logic_error);
+}
+
+TEST(ErrorList, SpillsToTheHeapBeyondItsInlineCapacity) {
+  res::error_list<std::string, 2> errors;
+  errors.push_back("a");
+  errors.push_back("b");
+  EXPECT_TRUE(errors.is_inline());
+  errors.push_back("c");
+  EXPECT_FALSE(errors.is_inline());
+  EXPECT_EQ(std::vector<std::string>(errors.begin(), errors.end()), (std::vector<std::string>{"a", "b", "c"}));
+
+  auto moved = std::move(errors);
+  EXPECT_EQ(moved.size(), 3U);
+  EXPECT_TRUE(errors.empty()); // NOLINT(bugprone-use-after-move)
+  EXPECT_TRUE(errors.is_inline());
+
+  const auto copied = moved;
+  EXPECT_EQ(copied[2], "c");
+}
+
+TEST(ErrorList, MovesInlineElements) {
+  res::error_list<std::unique_ptr<int>> errors;
+  errors.push_back(std::make_unique<int>(1));
+  errors.emplace_back(new int(2));
+  res::error_list<std::unique_ptr<int>> moved(std::move(errors));
+  ASSERT_EQ(moved.size(), 2U);
+  EXPECT_TRUE(moved.is_inline());
+  EXPECT_EQ(*moved[1], 2);
+
+  res::error_list<std::unique_ptr<int>> target;
+  target.push_back(std::make_unique<int>(0));
+  target.append(std::move(moved));
+  EXPECT_EQ(target.size(), 3U);
+  EXPECT_EQ(*target[2], 2);
+}
+
+TEST(ErrorList, AppendsAcrossTheInlineBoundary) {
+  res::error_list<int, 3> lhs;
+  res::error_list<int, 3> rhs;
+  for (int value = 0; value < 3; ++value) {
+    lhs.push_back(value);
+    rhs.push_back(value + 3);
+  }
+  lhs.append(rhs);
+  EXPECT_EQ(std::vector<int>(lhs.begin(), lhs.end()), (std::vector<int>{0, 1, 2, 3, 4, 5}));
+  EXPECT_EQ(rhs.size(), 3U);
+}
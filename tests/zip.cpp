@@ -0,0 +1,105 @@
+#include "../result.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+namespace {
+
+auto parse(const std::string &text) -> res::result<int, std::string> {
+  if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) { return res::err("bad: " + text); }
+  return res::ok(std::stoi(text));
+}
+
+auto check_positive(int value) -> res::result<void, std::string> {
+  if (value <= 0) { return res::err(std::string("not positive")); }
+  return res::ok();
+}
+
+// Counts how often it is copied and moved.
+struct tracked {
+  int copies = 0;
+  int moves = 0;
+
+  tracked() = default;
+  tracked(const tracked &other) : copies(other.copies + 1), moves(other.moves) {}
+  tracked(tracked &&other) noexcept : copies(other.copies), moves(other.moves + 1) {}
+  auto operator=(const tracked &) -> tracked & = default;
+  auto operator=(tracked &&) -> tracked & = default;
+  ~tracked() = default;
+};
+
+} // namespace
+
+TEST(Zip, TupleOfValues) {
+  const auto zipped = res::zip(parse("1"), parse("22"), parse("333"));
+  static_assert(std::is_same_v<decltype(zipped), const res::result<std::tuple<int, int, int>, std::string>>);
+  ASSERT_TRUE(zipped);
+  EXPECT_EQ(zipped.value(), std::make_tuple(1, 22, 333));
+}
+
+TEST(Zip, FirstErrorInArgumentOrder) {
+  const auto zipped = res::zip(parse("1"), parse("x"), parse("y"));
+  ASSERT_FALSE(zipped);
+  EXPECT_EQ(zipped.error(), "bad: x");
+}
+
+TEST(Zip, VoidResultsAreLeftOut) {
+  const auto zipped = res::zip(check_positive(1), parse("7"), check_positive(2));
+  static_assert(std::is_same_v<decltype(zipped), const res::result<std::tuple<int>, std::string>>);
+  EXPECT_EQ(std::get<0>(zipped.value()), 7);
+
+  const auto checks = res::zip(check_positive(1), check_positive(2));
+  static_assert(std::is_same_v<decltype(checks), const res::result<void, std::string>>);
+  EXPECT_TRUE(checks);
+  EXPECT_EQ(res::zip(check_positive(1), check_positive(0)).error(), "not positive");
+}
+
+TEST(Zip, MovesRvaluesAndCopiesLvalues) {
+  const res::result<tracked, std::string> kept = res::ok(tracked{});
+  const auto zipped = res::zip(kept, res::result<tracked, std::string>(res::ok(tracked{})));
+  const auto &[copied, moved] = zipped.value();
+  EXPECT_EQ(copied.copies, kept.value().copies + 1);
+  EXPECT_EQ(copied.moves, kept.value().moves);
+  EXPECT_EQ(moved.copies, 0);
+
+  auto owned = res::zip(res::result<std::unique_ptr<int>, std::string>(res::ok(std::make_unique<int>(3))));
+  EXPECT_EQ(*std::get<0>(owned.value()), 3);
+}
+
+TEST(Apply, CallsWithEveryValue) {
+  const auto sum = res::apply([](int lhs, int rhs) { return lhs + rhs; }, parse("2"), parse("40"));
+  EXPECT_EQ(sum.value(), 42);
+  const auto failed = res::apply([](int lhs, int rhs) { return lhs + rhs; }, parse("2"), parse("z"));
+  EXPECT_EQ(failed.error(), "bad: z");
+}
+
+TEST(Apply, SkipsVoidValuesAndReturnsVoid) {
+  int seen = 0;
+  const auto done = res::apply([&](int value) { seen = value; }, check_positive(1), parse("5"));
+  static_assert(std::is_same_v<decltype(done), const res::result<void, std::string>>);
+  EXPECT_TRUE(done);
+  EXPECT_EQ(seen, 5);
+
+  bool called = false;
+  const auto skipped = res::apply([&](int value) { called = value > 0; }, check_positive(0), parse("5"));
+  EXPECT_FALSE(skipped);
+  EXPECT_FALSE(called);
+}
+
+TEST(Apply, MovesValuesIntoTheFunctor) {
+  const auto moves = res::apply([](tracked value) { return value.moves; },
+                                res::result<tracked, std::string>(res::ok(tracked{})));
+  const res::result<tracked, std::string> source = res::ok(tracked{});
+  EXPECT_EQ(moves.value(), source.value().moves + 1);
+  const auto length = res::apply([](std::unique_ptr<int> value) { return *value; },
+                                 res::result<std::unique_ptr<int>, std::string>(res::ok(std::make_unique<int>(9))));
+  EXPECT_EQ(length.value(), 9);
+}
+
+TEST(Zip, Constexpr) {
+  constexpr auto zipped = res::apply([](int lhs, int rhs) { return lhs * rhs; }, res::result<int, int>(res::ok(6)),
+                                     res::result<int, int>(res::ok(7)));
+  static_assert(zipped.value() == 42);
+}
@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+"""Merges a header and the project headers it includes into a single header.
+
+Quoted includes are inlined recursively, each file at most once, and their `#pragma once` lines are dropped. Angle
+bracket includes are kept where they appear. Only the standard library is used, so the headers can be regenerated
+without network access:
+
+    python3 tools/amalgamate.py src/result-wrapper.h result.h
+    python3 tools/amalgamate.py --check src/result-wrapper.h result.h
+"""
+
+import argparse
+import os
+import re
+import sys
+
+QUOTED_INCLUDE = re.compile(r'\s*#\s*include\s+"([^"]+)"')
+
+
+def amalgamate(path, seen):
+    path = os.path.normpath(path)
+    if path in seen:
+        return ""
+    seen.add(path)
+    lines = []
+    separate_next = False
+    skip_blank = False
+    with open(path, encoding="utf-8") as source:
+        text = source.read()
+    for line in text.split("\n"):
+        if line.strip() == "#pragma once":
+            skip_blank = True
+            continue
+        if skip_blank and not line.strip():
+            continue
+        skip_blank = False
+        # Keep an inlined header apart from whatever follows it.
+        if separate_next and line.strip():
+            lines.append("")
+        separate_next = False
+        match = QUOTED_INCLUDE.match(line)
+        if match:
+            inlined = amalgamate(os.path.join(os.path.dirname(path), match.group(1)), seen)
+            if inlined:
+                lines.append(inlined)
+                separate_next = True
+            continue
+        lines.append(line)
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--check", action="store_true", help="fail if the output is not up to date instead of writing")
+    parser.add_argument("source")
+    parser.add_argument("output")
+    args = parser.parse_args()
+
+    merged = amalgamate(args.source, set())
+    if args.check:
+        try:
+            with open(args.output, encoding="utf-8") as existing:
+                current = existing.read()
+        except FileNotFoundError:
+            current = None
+        if current != merged:
+            print(f"{args.output} is out of date, run tools/amalgamate.py {args.source} {args.output}", file=sys.stderr)
+            return 1
+        return 0
+    with open(args.output, "w", encoding="utf-8") as output:
+        output.write(merged)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())